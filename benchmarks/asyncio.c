@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CAsyncIO.h>
+#include <cstd/CHRTime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FILE_SIZE (256 << 20)
+#define BLOCK 4096
+#define READS 200000
+
+typedef struct {
+    CAsyncIO_t *io;
+    int fd;
+    char *buffer;
+    size_t issued;
+    size_t failed;
+} Bench;
+
+static uint64_t random_offset() {
+    return ((uint64_t)rand() % (FILE_SIZE / BLOCK)) * BLOCK;
+}
+
+static void report(const char *name, unsigned depth, hrtime_t start,
+                   hrtime_t end) {
+    double seconds = (double)(end - start) / 1e9;
+    printf("%-10s depth %-3u %8.2f ms %10.0f IOPS\n", name, depth,
+           seconds * 1e3, READS / seconds);
+}
+
+// Every completion issues the next read, keeping `depth` requests in flight.
+static void on_read(void *user_data, int64_t result) {
+    Bench *bench = user_data;
+    if (result != BLOCK)
+        bench->failed++;
+    if (bench->issued < READS) {
+        bench->issued++;
+        CAsyncIO_read(bench->io, bench->fd, bench->buffer, BLOCK,
+                      random_offset(), on_read, bench);
+    }
+}
+
+static void run(int fd, int backend, const char *name, unsigned depth) {
+    CResult_t *res = CAsyncIO_new(depth, backend);
+    if (CResult_is_error(res)) {
+        CResult_free(&res);
+        return;
+    }
+    // Requests share one buffer; only the syscall cost is being measured.
+    Bench bench = {CResult_get(res), fd, malloc(BLOCK), 0, 0};
+    CResult_free(&res);
+
+    srand(42);
+    hrtime_t start = hrtime_ns();
+    for (unsigned i = 0; i < depth; i++, bench.issued++)
+        CAsyncIO_read(bench.io, fd, bench.buffer, BLOCK, random_offset(),
+                      on_read, &bench);
+    while (CAsyncIO_pending(bench.io))
+        CAsyncIO_poll(bench.io, 1);
+    report(name, depth, start, hrtime_ns());
+
+    if (bench.failed)
+        printf("%zu reads failed\n", bench.failed);
+    CAsyncIO_free(&bench.io);
+    free(bench.buffer);
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    char *chunk = malloc(1 << 20);
+    memset(chunk, 'x', 1 << 20);
+    for (int i = 0; i < FILE_SIZE >> 20; i++)
+        if (write(fd, chunk, 1 << 20) != 1 << 20)
+            return 1;
+    free(chunk);
+
+    char buffer[BLOCK];
+    srand(42);
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < READS; i++)
+        if (pread(fd, buffer, BLOCK, (off_t)random_offset()) != BLOCK)
+            return 1;
+    report("pread", 1, start, hrtime_ns());
+
+    unsigned depths[] = {1, 4, 16, 64};
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        run(fd, CASYNCIO_URING, "io_uring", depths[i]);
+        run(fd, CASYNCIO_THREADS, "threads", depths[i]);
+    }
+
+    close(fd);
+    unlink(path);
+    return 0;
+}
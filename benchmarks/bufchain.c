@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CBufChain.h>
+#include <cstd/CHRTime.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RESPONSES 20000
+#define BODY (256 * 1024)
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-28s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+int main() {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+        return 1;
+    char *body = malloc(BODY);
+    if (body == NULL)
+        return 1;
+    memset(body, 'x', BODY);
+    const char *header = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n"
+                         "Content-Length: 262144\r\n\r\n";
+    const char *trailer = "\r\n";
+    size_t header_len = strlen(header), trailer_len = strlen(trailer);
+
+    // Copying everything into one buffer first.
+    size_t written = 0;
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < RESPONSES; i++) {
+        size_t len = header_len + BODY + trailer_len;
+        char *response = malloc(len);
+        memcpy(response, header, header_len);
+        memcpy(response + header_len, body, BODY);
+        memcpy(response + header_len + BODY, trailer, trailer_len);
+        written += (size_t)write(fd, response, len);
+        free(response);
+    }
+    report("flatten + write", start, hrtime_ns());
+
+    CResult_t *res = CBufSegment_wrap(CStringView_from(body, BODY), NULL, NULL);
+    CBufSegment_t *cached = CResult_get(res);
+    CResult_free(&res);
+    res = CBufChain_new();
+    CBufChain_t *chain = CResult_get(res);
+    CResult_free(&res);
+    start = hrtime_ns();
+    for (int i = 0; i < RESPONSES; i++) {
+        CBufChain_append_copy(chain, CStringView_from(header, header_len));
+        CBufChain_append(chain, cached, 0, BODY);
+        CBufChain_append_copy(chain, CStringView_from(trailer, trailer_len));
+        written += (size_t)CBufChain_writev(chain, fd);
+    }
+    report("CBufChain + writev", start, hrtime_ns());
+
+    CBufChain_free(&chain);
+    CBufSegment_free(&cached);
+    free(body);
+    close(fd);
+    return written == 2 * (size_t)RESPONSES * (header_len + BODY + trailer_len)
+               ? 0
+               : 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CConstMap.h>
+#include <cstd/CHRTime.h>
+#include <cstd/CHashMap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ENTRIES 1000000
+#define LOOKUPS 1000000
+
+static int string_compare(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-28s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+static int format_key(char *buffer, int i) {
+    return snprintf(buffer, 32, "198.%d.%d.%d", (i >> 16) & 255,
+                    (i >> 8) & 255, i & 255);
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    char key[32];
+    hrtime_t start = hrtime_ns();
+    CResult_t *res = CConstMapBuilder_new(path);
+    CConstMapBuilder_t *builder = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < ENTRIES; i++) {
+        int len = format_key(key, i);
+        CConstMapBuilder_add(builder, CStringView_from(key, (size_t)len),
+                             CStringView_from_c("blocked"));
+    }
+    if (CConstMapBuilder_finish(&builder))
+        return 1;
+    report("CConstMapBuilder", start, hrtime_ns());
+
+    // What every process pays today.
+    start = hrtime_ns();
+    res = CHashMap_new(ENTRIES * 2, string_compare, chash_string, free, NULL);
+    CHashMap_t *heap = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < ENTRIES; i++) {
+        char *copy = malloc(32);
+        format_key(copy, i);
+        CHashMap_insert(heap, copy, "blocked");
+    }
+    report("CHashMap startup", start, hrtime_ns());
+
+    start = hrtime_ns();
+    res = CConstMap_open(path);
+    if (CResult_is_error(res))
+        return 1;
+    CConstMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    report("CConstMap startup", start, hrtime_ns());
+
+    size_t found = 0;
+    start = hrtime_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        format_key(key, (i * 7919) % (ENTRIES * 2));
+        res = CHashMap_get(heap, key);
+        found += !CResult_is_error(res);
+        CResult_free(&res);
+    }
+    report("CHashMap lookups", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        int len = format_key(key, (i * 7919) % (ENTRIES * 2));
+        found += CConstMap_get(map, CStringView_from(key, (size_t)len),
+                               NULL) == CCONSTMAP_SUCCESS;
+    }
+    report("CConstMap lookups", start, hrtime_ns());
+
+    CHashMap_free(&heap);
+    CConstMap_free(&map);
+    unlink(path);
+    return found ? 0 : 1;
+}
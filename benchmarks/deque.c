@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+#include <cstd/CDeque.h>
+#include <cstd/CHRTime.h>
+#include <cstd/CLinkedList.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ELEMENTS 1000000
+#define WINDOW 1000
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-28s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+int main() {
+    CResult_t *res = CLinkedList_new(CLINKEDLIST_TYPE_DOUBLE, NULL);
+    CLinkedList_t *list = CResult_get(res);
+    CResult_free(&res);
+    res = CDeque_new(NULL);
+    CDeque_t *deque = CResult_get(res);
+    CResult_free(&res);
+    uintptr_t sum = 0;
+
+    // A BFS frontier: the queue fills up, then drains.
+    hrtime_t start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i++)
+        CLinkedList_add(list, (void *)i);
+    while (CLinkedList_size(list) > 0) {
+        res = CLinkedList_get(list, 0);
+        sum += (uintptr_t)CResult_get(res);
+        CResult_free(&res);
+        CLinkedList_remove(list, 0);
+    }
+    report("CLinkedList fill + drain", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i++)
+        CDeque_push_back(deque, (void *)i);
+    while (CDeque_size(deque) > 0)
+        sum -= (uintptr_t)CDeque_fpop_front(deque);
+    report("CDeque fill + drain", start, hrtime_ns());
+
+    // A sliding window over a stream.
+    start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i++) {
+        CLinkedList_add(list, (void *)i);
+        if (CLinkedList_size(list) > WINDOW)
+            CLinkedList_remove(list, 0);
+    }
+    report("CLinkedList window", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i++) {
+        CDeque_push_back(deque, (void *)i);
+        if (CDeque_size(deque) > WINDOW)
+            CDeque_fpop_front(deque);
+    }
+    report("CDeque window", start, hrtime_ns());
+
+    // Scanning the window, as a moving statistic does.
+    start = hrtime_ns();
+    for (int round = 0; round < 1000; round++) {
+        CListCursor_t it = CLinkedList_cursor(list);
+        while (CListCursor_next(&it))
+            sum += (uintptr_t)CListCursor_value(&it);
+    }
+    report("CLinkedList window scan", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int round = 0; round < 1000; round++) {
+        for (size_t i = 0; i < CDeque_size(deque); i++)
+            sum -= (uintptr_t)CDeque_fget(deque, i);
+    }
+    report("CDeque window scan", start, hrtime_ns());
+
+    CLinkedList_free(&list);
+    CDeque_free(&deque);
+    return sum != 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CDiskQueue.h>
+#include <cstd/CHRTime.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TOTAL (256 * 1024 * 1024)
+#define RECORD 1024
+
+static char buffer[RECORD];
+
+static void report(const char *name, size_t records, hrtime_t start,
+                   hrtime_t end) {
+    double seconds = (double)(end - start) / 1e9;
+    printf("%-28s %10.0f records/s %8.1f MB/s\n", name, records / seconds,
+           (double)records * RECORD / seconds / 1e6);
+}
+
+static void clear_dir(const char *dir) {
+    DIR *d = opendir(dir);
+    if (d == NULL)
+        return;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL)
+        if (entry->d_name[0] != '.')
+            unlinkat(dirfd(d), entry->d_name, 0);
+    closedir(d);
+}
+
+static int run(const char *dir, const char *name, size_t records,
+               size_t sync_every) {
+    clear_dir(dir);
+    CResult_t *res = CDiskQueue_new(dir, 0, sync_every);
+    if (CResult_is_error(res))
+        return 1;
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < records; i++)
+        if (CDiskQueue_push(queue, CStringView_from(buffer, RECORD)))
+            return 1;
+    if (CDiskQueue_sync(queue))
+        return 1;
+    report(name, records, start, hrtime_ns());
+    return CDiskQueue_free(&queue);
+}
+
+int main() {
+    char dir[] = "/var/tmp/cstd_bench_XXXXXX";
+    if (mkdtemp(dir) == NULL)
+        return 1;
+    memset(buffer, 'q', sizeof(buffer));
+    size_t records = TOTAL / RECORD;
+
+    // What the disk can do: one large sequential write and a single flush.
+    char path[64];
+    snprintf(path, sizeof(path), "%s/raw", dir);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return 1;
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < records; i++)
+        if (write(fd, buffer, RECORD) != RECORD)
+            return 1;
+    fdatasync(fd);
+    report("write + fdatasync", records, start, hrtime_ns());
+    close(fd);
+    unlink(path);
+
+    if (run(dir, "sync every record", records / 64, 1) ||
+        run(dir, "sync every 64 records", records, 64) ||
+        run(dir, "sync every 1024 records", records, 1024) ||
+        run(dir, "sync once", records, 0))
+        return 1;
+
+    CResult_t *res = CDiskQueue_new(dir, 0, 0);
+    if (CResult_is_error(res))
+        return 1;
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+    CStringView_t record;
+    size_t popped = 0;
+    start = hrtime_ns();
+    while (CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS)
+        popped++;
+    CDiskQueue_sync(queue);
+    report("pop_view", popped, start, hrtime_ns());
+    CDiskQueue_free(&queue);
+
+    clear_dir(dir);
+    rmdir(dir);
+    return popped == records ? 0 : 1;
+}
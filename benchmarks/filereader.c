@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CFileReader.h>
+#include <cstd/CHRTime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LINES 2000000
+
+static void report(const char *name, hrtime_t start, hrtime_t end,
+                   size_t bytes) {
+    double seconds = (double)(end - start) / 1e9;
+    printf("%-32s %8.2f ms %8.2f GB/s\n", name, seconds * 1e3,
+           (double)bytes / seconds / 1e9);
+}
+
+static void run(const char *path, int mode, const char *name, size_t bytes) {
+    hrtime_t start = hrtime_ns();
+    CResult_t *res = CFileReader_open(path, mode);
+    if (CResult_is_error(res))
+        return;
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+
+    size_t lines = 0, total = 0;
+    CStringView_t line;
+    while (CFileReader_next_line(reader, &line)) {
+        lines++;
+        total += line.len;
+    }
+    CFileReader_free(&reader);
+    report(name, start, hrtime_ns(), bytes);
+    if (lines != LINES)
+        printf("Unexpected line count %zu (%zu bytes)\n", lines, total);
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    FILE *out = fdopen(fd, "w");
+    srand(42);
+    for (int i = 0; i < LINES; i++)
+        fprintf(out, "2024-01-01T00:00:%02d level=info id=%d msg=%*s\n",
+                i % 60, rand(), rand() % 80, "x");
+    fclose(out);
+
+    FILE *in = fopen(path, "r");
+    fseek(in, 0, SEEK_END);
+    size_t bytes = (size_t)ftell(in);
+    rewind(in);
+
+    char buffer[4096];
+    size_t lines = 0;
+    hrtime_t start = hrtime_ns();
+    while (fgets(buffer, sizeof(buffer), in))
+        lines += strlen(buffer) > 0;
+    report("fgets", start, hrtime_ns(), bytes);
+    fclose(in);
+
+    run(path, CFILEREADER_MMAP, "CFileReader_next_line (mmap)", bytes);
+    run(path, CFILEREADER_READ, "CFileReader_next_line (read)", bytes);
+
+    unlink(path);
+    return lines == LINES ? 0 : 1;
+}
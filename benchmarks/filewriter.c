@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CFileWriter.h>
+#include <cstd/CHRTime.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RECORDS 2000000
+
+static void report(const char *name, hrtime_t start, hrtime_t end,
+                   size_t bytes) {
+    double seconds = (double)(end - start) / 1e9;
+    printf("%-36s %8.2f ms %8.2f GB/s\n", name, seconds * 1e3,
+           (double)bytes / seconds / 1e9);
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    // Records of 16 to 80 bytes, as produced by exporting small elements.
+    char record[80];
+    memset(record, 'r', sizeof(record));
+    size_t *lengths = malloc(RECORDS * sizeof(size_t));
+    if (lengths == NULL)
+        return 1;
+    size_t bytes = 0;
+    srand(42);
+    for (size_t i = 0; i < RECORDS; i++)
+        bytes += lengths[i] = 16 + (size_t)rand() % 64;
+
+    fd = open(path, O_WRONLY | O_TRUNC);
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < RECORDS / 10; i++)
+        if (write(fd, record, lengths[i]) < 0)
+            return 1;
+    report("write() per record (1/10 of data)", start, hrtime_ns(),
+           bytes / 10);
+    close(fd);
+
+    FILE *file = fopen(path, "w");
+    start = hrtime_ns();
+    for (size_t i = 0; i < RECORDS; i++)
+        fwrite(record, 1, lengths[i], file);
+    fclose(file);
+    report("fwrite", start, hrtime_ns(), bytes);
+
+    const int modes[] = {0, CFILEWRITER_DIRECT};
+    const char *names[] = {"CFileWriter_append", "CFileWriter_append (direct)"};
+    for (int m = 0; m < 2; m++) {
+        start = hrtime_ns();
+        CResult_t *res = CFileWriter_open(path, modes[m]);
+        if (CResult_is_error(res)) {
+            CResult_free(&res);
+            continue;
+        }
+        CFileWriter_t *writer = CResult_get(res);
+        CResult_free(&res);
+        for (size_t i = 0; i < RECORDS; i++)
+            CFileWriter_append(writer, record, lengths[i]);
+        CFileWriter_free(&writer);
+        report(names[m], start, hrtime_ns(), bytes);
+    }
+
+    unlink(path);
+    free(lengths);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CIntrusiveList.h>
+#include <cstd/CLinkedList.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ELEMENTS 1000000
+#define ROUNDS 10
+
+typedef struct {
+    uint64_t value;
+    CListLink_t link;
+    char payload[48];
+} Object;
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-32s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+static uint64_t walk(const char *name, CLinkedList_t *list,
+                     CIntrusiveList_t *intrusive) {
+    uint64_t sum = 0;
+    char label[64];
+    hrtime_t start = hrtime_ns();
+    for (int round = 0; round < ROUNDS; round++) {
+        CListCursor_t it = CLinkedList_cursor(list);
+        while (CListCursor_next(&it))
+            sum += ((Object *)CListCursor_value(&it))->value;
+    }
+    snprintf(label, sizeof(label), "CLinkedList walk, %s", name);
+    report(label, start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int round = 0; round < ROUNDS; round++) {
+        CINTRUSIVELIST_FOREACH(intrusive, link)
+            sum -= CLISTLINK_ENTRY(link, Object, link)->value;
+    }
+    snprintf(label, sizeof(label), "CIntrusiveList walk, %s", name);
+    report(label, start, hrtime_ns());
+    return sum;
+}
+
+int main() {
+    Object *pool = calloc(ELEMENTS, sizeof(Object));
+    size_t *order = malloc(ELEMENTS * sizeof(size_t));
+    CListNode_t **nodes = malloc(ELEMENTS * sizeof(CListNode_t *));
+    for (size_t i = 0; i < ELEMENTS; i++) {
+        pool[i].value = i;
+        order[i] = i;
+    }
+    srand(1);
+    for (size_t i = ELEMENTS - 1; i > 0; i--) {
+        size_t j = (size_t)rand() % (i + 1);
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    CResult_t *res = CLinkedList_new(CLINKEDLIST_TYPE_DOUBLE, NULL);
+    CLinkedList_t *list = CResult_get(res);
+    CResult_free(&res);
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < ELEMENTS; i++)
+        CLinkedList_add_node(list, &pool[i], &nodes[i]);
+    report("CLinkedList add", start, hrtime_ns());
+
+    CIntrusiveList_t intrusive;
+    CIntrusiveList_init(&intrusive);
+    start = hrtime_ns();
+    for (size_t i = 0; i < ELEMENTS; i++)
+        CIntrusiveList_push_back(&intrusive, &pool[i].link);
+    report("CIntrusiveList push_back", start, hrtime_ns());
+
+    uint64_t sum = walk("in order", list, &intrusive);
+
+    // Moving every object to the back in random order, as an LRU does,
+    // leaves the list in no particular order in memory.
+    start = hrtime_ns();
+    for (size_t i = 0; i < ELEMENTS; i++) {
+        size_t j = order[i];
+        CLinkedList_remove_node(list, nodes[j]);
+        CLinkedList_add_node(list, &pool[j], &nodes[j]);
+    }
+    report("CLinkedList move", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ELEMENTS; i++) {
+        CIntrusiveList_remove(&intrusive, &pool[order[i]].link);
+        CIntrusiveList_push_back(&intrusive, &pool[order[i]].link);
+    }
+    report("CIntrusiveList move", start, hrtime_ns());
+
+    sum += walk("shuffled", list, &intrusive);
+
+    CLinkedList_free(&list);
+    CIntrusiveList_clear(&intrusive);
+    free(nodes);
+    free(order);
+    free(pool);
+    return sum != 0;
+}
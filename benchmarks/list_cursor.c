@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CLinkedList.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ELEMENTS 20000
+
+static int32_t compare_ptr(const void *a, const void *b) {
+    return (a > b) - (a < b);
+}
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-28s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+int main() {
+    CResult_t *res = CLinkedList_new(CLINKEDLIST_TYPE_DOUBLE, NULL);
+    CLinkedList_t *list = CResult_get(res);
+    CResult_free(&res);
+    CListNode_t *nodes[ELEMENTS];
+    for (uintptr_t i = 0; i < ELEMENTS; i++)
+        CLinkedList_add_node(list, (void *)i, &nodes[i]);
+
+    uintptr_t sum = 0;
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < CLinkedList_size(list); i++) {
+        res = CLinkedList_get(list, i);
+        sum += (uintptr_t)CResult_get(res);
+        CResult_free(&res);
+    }
+    report("get(i) loop", start, hrtime_ns());
+
+    start = hrtime_ns();
+    CListCursor_t it = CLinkedList_cursor(list);
+    while (CListCursor_next(&it))
+        sum -= (uintptr_t)CListCursor_value(&it);
+    report("cursor loop", start, hrtime_ns());
+
+    // Moving elements to the back, as an LRU touch does.
+    start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i += 20) {
+        size_t index = CLinkedList_find(list, (void *)i, compare_ptr);
+        CLinkedList_remove(list, index);
+        CLinkedList_add_node(list, (void *)i, &nodes[i]);
+    }
+    report("find + remove + add", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (uintptr_t i = 0; i < ELEMENTS; i += 20) {
+        CLinkedList_remove_node(list, nodes[i]);
+        CLinkedList_add_node(list, (void *)i, &nodes[i]);
+    }
+    report("remove_node + add_node", start, hrtime_ns());
+
+    CLinkedList_free(&list);
+    return sum != 0;
+}
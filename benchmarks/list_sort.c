@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CLinkedList.h>
+#include <cstd/CVector.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ELEMENTS 1000000
+
+static int32_t compare_ptr(const void *a, const void *b) {
+    return (a > b) - (a < b);
+}
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-30s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+static CLinkedList_t *random_list(int type, size_t n) {
+    CResult_t *res = CLinkedList_new(type, NULL);
+    CLinkedList_t *list = CResult_get(res);
+    CResult_free(&res);
+    for (size_t i = 0; i < n; i++)
+        CLinkedList_add(list, (void *)(uintptr_t)rand());
+    return list;
+}
+
+int main() {
+    srand(1);
+    CLinkedList_t *list = random_list(CLINKEDLIST_TYPE_DOUBLE, ELEMENTS);
+
+    // What sorting took before: a round trip through a vector.
+    hrtime_t start = hrtime_ns();
+    CResult_t *res = CVector_new(ELEMENTS, NULL);
+    CVector_t *vector = CResult_get(res);
+    CResult_free(&res);
+    CListCursor_t it = CLinkedList_cursor(list);
+    while (CListCursor_next(&it))
+        CVector_add(vector, CListCursor_value(&it));
+    CVector_sort(vector, compare_ptr);
+    CLinkedList_clear(list);
+    for (size_t i = 0; i < ELEMENTS; i++)
+        CLinkedList_add(list, CVector_fget(vector, i));
+    report("copy + CVector_sort + copy", start, hrtime_ns());
+    CVector_free(&vector);
+    CLinkedList_free(&list);
+
+    list = random_list(CLINKEDLIST_TYPE_DOUBLE, ELEMENTS);
+    start = hrtime_ns();
+    CLinkedList_sort(list, compare_ptr);
+    report("CLinkedList_sort, double", start, hrtime_ns());
+    CLinkedList_free(&list);
+
+    // Lists small enough to stay in cache.
+    hrtime_t total = 0;
+    for (int round = 0; round < 1000; round++) {
+        list = random_list(CLINKEDLIST_TYPE_DOUBLE, 1000);
+        start = hrtime_ns();
+        CLinkedList_sort(list, compare_ptr);
+        total += hrtime_ns() - start;
+        CLinkedList_free(&list);
+    }
+    report("1000 x CLinkedList_sort(1000)", 0, total);
+    total = 0;
+    for (int round = 0; round < 1000; round++) {
+        list = random_list(CLINKEDLIST_TYPE_DOUBLE, 1000);
+        start = hrtime_ns();
+        res = CVector_new(1000, NULL);
+        vector = CResult_get(res);
+        CResult_free(&res);
+        it = CLinkedList_cursor(list);
+        while (CListCursor_next(&it))
+            CVector_add(vector, CListCursor_value(&it));
+        CVector_sort(vector, compare_ptr);
+        CLinkedList_clear(list);
+        for (size_t i = 0; i < 1000; i++)
+            CLinkedList_add(list, CVector_fget(vector, i));
+        total += hrtime_ns() - start;
+        CVector_free(&vector);
+        CLinkedList_free(&list);
+    }
+    report("1000 x vector round trip", 0, total);
+
+    list = random_list(CLINKEDLIST_TYPE_SINGLE, ELEMENTS);
+    start = hrtime_ns();
+    CLinkedList_sort(list, compare_ptr);
+    report("CLinkedList_sort, single", start, hrtime_ns());
+
+    start = hrtime_ns();
+    CLinkedList_reverse(list);
+    report("CLinkedList_reverse", start, hrtime_ns());
+    CLinkedList_free(&list);
+
+    // Joining per-thread results.
+    CLinkedList_t *parts[8];
+    for (int i = 0; i < 8; i++)
+        parts[i] = random_list(CLINKEDLIST_TYPE_DOUBLE, ELEMENTS / 8);
+    CLinkedList_t *joined = random_list(CLINKEDLIST_TYPE_DOUBLE, 0);
+    start = hrtime_ns();
+    for (int i = 0; i < 8; i++) {
+        it = CLinkedList_cursor(parts[i]);
+        while (CListCursor_next(&it))
+            CLinkedList_add(joined, CListCursor_value(&it));
+        CLinkedList_clear(parts[i]);
+    }
+    report("re-adding 8 lists", start, hrtime_ns());
+    CLinkedList_free(&joined);
+
+    for (int i = 0; i < 8; i++) {
+        CLinkedList_free(&parts[i]);
+        parts[i] = random_list(CLINKEDLIST_TYPE_DOUBLE, ELEMENTS / 8);
+    }
+    joined = random_list(CLINKEDLIST_TYPE_DOUBLE, 0);
+    start = hrtime_ns();
+    for (int i = 0; i < 8; i++)
+        CLinkedList_concat(joined, parts[i]);
+    report("CLinkedList_concat 8 lists", start, hrtime_ns());
+    size_t size = CLinkedList_size(joined);
+    CLinkedList_free(&joined);
+    for (int i = 0; i < 8; i++)
+        CLinkedList_free(&parts[i]);
+    return size != ELEMENTS;
+}
@@ -0,0 +1,162 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CString.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ITERATIONS 2000000
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-40s %8.2f ns/op\n", name, (double)(end - start) / ITERATIONS);
+}
+
+int main() {
+    CResult_t *res = CString_new();
+    if (CResult_is_error(res))
+        return 1;
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+
+    uint64_t *integers = malloc(ITERATIONS * sizeof(uint64_t));
+    double *doubles = malloc(ITERATIONS * sizeof(double));
+    double *prices = malloc(ITERATIONS * sizeof(double));
+    if (integers == NULL || doubles == NULL || prices == NULL)
+        return 1;
+    srand(42);
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        integers[i] = ((uint64_t)rand() << 31 | (uint64_t)rand()) >>
+                      (rand() % 48);
+        doubles[i] = (double)rand() / (rand() + 1) * (rand() % 1000);
+        prices[i] = (rand() % 10000000) / 100.0;
+    }
+
+    char buffer[64];
+    hrtime_t start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        int len = snprintf(buffer, sizeof(buffer), "%" PRIu64, integers[i]);
+        CString_append_n(str, buffer, (size_t)len);
+    }
+    report("snprintf + CString_append_n (u64)", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        CString_append_u64(str, integers[i]);
+    }
+    report("CString_append_u64", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        int len = snprintf(buffer, sizeof(buffer), "%.17g", doubles[i]);
+        CString_append_n(str, buffer, (size_t)len);
+    }
+    report("snprintf %.17g + CString_append_n", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        CString_append_double(str, doubles[i]);
+    }
+    report("CString_append_double (shortest)", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        int len = snprintf(buffer, sizeof(buffer), "%.17g", prices[i]);
+        CString_append_n(str, buffer, (size_t)len);
+    }
+    report("snprintf %.17g (2 decimals)", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if ((i & 1023) == 0)
+            CString_set(str, "");
+        CString_append_double(str, prices[i]);
+    }
+    report("CString_append_double (2 decimals)", start, hrtime_ns());
+
+    // Parse the integers back, each from its own slot in a flat buffer.
+    char *text = malloc(ITERATIONS * 24);
+    if (text == NULL)
+        return 1;
+    for (size_t i = 0; i < ITERATIONS; i++)
+        snprintf(text + i * 24, 24, "%" PRIu64, integers[i] >> 1);
+
+    uint64_t sum = 0;
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++)
+        sum += (uint64_t)strtoll(text + i * 24, NULL, 10);
+    report("strtoll", start, hrtime_ns());
+
+    uint64_t check = 0;
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        const char *p = text + i * 24;
+        int64_t value = 0;
+        CStringView_parse_i64(CStringView_from(p, strlen(p)), &value);
+        check += (uint64_t)value;
+    }
+    report("CStringView_parse_i64 (incl. strlen)", start, hrtime_ns());
+    if (check != sum)
+        printf("Mismatch between strtoll and CStringView_parse_i64!\n");
+
+    for (size_t i = 0; i < ITERATIONS; i++)
+        snprintf(text + i * 24, 24, "%.6f", doubles[i]);
+
+    double dsum = 0, dcheck = 0;
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++)
+        dsum += strtod(text + i * 24, NULL);
+    report("strtod", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        const char *p = text + i * 24;
+        double value = 0;
+        CStringView_parse_double(CStringView_from(p, strlen(p)), &value);
+        dcheck += value;
+    }
+    report("CStringView_parse_double (incl. strlen)", start, hrtime_ns());
+    if (dcheck != dsum)
+        printf("Mismatch between strtod and CStringView_parse_double!\n");
+
+    free(text);
+    free(prices);
+    free(doubles);
+    free(integers);
+    CString_free(&str);
+    return 0;
+}
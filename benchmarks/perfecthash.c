@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CHashMap.h>
+#include <cstd/CPerfectHash.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEYS 1000000
+#define LOOKUPS 4000000
+
+static int string_compare(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-28s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+int main() {
+    CResult_t *res = CVector_new(KEYS, free);
+    CVector_t *keys = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < KEYS; i++) {
+        char *key = malloc(32);
+        snprintf(key, 32, "GET /api/v2/item/%d", i);
+        CVector_add(keys, key);
+    }
+
+    hrtime_t start = hrtime_ns();
+    res = CPerfectHash_build(keys, chash_string);
+    if (CResult_is_error(res))
+        return 1;
+    CPerfectHash_t *ph = CResult_get(res);
+    CResult_free(&res);
+    report("CPerfectHash_build", start, hrtime_ns());
+    printf("%-28s %10.2f bits/key\n", "size",
+           CPerfectHash_serialize(ph, NULL, 0) * 8.0 / KEYS);
+
+    int *values = malloc(KEYS * sizeof(int));
+    const char **slots = malloc(KEYS * sizeof(char *));
+    res = CHashMap_new(KEYS, string_compare, chash_string, NULL, NULL);
+    CHashMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < KEYS; i++) {
+        char *key = CVector_fget(keys, i);
+        size_t index = CPerfectHash_index(ph, key);
+        slots[index] = key;
+        values[index] = i;
+        CHashMap_insert(map, key, &values[index]);
+    }
+
+    size_t hits = 0;
+    start = hrtime_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        const char *key = CVector_fget(keys, (i * 7919) % KEYS);
+        size_t index = CPerfectHash_index(ph, key);
+        hits += strcmp(slots[index], key) == 0;
+    }
+    report("CPerfectHash lookups", start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        res = CHashMap_get(map, CVector_fget(keys, (i * 7919) % KEYS));
+        hits += !CResult_is_error(res);
+        CResult_free(&res);
+    }
+    report("CHashMap lookups", start, hrtime_ns());
+
+    CHashMap_free(&map);
+    CPerfectHash_free(&ph);
+    CVector_free(&keys);
+    free(values);
+    free(slots);
+    return hits == 2 * LOOKUPS ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CShmRing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MESSAGES 5000000
+#define ROUND_TRIPS 200000
+#define MESSAGE 64
+
+static void report(const char *name, size_t messages, hrtime_t start,
+                   hrtime_t end) {
+    printf("%-28s %12.0f messages/s\n", name,
+           messages / ((double)(end - start) / 1e9));
+}
+
+static void report_latency(const char *name, size_t trips, hrtime_t start,
+                           hrtime_t end) {
+    printf("%-28s %12.0f ns one way\n", name,
+           (double)(end - start) / (double)trips / 2);
+}
+
+static int read_full(int fd, char *buffer, size_t len) {
+    while (len) {
+        ssize_t n = read(fd, buffer, len);
+        if (n <= 0)
+            return 1;
+        buffer += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int wait_child(pid_t pid) {
+    int status;
+    return waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+           WEXITSTATUS(status);
+}
+
+/// Stream messages from a child to the parent.
+static int stream_ring() {
+    CResult_t *res = CShmRing_new(NULL, 1 << 20);
+    CShmRing_t *ring = CResult_get(res);
+    CResult_free(&res);
+    char message[MESSAGE];
+    memset(message, 'm', sizeof(message));
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < MESSAGES; i++) {
+            void *data;
+            CShmRing_reserve(ring, MESSAGE, &data, CSHMRING_FOREVER);
+            memcpy(data, message, MESSAGE);
+            CShmRing_commit(ring, MESSAGE);
+        }
+        _exit(0);
+    }
+    hrtime_t start = hrtime_ns();
+    size_t bytes = 0;
+    CStringView_t record;
+    for (int i = 0; i < MESSAGES; i++) {
+        CShmRing_peek(ring, &record, CSHMRING_FOREVER);
+        bytes += record.len;
+        CShmRing_release(ring);
+    }
+    report("CShmRing stream", MESSAGES, start, hrtime_ns());
+    CShmRing_free(&ring);
+    return wait_child(pid) || bytes != (size_t)MESSAGES * MESSAGE;
+}
+
+static int stream_pipe() {
+    int fds[2];
+    if (pipe(fds))
+        return 1;
+    char message[MESSAGE];
+    memset(message, 'm', sizeof(message));
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        for (int i = 0; i < MESSAGES; i++)
+            if (write(fds[1], message, MESSAGE) != MESSAGE)
+                _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < MESSAGES; i++)
+        if (read_full(fds[0], message, MESSAGE))
+            return 1;
+    report("pipe stream", MESSAGES, start, hrtime_ns());
+    close(fds[0]);
+    return wait_child(pid);
+}
+
+/// Bounce a message between the parent and a child.
+static int ping_ring() {
+    CResult_t *res = CShmRing_new(NULL, 4096);
+    CShmRing_t *ping = CResult_get(res);
+    CResult_free(&res);
+    res = CShmRing_new(NULL, 4096);
+    CShmRing_t *pong = CResult_get(res);
+    CResult_free(&res);
+    char message[MESSAGE] = {0};
+    CStringView_t record;
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < ROUND_TRIPS; i++) {
+            CShmRing_peek(ping, &record, CSHMRING_FOREVER);
+            CShmRing_push(pong, record, CSHMRING_FOREVER);
+            CShmRing_release(ping);
+        }
+        _exit(0);
+    }
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < ROUND_TRIPS; i++) {
+        CShmRing_push(ping, CStringView_from(message, MESSAGE),
+                      CSHMRING_FOREVER);
+        CShmRing_peek(pong, &record, CSHMRING_FOREVER);
+        CShmRing_release(pong);
+    }
+    report_latency("CShmRing ping-pong", ROUND_TRIPS, start, hrtime_ns());
+    CShmRing_free(&ping);
+    CShmRing_free(&pong);
+    return wait_child(pid);
+}
+
+static int ping_pipe() {
+    int ping[2], pong[2];
+    if (pipe(ping) || pipe(pong))
+        return 1;
+    char message[MESSAGE] = {0};
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < ROUND_TRIPS; i++)
+            if (read_full(ping[0], message, MESSAGE) ||
+                write(pong[1], message, MESSAGE) != MESSAGE)
+                _exit(1);
+        _exit(0);
+    }
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < ROUND_TRIPS; i++)
+        if (write(ping[1], message, MESSAGE) != MESSAGE ||
+            read_full(pong[0], message, MESSAGE))
+            return 1;
+    report_latency("pipe ping-pong", ROUND_TRIPS, start, hrtime_ns());
+    close(ping[0]);
+    close(ping[1]);
+    close(pong[0]);
+    close(pong[1]);
+    return wait_child(pid);
+}
+
+int main() {
+    // Children must not flush what the parent has buffered.
+    setvbuf(stdout, NULL, _IONBF, 0);
+    return stream_ring() || stream_pipe() || ping_ring() || ping_pipe();
+}
@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CHashMap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ENTRIES 2000000
+
+static int string_compare(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    printf("%-24s %10.2f ms\n", name, (double)(end - start) / 1e6);
+}
+
+static CHashMap_t *build() {
+    CResult_t *res =
+        CHashMap_new(ENTRIES, string_compare, chash_string, free, free);
+    CHashMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < ENTRIES; i++) {
+        char *key = malloc(32);
+        int *value = malloc(sizeof(int));
+        snprintf(key, 32, "user:%d:profile", i);
+        *value = i;
+        CHashMap_insert(map, key, value);
+    }
+    return map;
+}
+
+static size_t probe(CHashMap_t *map) {
+    size_t found = 0;
+    char key[32];
+    for (int i = 0; i < ENTRIES; i += 16) {
+        snprintf(key, sizeof(key), "user:%d:profile", i);
+        CResult_t *res = CHashMap_get(map, key);
+        found += !CResult_is_error(res) && *(int *)CResult_get(res) == i;
+        CResult_free(&res);
+    }
+    return found;
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    hrtime_t start = hrtime_ns();
+    CHashMap_t *map = build();
+    report("rebuild by insertion", start, hrtime_ns());
+
+    start = hrtime_ns();
+    if (CHashMap_save(map, path, cserialize_string, cserialize_integer))
+        return 1;
+    report("CHashMap_save", start, hrtime_ns());
+    CHashMap_free(&map);
+
+    start = hrtime_ns();
+    CResult_t *res =
+        CHashMap_load(path, string_compare, chash_string, free, free);
+    if (CResult_is_error(res))
+        return 1;
+    map = CResult_get(res);
+    CResult_free(&res);
+    report("CHashMap_load", start, hrtime_ns());
+
+    start = hrtime_ns();
+    size_t found = probe(map);
+    report("lookups after load", start, hrtime_ns());
+    CHashMap_free(&map);
+
+    unlink(path);
+    return found == ENTRIES / 16 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CString.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BYTES (64 << 20)
+#define ROUNDS 8
+
+static void report(const char *name, hrtime_t start, hrtime_t end) {
+    double seconds = (double)(end - start) / 1e9;
+    printf("%-32s %8.2f GB/s\n", name,
+           (double)BYTES * ROUNDS / seconds / 1e9);
+}
+
+// Fill the buffer with text that is mostly ASCII with some multi-byte runs.
+static void fill(char *buffer, int ascii_only) {
+    const char *pieces[] = {"The quick brown fox ", "caf\xC3\xA9 ",
+                            "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\n"};
+    size_t len = 0;
+    while (len < BYTES - 4) {
+        const char *piece = pieces[ascii_only ? 0 : rand() % 5];
+        size_t n = strlen(piece);
+        if (len + n > BYTES)
+            break;
+        memcpy(buffer + len, piece, n);
+        len += n;
+    }
+    memset(buffer + len, ' ', BYTES - len);
+}
+
+static void run(const char *label, CStringView_t view, uint32_t *utf32,
+                uint16_t *utf16) {
+    char name[64];
+    size_t sink = 0;
+
+    hrtime_t start = hrtime_ns();
+    for (int i = 0; i < ROUNDS; i++)
+        sink += (size_t)CStringView_validate_utf8(view);
+    snprintf(name, sizeof(name), "validate (%s)", label);
+    report(name, start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int i = 0; i < ROUNDS; i++)
+        sink += CStringView_utf8_length(view);
+    snprintf(name, sizeof(name), "utf8_length (%s)", label);
+    report(name, start, hrtime_ns());
+
+    size_t n;
+    start = hrtime_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        CStringView_to_utf16(view, utf16, &n);
+        sink += n;
+    }
+    snprintf(name, sizeof(name), "to_utf16 (%s)", label);
+    report(name, start, hrtime_ns());
+
+    start = hrtime_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        CStringView_to_utf32(view, utf32, &n);
+        sink += n;
+    }
+    snprintf(name, sizeof(name), "to_utf32 (%s)", label);
+    report(name, start, hrtime_ns());
+
+    if (sink == 0)
+        printf("Unexpected result.\n");
+}
+
+int main() {
+    char *buffer = malloc(BYTES);
+    uint32_t *utf32 = malloc(BYTES * sizeof(uint32_t));
+    uint16_t *utf16 = malloc(BYTES * sizeof(uint16_t));
+    if (buffer == NULL || utf32 == NULL || utf16 == NULL)
+        return 1;
+    srand(42);
+
+    CStringView_t view = CStringView_from(buffer, BYTES);
+    fill(buffer, 1);
+    run("ascii", view, utf32, utf16);
+    fill(buffer, 0);
+    run("mixed", view, utf32, utf16);
+
+    free(utf16);
+    free(utf32);
+    free(buffer);
+    return 0;
+}
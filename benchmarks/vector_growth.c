@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CHRTime.h>
+#include <cstd/CVector.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define ELEMENTS 20000000
+
+// Each variant runs in a child so that its peak RSS can be told apart.
+static void run(const char *name, int mapped, const char *path) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        CResult_t *res = mapped ? CVector_new_mapped(1, NULL, path)
+                                : CVector_new(1, NULL);
+        if (CResult_is_error(res))
+            _exit(1);
+        CVector_t *vector = CResult_get(res);
+        CResult_free(&res);
+        hrtime_t start = hrtime_ns();
+        for (uintptr_t i = 0; i < ELEMENTS; i++)
+            CVector_add(vector, (void *)i);
+        printf("%-24s %10.2f ms", name, (hrtime_ns() - start) / 1e6);
+        fflush(stdout);
+        CVector_free(&vector);
+        _exit(0);
+    }
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    printf(" %10.1f MB peak RSS\n", usage.ru_maxrss / 1024.0);
+}
+
+int main() {
+    char path[] = "/tmp/cstd_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    run("CVector_new", 0, NULL);
+    run("CVector_new_mapped", 1, NULL);
+    run("CVector_new_mapped (file)", 1, path);
+
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CAsyncIO.h
+/// \brief Header file for the CAsyncIO implementation.
+///
+/// This file defines an asynchronous file I/O engine that keeps many reads and
+/// writes in flight at once. Requests are queued with `CAsyncIO_read` and
+/// `CAsyncIO_write`, handed to the kernel in batches with `CAsyncIO_submit`,
+/// and their completions are collected by `CAsyncIO_poll`.
+///
+/// A request queued with a callback has it invoked on the polling thread by
+/// `CAsyncIO_poll`. A request queued without one has its completion kept in a
+/// queue instead, which the caller drains with `CAsyncIO_next_completion`
+/// after polling. The slot of such a request stays in use until its
+/// completion has been taken.
+///
+/// Two backends are available. On Linux the engine talks to `io_uring`
+/// through its raw system calls, so that a whole batch costs a single system
+/// call and completions are read from shared memory. Where `io_uring` is
+/// unavailable, a pool of threads performs the requests with `pread` and
+/// `pwrite` and hands the results back through a completion queue.
+///
+/// \note The engine is only available on POSIX platforms. A single engine must
+/// not be used by several threads at once.
+#ifndef CSTD_CASYNCIO_H
+#define CSTD_CASYNCIO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \brief Use `io_uring` when the kernel supports it, threads otherwise.
+#define CASYNCIO_AUTO 0
+
+/// \brief Use `io_uring`, failing if it is unavailable.
+#define CASYNCIO_URING 1
+
+/// \brief Use the thread pool.
+#define CASYNCIO_THREADS 2
+
+/// \brief Number of threads in the pool of the thread backend.
+#define CASYNCIO_POOL_SIZE 4
+
+/// \brief Error code indicating that no completion is waiting to be taken.
+#define CASYNCIO_NO_COMPLETION -3
+
+/// \brief Error code indicating that the engine pointer is null.
+#define CASYNCIO_NULL_ENGINE -2
+
+/// \brief Error code indicating that `depth` requests are already in flight.
+/// \details Poll for completions, and take those without a callback, before
+/// queueing more requests.
+#define CASYNCIO_QUEUE_FULL -1
+
+/// \brief Success code for operations.
+#define CASYNCIO_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CASYNCIO_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure.
+#define CASYNCIO_IO_FAILURE 2
+
+/// \typedef CAsyncIOCallback
+/// \brief Function called when a request completes.
+/// \param user_data The pointer given when the request was queued.
+/// \param result The number of bytes transferred, which may be short at the
+/// end of a file, or a negated `errno` value on failure.
+typedef void (*CAsyncIOCallback)(void *user_data, int64_t result);
+
+/// \struct CAsyncIO
+/// \brief Structure representing an asynchronous I/O engine.
+typedef struct _CAsyncIO CAsyncIO_t;
+
+/// \brief Create a new engine.
+/// \param depth Maximum number of requests in flight at once.
+/// \param backend One of `CASYNCIO_AUTO`, `CASYNCIO_URING` or
+/// `CASYNCIO_THREADS`.
+/// \return A `CResult_t*` containing the new `CAsyncIO_t`, or an error if the
+/// requested backend could not be set up.
+CResult_t *CAsyncIO_new(unsigned depth, int backend);
+
+/// \brief Get the backend the engine ended up using.
+/// \param io Pointer to the engine.
+/// \return `CASYNCIO_URING` or `CASYNCIO_THREADS`, or `CASYNCIO_NULL_ENGINE`.
+int CAsyncIO_backend(const CAsyncIO_t *io);
+
+/// \brief Queue a read of `len` bytes at `offset` of `fd` into `buffer`.
+/// \details The request is not started until `CAsyncIO_submit` is called.
+/// `buffer` must stay valid until the request completes.
+/// \param io Pointer to the engine.
+/// \param fd File descriptor to read from.
+/// \param buffer Buffer receiving the bytes.
+/// \param len Number of bytes to read.
+/// \param offset Position in the file to read from.
+/// \param callback Function called with the result. If NULL, the completion
+/// is kept for `CAsyncIO_next_completion`.
+/// \param user_data Pointer passed to `callback`, or returned with the
+/// completion.
+/// \return `CASYNCIO_SUCCESS`, `CASYNCIO_NULL_ENGINE` or
+/// `CASYNCIO_QUEUE_FULL`.
+int CAsyncIO_read(CAsyncIO_t *io, int fd, void *buffer, size_t len,
+                  uint64_t offset, CAsyncIOCallback callback,
+                  void *user_data);
+
+/// \brief Queue a write of `len` bytes from `buffer` at `offset` of `fd`.
+/// \details The request is not started until `CAsyncIO_submit` is called.
+/// `buffer` must stay valid and unchanged until the request completes.
+/// \param io Pointer to the engine.
+/// \param fd File descriptor to write to.
+/// \param buffer Bytes to write.
+/// \param len Number of bytes to write.
+/// \param offset Position in the file to write at.
+/// \param callback Function called with the result. If NULL, the completion
+/// is kept for `CAsyncIO_next_completion`.
+/// \param user_data Pointer passed to `callback`, or returned with the
+/// completion.
+/// \return `CASYNCIO_SUCCESS`, `CASYNCIO_NULL_ENGINE` or
+/// `CASYNCIO_QUEUE_FULL`.
+int CAsyncIO_write(CAsyncIO_t *io, int fd, const void *buffer, size_t len,
+                   uint64_t offset, CAsyncIOCallback callback,
+                   void *user_data);
+
+/// \brief Start every queued request.
+/// \details If the kernel is busy, the requests stay queued and are submitted
+/// again by the next `CAsyncIO_poll`, once completions have been reaped.
+/// \param io Pointer to the engine.
+/// \return `CASYNCIO_SUCCESS`, `CASYNCIO_NULL_ENGINE` or `CASYNCIO_IO_FAILURE`.
+int CAsyncIO_submit(CAsyncIO_t *io);
+
+/// \brief Collect completed requests.
+/// \details Queued requests are submitted first. Callbacks run here and may
+/// queue new requests. Completions without a callback are kept for
+/// `CAsyncIO_next_completion`.
+/// \param io Pointer to the engine.
+/// \param min_complete Number of completions to wait for. 0 only collects the
+/// completions that are already available. It is capped by the number of
+/// requests in flight.
+/// \return The number of completions collected.
+size_t CAsyncIO_poll(CAsyncIO_t *io, size_t min_complete);
+
+/// \brief Take the oldest completion of a request queued without a callback.
+/// \details Completions are only collected by `CAsyncIO_poll`; this function
+/// never waits.
+/// \param io Pointer to the engine.
+/// \param user_data Receives the pointer given when the request was queued,
+/// may be NULL.
+/// \param result Receives the number of bytes transferred, or a negated
+/// `errno` value on failure, may be NULL.
+/// \return `CASYNCIO_SUCCESS`, `CASYNCIO_NULL_ENGINE` or
+/// `CASYNCIO_NO_COMPLETION`.
+int CAsyncIO_next_completion(CAsyncIO_t *io, void **user_data,
+                             int64_t *result);
+
+/// \brief Get the number of requests that have not completed yet.
+/// \param io Pointer to the engine.
+/// \return The number of queued and in-flight requests.
+size_t CAsyncIO_pending(const CAsyncIO_t *io);
+
+/// \brief Wait for every pending request, then free the engine.
+/// \details Completions that have not been taken are discarded.
+/// \param io Pointer to the pointer to the engine; set to NULL afterwards.
+/// \return `CASYNCIO_SUCCESS`. Freeing a NULL engine does nothing.
+int CAsyncIO_free(CAsyncIO_t **io);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CASYNCIO_H
@@ -0,0 +1,223 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// \file CBufChain.h
+/// \brief Header file for the CBufChain implementation.
+///
+/// This file defines a chain of byte ranges that together form one logical
+/// buffer, for assembling output from pieces that already live elsewhere: a
+/// header built for the occasion, a cached body shared by many responses, a
+/// trailer. Nothing is copied into one contiguous buffer; the chain hands its
+/// ranges to `writev` or `sendmsg` as an `iovec` array, and drops what was
+/// written from the front after a short write.
+///
+/// Bytes are held by `CBufSegment`s, reference counted blocks that either own
+/// a copy of their bytes or wrap memory owned by someone else, released once
+/// the last chain using them lets go. A chain refers to any range of a
+/// segment, and adding one at either end takes constant time.
+///
+/// \note Segments may be shared between threads; a chain may not.
+#ifndef CSTD_CBUFCHAIN_H
+#define CSTD_CBUFCHAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CString.h"
+#include "CStringView.h"
+#include "Operators.h"
+#include <stddef.h>
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/uio.h>
+#endif // POSIX
+
+/// \brief Error code indicating that the chain or segment pointer is null.
+#define CBUFCHAIN_NULL_CHAIN -2
+
+/// \brief Success code for operations.
+#define CBUFCHAIN_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CBUFCHAIN_ALLOC_FAILURE 1
+
+/// \brief Error code indicating a range outside of a segment or chain.
+#define CBUFCHAIN_OUT_OF_RANGE 2
+
+/// \struct CBufSegment
+/// \brief Structure representing a reference counted block of bytes.
+typedef struct _CBufSegment CBufSegment_t;
+
+/// \struct CBufChain
+/// \brief Structure representing a chain of byte ranges.
+typedef struct _CBufChain CBufChain_t;
+
+/// \brief Create a segment holding a copy of some bytes.
+/// \param bytes The bytes to copy.
+/// \return A `CResult_t*` containing the segment, or an error.
+CResult_t *CBufSegment_new(CStringView_t bytes);
+
+/// \brief Create a segment over bytes owned by someone else, without copying.
+/// \param bytes The bytes, which must stay valid and unchanged until
+/// `release` is called.
+/// \param release Called with `owner` once the segment is no longer used.
+/// May be `NULL`.
+/// \param owner Argument for `release`.
+/// \return A `CResult_t*` containing the segment, or an error. `release` is
+/// not called on failure.
+CResult_t *CBufSegment_wrap(CStringView_t bytes, Destructor release,
+                            void *owner);
+
+/// \brief Create a segment sharing the characters of a string.
+/// \details The string is cloned, which shares its characters instead of
+/// copying them; later changes to `string` do not affect the segment.
+/// \param string The string.
+/// \return A `CResult_t*` containing the segment, or an error.
+CResult_t *CBufSegment_from_string(const CString_t *string);
+
+/// \brief Get the bytes of a segment.
+/// \param segment Pointer to the segment.
+/// \return A view of the bytes, empty if `segment` is `NULL`.
+CStringView_t CBufSegment_view(const CBufSegment_t *segment);
+
+/// \brief Take another reference to a segment.
+/// \param segment Pointer to the segment.
+/// \return `segment`.
+CBufSegment_t *CBufSegment_retain(CBufSegment_t *segment);
+
+/// \brief Drop a reference to a segment, freeing it with the last one.
+/// \param segment Pointer to the segment pointer, set to `NULL` afterwards.
+/// \return `CBUFCHAIN_SUCCESS`, including when `segment` is `NULL`.
+int CBufSegment_free(CBufSegment_t **segment);
+
+/// \brief Create an empty chain.
+/// \return A `CResult_t*` containing the chain, or an error.
+CResult_t *CBufChain_new();
+
+/// \brief Get the number of bytes in the chain.
+/// \param chain Pointer to the chain.
+/// \return The number of bytes, or 0 if `chain` is `NULL`.
+size_t CBufChain_size(const CBufChain_t *chain);
+
+/// \brief Get the number of ranges in the chain.
+/// \param chain Pointer to the chain.
+/// \return The number of ranges, or 0 if `chain` is `NULL`.
+size_t CBufChain_count(const CBufChain_t *chain);
+
+/// \brief Add a range of a segment at the end of the chain.
+/// \details The chain takes its own reference to the segment.
+/// \param chain Pointer to the chain.
+/// \param segment Pointer to the segment.
+/// \param start Offset of the first byte in the segment.
+/// \param end Offset past the last byte in the segment.
+/// \return `CBUFCHAIN_SUCCESS`, `CBUFCHAIN_OUT_OF_RANGE` or
+/// `CBUFCHAIN_ALLOC_FAILURE`.
+int CBufChain_append(CBufChain_t *chain, CBufSegment_t *segment, size_t start,
+                     size_t end);
+
+/// \brief Add a range of a segment at the front of the chain.
+/// \param chain Pointer to the chain.
+/// \param segment Pointer to the segment.
+/// \param start Offset of the first byte in the segment.
+/// \param end Offset past the last byte in the segment.
+/// \return As for `CBufChain_append`.
+int CBufChain_prepend(CBufChain_t *chain, CBufSegment_t *segment,
+                      size_t start, size_t end);
+
+/// \brief Copy bytes to the end of the chain.
+/// \details Meant for small pieces such as headers: consecutive copies share
+/// one segment.
+/// \param chain Pointer to the chain.
+/// \param bytes The bytes to copy.
+/// \return `CBUFCHAIN_SUCCESS` or `CBUFCHAIN_ALLOC_FAILURE`.
+int CBufChain_append_copy(CBufChain_t *chain, CStringView_t bytes);
+
+/// \brief Add the characters of a string at the end of the chain, without
+/// copying them.
+/// \param chain Pointer to the chain.
+/// \param string The string, cloned as in `CBufSegment_from_string`.
+/// \return `CBUFCHAIN_SUCCESS` or `CBUFCHAIN_ALLOC_FAILURE`.
+int CBufChain_append_string(CBufChain_t *chain, const CString_t *string);
+
+/// \brief Move every range of another chain to the end of this one.
+/// \param chain Pointer to the chain.
+/// \param other Pointer to the chain to empty.
+/// \return `CBUFCHAIN_SUCCESS` or `CBUFCHAIN_ALLOC_FAILURE`, in which case
+/// both chains are left as they were.
+int CBufChain_concat(CBufChain_t *chain, CBufChain_t *other);
+
+/// \brief Copy bytes from the front of the chain without consuming them.
+/// \param chain Pointer to the chain.
+/// \param buffer Receives the bytes.
+/// \param len Maximum number of bytes to copy.
+/// \return The number of bytes copied.
+size_t CBufChain_copy_out(const CBufChain_t *chain, void *buffer, size_t len);
+
+/// \brief Drop bytes from the front of the chain, for instance those a short
+/// write got through.
+/// \param chain Pointer to the chain.
+/// \param len Number of bytes.
+/// \return `CBUFCHAIN_SUCCESS`, or `CBUFCHAIN_OUT_OF_RANGE` if the chain is
+/// shorter, in which case it is emptied.
+int CBufChain_consume(CBufChain_t *chain, size_t len);
+
+/// \brief Drop every range.
+/// \param chain Pointer to the chain.
+/// \return `CBUFCHAIN_SUCCESS` or `CBUFCHAIN_NULL_CHAIN`.
+int CBufChain_clear(CBufChain_t *chain);
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+/// \brief Describe the ranges at the front of the chain for `writev`.
+/// \param chain Pointer to the chain.
+/// \param iov Receives the ranges.
+/// \param max Capacity of `iov`.
+/// \return The number of entries filled in.
+size_t CBufChain_to_iovec(const CBufChain_t *chain, struct iovec *iov,
+                          size_t max);
+
+/// \brief Write the chain to a descriptor with `writev`, consuming what was
+/// written.
+/// \details Writes until the chain is empty or the descriptor would block.
+/// \param chain Pointer to the chain.
+/// \param fd The descriptor.
+/// \return The number of bytes written, or -1 if the first write failed, in
+/// which case `errno` describes the failure.
+ssize_t CBufChain_writev(CBufChain_t *chain, int fd);
+
+#endif // POSIX
+
+/// \brief Free the chain, dropping its references to segments.
+/// \param chain Pointer to the chain pointer, set to `NULL` afterwards.
+/// \return `CBUFCHAIN_SUCCESS`, including when `chain` is `NULL`.
+int CBufChain_free(CBufChain_t **chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CBUFCHAIN_H
@@ -0,0 +1,291 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// \file CByteBuffer.h
+/// \brief Header file for the CByteBuffer implementation.
+///
+/// This file defines a growable, contiguous byte buffer with a read and a
+/// write cursor, meant for building and parsing binary frames. Bytes between
+/// the cursors are readable; bytes after the write cursor are free room.
+///
+/// Fixed-width integers are written and read in an explicit byte order, and
+/// variable-length integers use unsigned LEB128, with zigzag encoding for
+/// signed values. Reads never run past the write cursor: when too few bytes
+/// are readable, they fail with `CBYTEBUFFER_UNDERFLOW` and leave the read
+/// cursor untouched, so a parser can wait for more input and try again.
+///
+/// In I/O loops, data is read straight into the free room with
+/// `CByteBuffer_write_ptr` and `CByteBuffer_commit`, and
+/// `CByteBuffer_compact` moves the unread bytes back to the front once the
+/// consumed ones are no longer needed.
+#ifndef CSTD_CBYTEBUFFER_H
+#define CSTD_CBYTEBUFFER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CStringView.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \brief Error code indicating that the buffer pointer is null.
+#define CBYTEBUFFER_NULL_BUFFER -2
+
+/// \brief Error code indicating that fewer bytes are readable than needed.
+#define CBYTEBUFFER_UNDERFLOW -1
+
+/// \brief Success code for operations.
+#define CBYTEBUFFER_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CBYTEBUFFER_ALLOC_FAILURE 1
+
+/// \brief Error code indicating a varint longer than 10 bytes, out of range
+/// for 64 bits, or padded with trailing zero groups.
+#define CBYTEBUFFER_INVALID_VARINT 2
+
+/// \brief Error code indicating a range outside of the readable bytes.
+#define CBYTEBUFFER_OUT_OF_RANGE 3
+
+/// \brief Maximum size of an encoded varint.
+#define CBYTEBUFFER_VARINT_MAX 10
+
+/// \struct CByteBuffer
+/// \brief Structure representing a byte buffer.
+typedef struct _CByteBuffer CByteBuffer_t;
+
+/// \brief Create an empty buffer.
+/// \param capacity Number of bytes to allocate up front, may be 0.
+/// \return A `CResult_t*` containing the buffer, or an error.
+CResult_t *CByteBuffer_new(size_t capacity);
+
+/// \brief Get the number of readable bytes.
+/// \param buffer Pointer to the buffer.
+/// \return The bytes between the cursors, or 0 if `buffer` is `NULL`.
+size_t CByteBuffer_readable(const CByteBuffer_t *buffer);
+
+/// \brief Get the number of bytes that can be written without growing.
+/// \param buffer Pointer to the buffer.
+/// \return The bytes after the write cursor, or 0 if `buffer` is `NULL`.
+size_t CByteBuffer_writable(const CByteBuffer_t *buffer);
+
+/// \brief Get the readable bytes.
+/// \param buffer Pointer to the buffer.
+/// \return A view of the readable bytes, valid until the buffer is written to
+/// or compacted.
+CStringView_t CByteBuffer_view(const CByteBuffer_t *buffer);
+
+/// \brief Get part of the readable bytes without copying them.
+/// \param buffer Pointer to the buffer.
+/// \param start Offset of the first byte, from the read cursor.
+/// \param end Offset past the last byte, from the read cursor.
+/// \param slice Receives the view, valid until the buffer is written to or
+/// compacted.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_OUT_OF_RANGE`.
+int CByteBuffer_slice(const CByteBuffer_t *buffer, size_t start, size_t end,
+                      CStringView_t *slice);
+
+/// \brief Make room for at least `len` more bytes.
+/// \details The unread bytes are moved to the front instead of growing when
+/// that frees enough room and at least half the buffer has been consumed.
+/// \param buffer Pointer to the buffer.
+/// \param len Number of bytes about to be written.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_reserve(CByteBuffer_t *buffer, size_t len);
+
+/// \brief Get where the next written byte goes, for writing in place.
+/// \param buffer Pointer to the buffer.
+/// \return The write cursor, followed by `CByteBuffer_writable` bytes of room.
+char *CByteBuffer_write_ptr(CByteBuffer_t *buffer);
+
+/// \brief Mark bytes written in place as readable.
+/// \param buffer Pointer to the buffer.
+/// \param len Number of bytes written after the write cursor.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_OUT_OF_RANGE` if `len` is
+/// larger than the room.
+int CByteBuffer_commit(CByteBuffer_t *buffer, size_t len);
+
+/// \brief Move the unread bytes to the front of the buffer.
+/// \param buffer Pointer to the buffer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_NULL_BUFFER`.
+int CByteBuffer_compact(CByteBuffer_t *buffer);
+
+/// \brief Drop every byte, keeping the memory.
+/// \param buffer Pointer to the buffer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_NULL_BUFFER`.
+int CByteBuffer_clear(CByteBuffer_t *buffer);
+
+/// \brief Append bytes.
+/// \param buffer Pointer to the buffer.
+/// \param data Bytes to append.
+/// \param len Number of bytes.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put(CByteBuffer_t *buffer, const void *data, size_t len);
+
+/// \brief Append a byte.
+/// \param buffer Pointer to the buffer.
+/// \param value The byte.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u8(CByteBuffer_t *buffer, uint8_t value);
+
+/// \brief Append a 16 bit integer, least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u16le(CByteBuffer_t *buffer, uint16_t value);
+
+/// \brief Append a 16 bit integer, most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u16be(CByteBuffer_t *buffer, uint16_t value);
+
+/// \brief Append a 32 bit integer, least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u32le(CByteBuffer_t *buffer, uint32_t value);
+
+/// \brief Append a 32 bit integer, most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u32be(CByteBuffer_t *buffer, uint32_t value);
+
+/// \brief Append a 64 bit integer, least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u64le(CByteBuffer_t *buffer, uint64_t value);
+
+/// \brief Append a 64 bit integer, most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_u64be(CByteBuffer_t *buffer, uint64_t value);
+
+/// \brief Append an unsigned LEB128 varint, 7 bits per byte.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer, taking 1 to 10 bytes.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_varint(CByteBuffer_t *buffer, uint64_t value);
+
+/// \brief Append a signed integer as a zigzag encoded varint, so that small
+/// negative values stay short.
+/// \param buffer Pointer to the buffer.
+/// \param value The integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_ALLOC_FAILURE`.
+int CByteBuffer_put_svarint(CByteBuffer_t *buffer, int64_t value);
+
+/// \brief Read bytes.
+/// \param buffer Pointer to the buffer.
+/// \param data Receives the bytes.
+/// \param len Number of bytes.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get(CByteBuffer_t *buffer, void *data, size_t len);
+
+/// \brief Read bytes without copying them.
+/// \param buffer Pointer to the buffer.
+/// \param len Number of bytes.
+/// \param view Receives a view of the bytes, valid until the buffer is
+/// written to or compacted.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_view(CByteBuffer_t *buffer, size_t len,
+                         CStringView_t *view);
+
+/// \brief Skip over readable bytes.
+/// \param buffer Pointer to the buffer.
+/// \param len Number of bytes.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_skip(CByteBuffer_t *buffer, size_t len);
+
+/// \brief Read a byte.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the byte.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u8(CByteBuffer_t *buffer, uint8_t *value);
+
+/// \brief Read a 16 bit integer stored least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u16le(CByteBuffer_t *buffer, uint16_t *value);
+
+/// \brief Read a 16 bit integer stored most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u16be(CByteBuffer_t *buffer, uint16_t *value);
+
+/// \brief Read a 32 bit integer stored least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u32le(CByteBuffer_t *buffer, uint32_t *value);
+
+/// \brief Read a 32 bit integer stored most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u32be(CByteBuffer_t *buffer, uint32_t *value);
+
+/// \brief Read a 64 bit integer stored least significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u64le(CByteBuffer_t *buffer, uint64_t *value);
+
+/// \brief Read a 64 bit integer stored most significant byte first.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS` or `CBYTEBUFFER_UNDERFLOW`.
+int CByteBuffer_get_u64be(CByteBuffer_t *buffer, uint64_t *value);
+
+/// \brief Read an unsigned LEB128 varint.
+/// \details Only the shortest encoding of each value is accepted, so a last
+/// byte of zero after the first is refused.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return `CBYTEBUFFER_SUCCESS`, `CBYTEBUFFER_UNDERFLOW` if the varint is
+/// cut short, or `CBYTEBUFFER_INVALID_VARINT`.
+int CByteBuffer_get_varint(CByteBuffer_t *buffer, uint64_t *value);
+
+/// \brief Read a zigzag encoded varint.
+/// \param buffer Pointer to the buffer.
+/// \param value Receives the integer.
+/// \return As for `CByteBuffer_get_varint`.
+int CByteBuffer_get_svarint(CByteBuffer_t *buffer, int64_t *value);
+
+/// \brief Free the buffer.
+/// \param buffer Pointer to the buffer pointer, set to `NULL` afterwards.
+/// \return `CBYTEBUFFER_SUCCESS`, including when `buffer` is `NULL`.
+int CByteBuffer_free(CByteBuffer_t **buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CBYTEBUFFER_H
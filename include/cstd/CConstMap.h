@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CConstMap.h
+/// \brief Header file for the CConstMap implementation.
+///
+/// This file defines an immutable hash table stored in a file, in the spirit
+/// of cdb. A `CConstMapBuilder` writes the keys and values once; any number of
+/// processes then open the file with `CConstMap_open`, which maps it read-only
+/// and answers lookups straight from the page cache. Nothing is parsed or
+/// copied at startup, and every process shares one physical copy of the data.
+///
+/// Keys and values are arbitrary byte strings. The file holds the records
+/// followed by an open-addressed table of (hash, offset) slots, kept at most
+/// half full, so a lookup usually touches one table slot and one record.
+///
+/// \note The map is only available on POSIX platforms. Files are specific to
+/// the byte order of the machine that built them.
+#ifndef CSTD_CCONSTMAP_H
+#define CSTD_CCONSTMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CStringView.h"
+#include <stddef.h>
+
+/// \brief Error code indicating that the map or builder pointer is null.
+#define CCONSTMAP_NULL_MAP -2
+
+/// \brief Error code indicating that a key is not in the map.
+#define CCONSTMAP_NOT_FOUND -1
+
+/// \brief Success code for operations.
+#define CCONSTMAP_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CCONSTMAP_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure.
+#define CCONSTMAP_IO_FAILURE 2
+
+/// \brief Error code indicating that a file is not a valid constant map.
+#define CCONSTMAP_INVALID_FILE 3
+
+/// \struct CConstMap
+/// \brief Structure representing an opened constant map.
+typedef struct _CConstMap CConstMap_t;
+
+/// \struct CConstMapBuilder
+/// \brief Structure representing a constant map being written.
+typedef struct _CConstMapBuilder CConstMapBuilder_t;
+
+/// \brief Start writing a constant map.
+/// \details Records are streamed to a temporary file next to `path`, which
+/// replaces `path` atomically once the builder is finished. Processes that
+/// still have the old file open keep reading it undisturbed.
+/// \param path Path of the map to create.
+/// \return A `CResult_t*` containing the new builder, or an error.
+CResult_t *CConstMapBuilder_new(const char *path);
+
+/// \brief Add a key and its value.
+/// \details Keys are not deduplicated: when a key is added more than once,
+/// lookups return the value that was added first.
+/// \param builder Pointer to the builder.
+/// \param key The key.
+/// \param value The value.
+/// \return `CCONSTMAP_SUCCESS`, `CCONSTMAP_ALLOC_FAILURE` or
+/// `CCONSTMAP_IO_FAILURE`. Errors are sticky, and make the builder fail to
+/// finish.
+int CConstMapBuilder_add(CConstMapBuilder_t *builder, CStringView_t key,
+                         CStringView_t value);
+
+/// \brief Write the table, move the file into place and free the builder.
+/// \param builder Pointer to the builder pointer, set to `NULL` in any case.
+/// \return `CCONSTMAP_SUCCESS` if the map was written, otherwise the first
+/// error the builder ran into. On failure `path` is left untouched.
+int CConstMapBuilder_finish(CConstMapBuilder_t **builder);
+
+/// \brief Abandon a builder, removing its temporary file.
+/// \param builder Pointer to the builder pointer, set to `NULL` afterwards.
+/// \return `CCONSTMAP_SUCCESS`, including when `builder` is `NULL`.
+int CConstMapBuilder_free(CConstMapBuilder_t **builder);
+
+/// \brief Open a constant map written by a `CConstMapBuilder`.
+/// \param path Path of the map.
+/// \return A `CResult_t*` containing the map, or an error with
+/// `CCONSTMAP_IO_FAILURE` or `CCONSTMAP_INVALID_FILE`.
+CResult_t *CConstMap_open(const char *path);
+
+/// \brief Retrieve the number of keys in the map.
+/// \param map Pointer to the map.
+/// \return The number of keys, or 0 if `map` is `NULL`.
+size_t CConstMap_size(const CConstMap_t *map);
+
+/// \brief Look up a key.
+/// \param map Pointer to the map.
+/// \param key The key to look up.
+/// \param value Receives a view of the value inside the mapping, valid until
+/// the map is freed. May be `NULL` to only test for the key.
+/// \return `CCONSTMAP_SUCCESS`, `CCONSTMAP_NOT_FOUND`, or
+/// `CCONSTMAP_NULL_MAP` if `map` is `NULL`.
+int CConstMap_get(const CConstMap_t *map, CStringView_t key,
+                  CStringView_t *value);
+
+/// \brief Unmap the map and free it.
+/// \param map Pointer to the map pointer, set to `NULL` afterwards.
+/// \return `CCONSTMAP_SUCCESS`, including when `map` is `NULL`.
+int CConstMap_free(CConstMap_t **map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CCONSTMAP_H
@@ -0,0 +1,161 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CDeque.h
+/// \brief Header file for the CDeque implementation.
+///
+/// A double-ended queue of `void*` pointers, stored in fixed-size blocks
+/// found through a block map. Elements can be added and removed at both
+/// ends, and read at any index, in constant time. Growing only allocates a
+/// block, or copies the block pointers once the map is full, so elements
+/// never move and walking the deque reads them block by block.
+///
+/// A block that empties out is freed, except for the last two, which are
+/// kept for the elements to come. A deque used as a FIFO queue or a sliding
+/// window therefore stops allocating once it is running, while one that
+/// shrinks after a spike gives its memory back. Only the block map, one
+/// pointer per 64 elements, stays at its largest size until the deque is
+/// freed.
+///
+/// \note Popping does not destroy the element, which is handed over to the
+/// caller. The destructor is called on the elements left by `CDeque_clear`
+/// and `CDeque_free`.
+#ifndef CSTD_CDEQUE_H
+#define CSTD_CDEQUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "Operators.h"
+#include <stddef.h>
+
+/// \brief Error code indicating that the deque is empty.
+#define CDEQUE_EMPTY -3
+
+/// \brief Error code indicating that the deque pointer is null.
+#define CDEQUE_NULL_DEQUE -2
+
+/// \brief Error code indicating that the index is out of bounds.
+#define CDEQUE_INDEX_OUT_OF_BOUNDS -1
+
+/// \brief Success code for operations.
+#define CDEQUE_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CDEQUE_ALLOC_FAILURE 1
+
+/// \struct CDeque
+/// \brief Opaque structure representing a double-ended queue.
+typedef struct _CDeque CDeque_t;
+
+/// \brief Create a new, empty deque.
+/// \param destroy The destructor function to use for cleaning up elements,
+/// or `NULL` if no destructor is needed.
+/// \return Returns a pointer to the newly created `CDeque` structure,
+/// encapsulated in CResult for better error handling.
+CResult_t *CDeque_new(Destructor destroy);
+
+/// \brief Get the number of elements in the deque.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return The number of elements, 0 if `deque` is `NULL`.
+size_t CDeque_size(const CDeque_t *deque);
+
+/// \brief Add an element at the back of the deque.
+/// \param deque Pointer to the `CDeque` structure.
+/// \param element Pointer to the element to be added.
+/// \return Returns `CDEQUE_SUCCESS` on success, or an error code if the
+/// operation fails (e.g., memory allocation failure).
+int CDeque_push_back(CDeque_t *deque, void *element);
+
+/// \brief Add an element at the front of the deque.
+/// \param deque Pointer to the `CDeque` structure.
+/// \param element Pointer to the element to be added.
+/// \return Returns `CDEQUE_SUCCESS` on success, or an error code if the
+/// operation fails (e.g., memory allocation failure).
+int CDeque_push_front(CDeque_t *deque, void *element);
+
+/// \brief Remove and return the element at the back of the deque.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return Returns a `CResult_t` encapsulating the element, or an error
+/// with `CDEQUE_EMPTY` if there is none.
+CResult_t *CDeque_pop_back(CDeque_t *deque);
+
+/// \brief Remove and return the element at the front of the deque.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return Returns a `CResult_t` encapsulating the element, or an error
+/// with `CDEQUE_EMPTY` if there is none.
+CResult_t *CDeque_pop_front(CDeque_t *deque);
+
+/// \brief Remove and return the element at the back of the deque, without
+/// allocating a `CResult_t`.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return The element, or `NULL` if the deque is empty.
+void *CDeque_fpop_back(CDeque_t *deque);
+
+/// \brief Remove and return the element at the front of the deque, without
+/// allocating a `CResult_t`.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return The element, or `NULL` if the deque is empty.
+void *CDeque_fpop_front(CDeque_t *deque);
+
+/// \brief Get the element at an index, counted from the front.
+/// \param deque Pointer to the `CDeque` structure.
+/// \param index The index of the element.
+/// \return The element, or `NULL` if the index is out of bounds.
+void *CDeque_fget(const CDeque_t *deque, size_t index);
+
+/// \brief Get the element at an index, counted from the front.
+/// \param deque Pointer to the `CDeque` structure.
+/// \param index The index of the element.
+/// \return Returns a pointer to CResult, which in turn contains the element,
+/// or an error if the index is out of bounds.
+CResult_t *CDeque_get(const CDeque_t *deque, size_t index);
+
+/// \brief Replace the element at an index, without destroying the old one.
+/// \param deque Pointer to the `CDeque` structure.
+/// \param index The index of the element.
+/// \param element Pointer to the new element.
+/// \return Returns `CDEQUE_SUCCESS`, or an error code if the index is out of
+/// bounds.
+int CDeque_set(CDeque_t *deque, size_t index, void *element);
+
+/// \brief Remove all the elements of the deque and release its blocks.
+/// \param deque Pointer to the `CDeque` structure.
+/// \return Returns `CDEQUE_SUCCESS`, or `CDEQUE_NULL_DEQUE`.
+int CDeque_clear(CDeque_t *deque);
+
+/// \brief Free the deque and the elements left in it.
+/// \param deque Pointer to the pointer to the `CDeque` structure, set to
+/// `NULL`.
+/// \return Returns `CDEQUE_SUCCESS`.
+int CDeque_free(CDeque_t **deque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CDEQUE_H
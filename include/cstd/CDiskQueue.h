@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// \file CDiskQueue.h
+/// \brief Header file for the CDiskQueue implementation.
+///
+/// This file defines a FIFO queue of byte strings kept in a directory, which
+/// survives process restarts and crashes. Records are appended to fixed-size
+/// segment files that are mapped into memory, each behind a small header
+/// holding its length, a CRC-32C checksum and the id of its segment. Reading
+/// a queue back stops at the first record that does not check out, so a write
+/// torn by a crash is simply dropped.
+///
+/// Pushes are made durable in batches: `CDiskQueue_sync` flushes every record
+/// pushed since the previous call with a single `fdatasync`, and is called on
+/// its own every `sync_every` pushes. The same call records how far the
+/// consumer has got in a checkpoint file; after a restart popping resumes from
+/// the last checkpoint, so records popped since then are delivered again.
+/// Segments that lie entirely behind the checkpoint are recycled for future
+/// writes instead of being deleted and recreated.
+///
+/// \note The queue is only available on POSIX platforms. It is not thread
+/// safe, and a directory can only be opened by one queue at a time.
+#ifndef CSTD_CDISKQUEUE_H
+#define CSTD_CDISKQUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CStringView.h"
+#include <stddef.h>
+
+/// \brief Error code indicating that the queue pointer is null.
+#define CDISKQUEUE_NULL_QUEUE -2
+
+/// \brief Error code indicating that the queue is empty.
+#define CDISKQUEUE_EMPTY -1
+
+/// \brief Success code for operations.
+#define CDISKQUEUE_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CDISKQUEUE_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure.
+#define CDISKQUEUE_IO_FAILURE 2
+
+/// \brief Error code indicating that a record does not fit in a segment.
+#define CDISKQUEUE_TOO_LARGE 3
+
+/// \brief Error code indicating that a record was damaged after it was
+/// counted, for instance by another process writing to the segment.
+#define CDISKQUEUE_INVALID_RECORD 4
+
+/// \brief Default size of a segment file, in bytes.
+#define CDISKQUEUE_SEGMENT_SIZE (64 * 1024 * 1024)
+
+/// \struct CDiskQueue
+/// \brief Structure representing a queue stored in a directory.
+typedef struct _CDiskQueue CDiskQueue_t;
+
+/// \brief Open the queue stored in a directory, creating it if needed.
+/// \details The records left in the directory are scanned once to find the
+/// end of the queue.
+/// \param dir Path of the directory.
+/// \param segment_size Size of the segment files created from now on, or 0
+/// for `CDISKQUEUE_SEGMENT_SIZE`. It bounds the size of a record.
+/// \param sync_every Number of pushes after which the queue is synced on its
+/// own, or 0 to only sync on `CDiskQueue_sync`.
+/// \return A `CResult_t*` containing the queue, or an error with
+/// `CDISKQUEUE_IO_FAILURE` or `CDISKQUEUE_ALLOC_FAILURE`.
+CResult_t *CDiskQueue_new(const char *dir, size_t segment_size,
+                          size_t sync_every);
+
+/// \brief Retrieve the number of records in the queue.
+/// \param queue Pointer to the queue.
+/// \return The number of records, or 0 if `queue` is `NULL`.
+size_t CDiskQueue_size(const CDiskQueue_t *queue);
+
+/// \brief Add a record to the rear of the queue.
+/// \details The record is durable once the queue has been synced.
+/// \param queue Pointer to the queue.
+/// \param record The bytes to add, copied into the queue.
+/// \return `CDISKQUEUE_SUCCESS`, `CDISKQUEUE_TOO_LARGE` or
+/// `CDISKQUEUE_IO_FAILURE`.
+int CDiskQueue_push(CDiskQueue_t *queue, CStringView_t record);
+
+/// \brief Remove the record at the front of the queue and return a view of
+/// it.
+/// \param queue Pointer to the queue.
+/// \param record Receives a view of the record inside the segment, valid
+/// until the next pop.
+/// \return `CDISKQUEUE_SUCCESS`, `CDISKQUEUE_EMPTY`,
+/// `CDISKQUEUE_INVALID_RECORD` or `CDISKQUEUE_IO_FAILURE`.
+int CDiskQueue_pop_view(CDiskQueue_t *queue, CStringView_t *record);
+
+/// \brief Remove and return the record at the front of the queue.
+/// \param queue Pointer to the queue.
+/// \return A `CResult_t*` containing a `CString_t*` copy of the record, or an
+/// error with `CDISKQUEUE_EMPTY` if the queue is empty.
+CResult_t *CDiskQueue_pop(CDiskQueue_t *queue);
+
+/// \brief Make the pushed records and the consumer position durable.
+/// \details Segments that have been consumed completely are recycled
+/// afterwards.
+/// \param queue Pointer to the queue.
+/// \return `CDISKQUEUE_SUCCESS` or `CDISKQUEUE_IO_FAILURE`.
+int CDiskQueue_sync(CDiskQueue_t *queue);
+
+/// \brief Sync the queue, close it and free it.
+/// \param queue Pointer to the queue pointer, set to `NULL` afterwards.
+/// \return `CDISKQUEUE_SUCCESS`, including when `queue` is `NULL`, or
+/// `CDISKQUEUE_IO_FAILURE` if the final sync failed.
+int CDiskQueue_free(CDiskQueue_t **queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CDISKQUEUE_H
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CFileReader.h
+/// \brief Header file for the CFileReader implementation.
+///
+/// This file defines a reader that iterates over the lines or records of a
+/// file without copying them: every line is returned as a `CStringView` into
+/// the reader's storage. Three backends are available:
+///
+/// - Regular files are mapped into memory with `mmap` and read with
+///   `MADV_SEQUENTIAL` readahead, so the whole file is a single view.
+/// - Files can instead be read into a large buffer with `read()`, which keeps
+///   the memory footprint bounded.
+/// - Pipes, sockets and terminals such as standard input always use the
+///   buffered backend, through `CFileReader_from_fd`.
+///
+/// \note The reader is only available on POSIX platforms.
+#ifndef CSTD_CFILEREADER_H
+#define CSTD_CFILEREADER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CString.h"
+#include "CStringView.h"
+#include <stddef.h>
+
+/// \brief Initial size of the buffer used by the `read()` backend.
+/// \details The buffer grows beyond this size only to hold a line that does
+/// not fit.
+#define CFILEREADER_BUFFER_SIZE (1 << 20)
+
+/// \brief Pick the backend automatically: `mmap` for regular files, `read()`
+/// for everything else.
+#define CFILEREADER_AUTO 0
+
+/// \brief Map the file into memory. Only valid for regular files.
+#define CFILEREADER_MMAP 1
+
+/// \brief Read the file through a buffer with `read()`.
+#define CFILEREADER_READ 2
+
+/// \brief Error code indicating that the reader pointer is null.
+#define CFILEREADER_NULL_READER -2
+
+/// \brief Success code for operations.
+#define CFILEREADER_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CFILEREADER_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure.
+#define CFILEREADER_IO_FAILURE 2
+
+/// \struct CFileReader
+/// \brief Structure representing a file reader.
+typedef struct _CFileReader CFileReader_t;
+
+/// \brief Open a file for reading.
+/// \param path Path of the file to open.
+/// \param mode One of `CFILEREADER_AUTO`, `CFILEREADER_MMAP` or
+/// `CFILEREADER_READ`.
+/// \return A `CResult_t*` containing the new `CFileReader_t`, or an error if
+/// the file cannot be opened or mapped. Free the reader with
+/// `CFileReader_free`, which also closes the file.
+CResult_t *CFileReader_open(const char *path, int mode);
+
+/// \brief Create a reader over an open file descriptor, such as standard
+/// input.
+/// \param fd The file descriptor to read from. Reading starts at its current
+/// position.
+/// \param mode One of `CFILEREADER_AUTO`, `CFILEREADER_MMAP` or
+/// `CFILEREADER_READ`.
+/// \return A `CResult_t*` containing the new `CFileReader_t`, or an error.
+///
+/// \note The reader does not take ownership of `fd`, and leaves it open.
+CResult_t *CFileReader_from_fd(int fd, int mode);
+
+/// \brief Retrieve the next line.
+/// \details Lines are terminated by `\n`, and a `\r` preceding it is not part
+/// of the line. The last line does not need a terminator, and a trailing
+/// terminator does not produce an extra empty line.
+/// \param reader Pointer to the reader.
+/// \param line Receives a view of the line.
+/// \return Returns 1 if a line was produced, 0 at the end of the file or on
+/// error; see `CFileReader_error`.
+///
+/// \note With the `read()` backend the view is only valid until the next call
+/// on the reader. With `mmap` it stays valid until the reader is freed.
+int CFileReader_next_line(CFileReader_t *reader, CStringView_t *line);
+
+/// \brief Retrieve the next record terminated by `delim`.
+/// \details Consecutive delimiters produce empty records. The last record does
+/// not need a terminator, and a trailing terminator does not produce an extra
+/// empty record.
+/// \param reader Pointer to the reader.
+/// \param delim The non-empty delimiter separating the records.
+/// \param record Receives a view of the record, without the delimiter.
+/// \return Returns 1 if a record was produced, 0 at the end of the file or on
+/// error; see `CFileReader_error`.
+///
+/// \note The view has the same lifetime as those of `CFileReader_next_line`.
+int CFileReader_next_record(CFileReader_t *reader, CStringView_t delim,
+                            CStringView_t *record);
+
+/// \brief Read everything that has not been consumed yet into a CString.
+/// \param reader Pointer to the reader.
+/// \return A `CResult_t*` containing a new `CString_t` with the rest of the
+/// file, or an error if reading or memory allocation failed.
+CResult_t *CFileReader_slurp(CFileReader_t *reader);
+
+/// \brief Get the error that stopped the reader, if any.
+/// \param reader Pointer to the reader.
+/// \return `CFILEREADER_SUCCESS` if the reader only ran out of input,
+/// `CFILEREADER_NULL_READER` if `reader` is NULL, or the error code of the
+/// failure.
+int CFileReader_error(const CFileReader_t *reader);
+
+/// \brief Free the reader, unmapping the file and closing it if the reader
+/// opened it.
+/// \param reader Pointer to the pointer to the reader; set to NULL afterwards.
+/// \return `CFILEREADER_SUCCESS`. Freeing a NULL reader does nothing.
+int CFileReader_free(CFileReader_t **reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CFILEREADER_H
@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CFileWriter.h
+/// \brief Header file for the CFileWriter implementation.
+///
+/// This file defines a buffered writer that turns many small appends into a
+/// few large `write` system calls. Payloads that are large compared to the
+/// buffer are not copied: they are written together with the pending buffer
+/// in a single `writev`.
+///
+/// The writer can optionally bypass the page cache with `O_DIRECT`, in which
+/// case it only ever writes whole, aligned blocks from an aligned buffer, and
+/// it can call `fdatasync` after every flush or once when it is freed.
+///
+/// \note The writer is only available on POSIX platforms. `O_DIRECT` requires
+/// Linux and a file system that supports it.
+#ifndef CSTD_CFILEWRITER_H
+#define CSTD_CFILEWRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CString.h"
+#include "CStringView.h"
+#include <stddef.h>
+
+/// \brief Size of the writer's buffer.
+#define CFILEWRITER_BUFFER_SIZE (1 << 20)
+
+/// \brief Alignment of the buffer, file offsets and write sizes in
+/// `CFILEWRITER_DIRECT` mode.
+#define CFILEWRITER_ALIGNMENT 4096
+
+/// \brief Append to the file instead of truncating it.
+#define CFILEWRITER_APPEND (1 << 0)
+
+/// \brief Open the file with `O_DIRECT`, bypassing the page cache. The file is
+/// truncated, and cannot be combined with `CFILEWRITER_APPEND`.
+#define CFILEWRITER_DIRECT (1 << 1)
+
+/// \brief Call `fdatasync` after every flush.
+#define CFILEWRITER_SYNC_FLUSH (1 << 2)
+
+/// \brief Call `fdatasync` once, when the writer is freed.
+#define CFILEWRITER_SYNC_CLOSE (1 << 3)
+
+/// \brief Error code indicating that the writer pointer is null.
+#define CFILEWRITER_NULL_WRITER -2
+
+/// \brief Success code for operations.
+#define CFILEWRITER_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CFILEWRITER_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure. Errors are sticky: once a write
+/// fails, every later operation on the writer fails with the same code.
+#define CFILEWRITER_IO_FAILURE 2
+
+/// \struct CFileWriter
+/// \brief Structure representing a buffered file writer.
+typedef struct _CFileWriter CFileWriter_t;
+
+/// \brief Open a file for writing, creating it if needed.
+/// \param path Path of the file to open.
+/// \param flags A combination of the `CFILEWRITER_` flags, or 0 to truncate
+/// the file and never sync.
+/// \return A `CResult_t*` containing the new `CFileWriter_t`, or an error if
+/// the file cannot be opened. Free the writer with `CFileWriter_free`, which
+/// flushes it and closes the file.
+CResult_t *CFileWriter_open(const char *path, int flags);
+
+/// \brief Create a writer over an open file descriptor, such as standard
+/// output.
+/// \param fd The file descriptor to write to.
+/// \param flags A combination of `CFILEWRITER_SYNC_FLUSH` and
+/// `CFILEWRITER_SYNC_CLOSE`.
+/// \return A `CResult_t*` containing the new `CFileWriter_t`, or an error.
+///
+/// \note The writer does not take ownership of `fd`, and leaves it open.
+CResult_t *CFileWriter_from_fd(int fd, int flags);
+
+/// \brief Append characters to the writer.
+/// \details Small appends are copied into the buffer. An append of at least
+/// half the buffer size is written straight from `ptr`, together with the
+/// buffered characters, in one `writev`.
+/// \param writer Pointer to the writer.
+/// \param ptr The characters to write.
+/// \param len The number of characters to write.
+/// \return `CFILEWRITER_SUCCESS`, `CFILEWRITER_NULL_WRITER` or the error that
+/// stopped the writer.
+int CFileWriter_append(CFileWriter_t *writer, const void *ptr, size_t len);
+
+/// \brief Append the characters of a view to the writer.
+/// \param writer Pointer to the writer.
+/// \param view The characters to write.
+/// \return See `CFileWriter_append`.
+int CFileWriter_append_view(CFileWriter_t *writer, CStringView_t view);
+
+/// \brief Append the characters of a CString to the writer.
+/// \param writer Pointer to the writer.
+/// \param string Pointer to the `CString` to write.
+/// \return See `CFileWriter_append`, or `CFILEWRITER_NULL_WRITER` if `string`
+/// is NULL.
+int CFileWriter_append_cstring(CFileWriter_t *writer,
+                               const CString_t *string);
+
+/// \brief Write the buffered characters to the file.
+/// \details Calls `fdatasync` afterwards with `CFILEWRITER_SYNC_FLUSH`. In
+/// `CFILEWRITER_DIRECT` mode only whole blocks are written; the remainder
+/// stays buffered until more characters arrive or the writer is freed.
+/// \param writer Pointer to the writer.
+/// \return `CFILEWRITER_SUCCESS`, `CFILEWRITER_NULL_WRITER` or the error that
+/// stopped the writer.
+int CFileWriter_flush(CFileWriter_t *writer);
+
+/// \brief Flush the writer and call `fdatasync`, regardless of the flags.
+/// \param writer Pointer to the writer.
+/// \return See `CFileWriter_flush`.
+int CFileWriter_sync(CFileWriter_t *writer);
+
+/// \brief Get the error that stopped the writer, if any.
+/// \param writer Pointer to the writer.
+/// \return `CFILEWRITER_SUCCESS`, `CFILEWRITER_NULL_WRITER` if `writer` is
+/// NULL, or the error code of the failure.
+int CFileWriter_error(const CFileWriter_t *writer);
+
+/// \brief Flush the writer, sync it with `CFILEWRITER_SYNC_CLOSE`, close the
+/// file if the writer opened it, and free the writer.
+/// \param writer Pointer to the pointer to the writer; set to NULL afterwards.
+/// \return `CFILEWRITER_SUCCESS`, or the error that prevented writing all of
+/// the characters. The writer is freed in either case.
+int CFileWriter_free(CFileWriter_t **writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CFILEWRITER_H
@@ -70,6 +70,15 @@ extern "C" {
 /// performing an operation on the hash map.
 #define CHASHMAP_ALLOC_FAILURE 1
 
+/// \def CHASHMAP_IO_FAILURE
+/// \brief Error code indicating that a snapshot could not be written or read.
+#define CHASHMAP_IO_FAILURE 2
+
+/// \def CHASHMAP_INVALID_SNAPSHOT
+/// \brief Error code indicating that a file is not a hash map snapshot, or was
+/// written by a machine with a different byte order or pointer size.
+#define CHASHMAP_INVALID_SNAPSHOT 3
+
 /// \def CHASHMAP_DEFAULT_CAPACITY
 /// \brief Default initial capacity for the hash map.
 /// \details The default capacity determines the number of buckets allocated
@@ -247,6 +256,49 @@ size_t CHashMap_size(const CHashMap_t *map);
 /// \warning If `map` is NULL, the function returns 0.0.
 double CHashMap_load_factor(const CHashMap_t *map);
 
+/// \brief Write a snapshot of the hash map to a file.
+/// \details The snapshot holds the slot table exactly as it is laid out in
+/// memory, along with the bytes of every key and value as produced by the
+/// serializers. See `CHashMap_load`.
+/// \param map Pointer to the hash map.
+/// \param path Path of the file to create or replace. The snapshot is written
+/// to a temporary file beside it and renamed over it once synced, so a
+/// container loaded from `path` may be saved back to it.
+/// \param serializeKey Serializer for the keys.
+/// \param serializeValue Serializer for the values.
+/// \return An integer value indicating the result of the operation:
+///         - `CHASHMAP_SUCCESS` if the snapshot was written,
+///         - `CHASHMAP_NULL_MAP` if the hash map is `NULL` or cleared,
+///         - `CHASHMAP_NULL_VAL` if `path` or a serializer is `NULL`,
+///         - `CHASHMAP_ALLOC_FAILURE` if memory allocation failed,
+///         - `CHASHMAP_IO_FAILURE` if the file could not be written.
+///
+/// \note Only available on POSIX systems.
+int CHashMap_save(const CHashMap_t *map, const char *path,
+                  SerializeFn serializeKey, SerializeFn serializeValue);
+
+/// \brief Load a hash map from a snapshot written by `CHashMap_save`.
+/// \details The file is mapped privately and the slot table is used in place
+/// after its offsets are turned back into pointers, so loading costs one
+/// `mmap` and a pass over the table, with no hashing or per-entry allocation.
+/// Keys and values point at their serialized bytes inside the mapping, which
+/// lives until the map is cleared or freed.
+///
+/// The map can be modified afterwards. Entries from the snapshot are never
+/// passed to the destructors; entries inserted later are.
+/// \param path Path of the snapshot.
+/// \param cmp Comparison function for keys.
+/// \param hash Hash function for keys. It must return the same hash for the
+/// serialized bytes as the map it was saved from did for the original key.
+/// \param destroyKey Destructor for keys inserted after loading.
+/// \param destroyValue Destructor for values inserted after loading.
+/// \return Pointer to a `CResult` containing the hash map, or an error with
+/// `CHASHMAP_IO_FAILURE` or `CHASHMAP_INVALID_SNAPSHOT`.
+///
+/// \note Only available on POSIX systems.
+CResult_t *CHashMap_load(const char *path, CompareTo cmp, Hash hash,
+                         Destructor destroyKey, Destructor destroyValue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -84,6 +84,15 @@ extern "C" {
 /// fails.
 #define CHASHSET_ALLOC_FAILURE 1
 
+/// \def CHASHSET_IO_FAILURE
+/// \brief Error code indicating that a snapshot could not be written or read.
+#define CHASHSET_IO_FAILURE 2
+
+/// \def CHASHSET_INVALID_SNAPSHOT
+/// \brief Error code indicating that a file is not a hash set snapshot, or was
+/// written by a machine with a different byte order or pointer size.
+#define CHASHSET_INVALID_SNAPSHOT 3
+
 /// \struct CHashSet
 /// \brief Structure representing a hash set of pointers.
 /// \details The `CHashSet` structure stores a set of elements with no
@@ -160,6 +169,35 @@ int CHashSet_clear(CHashSet_t *set);
 /// including the structure itself.
 int CHashSet_free(CHashSet_t **set);
 
+/// \brief Write a snapshot of the hash set to a file.
+/// \details See `CHashMap_save`; the layout is the same with keys only.
+/// \param set Pointer to the `CHashSet` structure.
+/// \param path Path of the file to create or replace. The snapshot is written
+/// to a temporary file beside it and renamed over it once synced, so a
+/// container loaded from `path` may be saved back to it.
+/// \param serialize Serializer for the elements.
+/// \return Returns `CHASHSET_SUCCESS` on success, `CHASHSET_IO_FAILURE` if
+/// the file could not be written, or another error code on invalid input.
+/// \note Only available on POSIX systems.
+int CHashSet_save(const CHashSet_t *set, const char *path,
+                  SerializeFn serialize);
+
+/// \brief Load a hash set from a snapshot written by `CHashSet_save`.
+/// \details The file is mapped and its table used in place without rehashing.
+/// Elements point at their serialized bytes inside the mapping and are never
+/// passed to `destroy`, which only applies to elements added afterwards. The
+/// hash function must give the serialized bytes the same hash the original
+/// elements had.
+/// \param path Path of the snapshot.
+/// \param hash The hash function to use for element indexing.
+/// \param cmp The comparator for the elements.
+/// \param destroy The destructor for elements added after loading, or `NULL`.
+/// \return Returns a pointer to `CResult` containing the hash set, or an error
+/// with `CHASHSET_IO_FAILURE` or `CHASHSET_INVALID_SNAPSHOT`.
+/// \note Only available on POSIX systems.
+CResult_t *CHashSet_load(const char *path, CompareTo cmp, Hash hash,
+                         Destructor destroy);
+
 #ifdef __cplusplus
 }
 #endif
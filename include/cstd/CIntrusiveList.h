@@ -0,0 +1,230 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CIntrusiveList.h
+/// \brief Header file for the CIntrusiveList implementation.
+///
+/// An intrusive list links objects through a `CListLink_t` embedded in them,
+/// instead of allocating a node per element the way `CLinkedList` does.
+/// Adding and removing never allocate and cannot fail for lack of memory,
+/// and walking the list touches the objects alone. `CLISTLINK_ENTRY` gets an
+/// object back from its link.
+///
+/// \code
+/// typedef struct {
+///     int fd;
+///     CListLink_t idle; // Links the connection on the idle list.
+/// } Connection;
+///
+/// CIntrusiveList_push_back(&idle, &connection->idle);
+/// CINTRUSIVELIST_FOREACH(&idle, link) {
+///     Connection *c = CLISTLINK_ENTRY(link, Connection, idle);
+///     ...
+/// }
+/// \endcode
+///
+/// \note The list does not own its elements and never frees them. An object
+/// can be on as many lists as it has links, but each link is on one list at
+/// most. Functions taking a list and a link expect the link to be on that
+/// list, which is not checked.
+#ifndef CSTD_CINTRUSIVELIST_H
+#define CSTD_CINTRUSIVELIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/// \brief Error code indicating that a list or link pointer is null.
+#define CINTRUSIVELIST_NULL -2
+
+/// \brief Error code indicating that a link is not on a list.
+#define CINTRUSIVELIST_NOT_LINKED -1
+
+/// \brief Success code for operations.
+#define CINTRUSIVELIST_SUCCESS 0
+
+/// \brief Error code indicating that a link is already on a list.
+#define CINTRUSIVELIST_ALREADY_LINKED 1
+
+/// \struct CListLink
+/// \brief Link embedded in the objects of a `CIntrusiveList`.
+/// \details A link is not on a list when both its fields are `NULL`, so
+/// zeroed memory holds valid links. The fields are private.
+typedef struct CListLink {
+    struct CListLink *next; ///< Next link, or the list head.
+    struct CListLink *prev; ///< Previous link, or the list head.
+} CListLink_t;
+
+/// \struct CIntrusiveList
+/// \brief Circular doubly linked list of `CListLink_t`.
+/// \details The list is meant to be embedded or allocated by the user, and
+/// must be initialized with `CIntrusiveList_init`. The fields are private.
+typedef struct CIntrusiveList {
+    CListLink_t head; ///< Sentinel, linked to the first and last links.
+    size_t size;      ///< Number of links.
+} CIntrusiveList_t;
+
+/// \def CLISTLINK_ENTRY
+/// \brief Get the object a link is embedded in.
+/// \param link Pointer to the link.
+/// \param type Type of the object.
+/// \param member Name of the `CListLink_t` field in `type`.
+#define CLISTLINK_ENTRY(link, type, member)                                    \
+    ((type *)((char *)(link) - offsetof(type, member)))
+
+/// \def CINTRUSIVELIST_FOREACH
+/// \brief Loop over the links of a list, from the first.
+/// \details The loop body must not remove `link` from the list; use
+/// `CINTRUSIVELIST_FOREACH_SAFE` for that.
+/// \param list Pointer to the list.
+/// \param link Name of the `CListLink_t *` variable declared by the loop.
+#define CINTRUSIVELIST_FOREACH(list, link)                                     \
+    for (CListLink_t *link = (list)->head.next; link != &(list)->head;         \
+         link = link->next)
+
+/// \def CINTRUSIVELIST_FOREACH_SAFE
+/// \brief Loop over the links of a list, allowing the body to remove `link`.
+/// \param list Pointer to the list.
+/// \param link Name of the `CListLink_t *` variable declared by the loop.
+/// \param tmp Name of a second variable declared by the loop.
+#define CINTRUSIVELIST_FOREACH_SAFE(list, link, tmp)                           \
+    for (CListLink_t *link = (list)->head.next, *tmp = link->next;             \
+         link != &(list)->head; link = tmp, tmp = link->next)
+
+/// \brief Initialize a list, empty.
+/// \param list Pointer to the list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or `CINTRUSIVELIST_NULL`.
+int CIntrusiveList_init(CIntrusiveList_t *list);
+
+/// \brief Initialize a link, off any list.
+/// \details Not needed for links in zeroed memory.
+/// \param link Pointer to the link.
+void CListLink_init(CListLink_t *link);
+
+/// \brief Check whether a link is on a list.
+/// \param link Pointer to the link.
+/// \return Non-zero if the link is on a list, 0 otherwise.
+int CListLink_is_linked(const CListLink_t *link);
+
+/// \brief Get the number of links on the list.
+/// \param list Pointer to the list.
+/// \return The number of links, 0 if `list` is `NULL`.
+size_t CIntrusiveList_size(const CIntrusiveList_t *list);
+
+/// \brief Add a link at the front of the list.
+/// \param list Pointer to the list.
+/// \param link Pointer to the link, not on any list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or an error code if either
+/// pointer is null or the link is already on a list.
+int CIntrusiveList_push_front(CIntrusiveList_t *list, CListLink_t *link);
+
+/// \brief Add a link at the back of the list.
+/// \param list Pointer to the list.
+/// \param link Pointer to the link, not on any list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or an error code if either
+/// pointer is null or the link is already on a list.
+int CIntrusiveList_push_back(CIntrusiveList_t *list, CListLink_t *link);
+
+/// \brief Add a link before another one.
+/// \param list Pointer to the list holding `position`.
+/// \param position Pointer to a link on the list.
+/// \param link Pointer to the link, not on any list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or an error code if a pointer
+/// is null, `position` is not on a list or `link` is already on one.
+int CIntrusiveList_insert_before(CIntrusiveList_t *list, CListLink_t *position,
+                                 CListLink_t *link);
+
+/// \brief Add a link after another one.
+/// \param list Pointer to the list holding `position`.
+/// \param position Pointer to a link on the list.
+/// \param link Pointer to the link, not on any list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or an error code if a pointer
+/// is null, `position` is not on a list or `link` is already on one.
+int CIntrusiveList_insert_after(CIntrusiveList_t *list, CListLink_t *position,
+                                CListLink_t *link);
+
+/// \brief Remove a link from the list, in constant time.
+/// \details The link is left off any list, ready to be added again.
+/// \param list Pointer to the list holding the link.
+/// \param link Pointer to the link.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or an error code if either
+/// pointer is null or the link is not on a list.
+int CIntrusiveList_remove(CIntrusiveList_t *list, CListLink_t *link);
+
+/// \brief Remove the first link of the list.
+/// \param list Pointer to the list.
+/// \return The link, off any list, or `NULL` if the list is empty.
+CListLink_t *CIntrusiveList_pop_front(CIntrusiveList_t *list);
+
+/// \brief Remove the last link of the list.
+/// \param list Pointer to the list.
+/// \return The link, off any list, or `NULL` if the list is empty.
+CListLink_t *CIntrusiveList_pop_back(CIntrusiveList_t *list);
+
+/// \brief Get the first link of the list.
+/// \param list Pointer to the list.
+/// \return The link, or `NULL` if the list is empty.
+CListLink_t *CIntrusiveList_front(const CIntrusiveList_t *list);
+
+/// \brief Get the last link of the list.
+/// \param list Pointer to the list.
+/// \return The link, or `NULL` if the list is empty.
+CListLink_t *CIntrusiveList_back(const CIntrusiveList_t *list);
+
+/// \brief Get the link after another one.
+/// \param list Pointer to the list holding the link.
+/// \param link Pointer to a link on the list.
+/// \return The next link, or `NULL` if `link` is the last one.
+CListLink_t *CIntrusiveList_next(const CIntrusiveList_t *list,
+                                 const CListLink_t *link);
+
+/// \brief Get the link before another one.
+/// \param list Pointer to the list holding the link.
+/// \param link Pointer to a link on the list.
+/// \return The previous link, or `NULL` if `link` is the first one.
+CListLink_t *CIntrusiveList_prev(const CIntrusiveList_t *list,
+                                 const CListLink_t *link);
+
+/// \brief Move all the links of `source` to the back of `list`.
+/// \details Takes constant time. `source` is left empty.
+/// \param list Pointer to the list receiving the links.
+/// \param source Pointer to the list giving them.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or `CINTRUSIVELIST_NULL`.
+int CIntrusiveList_splice(CIntrusiveList_t *list, CIntrusiveList_t *source);
+
+/// \brief Remove all the links of the list.
+/// \details Takes time linear in the size of the list, to leave every link
+/// off any list. The objects are not touched otherwise.
+/// \param list Pointer to the list.
+/// \return Returns `CINTRUSIVELIST_SUCCESS`, or `CINTRUSIVELIST_NULL`.
+int CIntrusiveList_clear(CIntrusiveList_t *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CINTRUSIVELIST_H
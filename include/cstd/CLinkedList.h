@@ -86,12 +86,39 @@ extern "C" {
 /// fails.
 #define CLINKEDLIST_ALLOC_FAILURE 1
 
+/// \brief Error code indicating that an operation cannot be done with the
+/// arguments it was given.
+/// \details This code is returned when sorting without a comparison
+/// function, or when splicing lists of different types or a list into
+/// itself.
+#define CLINKEDLIST_INVALID_OPERATION 2
+
 /// \struct CLinkedList
 /// \brief Structure representing a doubly linked list.
 /// \details The linked list maintains pointers to the head and tail nodes,
 /// and supports operations like adding, removing, and retrieving elements.
 typedef struct _CLinkedList CLinkedList_t;
 
+/// \struct CListNode
+/// \brief Handle on an element of a `CLinkedList`.
+/// \details Handles stay valid until their element is removed, whatever else
+/// happens to the list.
+typedef struct _CListNode CListNode_t;
+
+/// \struct CListCursor
+/// \brief Position in a `CLinkedList`, used to walk and edit it in place.
+/// \details A cursor is either on an element, or in a gap between two
+/// elements (or before the first, or after the last). A new cursor sits
+/// before the first element, and removing the element under a cursor leaves
+/// it in the gap where the element was. Cursors need no allocation and are
+/// invalidated by changes made to the list other than through them.
+/// The fields are private.
+typedef struct CListCursor {
+    CLinkedList_t *list; ///< The list.
+    CListNode_t *node;   ///< Element under the cursor, NULL in a gap.
+    CListNode_t *prev;   ///< Element before the cursor, NULL at the front.
+} CListCursor_t;
+
 /// \brief Create a new linked list.
 /// \param list_type Specifies the type of the list(Singly or Doubly). Use the
 /// `CLINKEDLIST_TYPE_SINGLE` nad `CLINKEDLIST_TYPE_DOUBLE` macros for this.
@@ -166,6 +193,128 @@ CResult_t *CLinkedList_clone(const CLinkedList_t *source, CloneFn cloner);
 /// \return The size of the list (number of elements).
 size_t CLinkedList_size(const CLinkedList_t *list);
 
+/// \brief Add an element to the end of the list and get a handle on it.
+/// \param list Pointer to the `CLinkedList` structure.
+/// \param element Pointer to the element to be added.
+/// \param node Receives the handle on the element. May be `NULL`.
+/// \return Returns `CLINKEDLIST_SUCCESS` on success, or an error code if
+/// the operation fails (e.g., memory allocation failure).
+int CLinkedList_add_node(CLinkedList_t *list, void *element,
+                         CListNode_t **node);
+
+/// \brief Remove an element through its handle.
+/// \details Takes constant time on doubly linked lists; singly linked lists
+/// have to look for the previous element. As with `CLinkedList_remove`, the
+/// element itself is not destroyed.
+/// \param list Pointer to the `CLinkedList` structure holding the element.
+/// \param node Handle on the element, invalid afterwards.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or `CLINKEDLIST_NULL_LIST`.
+int CLinkedList_remove_node(CLinkedList_t *list, CListNode_t *node);
+
+/// \brief Get the element behind a handle.
+/// \param node Handle on the element.
+/// \return The element, or `NULL` if `node` is `NULL`.
+void *CListNode_value(const CListNode_t *node);
+
+/// \brief Get a cursor before the first element of the list.
+/// \param list Pointer to the `CLinkedList` structure.
+/// \return The cursor.
+CListCursor_t CLinkedList_cursor(CLinkedList_t *list);
+
+/// \brief Get a cursor on an element.
+/// \details Takes constant time on doubly linked lists; singly linked lists
+/// have to look for the previous element.
+/// \param list Pointer to the `CLinkedList` structure holding the element.
+/// \param node Handle on the element.
+/// \return The cursor.
+CListCursor_t CLinkedList_cursor_at(CLinkedList_t *list, CListNode_t *node);
+
+/// \brief Move the cursor to the next element.
+/// \param cursor Pointer to the cursor.
+/// \return Non-zero if the cursor is on an element, or 0 if it went past the
+/// last one, in which case it stays after it.
+int CListCursor_next(CListCursor_t *cursor);
+
+/// \brief Move the cursor to the previous element.
+/// \details Singly linked lists have to look for the previous element from
+/// the front.
+/// \param cursor Pointer to the cursor.
+/// \return Non-zero if the cursor is on an element, or 0 if it went past the
+/// first one, in which case it stays before it.
+int CListCursor_prev(CListCursor_t *cursor);
+
+/// \brief Get the element under the cursor.
+/// \param cursor Pointer to the cursor.
+/// \return The element, or `NULL` if the cursor is in a gap.
+void *CListCursor_value(const CListCursor_t *cursor);
+
+/// \brief Get a handle on the element under the cursor.
+/// \param cursor Pointer to the cursor.
+/// \return The handle, or `NULL` if the cursor is in a gap.
+CListNode_t *CListCursor_node(const CListCursor_t *cursor);
+
+/// \brief Insert an element before the cursor.
+/// \details The cursor stays where it is, now after the new element.
+/// \param cursor Pointer to the cursor.
+/// \param element Pointer to the element to be added.
+/// \return Returns `CLINKEDLIST_SUCCESS` on success, or an error code if
+/// the operation fails (e.g., memory allocation failure).
+int CListCursor_insert_before(CListCursor_t *cursor, void *element);
+
+/// \brief Insert an element after the cursor.
+/// \details The cursor stays where it is, now before the new element, which
+/// `CListCursor_next` moves to.
+/// \param cursor Pointer to the cursor.
+/// \param element Pointer to the element to be added.
+/// \return Returns `CLINKEDLIST_SUCCESS` on success, or an error code if
+/// the operation fails (e.g., memory allocation failure).
+int CListCursor_insert_after(CListCursor_t *cursor, void *element);
+
+/// \brief Remove the element under the cursor, in constant time.
+/// \details The cursor is left in the gap where the element was. As with
+/// `CLinkedList_remove`, the element itself is not destroyed.
+/// \param cursor Pointer to the cursor.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or
+/// `CLINKEDLIST_INDEX_OUT_OF_BOUNDS` if the cursor is in a gap.
+int CListCursor_remove_here(CListCursor_t *cursor);
+
+/// \brief Sort the list in place.
+/// \details A bottom-up merge sort that relinks the nodes, so it allocates
+/// nothing, takes O(n log n) time, and keeps node handles valid. The sort is
+/// stable: equal elements keep their order.
+/// \param list Pointer to the `CLinkedList` structure.
+/// \param cmp The function pointer to compare the elements.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or an error code if `list` or `cmp`
+/// is `NULL`.
+int CLinkedList_sort(CLinkedList_t *list, CompareTo cmp);
+
+/// \brief Move all the elements of another list into this one, after an
+/// element.
+/// \details Takes constant time: the nodes of `other` are linked into `list`
+/// as they are, and their handles stay valid. `other` is left empty, and the
+/// elements moved are destroyed with the destructor of `list` from then on.
+/// \param list Pointer to the `CLinkedList` structure receiving the elements.
+/// \param after Handle on the element of `list` to insert after, or `NULL`
+/// to insert at the front.
+/// \param other Pointer to the list giving its elements, of the same type.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or an error code if a list is
+/// `NULL`, or the lists are the same or of different types.
+int CLinkedList_splice(CLinkedList_t *list, CListNode_t *after,
+                       CLinkedList_t *other);
+
+/// \brief Move all the elements of another list to the end of this one.
+/// \details Takes constant time, see `CLinkedList_splice`.
+/// \param list Pointer to the `CLinkedList` structure receiving the elements.
+/// \param other Pointer to the list giving its elements, of the same type.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or an error code if a list is
+/// `NULL`, or the lists are the same or of different types.
+int CLinkedList_concat(CLinkedList_t *list, CLinkedList_t *other);
+
+/// \brief Reverse the order of the elements of the list, in place.
+/// \param list Pointer to the `CLinkedList` structure.
+/// \return Returns `CLINKEDLIST_SUCCESS`, or `CLINKEDLIST_NULL_LIST`.
+int CLinkedList_reverse(CLinkedList_t *list);
+
 #ifdef __cplusplus
 }
 #endif
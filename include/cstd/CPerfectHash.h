@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CPerfectHash.h
+/// \brief Header file for the CPerfectHash implementation.
+///
+/// This file defines a minimal perfect hash function over a static set of
+/// keys. Each of the `n` keys maps to its own index in `[0, n)`, so values
+/// can be stored in a plain array with no empty slots and found without
+/// probing. Keys outside the set also map somewhere in `[0, n)`, so a lookup
+/// that may miss needs exactly one key comparison to confirm the hit.
+///
+/// Construction follows PTHash: keys are spread over buckets, with the
+/// largest buckets placed first, and each bucket stores a small "pilot" that
+/// is mixed into the hash until all of its keys land on free positions. The
+/// table is 2% larger than the key set to keep the search short, and the few
+/// positions past `n` are remapped into the holes below it. The result takes
+/// a few bits per key.
+///
+/// The function only stores pilots, never the keys, and is built on top of
+/// the user's `Hash` function, which must not give two keys the same hash.
+#ifndef CSTD_CPERFECTHASH_H
+#define CSTD_CPERFECTHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CVector.h"
+#include "Operators.h"
+#include <stddef.h>
+
+/// \brief Error code indicating that a required pointer is null.
+#define CPERFECTHASH_NULL_VAL -2
+
+/// \brief Success code for operations.
+#define CPERFECTHASH_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CPERFECTHASH_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that two keys have the same hash, usually
+/// because the same key was given twice.
+#define CPERFECTHASH_DUPLICATE_KEYS 2
+
+/// \brief Error code indicating that no function could be found. This does
+/// not happen in practice with a reasonable hash function.
+#define CPERFECTHASH_BUILD_FAILURE 3
+
+/// \brief Error code indicating that a buffer does not hold a serialized
+/// function.
+#define CPERFECTHASH_INVALID_FORMAT 4
+
+/// \struct CPerfectHash
+/// \brief Structure representing a minimal perfect hash function.
+typedef struct _CPerfectHash CPerfectHash_t;
+
+/// \brief Build a minimal perfect hash function over a set of keys.
+/// \param keys Vector of the keys. Only read during the call.
+/// \param hash Hash function for the keys, such as `chash_string` or
+/// `chash_cstring`.
+/// \return A `CResult_t*` containing the function, or an error with
+/// `CPERFECTHASH_DUPLICATE_KEYS` if two keys hash alike.
+CResult_t *CPerfectHash_build(const CVector_t *keys, Hash hash);
+
+/// \brief Retrieve the number of keys the function was built over.
+/// \param ph Pointer to the function.
+/// \return The number of keys, or 0 if `ph` is `NULL`.
+size_t CPerfectHash_size(const CPerfectHash_t *ph);
+
+/// \brief Map a key to its index.
+/// \param ph Pointer to the function.
+/// \param key The key.
+/// \return The index of `key` in `[0, n)`, different for every key of the
+/// set. Keys outside the set map to an arbitrary index in the same range, or
+/// to 0 if the set is empty.
+size_t CPerfectHash_index(const CPerfectHash_t *ph, const void *key);
+
+/// \brief Serialize the function into a compact, position-independent form.
+/// \details Follows the `SerializeFn` convention and can be used as one.
+/// \param ph Pointer to the function.
+/// \param buffer Buffer to write into.
+/// \param size Size of `buffer` in bytes.
+/// \return The number of bytes needed. Nothing is written if this exceeds
+/// `size`.
+size_t CPerfectHash_serialize(const void *ph, void *buffer, size_t size);
+
+/// \brief Recreate a function from its serialized form.
+/// \param buffer Bytes produced by `CPerfectHash_serialize`.
+/// \param size Number of bytes in `buffer`.
+/// \param hash The hash function the original was built with.
+/// \return A `CResult_t*` containing the function, or an error with
+/// `CPERFECTHASH_INVALID_FORMAT`.
+CResult_t *CPerfectHash_deserialize(const void *buffer, size_t size,
+                                    Hash hash);
+
+/// \brief Free the function.
+/// \param ph Pointer to the function pointer, set to `NULL` afterwards.
+/// \return `CPERFECTHASH_SUCCESS`, including when `ph` is `NULL`.
+int CPerfectHash_free(CPerfectHash_t **ph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CPERFECTHASH_H
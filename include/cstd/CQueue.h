@@ -27,7 +27,7 @@
 /// \brief Header file for the CQueue implementation.
 ///
 /// This file defines the functions for managing a queue data structure.
-/// The queue is implemented using a linked list. The `CQueue_t` structure
+/// The queue is implemented using a `CDeque`. The `CQueue_t` structure
 /// maintains the elements of the queue and provides operations for adding,
 /// removing, and clearing elements.
 ///
@@ -53,9 +53,10 @@ extern "C" {
 
 /// \brief Opaque structure representing a queue.
 ///
-/// The queue is implemented using a linked list. Each element in the queue
-/// is linked to the next element. The front and rear pointers are used
-/// to manage the flow of elements.
+/// The queue is implemented using a `CDeque`, which stores the elements in
+/// blocks of 64 and reuses them as elements flow through the queue. Blocks
+/// emptied by pops are freed beyond two spares, so a queue that shrinks
+/// after a spike gives its memory back, apart from its block map.
 typedef struct _CQueue CQueue_t;
 
 /// \brief Error code indicating the queue was successfully created.
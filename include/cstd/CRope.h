@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CRope.h
+/// \brief Header file for the CRope implementation.
+///
+/// This file defines a rope: a string stored as a balanced binary tree whose
+/// leaves hold chunks of up to `CROPE_LEAF_SIZE` characters. Inserting,
+/// deleting and extracting substrings anywhere in the text take O(log n)
+/// time instead of moving every character after the edit, and two ropes are
+/// concatenated in O(log n) time as well.
+///
+/// The nodes of the tree are immutable and reference counted, so substrings,
+/// clones and concatenations share their chunks with the rope they came from.
+/// The characters are read back one contiguous chunk at a time with
+/// `CRope_iter`, which maps directly onto scatter/gather output such as
+/// `writev`.
+///
+/// \note The functions in this header are intended to be used with dynamic
+/// memory allocation and require error checking to ensure successful memory
+/// operations.
+#ifndef CSTD_CROPE_H
+#define CSTD_CROPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CString.h"
+#include "CStringView.h"
+#include <stddef.h>
+
+/// \brief Maximum number of characters held by a single leaf.
+/// \details Edits copy at most one leaf, and small neighbouring leaves are
+/// merged as long as the result fits.
+#define CROPE_LEAF_SIZE 1024
+
+/// \brief Maximum height of a rope's tree, bounding the iterator's stack.
+#define CROPE_MAX_HEIGHT 96
+
+/// \brief Error code indicating that the rope pointer is null.
+#define CROPE_NULL_ROPE -2
+
+/// \brief Error code indicating that a position lies outside of the rope.
+#define CROPE_INDEX_OUT_OF_BOUNDS -1
+
+/// \brief Success code for operations.
+#define CROPE_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+/// \details The rope is left unchanged when an operation fails.
+#define CROPE_ALLOC_FAILURE 1
+
+/// \struct CRope
+/// \brief Structure representing a rope.
+typedef struct _CRope CRope_t;
+
+/// \struct CRopeIter
+/// \brief Iterator yielding the chunks of a rope in order.
+/// \details The iterator is a plain value and allocates no memory. Its fields
+/// are internal and should not be accessed directly.
+typedef struct CRopeIter {
+    const struct _CRopeNode *stack[CROPE_MAX_HEIGHT]; ///< Pending subtrees.
+    size_t depth; ///< Number of subtrees on the stack.
+} CRopeIter_t;
+
+/// \brief Create a new, empty rope.
+/// \return A `CResult_t*` containing the new `CRope_t` on success, or an error
+/// if memory allocation failed. Free the rope with `CRope_free`.
+CResult_t *CRope_new();
+
+/// \brief Create a rope holding a copy of the characters of a view.
+/// \param view The characters to copy.
+/// \return A `CResult_t*` containing the new `CRope_t` on success, or an error
+/// if memory allocation failed.
+CResult_t *CRope_from_view(CStringView_t view);
+
+/// \brief Create a rope holding a copy of the characters of a CString.
+/// \param string Pointer to the `CString` to copy.
+/// \return A `CResult_t*` containing the new `CRope_t` on success, or an error
+/// if `string` is NULL or memory allocation failed.
+CResult_t *CRope_from_cstring(const CString_t *string);
+
+/// \brief Initialize a rope as empty.
+/// \param rope Pointer to the rope to initialize.
+/// \return `CROPE_SUCCESS`, or `CROPE_NULL_ROPE` if `rope` is NULL.
+int CRope_init(CRope_t *rope);
+
+/// \brief Get the number of characters in the rope.
+/// \param rope Pointer to the rope.
+/// \return The length of the rope, or 0 if `rope` is NULL.
+size_t CRope_length(const CRope_t *rope);
+
+/// \brief Get the character at a position.
+/// \param rope Pointer to the rope.
+/// \param index Position of the character.
+/// \return The character, or `'\0'` if `rope` is NULL or `index` is out of
+/// bounds. Takes O(log n) time.
+char CRope_at(const CRope_t *rope, size_t index);
+
+/// \brief Insert characters at a position.
+/// \param rope Pointer to the rope.
+/// \param index Position to insert at, at most `CRope_length(rope)`.
+/// \param view The characters to insert. They are copied.
+/// \return `CROPE_SUCCESS`, `CROPE_NULL_ROPE`, `CROPE_INDEX_OUT_OF_BOUNDS` or
+/// `CROPE_ALLOC_FAILURE`.
+int CRope_insert(CRope_t *rope, size_t index, CStringView_t view);
+
+/// \brief Append characters to the end of the rope.
+/// \param rope Pointer to the rope.
+/// \param view The characters to append. They are copied.
+/// \return `CROPE_SUCCESS`, `CROPE_NULL_ROPE` or `CROPE_ALLOC_FAILURE`.
+int CRope_append(CRope_t *rope, CStringView_t view);
+
+/// \brief Prepend characters to the start of the rope.
+/// \param rope Pointer to the rope.
+/// \param view The characters to prepend. They are copied.
+/// \return `CROPE_SUCCESS`, `CROPE_NULL_ROPE` or `CROPE_ALLOC_FAILURE`.
+int CRope_prepend(CRope_t *rope, CStringView_t view);
+
+/// \brief Delete the characters in `[start, end)`.
+/// \param rope Pointer to the rope.
+/// \param start Position of the first character to delete.
+/// \param end Position one past the last character to delete.
+/// \return `CROPE_SUCCESS`, `CROPE_NULL_ROPE`, `CROPE_INDEX_OUT_OF_BOUNDS` if
+/// `start > end` or `end > CRope_length(rope)`, or `CROPE_ALLOC_FAILURE`.
+int CRope_delete(CRope_t *rope, size_t start, size_t end);
+
+/// \brief Append the contents of another rope.
+/// \details The chunks of `other` are shared rather than copied, so this takes
+/// O(log n) time regardless of the length of `other`.
+/// \param rope Pointer to the rope to append to.
+/// \param other Pointer to the rope to append. It is left unchanged, and may
+/// be `rope` itself.
+/// \return `CROPE_SUCCESS`, `CROPE_NULL_ROPE` or `CROPE_ALLOC_FAILURE`.
+int CRope_concat(CRope_t *rope, const CRope_t *other);
+
+/// \brief Extract the characters in `[start, end)` as a new rope.
+/// \details The new rope shares its chunks with `rope`, apart from the at most
+/// two leaves the range cuts through.
+/// \param rope Pointer to the rope.
+/// \param start Position of the first character.
+/// \param end Position one past the last character.
+/// \return A `CResult_t*` containing the new `CRope_t`, or an error if `rope`
+/// is NULL, the range is out of bounds or memory allocation failed.
+CResult_t *CRope_substring(const CRope_t *rope, size_t start, size_t end);
+
+/// \brief Create a copy of the rope in constant time.
+/// \param rope Pointer to the rope to copy.
+/// \return A `CResult_t*` containing the new `CRope_t`, or an error if `rope`
+/// is NULL or memory allocation failed.
+CResult_t *CRope_clone(const CRope_t *rope);
+
+/// \brief Copy the characters of the rope into a new CString.
+/// \param rope Pointer to the rope.
+/// \return A `CResult_t*` containing the new `CString_t`, or an error if `rope`
+/// is NULL or memory allocation failed. Free it with `CString_free`.
+CResult_t *CRope_to_cstring(const CRope_t *rope);
+
+/// \brief Create an iterator over the chunks of the rope.
+/// \param rope Pointer to the rope. A NULL rope yields no chunks.
+/// \return The iterator, to be advanced with `CRopeIter_next`.
+///
+/// \note The rope must not be modified or freed while iterating.
+CRopeIter_t CRope_iter(const CRope_t *rope);
+
+/// \brief Retrieve the next chunk from the iterator.
+/// \param iter Pointer to the iterator.
+/// \param chunk Receives a view of the next chunk, which is never empty.
+/// \return Returns 1 if a chunk was produced, 0 once the rope is exhausted.
+int CRopeIter_next(CRopeIter_t *iter, CStringView_t *chunk);
+
+/// \brief Release the characters of the rope, leaving it empty.
+/// \param rope Pointer to the rope.
+/// \return `CROPE_SUCCESS`, or `CROPE_NULL_ROPE` if `rope` is NULL.
+int CRope_clear(CRope_t *rope);
+
+/// \brief Free the rope and its characters.
+/// \param rope Pointer to the pointer to the rope; set to NULL afterwards.
+/// \return `CROPE_SUCCESS`. Freeing a NULL rope does nothing.
+int CRope_free(CRope_t **rope);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CROPE_H
@@ -41,15 +41,28 @@ extern "C" {
 // VERSION: 1.0.3 (2025/01)
 #define CSTD_VERSION 103202501UL
 
+#include "CAsyncIO.h"
+#include "CBufChain.h"
+#include "CByteBuffer.h"
+#include "CConstMap.h"
+#include "CDeque.h"
+#include "CDiskQueue.h"
 #include "CError.h"
+#include "CFileReader.h"
+#include "CFileWriter.h"
 #include "CHashMap.h"
 #include "CHashSet.h"
+#include "CIntrusiveList.h"
 #include "CLinkedList.h"
 #include "CLog.h"
+#include "CPerfectHash.h"
 #include "CQueue.h"
 #include "CResult.h"
+#include "CRope.h"
+#include "CShmRing.h"
 #include "CStack.h"
 #include "CString.h"
+#include "CStringView.h"
 #include "CVector.h"
 #include "Operators.h"
 
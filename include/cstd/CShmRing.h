@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// \file CShmRing.h
+/// \brief Header file for the CShmRing implementation.
+///
+/// This file defines a single-producer, single-consumer ring buffer of
+/// variable-length records, kept in shared memory so that two processes can
+/// exchange messages without copying them through the kernel. The producer
+/// reserves room for a record, writes it in place and commits it; the
+/// consumer peeks at the record in place and releases it once done.
+///
+/// The read and write positions live on separate cache lines and are the only
+/// state the two sides share. A side that has to wait spins briefly, then
+/// sleeps on a futex that the other side only touches when someone is asleep,
+/// so a busy ring costs no system calls.
+///
+/// A ring is created with `CShmRing_new`, either anonymous (a `memfd`, shared
+/// across `fork` or by passing its descriptor) or named (`shm_open`, opened by
+/// name with `CShmRing_open`).
+///
+/// \note The ring is only available on POSIX platforms. Futex wakeups are
+/// Linux only; elsewhere waiting sides poll. At most one process may produce
+/// and one consume at any time.
+#ifndef CSTD_CSHMRING_H
+#define CSTD_CSHMRING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CStringView.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \brief Error code indicating that the ring pointer is null.
+#define CSHMRING_NULL_RING -3
+
+/// \brief Error code indicating that the ring has no room for the record.
+#define CSHMRING_FULL -2
+
+/// \brief Error code indicating that the ring has no record to read.
+#define CSHMRING_EMPTY -1
+
+/// \brief Success code for operations.
+#define CSHMRING_SUCCESS 0
+
+/// \brief Error code indicating a memory allocation failure.
+#define CSHMRING_ALLOC_FAILURE 1
+
+/// \brief Error code indicating that a system call failed.
+/// \details `errno` describes the failure.
+#define CSHMRING_IO_FAILURE 2
+
+/// \brief Error code indicating that a record can never fit in the ring.
+#define CSHMRING_TOO_LARGE 3
+
+/// \brief Error code indicating that a region is not a ring.
+#define CSHMRING_INVALID_RING 4
+
+/// \brief Timeout that waits for as long as it takes.
+#define CSHMRING_FOREVER -1
+
+/// \struct CShmRing
+/// \brief Structure representing one process' handle on a ring.
+typedef struct _CShmRing CShmRing_t;
+
+/// \brief Create a ring.
+/// \param name Name of the region for `shm_open`, starting with a slash, or
+/// `NULL` for an anonymous region.
+/// \param capacity Number of bytes for records, rounded up to a power of two
+/// of at least 4096. Each record takes 8 bytes more, rounded up to 8.
+/// \return A `CResult_t*` containing the ring, or an error.
+CResult_t *CShmRing_new(const char *name, size_t capacity);
+
+/// \brief Open a named ring created by another process.
+/// \param name Name the ring was created with.
+/// \return A `CResult_t*` containing the ring, or an error with
+/// `CSHMRING_IO_FAILURE` or `CSHMRING_INVALID_RING`.
+CResult_t *CShmRing_open(const char *name);
+
+/// \brief Open a ring from a descriptor, for instance one received over a
+/// UNIX socket.
+/// \param fd Descriptor of the region, duplicated by the call.
+/// \return A `CResult_t*` containing the ring, or an error with
+/// `CSHMRING_IO_FAILURE` or `CSHMRING_INVALID_RING`.
+CResult_t *CShmRing_from_fd(int fd);
+
+/// \brief Get the descriptor of the region, to share it with another process.
+/// \param ring Pointer to the ring.
+/// \return The descriptor, or -1 if `ring` is `NULL`.
+int CShmRing_fd(const CShmRing_t *ring);
+
+/// \brief Get the number of bytes available for records.
+/// \param ring Pointer to the ring.
+/// \return The capacity, or 0 if `ring` is `NULL`.
+size_t CShmRing_capacity(const CShmRing_t *ring);
+
+/// \brief Reserve room for a record.
+/// \details The record is invisible to the consumer until it is committed. A
+/// new reservation replaces one that was not committed.
+/// \param ring Pointer to the ring.
+/// \param size Size of the record.
+/// \param data Receives where to write the record, aligned to 8 bytes.
+/// \param timeout_ns How long to wait for room: 0 to return at once, or
+/// `CSHMRING_FOREVER`.
+/// \return `CSHMRING_SUCCESS`, `CSHMRING_FULL` or `CSHMRING_TOO_LARGE`.
+int CShmRing_reserve(CShmRing_t *ring, size_t size, void **data,
+                     int64_t timeout_ns);
+
+/// \brief Publish the reserved record.
+/// \param ring Pointer to the ring.
+/// \param size Final size of the record, at most the reserved size.
+/// \return `CSHMRING_SUCCESS`, or `CSHMRING_EMPTY` if nothing is reserved.
+int CShmRing_commit(CShmRing_t *ring, size_t size);
+
+/// \brief Copy a record into the ring.
+/// \param ring Pointer to the ring.
+/// \param record The record.
+/// \param timeout_ns As for `CShmRing_reserve`.
+/// \return As for `CShmRing_reserve`.
+int CShmRing_push(CShmRing_t *ring, CStringView_t record, int64_t timeout_ns);
+
+/// \brief Look at the oldest record without consuming it.
+/// \param ring Pointer to the ring.
+/// \param record Receives a view of the record inside the ring, valid until
+/// it is released.
+/// \param timeout_ns How long to wait for a record: 0 to return at once, or
+/// `CSHMRING_FOREVER`.
+/// \return `CSHMRING_SUCCESS` or `CSHMRING_EMPTY`.
+int CShmRing_peek(CShmRing_t *ring, CStringView_t *record, int64_t timeout_ns);
+
+/// \brief Consume the oldest record, handing its room back to the producer.
+/// \param ring Pointer to the ring.
+/// \return `CSHMRING_SUCCESS` or `CSHMRING_EMPTY`.
+int CShmRing_release(CShmRing_t *ring);
+
+/// \brief Unmap the ring and free the handle.
+/// \details The region lives on as long as another process has it open, and
+/// named regions until they are unlinked.
+/// \param ring Pointer to the ring pointer, set to `NULL` afterwards.
+/// \return `CSHMRING_SUCCESS`, including when `ring` is `NULL`.
+int CShmRing_free(CShmRing_t **ring);
+
+/// \brief Remove the name of a named ring.
+/// \param name Name the ring was created with.
+/// \return `CSHMRING_SUCCESS` or `CSHMRING_IO_FAILURE`.
+int CShmRing_unlink(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CSHMRING_H
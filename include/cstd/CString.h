@@ -48,7 +48,9 @@
 extern "C" {
 #endif
 
+#include "CStringView.h"
 #include "CVector.h"
+#include <stdarg.h>
 #include <stdint.h>
 
 /// \brief Default initial capacity for the character vector.
@@ -78,10 +80,15 @@ extern "C" {
 /// fails.
 #define CSTRING_ALLOC_FAILURE 1
 
+/// \brief Error code indicating that the string is not valid UTF-8.
+/// \details This code is returned by the transcoding functions when the string
+/// contains a malformed sequence.
+#define CSTRING_INVALID_UTF8 2
+
 /// \struct CString
 /// \brief Structure representing a string.
-/// \details The `CString` structure uses a dynamic array to store characters.
-/// It supports various
+/// \details The `CString` structure stores its characters in a contiguous,
+/// reference counted buffer that is shared between clones. It supports various
 ///          operations such as initialization, setting, retrieving, appending,
 ///          copying, and clearing.
 typedef struct _CString CString_t;
@@ -164,14 +171,153 @@ int CString_append_c(CString_t *string, const char *str);
 /// appropriate error code will be returned.
 int CString_append(CString_t *string, CString_t *str_to_add);
 
+/// \brief Append `len` characters to the end of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param str Pointer to the characters to be appended. They do not need to
+/// be null-terminated, and may point into `string` itself.
+/// \param len Number of characters to append.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \note The characters are copied with a single `memcpy` after growing the
+/// buffer at most once.
+int CString_append_n(CString_t *string, const char *str, size_t len);
+
+/// \brief Append formatted output to the end of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param format The format string, as for `printf`.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \details The output is formatted straight into the spare capacity of the
+/// string. Only if it does not fit is the buffer grown to the exact size
+/// reported by the first attempt and the output formatted a second time, so
+/// there is never an intermediate buffer.
+int CString_appendf(CString_t *string, const char *format, ...);
+
+/// \brief Append formatted output to the end of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param format The format string, as for `vprintf`.
+/// \param args The arguments for `format`.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \see CString_appendf
+int CString_vappendf(CString_t *string, const char *format, va_list args);
+
+/// \brief Reserve capacity in the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param capacity The number of characters the string should be able to hold
+/// without reallocating.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \note If `capacity` is less than or equal to the current capacity, no
+/// resizing is performed.
+int CString_reserve(CString_t *string, size_t capacity);
+
+/// \brief Append the decimal representation of an unsigned integer to the end
+/// of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param value The integer to append.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \details The digits are written straight into the string's buffer, two at
+/// a time from a lookup table.
+int CString_append_u64(CString_t *string, uint64_t value);
+
+/// \brief Append the decimal representation of a signed integer to the end of
+/// the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param value The integer to append.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \see CString_append_u64
+int CString_append_i64(CString_t *string, int64_t value);
+
+/// \brief Append the shortest representation of a double that parses back to
+/// the same value to the end of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param value The double to append.
+/// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
+/// operation fails.
+///
+/// \details Numbers are written in plain notation (`0.1`, `42`, `1234.5`)
+/// when their decimal exponent is between -6 and 20, and in scientific
+/// notation (`1e+21`, `5e-324`) otherwise. Non-finite values are written as
+/// `nan`, `inf` and `-inf`. Integral values below 2^53 take the integer path.
+/// When several shortest representations parse back to the value, the one
+/// closest to it is used. The digits are computed with the Schubfach
+/// algorithm, without going through `snprintf`.
+int CString_append_double(CString_t *string, double value);
+
+/// \brief Parse the CString object as a signed decimal integer.
+/// \param string Pointer to the `CString` structure.
+/// \param value Pointer to the integer receiving the result.
+/// \return Returns `CSTRINGVIEW_SUCCESS` on success, `CSTRING_NULL_STRING` if
+/// either pointer is NULL, or an error code from `CStringView_parse_i64`.
+int CString_parse_i64(const CString_t *string, int64_t *value);
+
+/// \brief Parse the CString object as a floating-point number.
+/// \param string Pointer to the `CString` structure.
+/// \param value Pointer to the double receiving the result.
+/// \return Returns `CSTRINGVIEW_SUCCESS` on success, `CSTRING_NULL_STRING` if
+/// either pointer is NULL, or an error code from `CStringView_parse_double`.
+int CString_parse_double(const CString_t *string, double *value);
+
+/// \brief Check whether the string holds well-formed UTF-8.
+/// \param string Pointer to the `CString` object.
+/// \return 1 if the string is valid UTF-8, 0 otherwise or if `string` is NULL.
+int CString_validate_utf8(const CString_t *string);
+
+/// \brief Count the code points in the string.
+/// \details The string is assumed to be valid UTF-8; see
+/// `CString_validate_utf8`.
+/// \param string Pointer to the `CString` object.
+/// \return The number of code points, or 0 if `string` is NULL.
+size_t CString_utf8_length(const CString_t *string);
+
+/// \brief Transcode the string into UTF-16.
+/// \param string Pointer to the `CString` object.
+/// \param length If not NULL, receives the number of code units, excluding the
+/// terminator.
+/// \return A `CResult_t*` holding a null-terminated `uint16_t*` on success,
+/// which is freed by destroying the result. On failure it holds
+/// `CSTRING_NULL_STRING`, `CSTRING_ALLOC_FAILURE` or `CSTRING_INVALID_UTF8`.
+CResult_t *CString_to_utf16(const CString_t *string, size_t *length);
+
+/// \brief Decode the string into UTF-32.
+/// \param string Pointer to the `CString` object.
+/// \param length If not NULL, receives the number of code points, excluding
+/// the terminator.
+/// \return A `CResult_t*` holding a null-terminated `uint32_t*` on success,
+/// which is freed by destroying the result. On failure it holds
+/// `CSTRING_NULL_STRING`, `CSTRING_ALLOC_FAILURE` or `CSTRING_INVALID_UTF8`.
+CResult_t *CString_to_utf32(const CString_t *string, size_t *length);
+
+/// \brief Hash the characters of the CString object.
+/// \details The hash equals `CStringView_hash` of the string's view. It is
+/// computed on first use and cached until the string is modified, so repeated
+/// lookups with the same key do not rehash it. Clones share the cache.
+/// \param string Pointer to the `CString` object.
+/// \return The hash of the characters.
+///
+/// \note The cache is atomic, so any number of threads may hash a string that
+/// none of them modifies.
+size_t CString_hash(const CString_t *string);
+
 /// \brief Check if two `CString` objects are equal.
 /// \param str1 Pointer to the first `CString` object.
 /// \param str2 Pointer to the second `CString` object.
 /// \return Returns 1 if they are equal, 0 otherwise.
 ///
-/// \details This function performs a lexicographical comparison of the two
-/// `CString` objects. Ensure both `CString` objects are properly initialized
-/// before calling this function.
+/// \details Strings of different lengths are rejected without looking at
+/// their characters, as are strings whose cached hashes differ (see
+/// `CString_hash`). Otherwise the characters are compared with wide loads.
+/// Ensure both `CString` objects are properly initialized before calling this
+/// function.
 ///
 /// \warning If either of the `CString` objects is NULL or not properly
 /// initialized, the function may return unexpected results.
@@ -197,7 +343,105 @@ int CString_equals(CString_t *str1, CString_t *str2);
 /// returns a result encapsulating an error.
 CResult_t *CString_substring(const CString_t *string, size_t start, size_t end);
 
-/// \brief Create a deep-copy of the CString object.
+/// \brief Get a non-owning view over the characters of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \return Returns a `CStringView` spanning the whole string, or an empty view
+/// if `string` is NULL.
+///
+/// \note No memory is allocated. The view is invalidated by any operation
+/// that modifies or frees `string`.
+CStringView_t CString_view(const CString_t *string);
+
+/// \brief Get a non-owning view over a part of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param start Starting index of the slice (inclusive).
+/// \param end Ending index of the slice (exclusive).
+/// \return Returns a `CStringView` over the characters from `start` to
+/// `end - 1`.
+///
+/// \details Unlike `CString_substring`, this does not copy any characters.
+/// Indices are clamped the same way as in `CStringView_slice`. Use
+/// `CString_from_view` to turn the slice into an owned `CString` when needed.
+CStringView_t CString_slice(const CString_t *string, size_t start, size_t end);
+
+/// \brief Create a new CString object holding a copy of the characters of a
+/// view.
+/// \param view The view to copy the characters from.
+/// \return Returns a `CResult` structure containing the new `CString`, or an
+/// error `CResult` if memory allocation fails.
+///
+/// \note The caller is responsible for freeing the `CResult` and the newly
+/// created `CString` object.
+CResult_t *CString_from_view(CStringView_t view);
+
+/// \brief Find the first occurrence of a substring in the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param needle The substring to search for.
+/// \return Returns the index at which `needle` starts, or
+/// `CSTRINGVIEW_NOT_FOUND` if it is not present or `string` is NULL.
+///
+/// \note The search runs directly on the string's buffer, see
+/// `CStringView_find`.
+size_t CString_find(const CString_t *string, CStringView_t needle);
+
+/// \brief Find the last occurrence of a substring in the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param needle The substring to search for.
+/// \return Returns the index at which the last occurrence of `needle` starts,
+/// or `CSTRINGVIEW_NOT_FOUND` if it is not present or `string` is NULL.
+size_t CString_rfind(const CString_t *string, CStringView_t needle);
+
+/// \brief Check if the CString object contains a substring.
+/// \param string Pointer to the `CString` structure.
+/// \param needle The substring to search for.
+/// \return Returns 1 if `needle` occurs in `string`, 0 otherwise.
+int CString_contains(const CString_t *string, CStringView_t needle);
+
+/// \brief Find the first occurrence of a character in the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \param c The character to search for.
+/// \return Returns the index of the first occurrence of `c`, or
+/// `CSTRINGVIEW_NOT_FOUND` if it is not present or `string` is NULL.
+size_t CString_find_char(const CString_t *string, char c);
+
+/// \brief Find the first character of the CString object that is part of a
+/// set.
+/// \param string Pointer to the `CString` structure.
+/// \param set The characters to search for.
+/// \return Returns the index of the first matching character, or
+/// `CSTRINGVIEW_NOT_FOUND` if there is none or `string` is NULL.
+size_t CString_find_any(const CString_t *string, CStringView_t set);
+
+/// \brief Count the non-overlapping occurrences of a substring in the CString
+/// object.
+/// \param string Pointer to the `CString` structure.
+/// \param needle The substring to count.
+/// \return Returns the number of occurrences, or 0 if `string` is NULL.
+size_t CString_count(const CString_t *string, CStringView_t needle);
+
+/// \brief Create an iterator over the tokens of the CString object separated
+/// by a delimiter.
+/// \param string Pointer to the `CString` structure.
+/// \param delim The delimiter.
+/// \return Returns the iterator, see `CStringView_split_iter`.
+///
+/// \note The tokens are views into `string`, which must not be modified while
+/// iterating.
+CStringSplit_t CString_split_iter(const CString_t *string,
+                                  CStringView_t delim);
+
+/// \brief Create an iterator over the lines of the CString object.
+/// \param string Pointer to the `CString` structure.
+/// \return Returns the iterator, see `CStringView_lines_iter`.
+///
+/// \note The lines are views into `string`, which must not be modified while
+/// iterating.
+CStringSplit_t CString_lines_iter(const CString_t *string);
+
+/// \brief Create a copy of the CString object.
+/// \details The copy shares the source's characters, so cloning takes constant
+/// time regardless of the length. The characters are reference counted, and
+/// whichever string is modified first makes its own copy of them.
 /// \param source Pointer to the source `CString` structure.
 /// \return Returns a pointer to a new `CResult` structure, containing a
 /// `CString` with the copied data, or an error code if the operation fails.
@@ -206,6 +450,10 @@ CResult_t *CString_substring(const CString_t *string, size_t start, size_t end);
 /// object with the same content as the source `CString`. Ensure to free the
 /// `CResult` and the copied `CString` when no longer needed.
 ///
+/// \note The reference count is atomic, so clones may be handed to, modified
+/// and freed by other threads. A single `CString` object must still not be
+/// used by several threads at once.
+///
 /// \warning If the source `CString` is NULL or memory allocation fails, the
 /// function will return an error `CResult`.
 CResult_t *CString_clone(const CString_t *source);
@@ -245,7 +493,8 @@ int CString_set(CString_t *string, char *str);
 ///         - A positive value if `str1` is greater than `str2`.
 ///
 /// \note This function compares two `CString` objects lexicographically based
-/// on the character data they contain. The comparison is case-sensitive. Ensure
+/// on the character data they contain, as unsigned bytes; a string orders
+/// after all of its proper prefixes. The comparison is case-sensitive. Ensure
 /// that both `CString` objects are properly initialized before calling this
 /// function.
 ///
@@ -253,6 +502,18 @@ int CString_set(CString_t *string, char *str);
 /// characters, the function returns `-0x8000000000000000L`.
 int64_t CString_compare(CString_t *str1, CString_t *str2);
 
+/// \brief Check whether the CString object begins with `prefix`.
+/// \param string Pointer to the `CString` structure.
+/// \param prefix The characters to look for.
+/// \return Returns 1 if it does, 0 otherwise.
+int CString_starts_with(const CString_t *string, CStringView_t prefix);
+
+/// \brief Check whether the CString object ends with `suffix`.
+/// \param string Pointer to the `CString` structure.
+/// \param suffix The characters to look for.
+/// \return Returns 1 if it does, 0 otherwise.
+int CString_ends_with(const CString_t *string, CStringView_t suffix);
+
 /// \brief Clear the contents of the CString object.
 /// \param string Pointer to the `CString` structure to be cleared.
 /// \return Returns `CSTRING_SUCCESS` on success, or an error code if the
@@ -287,10 +548,11 @@ int CString_free(CString_t **string);
 /// \brief Convert the contents of a CString object to a wide character string
 /// (wchar_t*).
 ///
-/// This function converts the content of a `CString_t` object into a wide
+/// This function decodes the UTF-8 content of a `CString_t` object into a wide
 /// character string (`wchar_t*`), which can then be used in functions that
-/// expect a wide character encoding. The result is dynamically allocated and
-/// needs to be freed by the caller.
+/// expect a wide character encoding. Wide strings are UTF-32 where `wchar_t`
+/// is 4 bytes, and UTF-16 where it is 2 bytes. The result is dynamically
+/// allocated and is freed by destroying the result.
 ///
 /// \param string A pointer to the `CString_t` structure to be converted.
 ///
@@ -299,7 +561,7 @@ int CString_free(CString_t **string);
 ///         to the converted string.
 ///         - On failure, the `CResult` structure contains an error code
 ///         indicating the reason for failure (e.g., null string, allocation
-///         failure).
+///         failure, invalid UTF-8).
 ///
 /// \note The returned `wchar_t*` string is null-terminated.
 CResult_t *CString_c_wchar_t(CString_t *string);
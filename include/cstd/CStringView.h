@@ -0,0 +1,316 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file CStringView.h
+/// \brief Header file for the CStringView implementation.
+///
+/// This file defines a non-owning, read-only view over a contiguous run of
+/// characters. A view is a plain value (a pointer and a length), so it can be
+/// created, copied and sliced without any memory allocation. Views are usually
+/// obtained from a `CString` via `CString_view` or from a C-style string via
+/// `CStringView_from_c`.
+///
+/// \note A view does not own the characters it refers to. It stays valid only
+/// as long as the underlying storage is alive and left unmodified. Any
+/// operation that modifies a `CString` invalidates the views taken from it.
+#ifndef CSTD_CSTRINGVIEW_H
+#define CSTD_CSTRINGVIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "CResult.h"
+#include "CVector.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \brief Success code for operations.
+/// \details This code is returned when an operation completes successfully.
+#define CSTRINGVIEW_SUCCESS 0
+
+/// \brief Error code indicating that the characters are not a valid number.
+/// \details This code is returned by the parsing functions when the view is
+/// empty, or contains anything besides the number itself.
+#define CSTRINGVIEW_INVALID_NUMBER 1
+
+/// \brief Error code indicating that a number does not fit the target type.
+/// \details This code is returned by the parsing functions when the number is
+/// well-formed but its magnitude is too large.
+#define CSTRINGVIEW_OUT_OF_RANGE 2
+
+/// \brief Error code indicating that the characters are not valid UTF-8.
+/// \details This code is returned by the transcoding functions when the view
+/// contains a malformed, overlong, surrogate or out of range sequence.
+#define CSTRINGVIEW_INVALID_UTF8 3
+
+/// \brief Value returned by the search functions when nothing was found.
+#define CSTRINGVIEW_NOT_FOUND ((size_t)-1)
+
+/// \struct CStringView
+/// \brief Structure representing a non-owning view over characters.
+/// \details The characters are not required to be null-terminated, and may
+/// contain embedded null characters.
+typedef struct CStringView {
+    const char *ptr; ///< Pointer to the first character of the view.
+    size_t len;      ///< Number of characters in the view.
+} CStringView_t;
+
+/// \brief Create a view over a null-terminated C-style string.
+/// \param str Pointer to the C-style string. May be NULL, in which case an
+/// empty view is returned.
+/// \return Returns a view spanning `str` without its null terminator.
+CStringView_t CStringView_from_c(const char *str);
+
+/// \brief Create a view over `len` characters starting at `ptr`.
+/// \param ptr Pointer to the first character.
+/// \param len Number of characters in the view.
+/// \return Returns the view.
+CStringView_t CStringView_from(const char *ptr, size_t len);
+
+/// \brief Get a view over a part of another view.
+/// \param view The view to slice.
+/// \param start Starting index of the slice (inclusive).
+/// \param end Ending index of the slice (exclusive).
+/// \return Returns a view over the characters from `start` to `end - 1`.
+///
+/// \note Indices past the end of the view are clamped to its length, and an
+/// empty view is returned if `start` is greater than or equal to `end`. No
+/// memory is allocated.
+CStringView_t CStringView_slice(CStringView_t view, size_t start, size_t end);
+
+/// \brief Check if two views hold the same characters.
+/// \param view1 The first view.
+/// \param view2 The second view.
+/// \return Returns 1 if they are equal, 0 otherwise.
+int CStringView_equals(CStringView_t view1, CStringView_t view2);
+
+/// \brief Compare two views lexicographically.
+/// \details Characters are compared as unsigned bytes, and a view that is a
+/// proper prefix of the other orders first.
+/// \param view1 The first view.
+/// \param view2 The second view.
+/// \return -1, 0 or 1 if `view1` orders before, equal to or after `view2`.
+int CStringView_compare(CStringView_t view1, CStringView_t view2);
+
+/// \brief Check whether the view begins with `prefix`.
+/// \param view The view to check.
+/// \param prefix The characters to look for.
+/// \return Returns 1 if it does, 0 otherwise. Every view starts with an empty
+/// prefix.
+int CStringView_starts_with(CStringView_t view, CStringView_t prefix);
+
+/// \brief Check whether the view ends with `suffix`.
+/// \param view The view to check.
+/// \param suffix The characters to look for.
+/// \return Returns 1 if it does, 0 otherwise. Every view ends with an empty
+/// suffix.
+int CStringView_ends_with(CStringView_t view, CStringView_t suffix);
+
+/// \brief Length of the longest common prefix of two views.
+/// \param view1 The first view.
+/// \param view2 The second view.
+/// \return The number of leading characters the views have in common.
+size_t CStringView_common_prefix(CStringView_t view1, CStringView_t view2);
+
+/// \brief Hash the characters of a view.
+/// \param view The view to hash.
+/// \return A `size_t` value representing the hash of the characters.
+///
+/// \details The characters are consumed a word at a time, so long keys hash
+/// considerably faster than with a byte-wise hash. Equal views always produce
+/// equal hashes, regardless of where their characters are stored.
+size_t CStringView_hash(CStringView_t view);
+
+/// \brief Find the first occurrence of a character in a view.
+/// \param view The view to search in.
+/// \param c The character to search for.
+/// \return Returns the index of the first occurrence of `c`, or
+/// `CSTRINGVIEW_NOT_FOUND` if it is not present.
+///
+/// \details The view is scanned a vector register at a time when SSE2 or AVX2
+/// is available, falling back to a scalar scan otherwise.
+size_t CStringView_find_char(CStringView_t view, char c);
+
+/// \brief Find the first occurrence of a substring in a view.
+/// \param view The view to search in.
+/// \param needle The substring to search for.
+/// \return Returns the index at which `needle` starts, or
+/// `CSTRINGVIEW_NOT_FOUND` if it is not present. An empty `needle` is found at
+/// index 0.
+///
+/// \details Candidate positions are filtered by comparing the first and the
+/// last character of `needle` a vector register at a time, so only likely
+/// matches are compared in full.
+size_t CStringView_find(CStringView_t view, CStringView_t needle);
+
+/// \brief Find the last occurrence of a substring in a view.
+/// \param view The view to search in.
+/// \param needle The substring to search for.
+/// \return Returns the index at which the last occurrence of `needle` starts,
+/// or `CSTRINGVIEW_NOT_FOUND` if it is not present. An empty `needle` is found
+/// at the end of the view.
+size_t CStringView_rfind(CStringView_t view, CStringView_t needle);
+
+/// \brief Check if a view contains a substring.
+/// \param view The view to search in.
+/// \param needle The substring to search for.
+/// \return Returns 1 if `needle` occurs in `view`, 0 otherwise.
+int CStringView_contains(CStringView_t view, CStringView_t needle);
+
+/// \brief Find the first character of a view that is part of a set.
+/// \param view The view to search in.
+/// \param set The characters to search for.
+/// \return Returns the index of the first character of `view` found in `set`,
+/// or `CSTRINGVIEW_NOT_FOUND` if there is none.
+///
+/// \note Sets of up to 8 characters are matched with vector instructions.
+/// Larger sets use a lookup table.
+size_t CStringView_find_any(CStringView_t view, CStringView_t set);
+
+/// \brief Count the non-overlapping occurrences of a substring in a view.
+/// \param view The view to search in.
+/// \param needle The substring to count.
+/// \return Returns the number of occurrences. An empty `needle` yields 0.
+size_t CStringView_count(CStringView_t view, CStringView_t needle);
+
+/// \struct CStringSplit
+/// \brief Iterator yielding the tokens of a view one at a time.
+/// \details The iterator is a plain value that can live on the stack. Create
+/// it with `CStringView_split_iter` or `CStringView_lines_iter` and advance it
+/// with `CStringSplit_next`. Its fields are not meant to be modified directly.
+typedef struct CStringSplit {
+    CStringView_t rest;  ///< Characters that have not been consumed yet.
+    CStringView_t delim; ///< Delimiter separating the tokens.
+    int lines;           ///< Non-zero when splitting into lines.
+    int done;            ///< Non-zero once the last token has been returned.
+} CStringSplit_t;
+
+/// \brief Create an iterator over the tokens of a view separated by a
+/// delimiter.
+/// \param view The view to split.
+/// \param delim The delimiter. An empty delimiter yields the whole view as a
+/// single token.
+/// \return Returns the iterator.
+///
+/// \details Consecutive delimiters produce empty tokens, and an empty view
+/// produces a single empty token. No memory is allocated: the tokens are views
+/// into `view`, found with `CStringView_find`.
+CStringSplit_t CStringView_split_iter(CStringView_t view, CStringView_t delim);
+
+/// \brief Create an iterator over the lines of a view.
+/// \param view The view to split.
+/// \return Returns the iterator.
+///
+/// \details Lines are terminated by `\n`, and a `\r` preceding it is not part
+/// of the line. A trailing terminator does not produce an extra empty line,
+/// and an empty view produces no lines at all.
+CStringSplit_t CStringView_lines_iter(CStringView_t view);
+
+/// \brief Advance a split iterator.
+/// \param iter Pointer to the iterator.
+/// \param token Pointer to the view receiving the next token.
+/// \return Returns 1 if a token was stored in `token`, 0 once the iterator is
+/// exhausted.
+int CStringSplit_next(CStringSplit_t *iter, CStringView_t *token);
+
+/// \brief Split a view and collect all of its tokens in a single pass.
+/// \param view The view to split.
+/// \param delim The delimiter, as for `CStringView_split_iter`.
+/// \return Returns a `CResult` holding a new `CVector` with a
+/// `CStringView_t *` for every token, in order, or an error `CResult` if
+/// memory allocation fails.
+///
+/// \note The vector owns the views it holds and frees them along with
+/// itself, while the views point into `view` and must not outlive it.
+CResult_t *CStringView_split_collect(CStringView_t view, CStringView_t delim);
+
+/// \brief Parse a view holding a signed decimal integer.
+/// \param view The view to parse. It must consist of an optional sign
+/// followed by decimal digits only.
+/// \param value Pointer to the integer receiving the result.
+/// \return Returns `CSTRINGVIEW_SUCCESS` on success,
+/// `CSTRINGVIEW_INVALID_NUMBER` if the view is not an integer, or
+/// `CSTRINGVIEW_OUT_OF_RANGE` if it does not fit in an `int64_t`. `value` is
+/// only written on success.
+///
+/// \details The digits are read directly from the view, eight at a time with
+/// SWAR arithmetic on little-endian targets. No copy is made.
+int CStringView_parse_i64(CStringView_t view, int64_t *value);
+
+/// \brief Parse a view holding a floating-point number.
+/// \param view The view to parse, in any format accepted by `strtod`. It must
+/// not contain anything besides the number itself.
+/// \param value Pointer to the double receiving the result.
+/// \return Returns `CSTRINGVIEW_SUCCESS` on success,
+/// `CSTRINGVIEW_INVALID_NUMBER` if the view is not a number, or
+/// `CSTRINGVIEW_OUT_OF_RANGE` if its magnitude overflows a `double`. `value`
+/// is only written on success.
+///
+/// \details Decimal numbers with at most 19 significant digits and a small
+/// exponent, which covers most real-world input, are converted exactly
+/// without leaving the view. Anything else is copied to a temporary buffer
+/// and handed to `strtod`, so the decimal point is always `.` on the fast
+/// path but follows the current locale otherwise.
+int CStringView_parse_double(CStringView_t view, double *value);
+
+/// \brief Check whether the view holds well-formed UTF-8.
+/// \details Rejects truncated and overlong sequences, surrogates and code
+/// points above U+10FFFF. Vectorized where SSSE3 or AVX2 is available, with
+/// runs of ASCII skipped a block at a time.
+/// \param view The view to check.
+/// \return 1 if the view is valid UTF-8, 0 otherwise.
+int CStringView_validate_utf8(CStringView_t view);
+
+/// \brief Count the code points in the view.
+/// \details Counts the bytes that are not continuation bytes, so the view is
+/// assumed to be valid UTF-8.
+/// \param view The view to measure.
+/// \return The number of code points.
+size_t CStringView_utf8_length(CStringView_t view);
+
+/// \brief Decode UTF-8 into UTF-32.
+/// \param view The UTF-8 characters to decode.
+/// \param out Buffer receiving the code points, with room for at least
+/// `view.len` of them. It is not null-terminated.
+/// \param length Receives the number of code points written.
+/// \return `CSTRINGVIEW_SUCCESS`, or `CSTRINGVIEW_INVALID_UTF8` if the view is
+/// not valid UTF-8, in which case `out` holds a partial result.
+int CStringView_to_utf32(CStringView_t view, uint32_t *out, size_t *length);
+
+/// \brief Transcode UTF-8 into UTF-16.
+/// \param view The UTF-8 characters to transcode.
+/// \param out Buffer receiving the code units, with room for at least
+/// `view.len` of them. It is not null-terminated.
+/// \param length Receives the number of code units written.
+/// \return `CSTRINGVIEW_SUCCESS`, or `CSTRINGVIEW_INVALID_UTF8` if the view is
+/// not valid UTF-8, in which case `out` holds a partial result.
+int CStringView_to_utf16(CStringView_t view, uint16_t *out, size_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSTD_CSTRINGVIEW_H
@@ -77,6 +77,14 @@ extern "C" {
 /// to a NULL comparison function.
 #define CVECTOR_SORT_FAILURE 2
 
+/// \brief Error code indicating that a snapshot could not be written or read.
+#define CVECTOR_IO_FAILURE 3
+
+/// \brief Error code indicating that a file is not a vector snapshot or mapped
+/// vector, or was written by a machine with a different byte order or pointer
+/// size.
+#define CVECTOR_INVALID_SNAPSHOT 4
+
 /// \struct CVector
 /// \brief Structure representing a dynamic array of `void*` pointers.
 /// \details The `CVector` structure maintains an array of `void*` pointers, its
@@ -219,6 +227,69 @@ int CVector_reserve(CVector_t *vector, size_t new_capacity);
 /// the destructor.
 int CVector_set(CVector_t *vector, size_t index, void *new_element);
 
+/// \brief Write a snapshot of the vector to a file.
+/// \param vector Pointer to the `CVector` structure.
+/// \param path Path of the file to create or replace. The snapshot is written
+/// to a temporary file beside it and renamed over it once synced, so a
+/// container loaded from `path` may be saved back to it.
+/// \param serialize Serializer producing the bytes of each element.
+/// \return Returns `CVECTOR_SUCCESS` on success, `CVECTOR_IO_FAILURE` if the
+/// file could not be written, or another error code on invalid input.
+///
+/// \note Only available on POSIX systems. `NULL` elements are kept as is.
+int CVector_save(const CVector_t *vector, const char *path,
+                 SerializeFn serialize);
+
+/// \brief Load a vector from a snapshot written by `CVector_save`.
+/// \param path Path of the snapshot.
+/// \param destroy The destructor for elements added after loading, or `NULL`.
+/// \return Returns a pointer to `CResult` containing the vector, or an error
+/// with `CVECTOR_IO_FAILURE` or `CVECTOR_INVALID_SNAPSHOT`.
+///
+/// \note The file is mapped privately and used in place: each element points
+/// at its serialized bytes inside the mapping, which lives until the vector is
+/// cleared or freed. Those elements are never passed to `destroy`. Only
+/// available on POSIX systems.
+CResult_t *CVector_load(const char *path, Destructor destroy);
+
+/// \brief Create a vector whose storage is mapped memory instead of the heap.
+/// \details A large range of virtual memory is reserved and pages are only
+/// committed as they are first written, so the resident size follows the
+/// number of elements. Growing never copies the elements: the mapping is
+/// extended with `mremap` where available, which also avoids the doubled peak
+/// memory of `realloc`.
+///
+/// With a `path`, the elements are stored in that file and survive the
+/// process. An existing file is reopened with the elements it held at the
+/// last `CVector_sync` or `CVector_free`; it can exceed physical memory. Disk
+/// space is allocated as the file grows, so a full disk makes adding fail
+/// with `CVECTOR_IO_FAILURE` instead of faulting on the store. Only
+/// elements that do not point into process memory, such as integers or
+/// offsets cast to `void *`, are meaningful across runs.
+/// \param reserve_capacity The capacity to reserve up front.
+/// \param destroy The destructor function to use for cleaning up elements, or
+/// `NULL` if no destructor is needed.
+/// \param path The file to keep the elements in, or `NULL` for anonymous
+/// memory.
+/// \return Returns a pointer to `CResult` containing the vector, or an error
+/// with `CVECTOR_IO_FAILURE`, `CVECTOR_ALLOC_FAILURE` or
+/// `CVECTOR_INVALID_SNAPSHOT` if the file holds something else.
+///
+/// \note For file-backed vectors, `CVector_free` keeps the elements in the
+/// file and does not call `destroy`, while `CVector_clear` empties the file.
+/// Only available on POSIX systems.
+CResult_t *CVector_new_mapped(size_t reserve_capacity, Destructor destroy,
+                              const char *path);
+
+/// \brief Flush a file-backed vector to its file.
+/// \param vector Pointer to the `CVector` structure.
+/// \return Returns `CVECTOR_SUCCESS` on success, or `CVECTOR_IO_FAILURE` if
+/// the file could not be written. Vectors that are not file-backed have
+/// nothing to flush.
+///
+/// \note Only available on POSIX systems.
+int CVector_sync(CVector_t *vector);
+
 #ifdef __cplusplus
 }
 #endif
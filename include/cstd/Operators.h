@@ -47,6 +47,19 @@ typedef void (*Destructor)(void *data);
 /// \return A pointer to the cloned element.
 typedef void *(*CloneFn)(const void *data);
 
+/// \typedef SerializeFn
+/// \brief Function pointer type for serialization functions.
+/// \details Used when saving containers to snapshots. The bytes are handed
+/// back in place as the element when the snapshot is loaded, aligned to 8
+/// bytes, so they must form a usable element by themselves.
+/// \param data Pointer to the element to serialize.
+/// \param buffer Buffer to write the bytes into.
+/// \param size Size of `buffer` in bytes.
+/// \return The number of bytes the element needs. If it exceeds `size`,
+/// nothing needs to be written and the function is called again with a buffer
+/// that is large enough.
+typedef size_t (*SerializeFn)(const void *data, void *buffer, size_t size);
+
 #ifndef CSTD_NO_DEF_FN_IMPL
 /// \brief Compare function for pointers.
 /// \param a Pointer to the first element to compare.
@@ -74,6 +87,26 @@ int ccompare_integer(const void *a, const void *b);
 /// check for it's presence.
 size_t chash_string(const void *key);
 
+/// \brief Hash function for `CString_t` keys.
+/// \param key Pointer to the `CString_t` to hash.
+/// \return The cached hash of the string, see `CString_hash`.
+///
+/// \attention This method may be absent. Use the `HAVE_CSTD_DEFAULTS` macro to
+/// check for it's presence.
+size_t chash_cstring(const void *key);
+
+/// \brief Compare function for `CString_t` keys.
+/// \details Orders by length, then by hash, then by the characters, so that
+/// unequal keys rarely need a byte comparison. The order is not lexicographic;
+/// use `CString_compare` for that.
+/// \param a Pointer to the first `CString_t` to compare.
+/// \param b Pointer to the second `CString_t` to compare.
+/// \return An integer value indicating the result of the comparison.
+///
+/// \attention This method may be absent. Use the `HAVE_CSTD_DEFAULTS` macro to
+/// check for it's presence.
+int ccompare_cstring(const void *a, const void *b);
+
 /// \brief Default hash function for void pointers.
 /// \param key Pointer to the element to hash.
 /// \return A `int64_t` value representing the hash of the pointer.
@@ -90,6 +123,26 @@ size_t cdefault_hash(const void *key);
 /// check for it's presence.
 void *cclone_integer(const void *data);
 
+/// \brief Serialize function for integers.
+/// \param data Pointer to the integer to serialize.
+/// \param buffer Buffer to write the integer into.
+/// \param size Size of `buffer` in bytes.
+/// \return `sizeof(int)`.
+///
+/// \attention This method may be absent. Use the `HAVE_CSTD_DEFAULTS` macro to
+/// check for it's presence.
+size_t cserialize_integer(const void *data, void *buffer, size_t size);
+
+/// \brief Serialize function for strings.
+/// \param data Pointer to the NUL-terminated string to serialize.
+/// \param buffer Buffer to write the string into, terminator included.
+/// \param size Size of `buffer` in bytes.
+/// \return The length of the string plus one.
+///
+/// \attention This method may be absent. Use the `HAVE_CSTD_DEFAULTS` macro to
+/// check for it's presence.
+size_t cserialize_string(const void *data, void *buffer, size_t size);
+
 #endif // CSTD_NO_DEF_FN_IMPL
 
 #ifdef __cplusplus
@@ -0,0 +1,514 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _GNU_SOURCE
+#include <cstd/CAsyncIO.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// Plain reads and writes arrived together with this feature flag, in 5.6.
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#define HAVE_IO_URING
+#endif
+#endif
+#endif
+
+#define OP_READ 0
+#define OP_WRITE 1
+
+/// \internal
+/// \brief A queued or in-flight request. The engine owns `depth` of them.
+typedef struct Request {
+    int op;
+    int fd;
+    void *buffer;
+    size_t len;
+    uint64_t offset;
+    CAsyncIOCallback callback;
+    void *user_data;
+    int64_t result;
+    struct Request *next;
+} Request;
+
+struct _CAsyncIO {
+    int backend;        ///< `CASYNCIO_URING` or `CASYNCIO_THREADS`.
+    unsigned depth;     ///< Number of requests in `requests`.
+    Request *requests;  ///< Storage for every request.
+    Request *free_list; ///< Requests that are not in use.
+    size_t pending;     ///< Requests that are queued or in flight.
+    size_t queued;      ///< Requests that have not been submitted yet.
+    Request *queue_head, *queue_tail; ///< Unsubmitted requests (threads).
+    Request *ready_head, *ready_tail; ///< Completions without a callback.
+
+#ifdef HAVE_IO_URING
+    struct {
+        int fd;
+        unsigned *sq_tail, *sq_mask, *sq_array;
+        unsigned *cq_head, *cq_tail, *cq_mask;
+        struct io_uring_sqe *sqes;
+        struct io_uring_cqe *cqes;
+        void *sq_ptr, *cq_ptr;
+        size_t sq_size, cq_size, sqes_size;
+        unsigned tail; ///< Submission tail not yet published to the kernel.
+    } ring;
+#endif
+
+    pthread_t threads[CASYNCIO_POOL_SIZE];
+    size_t thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    Request *work_head, *work_tail; ///< Submitted requests, under `lock`.
+    Request *done_head, *done_tail; ///< Completed requests, under `lock`.
+    int stopping;
+};
+
+/// \internal
+/// \brief Return a completed request to the free list and run its callback,
+/// or keep it for `CAsyncIO_next_completion` if it has none.
+static void complete(CAsyncIO_t *io, Request *req, int64_t result) {
+    CAsyncIOCallback callback = req->callback;
+    void *user_data = req->user_data;
+    io->pending--;
+    if (callback == NULL) {
+        req->result = result;
+        req->next = NULL;
+        if (io->ready_head == NULL)
+            io->ready_head = req;
+        else
+            io->ready_tail->next = req;
+        io->ready_tail = req;
+        return;
+    }
+    req->next = io->free_list;
+    io->free_list = req;
+    callback(user_data, result);
+}
+
+#ifdef HAVE_IO_URING
+
+static int uring_setup(CAsyncIO_t *io) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, io->depth, &params);
+    if (fd < 0)
+        return CASYNCIO_IO_FAILURE;
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        close(fd);
+        errno = ENOSYS;
+        return CASYNCIO_IO_FAILURE;
+    }
+
+    io->ring.fd = fd;
+    io->ring.sq_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    io->ring.cq_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && io->ring.cq_size > io->ring.sq_size)
+        io->ring.sq_size = io->ring.cq_size;
+
+    io->ring.sq_ptr =
+        mmap(NULL, io->ring.sq_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    io->ring.cq_ptr = single ? io->ring.sq_ptr
+                             : mmap(NULL, io->ring.cq_size,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE, fd,
+                                    IORING_OFF_CQ_RING);
+    io->ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    io->ring.sqes = mmap(NULL, io->ring.sqes_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (io->ring.sq_ptr == MAP_FAILED || io->ring.cq_ptr == MAP_FAILED ||
+        io->ring.sqes == MAP_FAILED) {
+        if (io->ring.sq_ptr != MAP_FAILED)
+            munmap(io->ring.sq_ptr, io->ring.sq_size);
+        if (!single && io->ring.cq_ptr != MAP_FAILED)
+            munmap(io->ring.cq_ptr, io->ring.cq_size);
+        if (io->ring.sqes != MAP_FAILED)
+            munmap(io->ring.sqes, io->ring.sqes_size);
+        close(fd);
+        return CASYNCIO_IO_FAILURE;
+    }
+    if (single)
+        io->ring.cq_size = 0;
+
+    char *sq = io->ring.sq_ptr, *cq = io->ring.cq_ptr;
+    io->ring.sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    io->ring.sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    io->ring.sq_array = (unsigned *)(sq + params.sq_off.array);
+    io->ring.cq_head = (unsigned *)(cq + params.cq_off.head);
+    io->ring.cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    io->ring.cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    io->ring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    io->ring.tail = *io->ring.sq_tail;
+    return CASYNCIO_SUCCESS;
+}
+
+static void uring_queue(CAsyncIO_t *io, Request *req) {
+    unsigned index = io->ring.tail & *io->ring.sq_mask;
+    struct io_uring_sqe *sqe = &io->ring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = req->op == OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = req->fd;
+    sqe->addr = (uint64_t)(uintptr_t)req->buffer;
+    // Like read(2), a single request transfers at most 0x7ffff000 bytes.
+    sqe->len = req->len > 0x7ffff000 ? 0x7ffff000 : (unsigned)req->len;
+    sqe->off = req->offset;
+    sqe->user_data = (uint64_t)(uintptr_t)req;
+    io->ring.sq_array[index] = index;
+    io->ring.tail++;
+}
+
+/// \internal
+/// \brief `uring_enter` could not submit because the completion queue is full
+/// or the kernel is short of resources. Reap completions before trying again.
+#define URING_BUSY (-1)
+
+static int uring_enter(CAsyncIO_t *io, unsigned submit, unsigned wait) {
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        long n = syscall(__NR_io_uring_enter, io->ring.fd, submit, wait, flags,
+                         NULL, 0);
+        if (n >= 0) {
+            io->queued -= (size_t)n;
+            return CASYNCIO_SUCCESS;
+        }
+        if (errno == EAGAIN || errno == EBUSY)
+            return URING_BUSY;
+        if (errno != EINTR)
+            return CASYNCIO_IO_FAILURE;
+    }
+}
+
+static size_t uring_reap(CAsyncIO_t *io) {
+    size_t count = 0;
+    unsigned head = *io->ring.cq_head;
+    while (head != __atomic_load_n(io->ring.cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &io->ring.cqes[head & *io->ring.cq_mask];
+        Request *req = (Request *)(uintptr_t)cqe->user_data;
+        int64_t result = cqe->res;
+        // Release the entry before the callback, which may queue more work.
+        __atomic_store_n(io->ring.cq_head, ++head, __ATOMIC_RELEASE);
+        complete(io, req, result);
+        count++;
+    }
+    return count;
+}
+
+static void uring_close(CAsyncIO_t *io) {
+    munmap(io->ring.sqes, io->ring.sqes_size);
+    if (io->ring.cq_size)
+        munmap(io->ring.cq_ptr, io->ring.cq_size);
+    munmap(io->ring.sq_ptr, io->ring.sq_size);
+    close(io->ring.fd);
+}
+
+#endif // HAVE_IO_URING
+
+static void *worker(void *arg) {
+    CAsyncIO_t *io = arg;
+    pthread_mutex_lock(&io->lock);
+    for (;;) {
+        while (io->work_head == NULL && !io->stopping)
+            pthread_cond_wait(&io->work_ready, &io->lock);
+        if (io->work_head == NULL)
+            break;
+        Request *req = io->work_head;
+        io->work_head = req->next;
+        pthread_mutex_unlock(&io->lock);
+
+        ssize_t n;
+        do {
+            n = req->op == OP_READ
+                    ? pread(req->fd, req->buffer, req->len, (off_t)req->offset)
+                    : pwrite(req->fd, req->buffer, req->len,
+                             (off_t)req->offset);
+        } while (n < 0 && errno == EINTR);
+        req->result = n < 0 ? -(int64_t)errno : (int64_t)n;
+
+        pthread_mutex_lock(&io->lock);
+        req->next = NULL;
+        if (io->done_head == NULL)
+            io->done_head = req;
+        else
+            io->done_tail->next = req;
+        io->done_tail = req;
+        pthread_cond_signal(&io->work_done);
+    }
+    pthread_mutex_unlock(&io->lock);
+    return NULL;
+}
+
+static int threads_setup(CAsyncIO_t *io) {
+    size_t count = io->depth < CASYNCIO_POOL_SIZE ? io->depth
+                                                  : CASYNCIO_POOL_SIZE;
+    for (; io->thread_count < count; io->thread_count++)
+        if (pthread_create(&io->threads[io->thread_count], NULL, worker, io))
+            return io->thread_count ? CASYNCIO_SUCCESS : CASYNCIO_IO_FAILURE;
+    return CASYNCIO_SUCCESS;
+}
+
+static size_t threads_reap(CAsyncIO_t *io, size_t wanted) {
+    pthread_mutex_lock(&io->lock);
+    while (io->done_head == NULL && wanted)
+        pthread_cond_wait(&io->work_done, &io->lock);
+    Request *req = io->done_head;
+    io->done_head = io->done_tail = NULL;
+    pthread_mutex_unlock(&io->lock);
+
+    size_t count = 0;
+    while (req != NULL) {
+        Request *next = req->next;
+        complete(io, req, req->result);
+        req = next;
+        count++;
+    }
+    return count;
+}
+
+CResult_t *CAsyncIO_new(unsigned depth, int backend) {
+    if (depth == 0)
+        depth = 1;
+
+    CAsyncIO_t *io = calloc(1, sizeof(CAsyncIO_t));
+    Request *requests = calloc(depth, sizeof(Request));
+    if (io == NULL || requests == NULL) {
+        free(io);
+        free(requests);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CAsyncIO.", "CAsyncIO_new",
+            CASYNCIO_ALLOC_FAILURE));
+    }
+
+    io->depth = depth;
+    io->requests = requests;
+    for (unsigned i = 0; i < depth; i++) {
+        requests[i].next = io->free_list;
+        io->free_list = &requests[i];
+    }
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->work_ready, NULL);
+    pthread_cond_init(&io->work_done, NULL);
+
+    int code = CASYNCIO_IO_FAILURE;
+#ifdef HAVE_IO_URING
+    if (backend != CASYNCIO_THREADS) {
+        code = uring_setup(io);
+        io->backend = CASYNCIO_URING;
+    }
+#endif
+    if (code && backend != CASYNCIO_URING) {
+        io->backend = CASYNCIO_THREADS;
+        code = threads_setup(io);
+    }
+
+    if (code) {
+        io->backend = CASYNCIO_THREADS;
+        CAsyncIO_free(&io);
+        return CResult_ecreate(
+            CError_create("Unable to set up the requested backend.",
+                          "CAsyncIO_new", code));
+    }
+    return CResult_create(io, NULL);
+}
+
+int CAsyncIO_backend(const CAsyncIO_t *io) {
+    if (io == NULL)
+        return CASYNCIO_NULL_ENGINE;
+    return io->backend;
+}
+
+static int queue(CAsyncIO_t *io, int op, int fd, void *buffer, size_t len,
+                 uint64_t offset, CAsyncIOCallback callback,
+                 void *user_data) {
+    if (io == NULL)
+        return CASYNCIO_NULL_ENGINE;
+    Request *req = io->free_list;
+    if (req == NULL)
+        return CASYNCIO_QUEUE_FULL;
+    io->free_list = req->next;
+
+    req->op = op;
+    req->fd = fd;
+    req->buffer = buffer;
+    req->len = len;
+    req->offset = offset;
+    req->callback = callback;
+    req->user_data = user_data;
+    req->next = NULL;
+    io->pending++;
+    io->queued++;
+
+#ifdef HAVE_IO_URING
+    if (io->backend == CASYNCIO_URING) {
+        uring_queue(io, req);
+        return CASYNCIO_SUCCESS;
+    }
+#endif
+    if (io->queue_head == NULL)
+        io->queue_head = req;
+    else
+        io->queue_tail->next = req;
+    io->queue_tail = req;
+    return CASYNCIO_SUCCESS;
+}
+
+int CAsyncIO_read(CAsyncIO_t *io, int fd, void *buffer, size_t len,
+                  uint64_t offset, CAsyncIOCallback callback,
+                  void *user_data) {
+    return queue(io, OP_READ, fd, buffer, len, offset, callback, user_data);
+}
+
+int CAsyncIO_write(CAsyncIO_t *io, int fd, const void *buffer, size_t len,
+                   uint64_t offset, CAsyncIOCallback callback,
+                   void *user_data) {
+    return queue(io, OP_WRITE, fd, (void *)buffer, len, offset, callback,
+                 user_data);
+}
+
+int CAsyncIO_submit(CAsyncIO_t *io) {
+    if (io == NULL)
+        return CASYNCIO_NULL_ENGINE;
+    if (io->queued == 0)
+        return CASYNCIO_SUCCESS;
+
+#ifdef HAVE_IO_URING
+    if (io->backend == CASYNCIO_URING) {
+        __atomic_store_n(io->ring.sq_tail, io->ring.tail, __ATOMIC_RELEASE);
+        // A busy kernel leaves the requests queued for the next poll, which
+        // reaps completions before submitting them again.
+        int code = uring_enter(io, (unsigned)io->queued, 0);
+        return code == URING_BUSY ? CASYNCIO_SUCCESS : code;
+    }
+#endif
+    pthread_mutex_lock(&io->lock);
+    if (io->work_head == NULL)
+        io->work_head = io->queue_head;
+    else
+        io->work_tail->next = io->queue_head;
+    io->work_tail = io->queue_tail;
+    pthread_cond_broadcast(&io->work_ready);
+    pthread_mutex_unlock(&io->lock);
+    io->queue_head = io->queue_tail = NULL;
+    io->queued = 0;
+    return CASYNCIO_SUCCESS;
+}
+
+size_t CAsyncIO_poll(CAsyncIO_t *io, size_t min_complete) {
+    if (io == NULL || CAsyncIO_submit(io))
+        return 0;
+
+    // Requests queued by callbacks are not waited for, as they have not been
+    // submitted yet.
+    size_t in_flight = io->pending - io->queued;
+    if (min_complete > in_flight)
+        min_complete = in_flight;
+
+    size_t count = 0;
+    for (;;) {
+        size_t wanted = min_complete > count ? min_complete - count : 0;
+#ifdef HAVE_IO_URING
+        if (io->backend == CASYNCIO_URING) {
+            count += uring_reap(io);
+            if (count >= min_complete)
+                return count;
+            // Submit anything a busy kernel turned away while waiting, and
+            // go back to reaping if it is still busy.
+            if (uring_enter(io, (unsigned)io->queued,
+                            (unsigned)(min_complete - count)) ==
+                CASYNCIO_IO_FAILURE)
+                return count;
+            continue;
+        }
+#endif
+        count += threads_reap(io, wanted);
+        if (count >= min_complete)
+            return count;
+    }
+}
+
+int CAsyncIO_next_completion(CAsyncIO_t *io, void **user_data,
+                             int64_t *result) {
+    if (io == NULL)
+        return CASYNCIO_NULL_ENGINE;
+    Request *req = io->ready_head;
+    if (req == NULL)
+        return CASYNCIO_NO_COMPLETION;
+    io->ready_head = req->next;
+    if (user_data != NULL)
+        *user_data = req->user_data;
+    if (result != NULL)
+        *result = req->result;
+    req->next = io->free_list;
+    io->free_list = req;
+    return CASYNCIO_SUCCESS;
+}
+
+size_t CAsyncIO_pending(const CAsyncIO_t *io) {
+    if (io == NULL)
+        return 0;
+    return io->pending;
+}
+
+int CAsyncIO_free(CAsyncIO_t **io) {
+    if (io == NULL || *io == NULL)
+        return CASYNCIO_SUCCESS;
+
+    CAsyncIO_t *engine = *io;
+    while (engine->pending && CAsyncIO_poll(engine, engine->pending))
+        ;
+
+#ifdef HAVE_IO_URING
+    if (engine->backend == CASYNCIO_URING)
+        uring_close(engine);
+#endif
+    pthread_mutex_lock(&engine->lock);
+    engine->stopping = 1;
+    pthread_cond_broadcast(&engine->work_ready);
+    pthread_mutex_unlock(&engine->lock);
+    for (size_t i = 0; i < engine->thread_count; i++)
+        pthread_join(engine->threads[i], NULL);
+
+    pthread_cond_destroy(&engine->work_done);
+    pthread_cond_destroy(&engine->work_ready);
+    pthread_mutex_destroy(&engine->lock);
+    free(engine->requests);
+    free(engine);
+    *io = NULL;
+    return CASYNCIO_SUCCESS;
+}
+
+#endif // POSIX
@@ -0,0 +1,388 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CBufChain.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// \internal
+/// \brief Size of the segments that collect small copies.
+#define SCRATCH_SIZE 4096
+
+/// \internal
+/// \brief Number of ranges handed to one `writev` call.
+#define WRITEV_BATCH 64
+
+struct _CBufSegment {
+    atomic_size_t refs; ///< Number of ranges and users sharing it.
+    const char *data;   ///< The bytes, `bytes` unless wrapped.
+    size_t len;         ///< Number of bytes.
+    size_t capacity;    ///< Room in `bytes`, 0 for wrapped segments.
+    Destructor release; ///< Called with `owner` when freed.
+    void *owner;
+    char bytes[];
+};
+
+/// \internal
+/// \brief A range of a segment, holding a reference to it.
+typedef struct {
+    CBufSegment_t *segment;
+    const char *ptr;
+    size_t len;
+} Piece;
+
+struct _CBufChain {
+    Piece *pieces;          ///< Circular array of ranges.
+    size_t head;            ///< Index of the first range.
+    size_t count;           ///< Number of ranges.
+    size_t capacity;        ///< Capacity of `pieces`, a power of two.
+    size_t size;            ///< Number of bytes.
+    CBufSegment_t *scratch; ///< Segment that small copies are added to.
+};
+
+static CBufSegment_t *segment_alloc(size_t capacity) {
+    CBufSegment_t *segment = malloc(sizeof(CBufSegment_t) + capacity);
+    if (segment == NULL)
+        return NULL;
+    atomic_init(&segment->refs, 1);
+    segment->data = segment->bytes;
+    segment->len = 0;
+    segment->capacity = capacity;
+    segment->release = NULL;
+    segment->owner = NULL;
+    return segment;
+}
+
+CResult_t *CBufSegment_new(CStringView_t bytes) {
+    CBufSegment_t *segment = segment_alloc(bytes.len);
+    if (segment == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CBufSegment.", "CBufSegment_new",
+            CBUFCHAIN_ALLOC_FAILURE));
+    if (bytes.len)
+        memcpy(segment->bytes, bytes.ptr, bytes.len);
+    segment->len = bytes.len;
+    return CResult_create(segment, NULL);
+}
+
+CResult_t *CBufSegment_wrap(CStringView_t bytes, Destructor release,
+                            void *owner) {
+    CBufSegment_t *segment = segment_alloc(0);
+    if (segment == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CBufSegment.", "CBufSegment_wrap",
+            CBUFCHAIN_ALLOC_FAILURE));
+    segment->data = bytes.ptr;
+    segment->len = bytes.len;
+    segment->release = release;
+    segment->owner = owner;
+    return CResult_create(segment, NULL);
+}
+
+static void release_string(void *string) {
+    CString_t *clone = string;
+    CString_free(&clone);
+}
+
+CResult_t *CBufSegment_from_string(const CString_t *string) {
+    if (string == NULL)
+        return CResult_ecreate(CError_create("Recieved a null string.",
+                                             "CBufSegment_from_string",
+                                             CBUFCHAIN_NULL_CHAIN));
+    CResult_t *res = CString_clone(string);
+    if (CResult_is_error(res)) {
+        CResult_free(&res);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CBufSegment.",
+            "CBufSegment_from_string", CBUFCHAIN_ALLOC_FAILURE));
+    }
+    CString_t *clone = CResult_get(res);
+    CResult_free(&res);
+
+    res = CBufSegment_wrap(CString_view(clone), release_string, clone);
+    if (CResult_is_error(res))
+        CString_free(&clone);
+    return res;
+}
+
+CStringView_t CBufSegment_view(const CBufSegment_t *segment) {
+    if (segment == NULL)
+        return CStringView_from(NULL, 0);
+    return CStringView_from(segment->data, segment->len);
+}
+
+CBufSegment_t *CBufSegment_retain(CBufSegment_t *segment) {
+    if (segment != NULL)
+        atomic_fetch_add_explicit(&segment->refs, 1, memory_order_relaxed);
+    return segment;
+}
+
+int CBufSegment_free(CBufSegment_t **segment) {
+    if (segment == NULL || *segment == NULL)
+        return CBUFCHAIN_SUCCESS;
+    CBufSegment_t *s = *segment;
+    *segment = NULL;
+    if (atomic_fetch_sub_explicit(&s->refs, 1, memory_order_acq_rel) == 1) {
+        if (s->release != NULL)
+            s->release(s->owner);
+        free(s);
+    }
+    return CBUFCHAIN_SUCCESS;
+}
+
+CResult_t *CBufChain_new() {
+    CBufChain_t *chain = calloc(1, sizeof(CBufChain_t));
+    if (chain == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CBufChain.", "CBufChain_new",
+            CBUFCHAIN_ALLOC_FAILURE));
+    return CResult_create(chain, NULL);
+}
+
+size_t CBufChain_size(const CBufChain_t *chain) {
+    return chain ? chain->size : 0;
+}
+
+size_t CBufChain_count(const CBufChain_t *chain) {
+    return chain ? chain->count : 0;
+}
+
+static Piece *piece(const CBufChain_t *chain, size_t i) {
+    return &chain->pieces[(chain->head + i) & (chain->capacity - 1)];
+}
+
+/// \internal
+/// \brief Make room for `more` ranges.
+static int reserve(CBufChain_t *chain, size_t more) {
+    if (chain->count + more <= chain->capacity)
+        return CBUFCHAIN_SUCCESS;
+    size_t capacity = chain->capacity ? chain->capacity : 8;
+    while (capacity < chain->count + more)
+        capacity *= 2;
+    Piece *pieces = malloc(capacity * sizeof(Piece));
+    if (pieces == NULL)
+        return CBUFCHAIN_ALLOC_FAILURE;
+    for (size_t i = 0; i < chain->count; i++)
+        pieces[i] = *piece(chain, i);
+    free(chain->pieces);
+    chain->pieces = pieces;
+    chain->head = 0;
+    chain->capacity = capacity;
+    return CBUFCHAIN_SUCCESS;
+}
+
+static int add(CBufChain_t *chain, CBufSegment_t *segment, size_t start,
+               size_t end, int front) {
+    if (chain == NULL || segment == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    if (start > end || end > segment->len)
+        return CBUFCHAIN_OUT_OF_RANGE;
+    if (start == end)
+        return CBUFCHAIN_SUCCESS;
+    if (reserve(chain, 1))
+        return CBUFCHAIN_ALLOC_FAILURE;
+
+    if (front)
+        chain->head = (chain->head - 1) & (chain->capacity - 1);
+    *piece(chain, front ? 0 : chain->count) =
+        (Piece){CBufSegment_retain(segment), segment->data + start,
+                end - start};
+    chain->count++;
+    chain->size += end - start;
+    return CBUFCHAIN_SUCCESS;
+}
+
+int CBufChain_append(CBufChain_t *chain, CBufSegment_t *segment, size_t start,
+                     size_t end) {
+    return add(chain, segment, start, end, 0);
+}
+
+int CBufChain_prepend(CBufChain_t *chain, CBufSegment_t *segment,
+                      size_t start, size_t end) {
+    return add(chain, segment, start, end, 1);
+}
+
+int CBufChain_append_copy(CBufChain_t *chain, CStringView_t bytes) {
+    if (chain == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    if (bytes.len == 0)
+        return CBUFCHAIN_SUCCESS;
+
+    // Extend the last range in place while it ends the scratch segment.
+    CBufSegment_t *scratch = chain->scratch;
+    Piece *last = chain->count ? piece(chain, chain->count - 1) : NULL;
+    if (scratch != NULL && last != NULL && last->segment == scratch &&
+        last->ptr + last->len == scratch->bytes + scratch->len &&
+        bytes.len <= scratch->capacity - scratch->len) {
+        memcpy(scratch->bytes + scratch->len, bytes.ptr, bytes.len);
+        scratch->len += bytes.len;
+        last->len += bytes.len;
+        chain->size += bytes.len;
+        return CBUFCHAIN_SUCCESS;
+    }
+
+    size_t room = SCRATCH_SIZE - sizeof(CBufSegment_t);
+    CBufSegment_t *segment =
+        segment_alloc(bytes.len > room ? bytes.len : room);
+    if (segment == NULL)
+        return CBUFCHAIN_ALLOC_FAILURE;
+    memcpy(segment->bytes, bytes.ptr, bytes.len);
+    segment->len = bytes.len;
+    int code = add(chain, segment, 0, bytes.len, 0);
+    if (!code)
+        chain->scratch = segment->capacity > bytes.len ? segment : NULL;
+    CBufSegment_free(&segment);
+    return code;
+}
+
+int CBufChain_append_string(CBufChain_t *chain, const CString_t *string) {
+    if (chain == NULL || string == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    CResult_t *res = CBufSegment_from_string(string);
+    if (CResult_is_error(res)) {
+        CResult_free(&res);
+        return CBUFCHAIN_ALLOC_FAILURE;
+    }
+    CBufSegment_t *segment = CResult_get(res);
+    CResult_free(&res);
+    int code = add(chain, segment, 0, segment->len, 0);
+    CBufSegment_free(&segment);
+    return code;
+}
+
+int CBufChain_concat(CBufChain_t *chain, CBufChain_t *other) {
+    if (chain == NULL || other == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    if (chain == other || other->count == 0)
+        return CBUFCHAIN_SUCCESS;
+    if (reserve(chain, other->count))
+        return CBUFCHAIN_ALLOC_FAILURE;
+    // The references move along with the ranges.
+    for (size_t i = 0; i < other->count; i++)
+        *piece(chain, chain->count + i) = *piece(other, i);
+    chain->count += other->count;
+    chain->size += other->size;
+    other->head = 0;
+    other->count = 0;
+    other->size = 0;
+    other->scratch = NULL;
+    return CBUFCHAIN_SUCCESS;
+}
+
+size_t CBufChain_copy_out(const CBufChain_t *chain, void *buffer, size_t len) {
+    if (chain == NULL || buffer == NULL)
+        return 0;
+    size_t copied = 0;
+    for (size_t i = 0; i < chain->count && copied < len; i++) {
+        const Piece *p = piece(chain, i);
+        size_t n = p->len < len - copied ? p->len : len - copied;
+        memcpy((char *)buffer + copied, p->ptr, n);
+        copied += n;
+    }
+    return copied;
+}
+
+int CBufChain_consume(CBufChain_t *chain, size_t len) {
+    if (chain == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    while (len && chain->count) {
+        Piece *p = piece(chain, 0);
+        if (len < p->len) {
+            p->ptr += len;
+            p->len -= len;
+            chain->size -= len;
+            return CBUFCHAIN_SUCCESS;
+        }
+        len -= p->len;
+        chain->size -= p->len;
+        if (p->segment == chain->scratch)
+            chain->scratch = NULL;
+        CBufSegment_free(&p->segment);
+        chain->head = (chain->head + 1) & (chain->capacity - 1);
+        chain->count--;
+    }
+    return len ? CBUFCHAIN_OUT_OF_RANGE : CBUFCHAIN_SUCCESS;
+}
+
+int CBufChain_clear(CBufChain_t *chain) {
+    if (chain == NULL)
+        return CBUFCHAIN_NULL_CHAIN;
+    CBufChain_consume(chain, chain->size);
+    chain->head = 0;
+    chain->scratch = NULL;
+    return CBUFCHAIN_SUCCESS;
+}
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+size_t CBufChain_to_iovec(const CBufChain_t *chain, struct iovec *iov,
+                          size_t max) {
+    if (chain == NULL || iov == NULL)
+        return 0;
+    size_t n = chain->count < max ? chain->count : max;
+    for (size_t i = 0; i < n; i++) {
+        const Piece *p = piece(chain, i);
+        iov[i].iov_base = (void *)p->ptr;
+        iov[i].iov_len = p->len;
+    }
+    return n;
+}
+
+ssize_t CBufChain_writev(CBufChain_t *chain, int fd) {
+    if (chain == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    struct iovec iov[WRITEV_BATCH];
+    ssize_t total = 0;
+    while (chain->count) {
+        int n = (int)CBufChain_to_iovec(chain, iov, WRITEV_BATCH);
+        ssize_t written = writev(fd, iov, n);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return total ? total : -1;
+        }
+        if (written == 0)
+            break;
+        CBufChain_consume(chain, (size_t)written);
+        total += written;
+    }
+    return total;
+}
+
+#endif // POSIX
+
+int CBufChain_free(CBufChain_t **chain) {
+    if (chain == NULL || *chain == NULL)
+        return CBUFCHAIN_SUCCESS;
+    CBufChain_clear(*chain);
+    free((*chain)->pieces);
+    free(*chain);
+    *chain = NULL;
+    return CBUFCHAIN_SUCCESS;
+}
@@ -0,0 +1,350 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CByteBuffer.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct _CByteBuffer {
+    char *data;
+    size_t capacity;
+    size_t read;  ///< Read cursor.
+    size_t write; ///< Write cursor, never before `read`.
+};
+
+CResult_t *CByteBuffer_new(size_t capacity) {
+    CByteBuffer_t *buffer = malloc(sizeof(CByteBuffer_t));
+    char *data = capacity ? malloc(capacity) : NULL;
+    if (buffer == NULL || (capacity && data == NULL)) {
+        free(buffer);
+        free(data);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CByteBuffer.", "CByteBuffer_new",
+            CBYTEBUFFER_ALLOC_FAILURE));
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    buffer->read = 0;
+    buffer->write = 0;
+    return CResult_create(buffer, NULL);
+}
+
+size_t CByteBuffer_readable(const CByteBuffer_t *buffer) {
+    return buffer ? buffer->write - buffer->read : 0;
+}
+
+size_t CByteBuffer_writable(const CByteBuffer_t *buffer) {
+    return buffer ? buffer->capacity - buffer->write : 0;
+}
+
+CStringView_t CByteBuffer_view(const CByteBuffer_t *buffer) {
+    if (buffer == NULL)
+        return CStringView_from(NULL, 0);
+    return CStringView_from(buffer->data + buffer->read,
+                            buffer->write - buffer->read);
+}
+
+int CByteBuffer_slice(const CByteBuffer_t *buffer, size_t start, size_t end,
+                      CStringView_t *slice) {
+    if (buffer == NULL || slice == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (start > end || end > buffer->write - buffer->read)
+        return CBYTEBUFFER_OUT_OF_RANGE;
+    *slice = CStringView_from(buffer->data + buffer->read + start,
+                              end - start);
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_compact(CByteBuffer_t *buffer) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    size_t readable = buffer->write - buffer->read;
+    if (buffer->read && readable)
+        memmove(buffer->data, buffer->data + buffer->read, readable);
+    buffer->read = 0;
+    buffer->write = readable;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_reserve(CByteBuffer_t *buffer, size_t len) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (len <= buffer->capacity - buffer->write)
+        return CBYTEBUFFER_SUCCESS;
+
+    size_t readable = buffer->write - buffer->read;
+    if (len > SIZE_MAX - readable)
+        return CBYTEBUFFER_ALLOC_FAILURE;
+    // Sliding is cheaper than growing once most of the bytes are consumed.
+    if (readable + len <= buffer->capacity &&
+        buffer->read >= buffer->capacity / 2)
+        return CByteBuffer_compact(buffer);
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 64;
+    while (capacity < readable + len)
+        capacity = capacity > SIZE_MAX / 2 ? readable + len : capacity * 2;
+    CByteBuffer_compact(buffer);
+    char *data = realloc(buffer->data, capacity);
+    if (data == NULL)
+        return CBYTEBUFFER_ALLOC_FAILURE;
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+char *CByteBuffer_write_ptr(CByteBuffer_t *buffer) {
+    return buffer ? buffer->data + buffer->write : NULL;
+}
+
+int CByteBuffer_commit(CByteBuffer_t *buffer, size_t len) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (len > buffer->capacity - buffer->write)
+        return CBYTEBUFFER_OUT_OF_RANGE;
+    buffer->write += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_clear(CByteBuffer_t *buffer) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    buffer->read = 0;
+    buffer->write = 0;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_put(CByteBuffer_t *buffer, const void *data, size_t len) {
+    int code = CByteBuffer_reserve(buffer, len);
+    if (code)
+        return code;
+    if (len)
+        memcpy(buffer->data + buffer->write, data, len);
+    buffer->write += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+/// \internal
+/// \brief Append the `size` low bytes of `value`, least significant first
+/// unless `big` is set.
+static int put_uint(CByteBuffer_t *buffer, uint64_t value, size_t size,
+                    int big) {
+    int code = CByteBuffer_reserve(buffer, size);
+    if (code)
+        return code;
+    unsigned char *p = (unsigned char *)buffer->data + buffer->write;
+    for (size_t i = 0; i < size; i++)
+        p[big ? size - 1 - i : i] = (unsigned char)(value >> (8 * i));
+    buffer->write += size;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+/// \internal
+/// \brief Read a `size` byte integer, least significant byte first unless
+/// `big` is set.
+static int get_uint(CByteBuffer_t *buffer, uint64_t *value, size_t size,
+                    int big) {
+    if (buffer == NULL || value == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (buffer->write - buffer->read < size)
+        return CBYTEBUFFER_UNDERFLOW;
+    const unsigned char *p =
+        (const unsigned char *)buffer->data + buffer->read;
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; i++)
+        result |= (uint64_t)p[big ? size - 1 - i : i] << (8 * i);
+    buffer->read += size;
+    *value = result;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_put_u8(CByteBuffer_t *buffer, uint8_t value) {
+    return put_uint(buffer, value, 1, 0);
+}
+
+int CByteBuffer_put_u16le(CByteBuffer_t *buffer, uint16_t value) {
+    return put_uint(buffer, value, 2, 0);
+}
+
+int CByteBuffer_put_u16be(CByteBuffer_t *buffer, uint16_t value) {
+    return put_uint(buffer, value, 2, 1);
+}
+
+int CByteBuffer_put_u32le(CByteBuffer_t *buffer, uint32_t value) {
+    return put_uint(buffer, value, 4, 0);
+}
+
+int CByteBuffer_put_u32be(CByteBuffer_t *buffer, uint32_t value) {
+    return put_uint(buffer, value, 4, 1);
+}
+
+int CByteBuffer_put_u64le(CByteBuffer_t *buffer, uint64_t value) {
+    return put_uint(buffer, value, 8, 0);
+}
+
+int CByteBuffer_put_u64be(CByteBuffer_t *buffer, uint64_t value) {
+    return put_uint(buffer, value, 8, 1);
+}
+
+int CByteBuffer_put_varint(CByteBuffer_t *buffer, uint64_t value) {
+    int code = CByteBuffer_reserve(buffer, CBYTEBUFFER_VARINT_MAX);
+    if (code)
+        return code;
+    unsigned char *p = (unsigned char *)buffer->data + buffer->write;
+    size_t len = 0;
+    while (value >= 0x80) {
+        p[len++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    p[len++] = (unsigned char)value;
+    buffer->write += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_put_svarint(CByteBuffer_t *buffer, int64_t value) {
+    // Interleaves the signs: 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    return CByteBuffer_put_varint(buffer, zigzag);
+}
+
+int CByteBuffer_get(CByteBuffer_t *buffer, void *data, size_t len) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (buffer->write - buffer->read < len)
+        return CBYTEBUFFER_UNDERFLOW;
+    if (len)
+        memcpy(data, buffer->data + buffer->read, len);
+    buffer->read += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_get_view(CByteBuffer_t *buffer, size_t len,
+                         CStringView_t *view) {
+    if (buffer == NULL || view == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (buffer->write - buffer->read < len)
+        return CBYTEBUFFER_UNDERFLOW;
+    *view = CStringView_from(buffer->data + buffer->read, len);
+    buffer->read += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_skip(CByteBuffer_t *buffer, size_t len) {
+    if (buffer == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    if (buffer->write - buffer->read < len)
+        return CBYTEBUFFER_UNDERFLOW;
+    buffer->read += len;
+    return CBYTEBUFFER_SUCCESS;
+}
+
+int CByteBuffer_get_u8(CByteBuffer_t *buffer, uint8_t *value) {
+    uint64_t result;
+    int code = get_uint(buffer, value ? &result : NULL, 1, 0);
+    if (!code)
+        *value = (uint8_t)result;
+    return code;
+}
+
+int CByteBuffer_get_u16le(CByteBuffer_t *buffer, uint16_t *value) {
+    uint64_t result;
+    int code = get_uint(buffer, value ? &result : NULL, 2, 0);
+    if (!code)
+        *value = (uint16_t)result;
+    return code;
+}
+
+int CByteBuffer_get_u16be(CByteBuffer_t *buffer, uint16_t *value) {
+    uint64_t result;
+    int code = get_uint(buffer, value ? &result : NULL, 2, 1);
+    if (!code)
+        *value = (uint16_t)result;
+    return code;
+}
+
+int CByteBuffer_get_u32le(CByteBuffer_t *buffer, uint32_t *value) {
+    uint64_t result;
+    int code = get_uint(buffer, value ? &result : NULL, 4, 0);
+    if (!code)
+        *value = (uint32_t)result;
+    return code;
+}
+
+int CByteBuffer_get_u32be(CByteBuffer_t *buffer, uint32_t *value) {
+    uint64_t result;
+    int code = get_uint(buffer, value ? &result : NULL, 4, 1);
+    if (!code)
+        *value = (uint32_t)result;
+    return code;
+}
+
+int CByteBuffer_get_u64le(CByteBuffer_t *buffer, uint64_t *value) {
+    return get_uint(buffer, value, 8, 0);
+}
+
+int CByteBuffer_get_u64be(CByteBuffer_t *buffer, uint64_t *value) {
+    return get_uint(buffer, value, 8, 1);
+}
+
+int CByteBuffer_get_varint(CByteBuffer_t *buffer, uint64_t *value) {
+    if (buffer == NULL || value == NULL)
+        return CBYTEBUFFER_NULL_BUFFER;
+    const unsigned char *p =
+        (const unsigned char *)buffer->data + buffer->read;
+    size_t readable = buffer->write - buffer->read;
+    uint64_t result = 0;
+    for (size_t i = 0; i < CBYTEBUFFER_VARINT_MAX; i++) {
+        if (i == readable)
+            return CBYTEBUFFER_UNDERFLOW;
+        uint64_t byte = p[i];
+        // The tenth byte only holds the top bit, and a zero last byte only
+        // pads a shorter encoding.
+        if ((i == CBYTEBUFFER_VARINT_MAX - 1 && byte > 1) || (i && !byte))
+            return CBYTEBUFFER_INVALID_VARINT;
+        result |= (byte & 0x7f) << (7 * i);
+        if (byte < 0x80) {
+            buffer->read += i + 1;
+            *value = result;
+            return CBYTEBUFFER_SUCCESS;
+        }
+    }
+    return CBYTEBUFFER_INVALID_VARINT;
+}
+
+int CByteBuffer_get_svarint(CByteBuffer_t *buffer, int64_t *value) {
+    uint64_t zigzag;
+    int code = CByteBuffer_get_varint(buffer, value ? &zigzag : NULL);
+    if (!code)
+        *value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    return code;
+}
+
+int CByteBuffer_free(CByteBuffer_t **buffer) {
+    if (buffer == NULL || *buffer == NULL)
+        return CBYTEBUFFER_SUCCESS;
+    free((*buffer)->data);
+    free(*buffer);
+    *buffer = NULL;
+    return CBYTEBUFFER_SUCCESS;
+}
@@ -0,0 +1,359 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _DEFAULT_SOURCE
+#include <cstd/CConstMap.h>
+#include <cstd/CFileWriter.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAGIC "CSTDCMAP"
+#define VERSION 1
+#define BYTE_ORDER_MARK 0x01020304u
+
+/// \internal
+/// \brief File header. Records follow it, then the table up to the end.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; ///< 0x01020304 in the builder's byte order.
+    uint64_t count;      ///< Number of records.
+    uint64_t slots;      ///< Number of table slots, a power of two.
+    uint64_t table;      ///< File offset of the table.
+} Header;
+
+/// \internal
+/// \brief Table slot. An offset of zero marks an empty slot.
+typedef struct {
+    uint64_t hash;
+    uint64_t offset;
+} Slot;
+
+/// \internal
+/// \brief Record header, followed by the key and the value, padded to 8
+/// bytes.
+typedef struct {
+    uint32_t key_len;
+    uint32_t value_len;
+} Record;
+
+struct _CConstMapBuilder {
+    char *path;            ///< Final path of the map.
+    char *temp;            ///< Temporary file being written.
+    int fd;                ///< Descriptor of `temp`.
+    CFileWriter_t *writer; ///< Writer streaming records to `fd`.
+    Slot *slots;           ///< One slot per record, in insertion order.
+    size_t count;          ///< Number of records.
+    size_t capacity;       ///< Capacity of `slots`.
+    uint64_t offset;       ///< File offset of the next record.
+    int error;             ///< First error encountered, if any.
+};
+
+struct _CConstMap {
+    const char *base;   ///< Start of the mapping.
+    size_t size;        ///< Size of the mapping.
+    const Slot *table;  ///< Slot table inside the mapping.
+    uint64_t mask;      ///< Number of slots minus one.
+    uint64_t count;     ///< Number of records.
+    uint64_t records;   ///< End of the records, where the table starts.
+};
+
+CResult_t *CConstMapBuilder_new(const char *path) {
+    if (path == NULL)
+        return CResult_ecreate(CError_create("Recieved a null path.",
+                                             "CConstMapBuilder_new",
+                                             CCONSTMAP_NULL_MAP));
+
+    CConstMapBuilder_t *builder = calloc(1, sizeof(CConstMapBuilder_t));
+    size_t len = strlen(path);
+    char *temp = malloc(len + 8);
+    char *copy = malloc(len + 1);
+    if (builder == NULL || temp == NULL || copy == NULL) {
+        free(builder);
+        free(temp);
+        free(copy);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CConstMapBuilder.",
+            "CConstMapBuilder_new", CCONSTMAP_ALLOC_FAILURE));
+    }
+    memcpy(copy, path, len + 1);
+    memcpy(temp, path, len);
+    memcpy(temp + len, ".XXXXXX", 8);
+
+    builder->path = copy;
+    builder->temp = temp;
+    builder->fd = mkstemp(temp);
+    if (builder->fd < 0) {
+        free(builder->path);
+        free(builder->temp);
+        free(builder);
+        return CResult_ecreate(
+            CError_create("Unable to create the temporary file.",
+                          "CConstMapBuilder_new", CCONSTMAP_IO_FAILURE));
+    }
+    // mkstemp only grants access to the owner, but maps are meant to be
+    // shared.
+    fchmod(builder->fd, 0644);
+
+    CResult_t *res = CFileWriter_from_fd(builder->fd, 0);
+    if (CResult_is_error(res)) {
+        CResult_free(&res);
+        builder->error = CCONSTMAP_ALLOC_FAILURE;
+        CConstMapBuilder_free(&builder);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CConstMapBuilder.",
+            "CConstMapBuilder_new", CCONSTMAP_ALLOC_FAILURE));
+    }
+    builder->writer = CResult_get(res);
+    CResult_free(&res);
+
+    // The header is written once the table is in place.
+    Header header = {{0}, 0, 0, 0, 0, 0};
+    CFileWriter_append(builder->writer, &header, sizeof(header));
+    builder->offset = sizeof(header);
+    return CResult_create(builder, NULL);
+}
+
+int CConstMapBuilder_add(CConstMapBuilder_t *builder, CStringView_t key,
+                         CStringView_t value) {
+    if (builder == NULL)
+        return CCONSTMAP_NULL_MAP;
+    if (builder->error)
+        return builder->error;
+    if (key.len > UINT32_MAX || value.len > UINT32_MAX) {
+        errno = EFBIG;
+        return builder->error = CCONSTMAP_IO_FAILURE;
+    }
+
+    if (builder->count == builder->capacity) {
+        size_t capacity = builder->capacity ? builder->capacity * 2 : 1024;
+        Slot *slots = realloc(builder->slots, capacity * sizeof(Slot));
+        if (slots == NULL)
+            return builder->error = CCONSTMAP_ALLOC_FAILURE;
+        builder->slots = slots;
+        builder->capacity = capacity;
+    }
+
+    static const char padding[8];
+    Record record = {(uint32_t)key.len, (uint32_t)value.len};
+    size_t len = sizeof(record) + key.len + value.len;
+    size_t pad = -len & 7;
+    CFileWriter_append(builder->writer, &record, sizeof(record));
+    CFileWriter_append(builder->writer, key.ptr, key.len);
+    CFileWriter_append(builder->writer, value.ptr, value.len);
+    CFileWriter_append(builder->writer, padding, pad);
+    if (CFileWriter_error(builder->writer))
+        return builder->error = CCONSTMAP_IO_FAILURE;
+
+    builder->slots[builder->count++] =
+        (Slot){CStringView_hash(key), builder->offset};
+    builder->offset += len + pad;
+    return CCONSTMAP_SUCCESS;
+}
+
+/// \internal
+/// \brief Append the table and fill in the header.
+static int write_table(CConstMapBuilder_t *builder) {
+    // At most half full, so that misses end quickly.
+    uint64_t slots = 2;
+    while (slots < builder->count * 2)
+        slots *= 2;
+    Slot *table = calloc(slots, sizeof(Slot));
+    if (table == NULL)
+        return CCONSTMAP_ALLOC_FAILURE;
+
+    // Inserting in order keeps the first duplicate of a key ahead of the
+    // others on its probe sequence.
+    for (size_t i = 0; i < builder->count; i++) {
+        uint64_t index = builder->slots[i].hash & (slots - 1);
+        while (table[index].offset)
+            index = (index + 1) & (slots - 1);
+        table[index] = builder->slots[i];
+    }
+    CFileWriter_append(builder->writer, table, slots * sizeof(Slot));
+    free(table);
+    if (CFileWriter_flush(builder->writer))
+        return CCONSTMAP_IO_FAILURE;
+
+    Header header = {{0},   VERSION, BYTE_ORDER_MARK, builder->count,
+                     slots, builder->offset};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    if (pwrite(builder->fd, &header, sizeof(header), 0) != sizeof(header) ||
+        fsync(builder->fd) || rename(builder->temp, builder->path))
+        return CCONSTMAP_IO_FAILURE;
+    return CCONSTMAP_SUCCESS;
+}
+
+int CConstMapBuilder_finish(CConstMapBuilder_t **builder) {
+    if (builder == NULL || *builder == NULL)
+        return CCONSTMAP_NULL_MAP;
+    CConstMapBuilder_t *b = *builder;
+    if (!b->error)
+        b->error = write_table(b);
+    int code = b->error;
+    if (!code) {
+        // The file is in place now, so there is nothing left to remove.
+        free(b->temp);
+        b->temp = NULL;
+    }
+    CConstMapBuilder_free(builder);
+    return code;
+}
+
+int CConstMapBuilder_free(CConstMapBuilder_t **builder) {
+    if (builder == NULL || *builder == NULL)
+        return CCONSTMAP_SUCCESS;
+    CConstMapBuilder_t *b = *builder;
+    CFileWriter_free(&b->writer);
+    close(b->fd);
+    if (b->temp != NULL)
+        unlink(b->temp);
+    free(b->temp);
+    free(b->path);
+    free(b->slots);
+    free(b);
+    *builder = NULL;
+    return CCONSTMAP_SUCCESS;
+}
+
+CResult_t *CConstMap_open(const char *path) {
+    if (path == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null path.", "CConstMap_open", CCONSTMAP_NULL_MAP));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+        if (fd >= 0)
+            close(fd);
+        return CResult_ecreate(CError_create(
+            "Unable to open the file.", "CConstMap_open",
+            CCONSTMAP_IO_FAILURE));
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(Header)) {
+        close(fd);
+        return CResult_ecreate(
+            CError_create("The file is not a constant map.",
+                          "CConstMap_open", CCONSTMAP_INVALID_FILE));
+    }
+    const char *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return CResult_ecreate(CError_create(
+            "Unable to map the file.", "CConstMap_open",
+            CCONSTMAP_IO_FAILURE));
+
+    Header header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, MAGIC, 8) || header.version != VERSION ||
+        header.byte_order != BYTE_ORDER_MARK || header.slots == 0 ||
+        (header.slots & (header.slots - 1)) || header.count > header.slots ||
+        header.table < sizeof(Header) || header.table % 8 ||
+        header.table > size ||
+        (size - header.table) / sizeof(Slot) != header.slots ||
+        (size - header.table) % sizeof(Slot)) {
+        munmap((void *)base, size);
+        return CResult_ecreate(
+            CError_create("The file is not a constant map.",
+                          "CConstMap_open", CCONSTMAP_INVALID_FILE));
+    }
+
+    CConstMap_t *map = malloc(sizeof(CConstMap_t));
+    if (map == NULL) {
+        munmap((void *)base, size);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CConstMap.", "CConstMap_open",
+            CCONSTMAP_ALLOC_FAILURE));
+    }
+    // Lookups jump around the file; readahead would only pull in pages that
+    // are not needed.
+    madvise((void *)base, size, MADV_RANDOM);
+
+    map->base = base;
+    map->size = size;
+    map->table = (const Slot *)(base + header.table);
+    map->mask = header.slots - 1;
+    map->count = header.count;
+    map->records = header.table;
+    return CResult_create(map, NULL);
+}
+
+size_t CConstMap_size(const CConstMap_t *map) {
+    return map ? (size_t)map->count : 0;
+}
+
+int CConstMap_get(const CConstMap_t *map, CStringView_t key,
+                  CStringView_t *value) {
+    if (map == NULL)
+        return CCONSTMAP_NULL_MAP;
+
+    uint64_t hash = CStringView_hash(key);
+    uint64_t index = hash & map->mask;
+    for (uint64_t probes = 0; probes <= map->mask; probes++) {
+        const Slot *slot = &map->table[index];
+        if (slot->offset == 0)
+            break;
+        // Bounds are checked so that a damaged file cannot read past the
+        // records.
+        if (slot->hash == hash && slot->offset >= sizeof(Header) &&
+            slot->offset <= map->records - sizeof(Record)) {
+            Record record;
+            memcpy(&record, map->base + slot->offset, sizeof(record));
+            const char *data = map->base + slot->offset + sizeof(record);
+            if (record.key_len == key.len &&
+                (uint64_t)record.key_len + record.value_len <=
+                    map->records - slot->offset - sizeof(record) &&
+                (key.len == 0 || memcmp(data, key.ptr, key.len) == 0)) {
+                if (value != NULL)
+                    *value = CStringView_from(data + key.len,
+                                              record.value_len);
+                return CCONSTMAP_SUCCESS;
+            }
+        }
+        index = (index + 1) & map->mask;
+    }
+    return CCONSTMAP_NOT_FOUND;
+}
+
+int CConstMap_free(CConstMap_t **map) {
+    if (map == NULL || *map == NULL)
+        return CCONSTMAP_SUCCESS;
+    munmap((void *)(*map)->base, (*map)->size);
+    free(*map);
+    *map = NULL;
+    return CCONSTMAP_SUCCESS;
+}
+
+#endif // POSIX
@@ -0,0 +1,261 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CDeque.h>
+#include <stdlib.h>
+
+/// \internal
+/// \brief Number of elements per block, a power of two.
+#define BLOCK_SIZE 64
+
+/// \internal
+/// \brief Number of blocks the map starts with, a power of two.
+#define MIN_BLOCKS 8
+
+/// \internal
+/// \brief Number of emptied blocks kept for reuse.
+#define MAX_SPARES 2
+
+/// \internal
+/// \brief Positions are taken modulo `blocks * BLOCK_SIZE`, so the map is
+/// circular and either end can grow into the blocks freed by the other.
+/// The deque holds at most `(blocks - 1) * BLOCK_SIZE` elements, which keeps
+/// the first and last blocks apart and lets the map grow by copying block
+/// pointers alone. A slot of the map holds a block exactly when the block
+/// holds elements.
+struct _CDeque {
+    void ***map;               ///< Blocks, NULL where no element is stored.
+    size_t blocks;             ///< Number of slots in `map`, a power of two.
+    size_t start;              ///< Position of the first element.
+    size_t size;               ///< Number of elements.
+    Destructor destroy;        ///< Destructor for the elements, or NULL.
+    void **spares[MAX_SPARES]; ///< Emptied blocks waiting to be reused.
+    size_t spare_count;        ///< Number of blocks in `spares`.
+};
+
+static size_t position(const CDeque_t *deque, size_t index) {
+    return (deque->start + index) & (deque->blocks * BLOCK_SIZE - 1);
+}
+
+static void **slot(const CDeque_t *deque, size_t position) {
+    return &deque->map[position / BLOCK_SIZE][position % BLOCK_SIZE];
+}
+
+/// \internal
+/// \brief Double the map if it has no room for one more element.
+static int reserve(CDeque_t *deque) {
+    if (deque->size == (deque->blocks - 1) * BLOCK_SIZE) {
+        void ***map = calloc(deque->blocks * 2, sizeof(void **));
+        if (map == NULL)
+            return CDEQUE_ALLOC_FAILURE;
+        // Unroll the circle, first block first.
+        size_t first = deque->start / BLOCK_SIZE;
+        for (size_t i = 0; i < deque->blocks; i++)
+            map[i] = deque->map[(first + i) & (deque->blocks - 1)];
+        free(deque->map);
+        deque->map = map;
+        deque->blocks *= 2;
+        deque->start %= BLOCK_SIZE;
+    }
+    return CDEQUE_SUCCESS;
+}
+
+/// \internal
+/// \brief Provide the block holding `position`, reusing a spare if there is
+/// one.
+static int ensure_block(CDeque_t *deque, size_t position) {
+    void ***block = &deque->map[position / BLOCK_SIZE];
+    if (*block == NULL) {
+        if (deque->spare_count > 0) {
+            *block = deque->spares[--deque->spare_count];
+            return CDEQUE_SUCCESS;
+        }
+        *block = malloc(BLOCK_SIZE * sizeof(void *));
+        if (*block == NULL)
+            return CDEQUE_ALLOC_FAILURE;
+    }
+    return CDEQUE_SUCCESS;
+}
+
+/// \internal
+/// \brief Take the block holding `position`, which no longer holds any
+/// element, out of the map. It is kept as a spare or freed.
+static void release_block(CDeque_t *deque, size_t position) {
+    void ***block = &deque->map[position / BLOCK_SIZE];
+    if (deque->spare_count < MAX_SPARES)
+        deque->spares[deque->spare_count++] = *block;
+    else
+        free(*block);
+    *block = NULL;
+}
+
+CResult_t *CDeque_new(Destructor destroy) {
+    CDeque_t *deque = malloc(sizeof(CDeque_t));
+    void ***map = calloc(MIN_BLOCKS, sizeof(void **));
+    if (deque == NULL || map == NULL) {
+        free(deque);
+        free(map);
+        return CResult_ecreate(
+            CError_create("Failed memory allocation for the deque.",
+                          "CDeque_new", CDEQUE_ALLOC_FAILURE));
+    }
+    deque->map = map;
+    deque->blocks = MIN_BLOCKS;
+    deque->start = 0;
+    deque->size = 0;
+    deque->destroy = destroy;
+    deque->spare_count = 0;
+    return CResult_create(deque, NULL);
+}
+
+size_t CDeque_size(const CDeque_t *deque) {
+    return deque == NULL ? 0 : deque->size;
+}
+
+int CDeque_push_back(CDeque_t *deque, void *element) {
+    if (deque == NULL)
+        return CDEQUE_NULL_DEQUE;
+    if (reserve(deque) != CDEQUE_SUCCESS)
+        return CDEQUE_ALLOC_FAILURE;
+    size_t pos = position(deque, deque->size);
+    if (ensure_block(deque, pos) != CDEQUE_SUCCESS)
+        return CDEQUE_ALLOC_FAILURE;
+    *slot(deque, pos) = element;
+    deque->size++;
+    return CDEQUE_SUCCESS;
+}
+
+int CDeque_push_front(CDeque_t *deque, void *element) {
+    if (deque == NULL)
+        return CDEQUE_NULL_DEQUE;
+    if (reserve(deque) != CDEQUE_SUCCESS)
+        return CDEQUE_ALLOC_FAILURE;
+    size_t pos = position(deque, (size_t)-1);
+    if (ensure_block(deque, pos) != CDEQUE_SUCCESS)
+        return CDEQUE_ALLOC_FAILURE;
+    *slot(deque, pos) = element;
+    deque->start = pos;
+    deque->size++;
+    return CDEQUE_SUCCESS;
+}
+
+void *CDeque_fpop_back(CDeque_t *deque) {
+    if (deque == NULL || deque->size == 0)
+        return NULL;
+    deque->size--;
+    size_t pos = position(deque, deque->size);
+    void *element = *slot(deque, pos);
+    if (deque->size == 0 || pos % BLOCK_SIZE == 0)
+        release_block(deque, pos);
+    return element;
+}
+
+void *CDeque_fpop_front(CDeque_t *deque) {
+    if (deque == NULL || deque->size == 0)
+        return NULL;
+    size_t pos = deque->start;
+    void *element = *slot(deque, pos);
+    deque->start = position(deque, 1);
+    deque->size--;
+    if (deque->size == 0 || deque->start % BLOCK_SIZE == 0)
+        release_block(deque, pos);
+    return element;
+}
+
+static CResult_t *pop_error(const CDeque_t *deque, const char *function) {
+    if (deque == NULL)
+        return CResult_ecreate(
+            CError_create("Recieved a null pointer to the deque.", function,
+                          CDEQUE_NULL_DEQUE));
+    return CResult_ecreate(
+        CError_create("The deque is empty.", function, CDEQUE_EMPTY));
+}
+
+CResult_t *CDeque_pop_back(CDeque_t *deque) {
+    if (deque == NULL || deque->size == 0)
+        return pop_error(deque, "CDeque_pop_back");
+    return CResult_create(CDeque_fpop_back(deque), NULL);
+}
+
+CResult_t *CDeque_pop_front(CDeque_t *deque) {
+    if (deque == NULL || deque->size == 0)
+        return pop_error(deque, "CDeque_pop_front");
+    return CResult_create(CDeque_fpop_front(deque), NULL);
+}
+
+void *CDeque_fget(const CDeque_t *deque, size_t index) {
+    if (deque == NULL || index >= deque->size)
+        return NULL;
+    return *slot(deque, position(deque, index));
+}
+
+CResult_t *CDeque_get(const CDeque_t *deque, size_t index) {
+    if (deque == NULL)
+        return CResult_ecreate(
+            CError_create("Recieved a null pointer to the deque.",
+                          "CDeque_get", CDEQUE_NULL_DEQUE));
+    if (index >= deque->size)
+        return CResult_ecreate(
+            CError_create("Index exceeds the size of the deque.",
+                          "CDeque_get", CDEQUE_INDEX_OUT_OF_BOUNDS));
+    return CResult_create(*slot(deque, position(deque, index)), NULL);
+}
+
+int CDeque_set(CDeque_t *deque, size_t index, void *element) {
+    if (deque == NULL)
+        return CDEQUE_NULL_DEQUE;
+    if (index >= deque->size)
+        return CDEQUE_INDEX_OUT_OF_BOUNDS;
+    *slot(deque, position(deque, index)) = element;
+    return CDEQUE_SUCCESS;
+}
+
+int CDeque_clear(CDeque_t *deque) {
+    if (deque == NULL)
+        return CDEQUE_NULL_DEQUE;
+    if (deque->destroy != NULL) {
+        for (size_t i = 0; i < deque->size; i++)
+            deque->destroy(*slot(deque, position(deque, i)));
+    }
+    for (size_t i = 0; i < deque->blocks; i++) {
+        free(deque->map[i]);
+        deque->map[i] = NULL;
+    }
+    while (deque->spare_count > 0)
+        free(deque->spares[--deque->spare_count]);
+    deque->start = 0;
+    deque->size = 0;
+    return CDEQUE_SUCCESS;
+}
+
+int CDeque_free(CDeque_t **deque) {
+    if (deque == NULL || *deque == NULL)
+        return CDEQUE_SUCCESS;
+    CDeque_clear(*deque);
+    free((*deque)->map);
+    free(*deque);
+    *deque = NULL;
+    return CDEQUE_SUCCESS;
+}
@@ -0,0 +1,622 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _DEFAULT_SOURCE
+#include <cstd/CDiskQueue.h>
+#include <cstd/CString.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+#define CHECKPOINT "checkpoint"
+#define SPARE "spare"
+#define SUFFIX ".seg"
+#define NAME_SIZE 24
+
+/// \internal
+/// \brief Record header, followed by the record and padded to 8 bytes.
+/// \details The checksum covers the length, the segment id and the record.
+/// Records left over from the previous use of a recycled segment carry an
+/// older id, which is how the end of a segment is recognised.
+typedef struct {
+    uint32_t len;
+    uint32_t crc;
+    uint64_t segment;
+} Record;
+
+/// \internal
+/// \brief Checkpoint, stored twice in alternation so that a torn write
+/// leaves the previous one readable.
+typedef struct {
+    uint64_t sequence;     ///< Incremented on every write, 0 when unused.
+    uint64_t segment;      ///< Segment of the first unconsumed record.
+    uint64_t offset;       ///< Offset of the first unconsumed record.
+    uint64_t tail_segment; ///< Segment being appended to.
+    uint64_t tail_offset;  ///< End of the last record pushed.
+    uint32_t closed;       ///< Set when the queue was closed cleanly.
+    uint32_t crc;
+} Checkpoint;
+
+#define CHECKPOINT_SLOT 64
+
+/// \internal
+/// \brief A mapped segment file.
+typedef struct {
+    uint64_t id;
+    int fd;     ///< Kept open for the segment being appended to only.
+    char *base;
+    size_t size;
+} Segment;
+
+struct _CDiskQueue {
+    int dir;              ///< Descriptor of the directory.
+    int checkpoint;       ///< Descriptor of the checkpoint file, also locked.
+    uint64_t sequence;    ///< Sequence of the last checkpoint written.
+    size_t segment_size;  ///< Size of new segments.
+    size_t sync_every;    ///< Pushes between automatic syncs, 0 for none.
+    size_t unsynced;      ///< Pushes since the last sync.
+    int moved;            ///< Whether records were popped since the last sync.
+    int spare;            ///< Whether a consumed segment is kept for reuse.
+    size_t count;         ///< Number of records in the queue.
+    uint64_t *ids;        ///< Ids of the segments on disk, oldest first.
+    size_t segments;      ///< Number of ids.
+    size_t capacity;      ///< Capacity of `ids`.
+    Segment head;         ///< Segment being consumed.
+    uint64_t head_offset; ///< Offset of the next record to pop.
+    Segment tail;         ///< Segment being appended to.
+    uint64_t tail_offset; ///< Offset of the next record to push.
+};
+
+/// \internal
+/// \brief Update a CRC-32C (Castagnoli) checksum.
+static uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = data;
+    crc = ~crc;
+#ifdef __SSE4_2__
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = (uint32_t)_mm_crc32_u64(crc, word);
+    }
+    for (; len; len--)
+        crc = _mm_crc32_u8(crc, *p++);
+#else
+    for (; len; len--) {
+        crc ^= *p++;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0x82F63B78u & -(crc & 1));
+    }
+#endif
+    return ~crc;
+}
+
+static uint32_t record_crc(uint64_t segment, uint32_t len, const void *data) {
+    uint32_t crc = crc32c(0, &segment, sizeof(segment));
+    crc = crc32c(crc, &len, sizeof(len));
+    return crc32c(crc, data, len);
+}
+
+static void segment_name(char *name, uint64_t id) {
+    snprintf(name, NAME_SIZE, "%016" PRIx64 SUFFIX, id);
+}
+
+/// \internal
+/// \brief Offset following a record, clamped to the end of the segment.
+static uint64_t advance(uint64_t offset, uint32_t len, size_t size) {
+    uint64_t next = offset + ((sizeof(Record) + len + 7) & ~(uint64_t)7);
+    return next < size ? next : size;
+}
+
+/// \internal
+/// \brief Read the record at `offset`.
+/// \return The offset of the next record, or 0 if there is no valid record at
+/// `offset`.
+static uint64_t read_record(const Segment *segment, uint64_t offset,
+                            CStringView_t *record) {
+    if (segment->size < sizeof(Record) ||
+        offset > segment->size - sizeof(Record))
+        return 0;
+    Record header;
+    memcpy(&header, segment->base + offset, sizeof(header));
+    const char *data = segment->base + offset + sizeof(header);
+    if (header.segment != segment->id ||
+        header.len > segment->size - offset - sizeof(header) ||
+        header.crc != record_crc(header.segment, header.len, data))
+        return 0;
+    *record = CStringView_from(data, header.len);
+    return advance(offset, header.len, segment->size);
+}
+
+static int map_segment(CDiskQueue_t *queue, Segment *segment, uint64_t id,
+                       int writable) {
+    char name[NAME_SIZE];
+    segment_name(name, id);
+    int fd = openat(queue->dir, name, (writable ? O_RDWR : O_RDONLY) |
+                                          O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+        if (fd >= 0)
+            close(fd);
+        return CDISKQUEUE_IO_FAILURE;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = size ? mmap(NULL, size,
+                             writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                             MAP_SHARED, fd, 0)
+                      : NULL;
+    if (base == MAP_FAILED) {
+        close(fd);
+        return CDISKQUEUE_IO_FAILURE;
+    }
+    if (!writable) {
+        madvise(base, size, MADV_SEQUENTIAL);
+        close(fd);
+        fd = -1;
+    }
+    *segment = (Segment){id, fd, base, size};
+    return CDISKQUEUE_SUCCESS;
+}
+
+static void unmap_segment(Segment *segment) {
+    if (segment->base != NULL)
+        munmap(segment->base, segment->size);
+    if (segment->fd >= 0)
+        close(segment->fd);
+    *segment = (Segment){0, -1, NULL, 0};
+}
+
+/// \internal
+/// \brief Create the segment file `id` and append it to the list.
+static int create_segment(CDiskQueue_t *queue, uint64_t id) {
+    if (queue->segments == queue->capacity) {
+        size_t capacity = queue->capacity ? queue->capacity * 2 : 8;
+        uint64_t *ids = realloc(queue->ids, capacity * sizeof(uint64_t));
+        if (ids == NULL)
+            return CDISKQUEUE_ALLOC_FAILURE;
+        queue->ids = ids;
+        queue->capacity = capacity;
+    }
+
+    char name[NAME_SIZE];
+    segment_name(name, id);
+    // Reusing a consumed segment saves allocating its blocks again.
+    if (queue->spare) {
+        if (renameat(queue->dir, SPARE, queue->dir, name))
+            return CDISKQUEUE_IO_FAILURE;
+        queue->spare = 0;
+    }
+    int fd = openat(queue->dir, name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return CDISKQUEUE_IO_FAILURE;
+    // Allocating the blocks up front keeps a full disk from turning into
+    // SIGBUS on a store, and spares `fdatasync` from updating the size.
+    struct stat st;
+    int error = fstat(fd, &st) ? errno : 0;
+    if (!error && (size_t)st.st_size > queue->segment_size &&
+        ftruncate(fd, (off_t)queue->segment_size))
+        error = errno;
+    if (!error)
+        error = posix_fallocate(fd, 0, (off_t)queue->segment_size);
+    close(fd);
+    if (error || fsync(queue->dir)) {
+        if (error)
+            errno = error;
+        return CDISKQUEUE_IO_FAILURE;
+    }
+    queue->ids[queue->segments++] = id;
+    return CDISKQUEUE_SUCCESS;
+}
+
+/// \internal
+/// \brief Start appending to a new segment.
+static int roll(CDiskQueue_t *queue) {
+    // Records in the old segment must not become durable after those in the
+    // new one.
+    if (queue->unsynced && queue->tail.fd >= 0) {
+        if (fdatasync(queue->tail.fd))
+            return CDISKQUEUE_IO_FAILURE;
+        queue->unsynced = 0;
+    }
+    uint64_t id = queue->ids[queue->segments - 1] + 1;
+    int code = create_segment(queue, id);
+    if (code)
+        return code;
+    unmap_segment(&queue->tail);
+    queue->tail_offset = 0;
+    return map_segment(queue, &queue->tail, id, 1);
+}
+
+static int write_checkpoint(CDiskQueue_t *queue, uint32_t closed) {
+    Checkpoint checkpoint = {queue->sequence + 1, queue->head.id,
+                             queue->head_offset, queue->tail.id,
+                             queue->tail_offset, closed, 0};
+    checkpoint.crc = crc32c(0, &checkpoint, offsetof(Checkpoint, crc));
+    off_t at = (off_t)(checkpoint.sequence & 1) * CHECKPOINT_SLOT;
+    if (pwrite(queue->checkpoint, &checkpoint, sizeof(checkpoint), at) !=
+            sizeof(checkpoint) ||
+        fdatasync(queue->checkpoint))
+        return CDISKQUEUE_IO_FAILURE;
+    queue->sequence = checkpoint.sequence;
+    return CDISKQUEUE_SUCCESS;
+}
+
+/// \internal
+/// \brief Read the latest valid checkpoint, or zeroes if there is none.
+static Checkpoint read_checkpoint(CDiskQueue_t *queue) {
+    Checkpoint best = {0, 0, 0, 0, 0, 0, 0};
+    for (int slot = 0; slot < 2; slot++) {
+        Checkpoint checkpoint;
+        if (pread(queue->checkpoint, &checkpoint, sizeof(checkpoint),
+                  slot * CHECKPOINT_SLOT) == sizeof(checkpoint) &&
+            checkpoint.sequence > best.sequence &&
+            checkpoint.crc ==
+                crc32c(0, &checkpoint, offsetof(Checkpoint, crc)))
+            best = checkpoint;
+    }
+    return best;
+}
+
+/// \internal
+/// \brief Recycle the segments that lie before the head.
+/// \details Only called once a checkpoint past them is durable, so that a
+/// crash can never go back to a recycled segment.
+static int recycle(CDiskQueue_t *queue) {
+    size_t done = 0;
+    int code = CDISKQUEUE_SUCCESS;
+    while (done < queue->segments && queue->ids[done] < queue->head.id) {
+        char name[NAME_SIZE];
+        segment_name(name, queue->ids[done]);
+        if (!queue->spare) {
+            if (renameat(queue->dir, name, queue->dir, SPARE)) {
+                code = CDISKQUEUE_IO_FAILURE;
+                break;
+            }
+            queue->spare = 1;
+        } else if (unlinkat(queue->dir, name, 0)) {
+            code = CDISKQUEUE_IO_FAILURE;
+            break;
+        }
+        done++;
+    }
+    queue->segments -= done;
+    memmove(queue->ids, queue->ids + done, queue->segments * sizeof(uint64_t));
+    return code;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/// \internal
+/// \brief Collect the ids of the segments in the directory, in order.
+static int list_segments(CDiskQueue_t *queue) {
+    int fd = dup(queue->dir);
+    DIR *dir = fd >= 0 ? fdopendir(fd) : NULL;
+    if (dir == NULL) {
+        if (fd >= 0)
+            close(fd);
+        return CDISKQUEUE_IO_FAILURE;
+    }
+    int code = CDISKQUEUE_SUCCESS;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, SPARE) == 0) {
+            queue->spare = 1;
+            continue;
+        }
+        char *end;
+        uint64_t id = strtoull(entry->d_name, &end, 16);
+        if (end != entry->d_name + 16 || strcmp(end, SUFFIX) || id == 0)
+            continue;
+        if (queue->segments == queue->capacity) {
+            size_t capacity = queue->capacity ? queue->capacity * 2 : 8;
+            uint64_t *ids = realloc(queue->ids, capacity * sizeof(uint64_t));
+            if (ids == NULL) {
+                code = CDISKQUEUE_ALLOC_FAILURE;
+                break;
+            }
+            queue->ids = ids;
+            queue->capacity = capacity;
+        }
+        queue->ids[queue->segments++] = id;
+    }
+    closedir(dir);
+    if (queue->segments)
+        qsort(queue->ids, queue->segments, sizeof(uint64_t), compare_u64);
+    return code;
+}
+
+/// \internal
+/// \brief Count the records from the checkpoint on and find where to append.
+static int recover(CDiskQueue_t *queue, const Checkpoint *checkpoint) {
+    int code = list_segments(queue);
+    if (code)
+        return code;
+
+    // Segments before the checkpoint have been consumed.
+    size_t first = 0;
+    int fresh = 0;
+    while (first < queue->segments &&
+           queue->ids[first] < checkpoint->segment)
+        first++;
+    if (first == queue->segments) {
+        queue->head.id = checkpoint->segment + 1;
+        if ((code = recycle(queue)) ||
+            (code = create_segment(queue, checkpoint->segment + 1)))
+            return code;
+        first = 0;
+        fresh = 1;
+    }
+    uint64_t id = queue->ids[first];
+    queue->head_offset = id == checkpoint->segment ? checkpoint->offset : 0;
+    if ((code = map_segment(queue, &queue->head, id, 0)))
+        return code;
+    if ((code = recycle(queue)))
+        return code;
+
+    // Scan every segment from the head on.
+    CStringView_t record;
+    uint64_t offset = queue->head_offset, next;
+    while ((next = read_record(&queue->head, offset, &record)) != 0) {
+        offset = next;
+        queue->count++;
+    }
+    for (size_t i = 1; i < queue->segments; i++) {
+        Segment segment;
+        if ((code = map_segment(queue, &segment, queue->ids[i], 0)))
+            return code;
+        offset = 0;
+        while ((next = read_record(&segment, offset, &record)) != 0) {
+            offset = next;
+            queue->count++;
+        }
+        unmap_segment(&segment);
+    }
+
+    // Bytes past the last valid record may still hold valid records that
+    // followed a torn one, which appending would bring back. The end is only
+    // trusted in a new segment, or if the queue was closed cleanly right
+    // there.
+    uint64_t last = queue->ids[queue->segments - 1];
+    if (fresh) {
+        queue->tail_offset = 0;
+        return map_segment(queue, &queue->tail, last, 1);
+    }
+    if (checkpoint->closed && checkpoint->tail_segment == last &&
+        checkpoint->tail_offset == offset) {
+        queue->tail_offset = offset;
+        if ((code = map_segment(queue, &queue->tail, last, 1)))
+            return code;
+        // Appending makes the checkpoint stale.
+        return write_checkpoint(queue, 0);
+    }
+    if ((code = map_segment(queue, &queue->tail, last, 1)))
+        return code;
+    return roll(queue);
+}
+
+CResult_t *CDiskQueue_new(const char *dir, size_t segment_size,
+                          size_t sync_every) {
+    if (dir == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null path.", "CDiskQueue_new", CDISKQUEUE_NULL_QUEUE));
+
+    CDiskQueue_t *queue = calloc(1, sizeof(CDiskQueue_t));
+    if (queue == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CDiskQueue.", "CDiskQueue_new",
+            CDISKQUEUE_ALLOC_FAILURE));
+    if (segment_size == 0)
+        segment_size = CDISKQUEUE_SEGMENT_SIZE;
+    if (segment_size < 2 * sizeof(Record))
+        segment_size = 2 * sizeof(Record);
+    queue->segment_size = (segment_size + 7) & ~(size_t)7;
+    queue->sync_every = sync_every;
+    queue->head = queue->tail = (Segment){0, -1, NULL, 0};
+
+    if (mkdir(dir, 0755) && errno != EEXIST) {
+        free(queue);
+        return CResult_ecreate(
+            CError_create("Unable to create the directory.",
+                          "CDiskQueue_new", CDISKQUEUE_IO_FAILURE));
+    }
+    queue->dir = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    queue->checkpoint =
+        queue->dir < 0 ? -1
+                       : openat(queue->dir, CHECKPOINT,
+                                O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (queue->checkpoint < 0) {
+        if (queue->dir >= 0)
+            close(queue->dir);
+        free(queue);
+        return CResult_ecreate(
+            CError_create("Unable to open the directory.", "CDiskQueue_new",
+                          CDISKQUEUE_IO_FAILURE));
+    }
+    if (flock(queue->checkpoint, LOCK_EX | LOCK_NB)) {
+        close(queue->checkpoint);
+        close(queue->dir);
+        free(queue);
+        return CResult_ecreate(
+            CError_create("The queue is already open.", "CDiskQueue_new",
+                          CDISKQUEUE_IO_FAILURE));
+    }
+
+    Checkpoint checkpoint = read_checkpoint(queue);
+    queue->sequence = checkpoint.sequence;
+    struct stat st;
+    int code = fstat(queue->checkpoint, &st) ? CDISKQUEUE_IO_FAILURE : 0;
+    // Both slots are allocated once, so that `fdatasync` never has to update
+    // the size of the file.
+    if (!code && st.st_size < 2 * CHECKPOINT_SLOT &&
+        (ftruncate(queue->checkpoint, 2 * CHECKPOINT_SLOT) ||
+         fsync(queue->checkpoint)))
+        code = CDISKQUEUE_IO_FAILURE;
+    if (!code)
+        code = recover(queue, &checkpoint);
+    if (code) {
+        unmap_segment(&queue->head);
+        unmap_segment(&queue->tail);
+        close(queue->checkpoint);
+        close(queue->dir);
+        free(queue->ids);
+        free(queue);
+        return CResult_ecreate(CError_create(
+            code == CDISKQUEUE_ALLOC_FAILURE
+                ? "Unable to allocate memory for CDiskQueue."
+                : "Unable to recover the queue.",
+            "CDiskQueue_new", code));
+    }
+    return CResult_create(queue, NULL);
+}
+
+size_t CDiskQueue_size(const CDiskQueue_t *queue) {
+    return queue ? queue->count : 0;
+}
+
+int CDiskQueue_push(CDiskQueue_t *queue, CStringView_t record) {
+    if (queue == NULL)
+        return CDISKQUEUE_NULL_QUEUE;
+    if (record.len > UINT32_MAX ||
+        sizeof(Record) + record.len > queue->segment_size)
+        return CDISKQUEUE_TOO_LARGE;
+
+    if (sizeof(Record) + record.len > queue->tail.size - queue->tail_offset) {
+        int code = roll(queue);
+        if (code)
+            return code;
+    }
+
+    char *at = queue->tail.base + queue->tail_offset;
+    Record header = {(uint32_t)record.len, 0, queue->tail.id};
+    header.crc = record_crc(header.segment, header.len, record.ptr);
+    memcpy(at, &header, sizeof(header));
+    if (record.len)
+        memcpy(at + sizeof(header), record.ptr, record.len);
+    queue->tail_offset =
+        advance(queue->tail_offset, header.len, queue->tail.size);
+    queue->count++;
+
+    if (++queue->unsynced == queue->sync_every)
+        return CDiskQueue_sync(queue);
+    return CDISKQUEUE_SUCCESS;
+}
+
+int CDiskQueue_pop_view(CDiskQueue_t *queue, CStringView_t *record) {
+    if (queue == NULL || record == NULL)
+        return CDISKQUEUE_NULL_QUEUE;
+    if (queue->count == 0)
+        return CDISKQUEUE_EMPTY;
+
+    for (;;) {
+        uint64_t next = read_record(&queue->head, queue->head_offset, record);
+        if (next) {
+            queue->head_offset = next;
+            queue->count--;
+            queue->moved = 1;
+            return CDISKQUEUE_SUCCESS;
+        }
+        // The end of the segment; the rest of the queue is in the next one.
+        size_t i = 0;
+        while (i < queue->segments && queue->ids[i] <= queue->head.id)
+            i++;
+        if (i == queue->segments)
+            return CDISKQUEUE_INVALID_RECORD;
+        unmap_segment(&queue->head);
+        queue->head_offset = 0;
+        queue->moved = 1;
+        if (map_segment(queue, &queue->head, queue->ids[i], 0))
+            return CDISKQUEUE_IO_FAILURE;
+    }
+}
+
+CResult_t *CDiskQueue_pop(CDiskQueue_t *queue) {
+    CStringView_t record;
+    int code = CDiskQueue_pop_view(queue, &record);
+    if (code == CDISKQUEUE_NULL_QUEUE)
+        return CResult_ecreate(CError_create(
+            "Queue is NULL.", "CDiskQueue_pop", CDISKQUEUE_NULL_QUEUE));
+    if (code == CDISKQUEUE_EMPTY)
+        return CResult_ecreate(CError_create("Queue is empty.",
+                                             "CDiskQueue_pop",
+                                             CDISKQUEUE_EMPTY));
+    if (code)
+        return CResult_ecreate(CError_create(
+            "Unable to read the record.", "CDiskQueue_pop", code));
+    return CString_from_view(record);
+}
+
+int CDiskQueue_sync(CDiskQueue_t *queue) {
+    if (queue == NULL)
+        return CDISKQUEUE_NULL_QUEUE;
+    if (queue->unsynced) {
+        if (fdatasync(queue->tail.fd))
+            return CDISKQUEUE_IO_FAILURE;
+        queue->unsynced = 0;
+    }
+    if (queue->moved) {
+        int code = write_checkpoint(queue, 0);
+        if (code)
+            return code;
+        queue->moved = 0;
+        return recycle(queue);
+    }
+    return CDISKQUEUE_SUCCESS;
+}
+
+int CDiskQueue_free(CDiskQueue_t **queue) {
+    if (queue == NULL || *queue == NULL)
+        return CDISKQUEUE_SUCCESS;
+    CDiskQueue_t *q = *queue;
+    int code = CDiskQueue_sync(q);
+    if (!code)
+        code = write_checkpoint(q, 1);
+    unmap_segment(&q->head);
+    unmap_segment(&q->tail);
+    close(q->checkpoint);
+    close(q->dir);
+    free(q->ids);
+    free(q);
+    *queue = NULL;
+    return code;
+}
+
+#endif // POSIX
@@ -0,0 +1,291 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _DEFAULT_SOURCE
+#include <cstd/CFileReader.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct _CFileReader {
+    int fd;          ///< File being read.
+    int owns_fd;     ///< Whether the reader closes `fd` when freed.
+    int mode;        ///< `CFILEREADER_MMAP` or `CFILEREADER_READ`.
+    int eof;         ///< Whether `buffer` holds everything left to read.
+    int error;       ///< Sticky error code, `CFILEREADER_SUCCESS` if none.
+    char *buffer;    ///< The mapping, or the buffer filled by `read()`.
+    size_t capacity; ///< Size of `buffer`.
+    size_t start;    ///< Offset of the first unconsumed character.
+    size_t scanned;  ///< Offset up to which no delimiter was found.
+    size_t end;      ///< Offset one past the last valid character.
+};
+
+/// \internal
+/// \brief Discard the consumed characters and read more after the rest,
+/// growing the buffer when the rest fills it.
+static int refill(CFileReader_t *reader) {
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start,
+                reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->scanned -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->end == reader->capacity) {
+        size_t capacity = reader->capacity * 2;
+        char *buffer = realloc(reader->buffer, capacity);
+        if (buffer == NULL)
+            return reader->error = CFILEREADER_ALLOC_FAILURE;
+        reader->buffer = buffer;
+        reader->capacity = capacity;
+    }
+
+    for (;;) {
+        ssize_t n = read(reader->fd, reader->buffer + reader->end,
+                         reader->capacity - reader->end);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return reader->error = CFILEREADER_IO_FAILURE;
+        if (n == 0)
+            reader->eof = 1;
+        reader->end += (size_t)n;
+        return CFILEREADER_SUCCESS;
+    }
+}
+
+/// \internal
+/// \brief Set up the backend for `reader->fd`.
+static int setup(CFileReader_t *reader, int mode) {
+    struct stat st;
+    if (fstat(reader->fd, &st))
+        return CFILEREADER_IO_FAILURE;
+
+    if (mode == CFILEREADER_AUTO)
+        mode = S_ISREG(st.st_mode) ? CFILEREADER_MMAP : CFILEREADER_READ;
+    reader->mode = mode;
+
+    if (mode == CFILEREADER_READ) {
+        reader->buffer = malloc(CFILEREADER_BUFFER_SIZE);
+        if (reader->buffer == NULL)
+            return CFILEREADER_ALLOC_FAILURE;
+        reader->capacity = CFILEREADER_BUFFER_SIZE;
+        return CFILEREADER_SUCCESS;
+    }
+
+    if (mode != CFILEREADER_MMAP || !S_ISREG(st.st_mode)) {
+        errno = EINVAL;
+        return CFILEREADER_IO_FAILURE;
+    }
+
+    // Map the whole file, and skip whatever precedes the current position.
+    off_t position = lseek(reader->fd, 0, SEEK_CUR);
+    if (position < 0 || position > st.st_size)
+        position = position < 0 ? 0 : st.st_size;
+    reader->eof = 1;
+    if (st.st_size == 0)
+        return CFILEREADER_SUCCESS;
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                     reader->fd, 0);
+    if (map == MAP_FAILED)
+        return CFILEREADER_IO_FAILURE;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    reader->buffer = map;
+    reader->capacity = (size_t)st.st_size;
+    reader->start = reader->scanned = (size_t)position;
+    reader->end = (size_t)st.st_size;
+    return CFILEREADER_SUCCESS;
+}
+
+static CResult_t *create(int fd, int owns_fd, int mode, const char *caller) {
+    CFileReader_t *reader = calloc(1, sizeof(CFileReader_t));
+    if (reader == NULL) {
+        if (owns_fd)
+            close(fd);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CFileReader.", caller,
+            CFILEREADER_ALLOC_FAILURE));
+    }
+    reader->fd = fd;
+    reader->owns_fd = owns_fd;
+
+    int code = setup(reader, mode);
+    if (code) {
+        CFileReader_free(&reader);
+        return CResult_ecreate(CError_create(
+            code == CFILEREADER_ALLOC_FAILURE
+                ? "Unable to allocate memory for the read buffer."
+                : "Unable to set up the file for reading.",
+            caller, code));
+    }
+    return CResult_create(reader, NULL);
+}
+
+CResult_t *CFileReader_open(const char *path, int mode) {
+    if (path == NULL)
+        return CResult_ecreate(CError_create("Recieved a null path.",
+                                             "CFileReader_open",
+                                             CFILEREADER_NULL_READER));
+
+    int fd;
+    do {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+        return CResult_ecreate(CError_create("Unable to open the file.",
+                                             "CFileReader_open",
+                                             CFILEREADER_IO_FAILURE));
+    return create(fd, 1, mode, "CFileReader_open");
+}
+
+CResult_t *CFileReader_from_fd(int fd, int mode) {
+    return create(fd, 0, mode, "CFileReader_from_fd");
+}
+
+int CFileReader_next_record(CFileReader_t *reader, CStringView_t delim,
+                            CStringView_t *record) {
+    if (reader == NULL || record == NULL || delim.len == 0 || reader->error)
+        return 0;
+    if (reader->buffer == NULL) // An empty, unmapped file.
+        return 0;
+
+    for (;;) {
+        CStringView_t pending =
+            CStringView_from(reader->buffer + reader->scanned,
+                             reader->end - reader->scanned);
+        size_t at = delim.len == 1 ? CStringView_find_char(pending, *delim.ptr)
+                                   : CStringView_find(pending, delim);
+        if (at != CSTRINGVIEW_NOT_FOUND) {
+            size_t stop = reader->scanned + at;
+            *record = CStringView_from(reader->buffer + reader->start,
+                                       stop - reader->start);
+            reader->start = reader->scanned = stop + delim.len;
+            return 1;
+        }
+
+        if (reader->eof) {
+            if (reader->start == reader->end)
+                return 0;
+            *record = CStringView_from(reader->buffer + reader->start,
+                                       reader->end - reader->start);
+            reader->start = reader->scanned = reader->end;
+            return 1;
+        }
+
+        // Resume the search where a delimiter could still begin.
+        reader->scanned = reader->end - reader->start >= delim.len
+                              ? reader->end - delim.len + 1
+                              : reader->start;
+        if (refill(reader))
+            return 0;
+    }
+}
+
+int CFileReader_next_line(CFileReader_t *reader, CStringView_t *line) {
+    if (!CFileReader_next_record(reader, CStringView_from("\n", 1), line))
+        return 0;
+    if (line->len && line->ptr[line->len - 1] == '\r')
+        line->len--;
+    return 1;
+}
+
+CResult_t *CFileReader_slurp(CFileReader_t *reader) {
+    if (reader == NULL)
+        return CResult_ecreate(CError_create("Recieved a null reader.",
+                                             "CFileReader_slurp",
+                                             CFILEREADER_NULL_READER));
+
+    CResult_t *res = CString_new();
+    if (CResult_is_error(res))
+        return res;
+    CString_t *string = CResult_get(res);
+
+    // Size the string for the rest of a regular file up front.
+    size_t expected = reader->end - reader->start;
+    struct stat st;
+    if (!reader->eof && !fstat(reader->fd, &st) && S_ISREG(st.st_mode)) {
+        off_t position = lseek(reader->fd, 0, SEEK_CUR);
+        if (position >= 0 && position < st.st_size)
+            expected += (size_t)(st.st_size - position);
+    }
+
+    int code = reader->error;
+    if (!code && CString_reserve(string, expected))
+        code = CFILEREADER_ALLOC_FAILURE;
+    while (!code && reader->buffer != NULL) {
+        if (CString_append_n(string, reader->buffer + reader->start,
+                             reader->end - reader->start)) {
+            code = CFILEREADER_ALLOC_FAILURE;
+            break;
+        }
+        reader->start = reader->scanned = reader->end;
+        if (reader->eof)
+            break;
+        code = refill(reader);
+    }
+
+    if (code) {
+        CResult_free(&res);
+        CString_free(&string);
+        return CResult_ecreate(CError_create("Unable to read the file.",
+                                             "CFileReader_slurp", code));
+    }
+    return res;
+}
+
+int CFileReader_error(const CFileReader_t *reader) {
+    if (reader == NULL)
+        return CFILEREADER_NULL_READER;
+    return reader->error;
+}
+
+int CFileReader_free(CFileReader_t **reader) {
+    if (reader == NULL || *reader == NULL)
+        return CFILEREADER_SUCCESS;
+
+    CFileReader_t *r = *reader;
+    if (r->mode == CFILEREADER_MMAP) {
+        if (r->buffer != NULL)
+            munmap(r->buffer, r->capacity);
+    } else {
+        free(r->buffer);
+    }
+    if (r->owns_fd)
+        close(r->fd);
+    free(r);
+    *reader = NULL;
+    return CFILEREADER_SUCCESS;
+}
+
+#endif // POSIX
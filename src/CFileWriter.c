@@ -0,0 +1,277 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _GNU_SOURCE
+#include <cstd/CFileWriter.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct _CFileWriter {
+    int fd;          ///< File being written.
+    int owns_fd;     ///< Whether the writer closes `fd` when freed.
+    int flags;       ///< The `CFILEWRITER_` flags.
+    int error;       ///< Sticky error code, `CFILEWRITER_SUCCESS` if none.
+    char *buffer;    ///< Characters not written yet.
+    size_t capacity; ///< Size of `buffer`.
+    size_t used;     ///< Number of characters in `buffer`.
+};
+
+static int sync_data(int fd) {
+#if defined(__APPLE__)
+    return fsync(fd);
+#else
+    return fdatasync(fd);
+#endif
+}
+
+/// \internal
+/// \brief Write every byte described by `iov`, resuming after partial writes.
+static int write_all(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return CFILEWRITER_IO_FAILURE;
+
+        size_t written = (size_t)n;
+        while (count > 0 && written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return CFILEWRITER_SUCCESS;
+}
+
+/// \internal
+/// \brief Write out the buffer. In direct mode only whole blocks are written,
+/// and the remainder is moved to the front of the buffer.
+static int drain(CFileWriter_t *writer) {
+    size_t len = writer->used;
+    if (writer->flags & CFILEWRITER_DIRECT)
+        len -= len % CFILEWRITER_ALIGNMENT;
+    if (len == 0)
+        return CFILEWRITER_SUCCESS;
+
+    struct iovec iov = {writer->buffer, len};
+    if (write_all(writer->fd, &iov, 1))
+        return writer->error = CFILEWRITER_IO_FAILURE;
+
+    writer->used -= len;
+    if (writer->used)
+        memmove(writer->buffer, writer->buffer + len, writer->used);
+    return CFILEWRITER_SUCCESS;
+}
+
+static CResult_t *create(int fd, int owns_fd, int flags, const char *caller) {
+    CFileWriter_t *writer = calloc(1, sizeof(CFileWriter_t));
+    if (writer != NULL) {
+        void *buffer = NULL;
+        if (flags & CFILEWRITER_DIRECT) {
+            if (posix_memalign(&buffer, CFILEWRITER_ALIGNMENT,
+                               CFILEWRITER_BUFFER_SIZE))
+                buffer = NULL;
+        } else {
+            buffer = malloc(CFILEWRITER_BUFFER_SIZE);
+        }
+        if (buffer == NULL) {
+            free(writer);
+            writer = NULL;
+        } else {
+            writer->buffer = buffer;
+        }
+    }
+
+    if (writer == NULL) {
+        if (owns_fd)
+            close(fd);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CFileWriter.", caller,
+            CFILEWRITER_ALLOC_FAILURE));
+    }
+
+    writer->fd = fd;
+    writer->owns_fd = owns_fd;
+    writer->flags = flags;
+    writer->capacity = CFILEWRITER_BUFFER_SIZE;
+    return CResult_create(writer, NULL);
+}
+
+CResult_t *CFileWriter_open(const char *path, int flags) {
+    if (path == NULL)
+        return CResult_ecreate(CError_create("Recieved a null path.",
+                                             "CFileWriter_open",
+                                             CFILEWRITER_NULL_WRITER));
+
+    int oflags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    oflags |= (flags & CFILEWRITER_APPEND) ? O_APPEND : O_TRUNC;
+    int direct = 0;
+#ifdef O_DIRECT
+    direct = !(flags & CFILEWRITER_APPEND);
+    if (flags & CFILEWRITER_DIRECT)
+        oflags |= O_DIRECT;
+#endif
+    if ((flags & CFILEWRITER_DIRECT) && !direct) {
+        errno = EINVAL;
+        return CResult_ecreate(CError_create(
+            "Direct I/O cannot be used for this file.", "CFileWriter_open",
+            CFILEWRITER_IO_FAILURE));
+    }
+
+    int fd;
+    do {
+        fd = open(path, oflags, 0666);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+        return CResult_ecreate(CError_create("Unable to open the file.",
+                                             "CFileWriter_open",
+                                             CFILEWRITER_IO_FAILURE));
+    return create(fd, 1, flags, "CFileWriter_open");
+}
+
+CResult_t *CFileWriter_from_fd(int fd, int flags) {
+    flags &= CFILEWRITER_SYNC_FLUSH | CFILEWRITER_SYNC_CLOSE;
+    return create(fd, 0, flags, "CFileWriter_from_fd");
+}
+
+int CFileWriter_append(CFileWriter_t *writer, const void *ptr, size_t len) {
+    if (writer == NULL)
+        return CFILEWRITER_NULL_WRITER;
+    if (writer->error || len == 0)
+        return writer->error;
+
+    if (len <= writer->capacity - writer->used) {
+        memcpy(writer->buffer + writer->used, ptr, len);
+        writer->used += len;
+        return CFILEWRITER_SUCCESS;
+    }
+
+    // Large payloads go out together with the buffer, without being copied.
+    if (!(writer->flags & CFILEWRITER_DIRECT) && len >= writer->capacity / 2) {
+        struct iovec iov[2] = {{writer->buffer, writer->used},
+                               {(void *)ptr, len}};
+        int first = writer->used == 0;
+        if (write_all(writer->fd, iov + first, 2 - first))
+            return writer->error = CFILEWRITER_IO_FAILURE;
+        writer->used = 0;
+        return CFILEWRITER_SUCCESS;
+    }
+
+    const char *src = ptr;
+    while (len) {
+        size_t n = writer->capacity - writer->used;
+        if (n > len)
+            n = len;
+        memcpy(writer->buffer + writer->used, src, n);
+        writer->used += n;
+        src += n;
+        len -= n;
+        if (writer->used == writer->capacity && drain(writer))
+            return writer->error;
+    }
+    return CFILEWRITER_SUCCESS;
+}
+
+int CFileWriter_append_view(CFileWriter_t *writer, CStringView_t view) {
+    return CFileWriter_append(writer, view.ptr, view.len);
+}
+
+int CFileWriter_append_cstring(CFileWriter_t *writer,
+                               const CString_t *string) {
+    if (string == NULL)
+        return CFILEWRITER_NULL_WRITER;
+    return CFileWriter_append_view(writer, CString_view(string));
+}
+
+int CFileWriter_flush(CFileWriter_t *writer) {
+    if (writer == NULL)
+        return CFILEWRITER_NULL_WRITER;
+    if (writer->error || drain(writer))
+        return writer->error;
+    if ((writer->flags & CFILEWRITER_SYNC_FLUSH) && sync_data(writer->fd))
+        return writer->error = CFILEWRITER_IO_FAILURE;
+    return CFILEWRITER_SUCCESS;
+}
+
+int CFileWriter_sync(CFileWriter_t *writer) {
+    if (writer == NULL)
+        return CFILEWRITER_NULL_WRITER;
+    if (writer->error || drain(writer))
+        return writer->error;
+    if (sync_data(writer->fd))
+        return writer->error = CFILEWRITER_IO_FAILURE;
+    return CFILEWRITER_SUCCESS;
+}
+
+int CFileWriter_error(const CFileWriter_t *writer) {
+    if (writer == NULL)
+        return CFILEWRITER_NULL_WRITER;
+    return writer->error;
+}
+
+int CFileWriter_free(CFileWriter_t **writer) {
+    if (writer == NULL || *writer == NULL)
+        return CFILEWRITER_SUCCESS;
+
+    CFileWriter_t *w = *writer;
+    if (!w->error)
+        drain(w);
+
+#ifdef O_DIRECT
+    // The partial block left over in direct mode is written through the page
+    // cache, since its length is not aligned.
+    if (!w->error && w->used) {
+        int fl = fcntl(w->fd, F_GETFL);
+        struct iovec iov = {w->buffer, w->used};
+        if (fl < 0 || fcntl(w->fd, F_SETFL, fl & ~O_DIRECT) ||
+            write_all(w->fd, &iov, 1))
+            w->error = CFILEWRITER_IO_FAILURE;
+    }
+#endif
+
+    if (!w->error && (w->flags & CFILEWRITER_SYNC_CLOSE) && sync_data(w->fd))
+        w->error = CFILEWRITER_IO_FAILURE;
+    if (w->owns_fd && close(w->fd) && !w->error)
+        w->error = CFILEWRITER_IO_FAILURE;
+
+    int code = w->error;
+    free(w->buffer);
+    free(w);
+    *writer = NULL;
+    return code;
+}
+
+#endif // POSIX
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "Snapshot.h"
 #include <cstd/CHashMap.h>
 #include <stdlib.h>
 #include <string.h>
@@ -42,8 +43,27 @@ struct _CHashMap {
     Hash hash;
     Destructor destroyKey;
     Destructor destroyValue;
+    void *mapping;       ///< Snapshot the map was loaded from, if any.
+    size_t mapping_size; ///< Size of `mapping` in bytes.
 };
 
+/// \internal
+/// \brief Whether `ptr` was allocated separately rather than taken from the
+/// snapshot the map was loaded from.
+static int owned(const CHashMap_t *map, const void *ptr) {
+    return !snapshot_contains(map->mapping, map->mapping_size, ptr);
+}
+
+static void destroy_key(const CHashMap_t *map, void *key) {
+    if (map->destroyKey && owned(map, key))
+        map->destroyKey(key);
+}
+
+static void destroy_value(const CHashMap_t *map, void *value) {
+    if (map->destroyValue && owned(map, value))
+        map->destroyValue(value);
+}
+
 static size_t __ceil(double x) {
     size_t int_part = (size_t)x;
     if (x > int_part) {
@@ -81,6 +101,8 @@ int CHashMap_init(CHashMap_t *map, size_t capacity, CompareTo cmp, Hash hash,
     map->hash = hash;
     map->destroyKey = destroyKey;
     map->destroyValue = destroyValue;
+    map->mapping = NULL;
+    map->mapping_size = 0;
     map->entries = calloc(map->capacity, sizeof(struct CHashMapEntry));
     if (!map->entries)
         return CHASHMAP_ALLOC_FAILURE;
@@ -109,7 +131,8 @@ static int CHashMap_resize(CHashMap_t *map) {
             new_entries[new_index] = *entry;
         }
     }
-    free(map->entries);
+    if (owned(map, map->entries))
+        free(map->entries);
     map->entries = new_entries;
     map->capacity = new_capacity;
     return CHASHMAP_SUCCESS;
@@ -125,8 +148,7 @@ int CHashMap_insert(CHashMap_t *map, void *key, void *value) {
     size_t index = map->hash(key) % map->capacity;
     while (map->entries[index].key && map->entries[index].key != DELETED) {
         if (map->cmp(map->entries[index].key, key) == 0) {
-            if (map->destroyValue)
-                map->destroyValue(map->entries[index].value);
+            destroy_value(map, map->entries[index].value);
             map->entries[index].value = value;
             return CHASHMAP_SUCCESS;
         }
@@ -160,10 +182,8 @@ int CHashMap_remove(CHashMap_t *map, void *key) {
     while (map->entries[index].key) {
         if (map->entries[index].key != DELETED &&
             map->cmp(map->entries[index].key, key) == 0) {
-            if (map->destroyKey)
-                map->destroyKey(map->entries[index].key);
-            if (map->destroyValue)
-                map->destroyValue(map->entries[index].value);
+            destroy_key(map, map->entries[index].key);
+            destroy_value(map, map->entries[index].value);
             map->entries[index].key = DELETED;
             map->entries[index].value = NULL;
             map->size--;
@@ -179,13 +199,15 @@ int CHashMap_clear(CHashMap_t *map) {
         return CHASHMAP_NULL_MAP;
     for (size_t i = 0; i < map->capacity; i++) {
         if (map->entries[i].key && map->entries[i].key != DELETED) {
-            if (map->destroyKey)
-                map->destroyKey(map->entries[i].key);
-            if (map->destroyValue)
-                map->destroyValue(map->entries[i].value);
+            destroy_key(map, map->entries[i].key);
+            destroy_value(map, map->entries[i].value);
         }
     }
-    free(map->entries);
+    if (owned(map, map->entries))
+        free(map->entries);
+    snapshot_unmap(map->mapping, map->mapping_size);
+    map->mapping = NULL;
+    map->mapping_size = 0;
     map->capacity = 0;
     map->size = 0;
     map->entries = NULL;
@@ -197,13 +219,13 @@ int CHashMap_free(CHashMap_t **map) {
         return CHASHMAP_NULL_MAP;
     for (size_t i = 0; i < (*map)->capacity; i++) {
         if ((*map)->entries[i].key && (*map)->entries[i].key != DELETED) {
-            if ((*map)->destroyKey)
-                (*map)->destroyKey((*map)->entries[i].key);
-            if ((*map)->destroyValue)
-                (*map)->destroyValue((*map)->entries[i].value);
+            destroy_key(*map, (*map)->entries[i].key);
+            destroy_value(*map, (*map)->entries[i].value);
         }
     }
-    free((*map)->entries);
+    if (owned(*map, (*map)->entries))
+        free((*map)->entries);
+    snapshot_unmap((*map)->mapping, (*map)->mapping_size);
     free(*map);
     *map = NULL;
     return CHASHMAP_SUCCESS;
@@ -220,12 +242,81 @@ int CHashMap_update(CHashMap_t *map, void *key, void *new_value) {
     while (map->entries[index].key) {
         if (map->entries[index].key != DELETED &&
             map->cmp(map->entries[index].key, key) == 0) {
-            if (map->destroyValue)
-                map->destroyValue(map->entries[index].value);
+            destroy_value(map, map->entries[index].value);
             map->entries[index].value = new_value;
             return CHASHMAP_SUCCESS;
         }
         index = (index + 1) % map->capacity;
     }
     return CHASHMAP_NOT_FOUND;
-}
\ No newline at end of file
+}
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+int CHashMap_save(const CHashMap_t *map, const char *path,
+                  SerializeFn serializeKey, SerializeFn serializeValue) {
+    if (!map || !map->entries)
+        return CHASHMAP_NULL_MAP;
+    if (!path)
+        return CHASHMAP_NULL_VAL;
+    _Static_assert(sizeof(struct CHashMapEntry) == 2 * sizeof(void *),
+                   "Entries are saved as a table of pointers.");
+    SerializeFn serializers[2] = {serializeKey, serializeValue};
+    uint64_t meta[2] = {map->size, 0};
+    switch (snapshot_save(path, "CSTDHMAP", (void *const *)map->entries,
+                          map->capacity * 2, serializers, 2, meta)) {
+    case SNAPSHOT_SUCCESS:
+        return CHASHMAP_SUCCESS;
+    case SNAPSHOT_ALLOC_FAILURE:
+        return CHASHMAP_ALLOC_FAILURE;
+    case SNAPSHOT_INVALID:
+        return CHASHMAP_NULL_VAL;
+    default:
+        return CHASHMAP_IO_FAILURE;
+    }
+}
+
+CResult_t *CHashMap_load(const char *path, CompareTo cmp, Hash hash,
+                         Destructor destroyKey, Destructor destroyValue) {
+    if (!path || !cmp || !hash)
+        return CResult_ecreate(
+            CError_create("Recieved a null path or operator.",
+                          "CHashMap_load", CHASHMAP_NULL_VAL));
+    CHashMap_t *map = malloc(sizeof(CHashMap_t));
+    if (!map)
+        return CResult_ecreate(
+            CError_create("Unable to allocate memory for hashmap.",
+                          "CHashMap_load", CHASHMAP_ALLOC_FAILURE));
+
+    SnapshotTrailer trailer;
+    int code;
+    map->mapping = snapshot_load(path, "CSTDHMAP", 2, &trailer,
+                                 &map->mapping_size, &code);
+    if (map->mapping &&
+        (trailer.slots == 0 || trailer.meta[0] > trailer.slots / 2)) {
+        snapshot_unmap(map->mapping, map->mapping_size);
+        map->mapping = NULL;
+        code = SNAPSHOT_INVALID;
+    }
+    if (!map->mapping) {
+        free(map);
+        if (code == SNAPSHOT_IO_FAILURE)
+            return CResult_ecreate(
+                CError_create("Unable to map the snapshot.", "CHashMap_load",
+                              CHASHMAP_IO_FAILURE));
+        return CResult_ecreate(CError_create("The snapshot is malformed.",
+                                             "CHashMap_load",
+                                             CHASHMAP_INVALID_SNAPSHOT));
+    }
+
+    map->entries =
+        (struct CHashMapEntry *)((char *)map->mapping + trailer.table);
+    map->capacity = trailer.slots / 2;
+    map->size = trailer.meta[0];
+    map->cmp = cmp;
+    map->hash = hash;
+    map->destroyKey = destroyKey;
+    map->destroyValue = destroyValue;
+    return CResult_create(map, NULL);
+}
+
+#endif // POSIX
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "Snapshot.h"
 #include <cstd/CHashSet.h>
 #include <stdlib.h>
 #include <string.h>
@@ -42,8 +43,22 @@ struct _CHashSet {
     CompareTo cmp;
     Hash hash;
     Destructor destroyKey;
+    void *mapping;       ///< Snapshot the set was loaded from, if any.
+    size_t mapping_size; ///< Size of `mapping` in bytes.
 };
 
+/// \internal
+/// \brief Whether `ptr` was allocated separately rather than taken from the
+/// snapshot the set was loaded from.
+static int owned(const CHashSet_t *set, const void *ptr) {
+    return !snapshot_contains(set->mapping, set->mapping_size, ptr);
+}
+
+static void destroy_key(const CHashSet_t *set, void *key) {
+    if (set->destroyKey && owned(set, key))
+        set->destroyKey(key);
+}
+
 double CHashSet_load_factor(const CHashSet_t *set) {
     return set ? ((double)set->size / set->capacity) : 0.0;
 }
@@ -85,6 +100,8 @@ int CHashSet_init(CHashSet_t *set, size_t capacity, CompareTo cmp, Hash hash,
     set->cmp = cmp;
     set->hash = hash;
     set->destroyKey = destroyKey;
+    set->mapping = NULL;
+    set->mapping_size = 0;
 
     set->entries = calloc(set->capacity, sizeof(struct CHashSetEntry));
     if (!set->entries)
@@ -121,7 +138,8 @@ static int CHashSet_resize(CHashSet_t *set) {
         }
     }
 
-    free(old_entries);
+    if (owned(set, old_entries))
+        free(old_entries);
     return CHASHSET_SUCCESS;
 }
 
@@ -181,8 +199,7 @@ int CHashSet_remove(CHashSet_t *set, void *key) {
     while (set->entries[index].key) {
         if (set->entries[index].key != DELETED &&
             set->cmp(set->entries[index].key, key) == 0) {
-            if (set->destroyKey)
-                set->destroyKey(set->entries[index].key);
+            destroy_key(set, set->entries[index].key);
 
             set->entries[index].key = DELETED;
             set->size--;
@@ -201,12 +218,15 @@ int CHashSet_clear(CHashSet_t *set) {
 
     for (size_t i = 0; i < set->capacity; i++) {
         if (set->entries[i].key && set->entries[i].key != DELETED) {
-            if (set->destroyKey)
-                set->destroyKey(set->entries[i].key);
+            destroy_key(set, set->entries[i].key);
         }
     }
 
-    free(set->entries);
+    if (owned(set, set->entries))
+        free(set->entries);
+    snapshot_unmap(set->mapping, set->mapping_size);
+    set->mapping = NULL;
+    set->mapping_size = 0;
     set->capacity = 0;
     set->size = 0;
     set->deleted_count = 0;
@@ -221,14 +241,81 @@ int CHashSet_free(CHashSet_t **set) {
 
     for (size_t i = 0; i < (*set)->capacity; i++) {
         if ((*set)->entries[i].key && (*set)->entries[i].key != DELETED) {
-            if ((*set)->destroyKey)
-                (*set)->destroyKey((*set)->entries[i].key);
+            destroy_key(*set, (*set)->entries[i].key);
         }
     }
 
-    free((*set)->entries);
+    if (owned(*set, (*set)->entries))
+        free((*set)->entries);
+    snapshot_unmap((*set)->mapping, (*set)->mapping_size);
     free(*set);
     *set = NULL;
 
     return CHASHSET_SUCCESS;
 }
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+int CHashSet_save(const CHashSet_t *set, const char *path,
+                  SerializeFn serialize) {
+    if (!set || !set->entries)
+        return CHASHSET_NULL_SET;
+    if (!path || !serialize)
+        return CHASHSET_NULL_KEY;
+    uint64_t meta[2] = {set->size, set->deleted_count};
+    switch (snapshot_save(path, "CSTDHSET", (void *const *)set->entries,
+                          set->capacity, &serialize, 1, meta)) {
+    case SNAPSHOT_SUCCESS:
+        return CHASHSET_SUCCESS;
+    case SNAPSHOT_ALLOC_FAILURE:
+        return CHASHSET_ALLOC_FAILURE;
+    default:
+        return CHASHSET_IO_FAILURE;
+    }
+}
+
+CResult_t *CHashSet_load(const char *path, CompareTo cmp, Hash hash,
+                         Destructor destroyKey) {
+    if (!path || !cmp || !hash)
+        return CResult_ecreate(
+            CError_create("Recieved a null path or operator.",
+                          "CHashSet_load", CHASHSET_NULL_KEY));
+    CHashSet_t *set = malloc(sizeof(CHashSet_t));
+    if (!set)
+        return CResult_ecreate(
+            CError_create("Unable to allocate memory for hashset.",
+                          "CHashSet_load", CHASHSET_ALLOC_FAILURE));
+
+    SnapshotTrailer trailer;
+    int code;
+    set->mapping = snapshot_load(path, "CSTDHSET", 1, &trailer,
+                                 &set->mapping_size, &code);
+    if (set->mapping && (trailer.slots == 0 ||
+                         trailer.meta[0] + trailer.meta[1] > trailer.slots)) {
+        snapshot_unmap(set->mapping, set->mapping_size);
+        set->mapping = NULL;
+        code = SNAPSHOT_INVALID;
+    }
+    if (!set->mapping) {
+        free(set);
+        if (code == SNAPSHOT_IO_FAILURE)
+            return CResult_ecreate(
+                CError_create("Unable to map the snapshot.", "CHashSet_load",
+                              CHASHSET_IO_FAILURE));
+        return CResult_ecreate(CError_create("The snapshot is malformed.",
+                                             "CHashSet_load",
+                                             CHASHSET_INVALID_SNAPSHOT));
+    }
+
+    set->entries =
+        (struct CHashSetEntry *)((char *)set->mapping + trailer.table);
+    set->capacity = trailer.slots;
+    set->size = trailer.meta[0];
+    set->deleted_count = trailer.meta[1];
+    set->cmp = cmp;
+    set->hash = hash;
+    set->destroyKey = destroyKey;
+    return CResult_create(set, NULL);
+}
+
+#endif // POSIX
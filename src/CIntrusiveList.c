@@ -0,0 +1,193 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CIntrusiveList.h>
+
+/// \internal
+/// \brief Link `link` between `prev` and `next`, which are adjacent.
+static void link_between(CIntrusiveList_t *list, CListLink_t *prev,
+                         CListLink_t *next, CListLink_t *link) {
+    link->prev = prev;
+    link->next = next;
+    prev->next = link;
+    next->prev = link;
+    list->size++;
+}
+
+/// \internal
+/// \brief Unlink `link` and leave it off any list.
+static void unlink_link(CIntrusiveList_t *list, CListLink_t *link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = NULL;
+    link->prev = NULL;
+    list->size--;
+}
+
+/// \internal
+/// \brief Check the arguments of the functions adding `link` next to
+/// `position`.
+static int check_insert(const CIntrusiveList_t *list,
+                        const CListLink_t *position, const CListLink_t *link) {
+    if (list == NULL || position == NULL || link == NULL)
+        return CINTRUSIVELIST_NULL;
+    if (!CListLink_is_linked(position))
+        return CINTRUSIVELIST_NOT_LINKED;
+    if (CListLink_is_linked(link))
+        return CINTRUSIVELIST_ALREADY_LINKED;
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+int CIntrusiveList_init(CIntrusiveList_t *list) {
+    if (list == NULL)
+        return CINTRUSIVELIST_NULL;
+    list->head.next = &list->head;
+    list->head.prev = &list->head;
+    list->size = 0;
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+void CListLink_init(CListLink_t *link) {
+    if (link == NULL)
+        return;
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+int CListLink_is_linked(const CListLink_t *link) {
+    return link != NULL && link->next != NULL;
+}
+
+size_t CIntrusiveList_size(const CIntrusiveList_t *list) {
+    return list == NULL ? 0 : list->size;
+}
+
+int CIntrusiveList_push_front(CIntrusiveList_t *list, CListLink_t *link) {
+    int code = check_insert(list, list == NULL ? NULL : &list->head, link);
+    if (code != CINTRUSIVELIST_SUCCESS)
+        return code;
+    link_between(list, &list->head, list->head.next, link);
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+int CIntrusiveList_push_back(CIntrusiveList_t *list, CListLink_t *link) {
+    int code = check_insert(list, list == NULL ? NULL : &list->head, link);
+    if (code != CINTRUSIVELIST_SUCCESS)
+        return code;
+    link_between(list, list->head.prev, &list->head, link);
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+int CIntrusiveList_insert_before(CIntrusiveList_t *list, CListLink_t *position,
+                                 CListLink_t *link) {
+    int code = check_insert(list, position, link);
+    if (code != CINTRUSIVELIST_SUCCESS)
+        return code;
+    link_between(list, position->prev, position, link);
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+int CIntrusiveList_insert_after(CIntrusiveList_t *list, CListLink_t *position,
+                                CListLink_t *link) {
+    int code = check_insert(list, position, link);
+    if (code != CINTRUSIVELIST_SUCCESS)
+        return code;
+    link_between(list, position, position->next, link);
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+int CIntrusiveList_remove(CIntrusiveList_t *list, CListLink_t *link) {
+    if (list == NULL || link == NULL)
+        return CINTRUSIVELIST_NULL;
+    if (!CListLink_is_linked(link) || link == &list->head)
+        return CINTRUSIVELIST_NOT_LINKED;
+    unlink_link(list, link);
+    return CINTRUSIVELIST_SUCCESS;
+}
+
+CListLink_t *CIntrusiveList_pop_front(CIntrusiveList_t *list) {
+    CListLink_t *link = CIntrusiveList_front(list);
+    if (link != NULL)
+        unlink_link(list, link);
+    return link;
+}
+
+CListLink_t *CIntrusiveList_pop_back(CIntrusiveList_t *list) {
+    CListLink_t *link = CIntrusiveList_back(list);
+    if (link != NULL)
+        unlink_link(list, link);
+    return link;
+}
+
+CListLink_t *CIntrusiveList_front(const CIntrusiveList_t *list) {
+    if (list == NULL || list->size == 0)
+        return NULL;
+    return list->head.next;
+}
+
+CListLink_t *CIntrusiveList_back(const CIntrusiveList_t *list) {
+    if (list == NULL || list->size == 0)
+        return NULL;
+    return list->head.prev;
+}
+
+CListLink_t *CIntrusiveList_next(const CIntrusiveList_t *list,
+                                 const CListLink_t *link) {
+    if (list == NULL || link == NULL || link->next == &list->head)
+        return NULL;
+    return link->next;
+}
+
+CListLink_t *CIntrusiveList_prev(const CIntrusiveList_t *list,
+                                 const CListLink_t *link) {
+    if (list == NULL || link == NULL || link->prev == &list->head)
+        return NULL;
+    return link->prev;
+}
+
+int CIntrusiveList_splice(CIntrusiveList_t *list, CIntrusiveList_t *source) {
+    if (list == NULL || source == NULL)
+        return CINTRUSIVELIST_NULL;
+    if (source == list || source->size == 0)
+        return CINTRUSIVELIST_SUCCESS;
+    CListLink_t *first = source->head.next;
+    CListLink_t *last = source->head.prev;
+    first->prev = list->head.prev;
+    list->head.prev->next = first;
+    last->next = &list->head;
+    list->head.prev = last;
+    list->size += source->size;
+    return CIntrusiveList_init(source);
+}
+
+int CIntrusiveList_clear(CIntrusiveList_t *list) {
+    if (list == NULL)
+        return CINTRUSIVELIST_NULL;
+    CINTRUSIVELIST_FOREACH_SAFE(list, link, next) {
+        link->next = NULL;
+        link->prev = NULL;
+    }
+    return CIntrusiveList_init(list);
+}
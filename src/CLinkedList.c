@@ -1,4 +1,5 @@
 #include <cstd/CLinkedList.h>
+#include <stddef.h>
 #include <stdlib.h>
 
 typedef struct __CSN {
@@ -18,6 +19,7 @@ typedef struct _CLinkedList {
         __CDNode *dhead;
     };
     __CDNode *tail;
+    __CSNode *slast; ///< Last node of a singly linked list.
     Destructor destroy;
     size_t size;
 } CLinkedList_t;
@@ -69,53 +71,92 @@ int CLinkedList_init(CLinkedList_t *list, int list_type, Destructor destroy) {
         list->shead = NULL;
         list->tail = NULL;
     }
+    list->slast = NULL;
 
     return CLINKEDLIST_SUCCESS;
 }
 
-int CLinkedList_add(CLinkedList_t *list, void *element) {
-    if (!list) {
-        return CLINKEDLIST_NULL_LIST;
-    }
+/// \internal
+/// \brief Map the sentinels of a doubly linked list to NULL.
+static void *outer(const CLinkedList_t *list, __CDNode *node) {
+    return node == list->dhead || node == list->tail ? NULL : node;
+}
 
+/// \internal
+/// \brief Insert a new node after `left`, or at the front if `left` is NULL.
+/// \return The new node, or NULL if it could not be allocated.
+static void *insert(CLinkedList_t *list, void *left, void *element) {
     if (list->tail) { // DOUBLY LINKED LIST
         __CDNode *new_node = malloc(sizeof(__CDNode));
         if (!new_node) {
-            return CLINKEDLIST_ALLOC_FAILURE;
+            return NULL;
         }
-
+        __CDNode *prev = left ? left : list->dhead;
         new_node->value = element;
-        new_node->next = list->tail;
-        new_node->prev = list->tail->prev;
+        new_node->prev = prev;
+        new_node->next = prev->next;
+        prev->next->prev = new_node;
+        prev->next = new_node;
+        list->size++;
+        return new_node;
+    }
 
-        if (list->tail->prev) {
-            list->tail->prev->next = new_node;
-        } else {
-            list->dhead = new_node;
-        }
-        list->tail->prev = new_node;
+    // SINGLY LINKED LIST
+    __CSNode *new_node = malloc(sizeof(__CSNode));
+    if (!new_node) {
+        return NULL;
+    }
+    __CSNode *prev = left;
+    new_node->value = element;
+    new_node->next = prev ? prev->next : list->shead;
+    if (prev) {
+        prev->next = new_node;
+    } else {
+        list->shead = new_node;
+    }
+    if (!new_node->next) {
+        list->slast = new_node;
+    }
+    list->size++;
+    return new_node;
+}
 
+/// \internal
+/// \brief Unlink and free `node`, whose predecessor is `prev` (NULL at the
+/// front). `prev` is only used by singly linked lists.
+static void unlink_node(CLinkedList_t *list, void *prev, void *node) {
+    if (list->tail) { // DOUBLY LINKED LIST
+        __CDNode *current = node;
+        current->prev->next = current->next;
+        current->next->prev = current->prev;
     } else { // SINGLY LINKED LIST
-        __CSNode *new_node = malloc(sizeof(__CSNode));
-        if (!new_node) {
-            return CLINKEDLIST_ALLOC_FAILURE;
-        }
-        new_node->value = element;
-        new_node->next = NULL;
-
-        if (list->shead) {
-            __CSNode *current = list->shead;
-            while (current->next) {
-                current = current->next;
-            }
-            current->next = new_node;
+        __CSNode *current = node;
+        if (prev) {
+            ((__CSNode *)prev)->next = current->next;
         } else {
-            list->shead = new_node;
+            list->shead = current->next;
+        }
+        if (list->slast == current) {
+            list->slast = prev;
         }
     }
+    free(node);
+    list->size--;
+}
 
-    list->size++;
-    return CLINKEDLIST_SUCCESS;
+/// \internal
+/// \brief Find the node before `node` in a singly linked list.
+static __CSNode *find_prev(const CLinkedList_t *list, const void *node) {
+    __CSNode *prev = NULL;
+    for (__CSNode *current = list->shead; current && current != node;
+         current = current->next) {
+        prev = current;
+    }
+    return prev;
+}
+
+int CLinkedList_add(CLinkedList_t *list, void *element) {
+    return CLinkedList_add_node(list, element, NULL);
 }
 
 int CLinkedList_remove(CLinkedList_t *list, size_t index) {
@@ -168,6 +209,9 @@ int CLinkedList_remove(CLinkedList_t *list, size_t index) {
         } else {
             list->shead = current->next;
         }
+        if (list->slast == current) {
+            list->slast = prev;
+        }
 
         free(current);
     }
@@ -263,6 +307,7 @@ int CLinkedList_clear(CLinkedList_t *list) {
             current = next;
         }
         list->shead = NULL;
+        list->slast = NULL;
     }
 
     list->size = 0;
@@ -347,3 +392,322 @@ size_t CLinkedList_size(const CLinkedList_t *list) {
     }
     return list->size;
 }
+
+int CLinkedList_add_node(CLinkedList_t *list, void *element,
+                         CListNode_t **node) {
+    if (!list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+
+    void *last = list->tail ? outer(list, list->tail->prev) : list->slast;
+    void *new_node = insert(list, last, element);
+    if (!new_node) {
+        return CLINKEDLIST_ALLOC_FAILURE;
+    }
+    if (node) {
+        *node = new_node;
+    }
+    return CLINKEDLIST_SUCCESS;
+}
+
+int CLinkedList_remove_node(CLinkedList_t *list, CListNode_t *node) {
+    if (!list || !node) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+
+    unlink_node(list, list->tail ? NULL : find_prev(list, node), node);
+    return CLINKEDLIST_SUCCESS;
+}
+
+void *CListNode_value(const CListNode_t *node) {
+    // Both kinds of node start with the value.
+    return node ? ((const __CSNode *)node)->value : NULL;
+}
+
+CListCursor_t CLinkedList_cursor(CLinkedList_t *list) {
+    return (CListCursor_t){list, NULL, NULL};
+}
+
+CListCursor_t CLinkedList_cursor_at(CLinkedList_t *list, CListNode_t *node) {
+    if (!list || !node) {
+        return (CListCursor_t){list, NULL, NULL};
+    }
+
+    void *prev = list->tail ? outer(list, ((__CDNode *)node)->prev)
+                            : find_prev(list, node);
+    return (CListCursor_t){list, node, prev};
+}
+
+/// \internal
+/// \brief Get the node after `node`, or the first one if `node` is NULL.
+static void *successor(const CLinkedList_t *list, void *node) {
+    if (list->tail) { // DOUBLY LINKED LIST
+        __CDNode *current = node ? node : list->dhead;
+        return outer(list, current->next);
+    }
+    return node ? ((__CSNode *)node)->next : list->shead;
+}
+
+int CListCursor_next(CListCursor_t *cursor) {
+    if (!cursor || !cursor->list) {
+        return 0;
+    }
+
+    // The element before the next position, whether on an element or not.
+    CListNode_t *after = cursor->node ? cursor->node : cursor->prev;
+    CListNode_t *next = successor(cursor->list, after);
+    cursor->prev = after;
+    cursor->node = next;
+    return next != NULL;
+}
+
+int CListCursor_prev(CListCursor_t *cursor) {
+    if (!cursor || !cursor->list) {
+        return 0;
+    }
+
+    // Whether on an element or in a gap, the target is the previous element.
+    CListNode_t *target = cursor->prev;
+    cursor->node = target;
+    if (!target) {
+        return 0;
+    }
+    cursor->prev = cursor->list->tail
+                       ? outer(cursor->list, ((__CDNode *)target)->prev)
+                       : (CListNode_t *)find_prev(cursor->list, target);
+    return 1;
+}
+
+void *CListCursor_value(const CListCursor_t *cursor) {
+    return cursor ? CListNode_value(cursor->node) : NULL;
+}
+
+CListNode_t *CListCursor_node(const CListCursor_t *cursor) {
+    return cursor ? cursor->node : NULL;
+}
+
+int CListCursor_insert_before(CListCursor_t *cursor, void *element) {
+    if (!cursor || !cursor->list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+
+    void *new_node = insert(cursor->list, cursor->prev, element);
+    if (!new_node) {
+        return CLINKEDLIST_ALLOC_FAILURE;
+    }
+    cursor->prev = new_node;
+    return CLINKEDLIST_SUCCESS;
+}
+
+int CListCursor_insert_after(CListCursor_t *cursor, void *element) {
+    if (!cursor || !cursor->list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+
+    void *left = cursor->node ? cursor->node : cursor->prev;
+    if (!insert(cursor->list, left, element)) {
+        return CLINKEDLIST_ALLOC_FAILURE;
+    }
+    return CLINKEDLIST_SUCCESS;
+}
+
+int CListCursor_remove_here(CListCursor_t *cursor) {
+    if (!cursor || !cursor->list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+    if (!cursor->node) {
+        return CLINKEDLIST_INDEX_OUT_OF_BOUNDS;
+    }
+
+    unlink_node(cursor->list, cursor->prev, cursor->node);
+    cursor->node = NULL;
+    return CLINKEDLIST_SUCCESS;
+}
+
+/// \internal
+/// \brief Number of sorted runs kept by `CLinkedList_sort`. Run `i` holds
+/// 2^i nodes, so no list can fill them all.
+#define SORT_RUNS 64
+
+/// \internal
+/// \brief Get the element of a node, whichever the list type; both node
+/// types start with it.
+static void *value_of(const void *node) {
+    return *(void *const *)node;
+}
+
+/// \internal
+/// \brief Get the `next` field of a node, found at `offset`.
+static void **next_of(size_t offset, void *node) {
+    return (void **)((char *)node + offset);
+}
+
+/// \internal
+/// \brief Merge two sorted chains ending in NULL, taking from `a` on ties.
+static void *merge(size_t offset, CompareTo cmp, void *a, void *b) {
+    void *head = NULL;
+    void **link = &head;
+    while (a && b) {
+        if (cmp(value_of(b), value_of(a)) < 0) {
+            *link = b;
+            link = next_of(offset, b);
+            b = *link;
+        } else {
+            *link = a;
+            link = next_of(offset, a);
+            a = *link;
+        }
+    }
+    *link = a ? a : b;
+    return head;
+}
+
+int CLinkedList_sort(CLinkedList_t *list, CompareTo cmp) {
+    if (!list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+    if (!cmp) {
+        return CLINKEDLIST_INVALID_OPERATION;
+    }
+    if (list->size < 2) {
+        return CLINKEDLIST_SUCCESS;
+    }
+
+    // Sort the `next` chain alone, keeping runs of 1, 2, 4... nodes that
+    // merge like the digits of a binary counter; runs[i] always holds nodes
+    // from before those of runs[i - 1].
+    size_t offset;
+    void *node;
+    if (list->tail) { // DOUBLY LINKED LIST
+        offset = offsetof(__CDNode, next);
+        node = list->dhead->next;
+        list->tail->prev->next = NULL;
+    } else { // SINGLY LINKED LIST
+        offset = offsetof(__CSNode, next);
+        node = list->shead;
+    }
+    void *runs[SORT_RUNS] = {NULL};
+    while (node) {
+        void *run = node;
+        node = *next_of(offset, node);
+        *next_of(offset, run) = NULL;
+        size_t i = 0;
+        for (; runs[i]; i++) {
+            run = merge(offset, cmp, runs[i], run);
+            runs[i] = NULL;
+        }
+        runs[i] = run;
+    }
+    void *sorted = NULL;
+    for (size_t i = 0; i < SORT_RUNS; i++) {
+        if (runs[i]) {
+            sorted = merge(offset, cmp, runs[i], sorted);
+        }
+    }
+
+    if (list->tail) { // DOUBLY LINKED LIST
+        __CDNode *prev = list->dhead;
+        for (__CDNode *current = sorted; current; current = current->next) {
+            current->prev = prev;
+            prev->next = current;
+            prev = current;
+        }
+        prev->next = list->tail;
+        list->tail->prev = prev;
+    } else { // SINGLY LINKED LIST
+        list->shead = sorted;
+        __CSNode *last = sorted;
+        while (last->next) {
+            last = last->next;
+        }
+        list->slast = last;
+    }
+    return CLINKEDLIST_SUCCESS;
+}
+
+int CLinkedList_splice(CLinkedList_t *list, CListNode_t *after,
+                       CLinkedList_t *other) {
+    if (!list || !other) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+    if (list == other || !list->tail != !other->tail) {
+        return CLINKEDLIST_INVALID_OPERATION;
+    }
+    if (other->size == 0) {
+        return CLINKEDLIST_SUCCESS;
+    }
+
+    if (list->tail) { // DOUBLY LINKED LIST
+        __CDNode *first = other->dhead->next;
+        __CDNode *last = other->tail->prev;
+        __CDNode *prev = after ? (__CDNode *)after : list->dhead;
+        last->next = prev->next;
+        prev->next->prev = last;
+        prev->next = first;
+        first->prev = prev;
+        other->dhead->next = other->tail;
+        other->tail->prev = other->dhead;
+    } else { // SINGLY LINKED LIST
+        __CSNode *prev = (__CSNode *)after;
+        __CSNode *last = other->slast;
+        if (prev) {
+            last->next = prev->next;
+            prev->next = other->shead;
+        } else {
+            last->next = list->shead;
+            list->shead = other->shead;
+        }
+        if (!last->next) {
+            list->slast = last;
+        }
+        other->shead = NULL;
+        other->slast = NULL;
+    }
+    list->size += other->size;
+    other->size = 0;
+    return CLINKEDLIST_SUCCESS;
+}
+
+int CLinkedList_concat(CLinkedList_t *list, CLinkedList_t *other) {
+    if (!list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+    void *last = list->tail ? outer(list, list->tail->prev) : list->slast;
+    return CLinkedList_splice(list, last, other);
+}
+
+int CLinkedList_reverse(CLinkedList_t *list) {
+    if (!list) {
+        return CLINKEDLIST_NULL_LIST;
+    }
+    if (list->size < 2) {
+        return CLINKEDLIST_SUCCESS;
+    }
+
+    if (list->tail) { // DOUBLY LINKED LIST
+        __CDNode *first = list->dhead->next;
+        __CDNode *last = list->tail->prev;
+        for (__CDNode *current = first; current != list->tail;) {
+            __CDNode *next = current->next;
+            current->next = current->prev;
+            current->prev = next;
+            current = next;
+        }
+        list->dhead->next = last;
+        last->prev = list->dhead;
+        list->tail->prev = first;
+        first->next = list->tail;
+    } else { // SINGLY LINKED LIST
+        __CSNode *prev = NULL;
+        __CSNode *current = list->shead;
+        list->slast = current;
+        while (current) {
+            __CSNode *next = current->next;
+            current->next = prev;
+            prev = current;
+            current = next;
+        }
+        list->shead = prev;
+    }
+    return CLINKEDLIST_SUCCESS;
+}
@@ -0,0 +1,394 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CPerfectHash.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAGIC "CSTDMPHF"
+#define VERSION 1
+#define LOAD_PERCENT 98    ///< Keys per 100 table positions.
+#define BUCKET_FACTOR 5    ///< Buckets per key, times log2 of the key count.
+#define MAX_PILOT (1 << 24)
+#define MAX_ATTEMPTS 16
+
+struct _CPerfectHash {
+    Hash hash;
+    uint64_t seed;          ///< Mixed into every key hash.
+    uint64_t count;         ///< Number of keys.
+    uint64_t table_size;    ///< Number of positions, a little above `count`.
+    uint64_t buckets;       ///< Number of buckets.
+    uint64_t dense;         ///< Buckets that receive 60% of the keys.
+    uint32_t width;         ///< Bytes per pilot: 1, 2 or 4.
+    uint64_t *remap;        ///< Free index for each position past `count`.
+    unsigned char *pilots;  ///< One pilot per bucket.
+};
+
+/// \internal
+/// \brief Serialized header, followed by `remap` and `pilots`.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint64_t seed;
+    uint64_t count;
+    uint64_t table_size;
+    uint64_t buckets;
+    uint64_t dense;
+} Header;
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/// \internal
+/// \brief Skewed bucket assignment: 60% of the keys go to the first 30% of
+/// the buckets. The crowded buckets are placed first while the table is
+/// empty, which keeps the pilots small.
+static uint64_t bucket_of(const CPerfectHash_t *ph, uint64_t g) {
+    uint64_t high = g >> 32;
+    if ((g & 0xffffffffULL) < 0x99999999ULL)
+        return high % ph->dense;
+    return ph->dense + high % (ph->buckets - ph->dense);
+}
+
+static uint64_t position(const CPerfectHash_t *ph, uint64_t g,
+                         uint64_t pilot) {
+    return mix(g ^ mix(pilot + ph->seed)) % ph->table_size;
+}
+
+static uint64_t pilot_of(const CPerfectHash_t *ph, uint64_t bucket) {
+    if (ph->width == 1)
+        return ph->pilots[bucket];
+    if (ph->width == 2) {
+        uint16_t pilot;
+        memcpy(&pilot, ph->pilots + bucket * 2, 2);
+        return pilot;
+    }
+    uint32_t pilot;
+    memcpy(&pilot, ph->pilots + bucket * 4, 4);
+    return pilot;
+}
+
+/// \internal
+/// \brief Allocate a function together with its arrays.
+static CPerfectHash_t *create(Hash hash, uint64_t count, uint64_t buckets,
+                              uint32_t width) {
+    uint64_t table_size = count ? (count * 100 + LOAD_PERCENT - 1) /
+                                      LOAD_PERCENT
+                                : 0;
+    size_t remap = (size_t)(table_size - count) * sizeof(uint64_t);
+    CPerfectHash_t *ph =
+        malloc(sizeof(CPerfectHash_t) + remap + (size_t)buckets * width);
+    if (ph == NULL)
+        return NULL;
+    ph->hash = hash;
+    ph->seed = 0;
+    ph->count = count;
+    ph->table_size = table_size;
+    ph->buckets = buckets;
+    ph->dense = buckets * 3 / 10 ? buckets * 3 / 10 : 1;
+    ph->width = width;
+    ph->remap = (uint64_t *)(ph + 1);
+    ph->pilots = (unsigned char *)ph->remap + remap;
+    return ph;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/// \internal
+/// \brief Try to place every bucket with the current seed.
+/// \return `CPERFECTHASH_SUCCESS`, `CPERFECTHASH_DUPLICATE_KEYS`, or
+/// `CPERFECTHASH_BUILD_FAILURE` if another seed should be tried.
+static int place(CPerfectHash_t *ph, const uint64_t *hashes, uint64_t *g,
+                 uint64_t *start, uint64_t *order, uint64_t *taken,
+                 uint32_t *pilots) {
+    uint64_t n = ph->count, buckets = ph->buckets;
+
+    // Counting sort of the mixed hashes by bucket.
+    memset(start, 0, (buckets + 1) * sizeof(uint64_t));
+    for (uint64_t i = 0; i < n; i++)
+        start[bucket_of(ph, mix(hashes[i] ^ ph->seed)) + 1]++;
+    uint64_t largest = 0;
+    for (uint64_t b = 0; b < buckets; b++) {
+        if (start[b + 1] > largest)
+            largest = start[b + 1];
+        start[b + 1] += start[b];
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t h = mix(hashes[i] ^ ph->seed);
+        g[start[bucket_of(ph, h)]++] = h;
+    }
+    memmove(start + 1, start, buckets * sizeof(uint64_t));
+    start[0] = 0;
+
+    // Buckets from the largest to the smallest, again by counting sort.
+    uint64_t *by_size = calloc(largest + 2, sizeof(uint64_t));
+    if (by_size == NULL)
+        return CPERFECTHASH_ALLOC_FAILURE;
+    for (uint64_t b = 0; b < buckets; b++)
+        by_size[largest - (start[b + 1] - start[b]) + 1]++;
+    for (uint64_t s = 0; s <= largest; s++)
+        by_size[s + 1] += by_size[s];
+    for (uint64_t b = 0; b < buckets; b++)
+        order[by_size[largest - (start[b + 1] - start[b])]++] = b;
+    free(by_size);
+
+    memset(taken, 0, (ph->table_size + 63) / 64 * sizeof(uint64_t));
+    uint64_t positions[64];
+    for (uint64_t i = 0; i < buckets; i++) {
+        uint64_t b = order[i];
+        uint64_t *keys = g + start[b];
+        uint64_t size = start[b + 1] - start[b];
+        if (size == 0)
+            break;
+        if (size > 64)
+            return CPERFECTHASH_BUILD_FAILURE;
+        qsort(keys, size, sizeof(uint64_t), compare_u64);
+        for (uint64_t j = 1; j < size; j++)
+            if (keys[j] == keys[j - 1])
+                return CPERFECTHASH_DUPLICATE_KEYS;
+
+        uint32_t pilot = 0;
+        for (;; pilot++) {
+            if (pilot == MAX_PILOT)
+                return CPERFECTHASH_BUILD_FAILURE;
+            uint64_t j = 0;
+            for (; j < size; j++) {
+                uint64_t p = position(ph, keys[j], pilot);
+                if (taken[p / 64] >> (p % 64) & 1)
+                    break;
+                taken[p / 64] |= 1ULL << (p % 64);
+                positions[j] = p;
+            }
+            if (j == size)
+                break;
+            while (j--)
+                taken[positions[j] / 64] &= ~(1ULL << (positions[j] % 64));
+        }
+        pilots[b] = pilot;
+    }
+    return CPERFECTHASH_SUCCESS;
+}
+
+CResult_t *CPerfectHash_build(const CVector_t *keys, Hash hash) {
+    if (keys == NULL || hash == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null pointer to the keys or the hash function.",
+            "CPerfectHash_build", CPERFECTHASH_NULL_VAL));
+
+    uint64_t n = CVector_size((CVector_t *)keys);
+    uint64_t log2n = 1;
+    while ((2ULL << log2n) <= n)
+        log2n++;
+    uint64_t buckets = n ? (BUCKET_FACTOR * n + log2n - 1) / log2n : 0;
+    if (n && buckets < 2)
+        buckets = 2;
+
+    CPerfectHash_t *ph = create(hash, n, buckets, sizeof(uint32_t));
+    uint64_t *hashes = malloc(n * sizeof(uint64_t) + 1);
+    uint64_t *g = malloc(n * sizeof(uint64_t) + 1);
+    uint64_t *start = malloc((buckets + 1) * sizeof(uint64_t));
+    uint64_t *order = malloc(buckets * sizeof(uint64_t) + 1);
+    uint64_t *taken =
+        malloc((ph ? ph->table_size + 63 : 0) / 64 * sizeof(uint64_t) + 1);
+    uint32_t *pilots = ph ? (uint32_t *)ph->pilots : NULL;
+
+    int code = CPERFECTHASH_ALLOC_FAILURE;
+    if (ph && hashes && g && start && order && taken) {
+        for (uint64_t i = 0; i < n; i++)
+            hashes[i] = hash(CVector_fget(keys, (size_t)i));
+        code = n ? CPERFECTHASH_BUILD_FAILURE : CPERFECTHASH_SUCCESS;
+        for (int attempt = 0; n && attempt < MAX_ATTEMPTS; attempt++) {
+            ph->seed = mix(0x9e3779b97f4a7c15ULL * (attempt + 1));
+            code = place(ph, hashes, g, start, order, taken, pilots);
+            if (code != CPERFECTHASH_BUILD_FAILURE)
+                break;
+        }
+    }
+
+    if (code == CPERFECTHASH_SUCCESS) {
+        // Send the positions past the end to the holes below it. Unused
+        // ones still need a valid index for keys outside the set.
+        uint64_t hole = 0;
+        for (uint64_t p = n; p < ph->table_size; p++) {
+            ph->remap[p - n] = 0;
+            if (!(taken[p / 64] >> (p % 64) & 1))
+                continue;
+            while (taken[hole / 64] >> (hole % 64) & 1)
+                hole++;
+            ph->remap[p - n] = hole++;
+        }
+
+        // Most pilots are tiny, so store them with as few bytes as possible.
+        uint32_t largest = 0;
+        for (uint64_t b = 0; b < buckets; b++)
+            if (pilots[b] > largest)
+                largest = pilots[b];
+        uint32_t width = largest <= UINT8_MAX ? 1 : largest <= UINT16_MAX ? 2
+                                                                          : 4;
+        for (uint64_t b = 0; width < 4 && b < buckets; b++) {
+            if (width == 1) {
+                ph->pilots[b] = (unsigned char)pilots[b];
+            } else {
+                uint16_t pilot = (uint16_t)pilots[b];
+                memcpy(ph->pilots + b * 2, &pilot, 2);
+            }
+        }
+        ph->width = width;
+        size_t remap = (size_t)(ph->table_size - n) * sizeof(uint64_t);
+        CPerfectHash_t *shrunk =
+            realloc(ph, sizeof(CPerfectHash_t) + remap + buckets * width);
+        if (shrunk != NULL) {
+            ph = shrunk;
+            ph->remap = (uint64_t *)(ph + 1);
+            ph->pilots = (unsigned char *)ph->remap + remap;
+        }
+    }
+
+    free(hashes);
+    free(g);
+    free(start);
+    free(order);
+    free(taken);
+    if (code == CPERFECTHASH_DUPLICATE_KEYS) {
+        free(ph);
+        return CResult_ecreate(CError_create(
+            "Two keys have the same hash.", "CPerfectHash_build", code));
+    }
+    if (code) {
+        free(ph);
+        return CResult_ecreate(
+            CError_create("Unable to build the perfect hash function.",
+                          "CPerfectHash_build", code));
+    }
+    return CResult_create(ph, NULL);
+}
+
+size_t CPerfectHash_size(const CPerfectHash_t *ph) {
+    return ph ? (size_t)ph->count : 0;
+}
+
+size_t CPerfectHash_index(const CPerfectHash_t *ph, const void *key) {
+    if (ph == NULL || ph->count == 0)
+        return 0;
+    uint64_t g = mix((uint64_t)ph->hash(key) ^ ph->seed);
+    uint64_t p = position(ph, g, pilot_of(ph, bucket_of(ph, g)));
+    return (size_t)(p < ph->count ? p : ph->remap[p - ph->count]);
+}
+
+size_t CPerfectHash_serialize(const void *data, void *buffer, size_t size) {
+    const CPerfectHash_t *ph = data;
+    if (ph == NULL)
+        return 0;
+    size_t remap = (size_t)(ph->table_size - ph->count) * sizeof(uint64_t);
+    size_t pilots = (size_t)ph->buckets * ph->width;
+    size_t needed = sizeof(Header) + remap + pilots;
+    if (needed > size)
+        return needed;
+
+    Header header = {{0},       VERSION,        ph->width,    ph->seed,
+                     ph->count, ph->table_size, ph->buckets, ph->dense};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    char *out = buffer;
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), ph->remap, remap);
+    memcpy(out + sizeof(header) + remap, ph->pilots, pilots);
+    return needed;
+}
+
+CResult_t *CPerfectHash_deserialize(const void *buffer, size_t size,
+                                    Hash hash) {
+    if (buffer == NULL || hash == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null pointer to the buffer or the hash function.",
+            "CPerfectHash_deserialize", CPERFECTHASH_NULL_VAL));
+
+    Header header;
+    int valid = size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, buffer, sizeof(header));
+        uint64_t rest = size - sizeof(header);
+        valid = memcmp(header.magic, MAGIC, 8) == 0 &&
+                header.version == VERSION && header.count < (1ULL << 56) &&
+                (header.width == 1 || header.width == 2 ||
+                 header.width == 4) &&
+                header.table_size >= header.count &&
+                header.table_size - header.count <= rest / 8 &&
+                header.buckets <= rest / header.width &&
+                (header.table_size - header.count) * 8 +
+                        header.buckets * header.width ==
+                    rest &&
+                (header.count == 0
+                     ? header.table_size == 0 && header.buckets == 0
+                     : header.table_size > header.count &&
+                           header.buckets >= 2 && header.dense >= 1 &&
+                           header.dense < header.buckets);
+    }
+    CPerfectHash_t *ph = NULL;
+    if (valid) {
+        ph = create(hash, header.count, header.buckets, header.width);
+        if (ph == NULL)
+            return CResult_ecreate(CError_create(
+                "Unable to allocate memory for CPerfectHash.",
+                "CPerfectHash_deserialize", CPERFECTHASH_ALLOC_FAILURE));
+        valid = ph->table_size == header.table_size;
+    }
+    if (valid) {
+        const char *in = (const char *)buffer + sizeof(header);
+        size_t remap = (size_t)(ph->table_size - ph->count) * 8;
+        memcpy(ph->remap, in, remap);
+        memcpy(ph->pilots, in + remap, (size_t)ph->buckets * ph->width);
+        ph->seed = header.seed;
+        ph->dense = header.dense;
+        for (uint64_t i = 0; valid && i < ph->table_size - ph->count; i++)
+            valid = ph->remap[i] < ph->count;
+    }
+    if (!valid) {
+        free(ph);
+        return CResult_ecreate(
+            CError_create("The buffer does not hold a perfect hash function.",
+                          "CPerfectHash_deserialize",
+                          CPERFECTHASH_INVALID_FORMAT));
+    }
+    return CResult_create(ph, NULL);
+}
+
+int CPerfectHash_free(CPerfectHash_t **ph) {
+    if (ph == NULL || *ph == NULL)
+        return CPERFECTHASH_SUCCESS;
+    free(*ph);
+    *ph = NULL;
+    return CPERFECTHASH_SUCCESS;
+}
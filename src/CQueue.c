@@ -21,12 +21,12 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
-#include <cstd/CLinkedList.h>
+#include <cstd/CDeque.h>
 #include <cstd/CQueue.h>
 #include <stdlib.h>
 
 struct _CQueue {
-    CLinkedList_t *list;
+    CDeque_t *deque;
     Destructor destroy;
 };
 
@@ -39,7 +39,7 @@ CResult_t *CQueue_new(Destructor destroy) {
                           "CQueue_new", CQUEUE_ALLOC_FAILURE));
     }
 
-    CResult_t *res = CLinkedList_new(CLINKEDLIST_TYPE_SINGLE, destroy);
+    CResult_t *res = CDeque_new(destroy);
     if (CResult_is_error(res)) {
         free(queue);
         CError_t *err = CResult_eget(res);
@@ -48,7 +48,7 @@ CResult_t *CQueue_new(Destructor destroy) {
         return res;
     }
 
-    queue->list = CResult_get(res);
+    queue->deque = CResult_get(res);
     queue->destroy = destroy;
 
     CResult_modify(res, queue, NULL);
@@ -60,12 +60,12 @@ int CQueue_init(CQueue_t *queue, Destructor destroy) {
         return CQUEUE_NULL_QUEUE;
     }
 
-    CResult_t *res = CLinkedList_new(CLINKEDLIST_TYPE_SINGLE, destroy);
+    CResult_t *res = CDeque_new(destroy);
     if (CResult_is_error(res)) {
         return CQUEUE_ALLOC_FAILURE;
     }
 
-    queue->list = CResult_get(res);
+    queue->deque = CResult_get(res);
     queue->destroy = destroy;
 
     return CQUEUE_SUCCESS;
@@ -73,7 +73,7 @@ int CQueue_init(CQueue_t *queue, Destructor destroy) {
 
 size_t CQueue_size(CQueue_t *queue) {
     if (!queue) return 0;
-    return CLinkedList_size(queue->list);
+    return CDeque_size(queue->deque);
 }
 
 int CQueue_push(CQueue_t *queue, void *element) {
@@ -81,8 +81,8 @@ int CQueue_push(CQueue_t *queue, void *element) {
         return CQUEUE_NULL_QUEUE;
     }
 
-    int result = CLinkedList_add(queue->list, element);
-    if (result != CLINKEDLIST_SUCCESS) {
+    int result = CDeque_push_back(queue->deque, element);
+    if (result != CDEQUE_SUCCESS) {
         return CQUEUE_ADD_FAILURE;
     }
 
@@ -95,26 +95,12 @@ CResult_t *CQueue_pop(CQueue_t *queue) {
             CError_create("Queue is NULL.", "CQueue_pop", CQUEUE_NULL_QUEUE));
     }
 
-    if (CLinkedList_size(queue->list) == 0) {
+    if (CDeque_size(queue->deque) == 0) {
         return CResult_ecreate(
             CError_create("Queue is empty.", "CQueue_pop", CQUEUE_EMPTY));
     }
 
-    CResult_t *res = CLinkedList_get(queue->list, 0);
-    if (CResult_is_error(res)) {
-        return res;
-    }
-
-    void *value = CResult_get(res);
-    CResult_free(&res);
-
-    int remove_result = CLinkedList_remove(queue->list, 0);
-    if (remove_result != CLINKEDLIST_SUCCESS) {
-        return CResult_ecreate(CError_create(
-            "Failed to remove element.", "CQueue_pop", CQUEUE_REMOVE_FAILURE));
-    }
-
-    return CResult_create(value, NULL);
+    return CResult_create(CDeque_fpop_front(queue->deque), NULL);
 }
 
 int CQueue_clear(CQueue_t *queue) {
@@ -122,8 +108,8 @@ int CQueue_clear(CQueue_t *queue) {
         return CQUEUE_NULL_QUEUE;
     }
 
-    int result = CLinkedList_clear(queue->list);
-    if (result != CLINKEDLIST_SUCCESS) {
+    int result = CDeque_clear(queue->deque);
+    if (result != CDEQUE_SUCCESS) {
         return CQUEUE_CLEAR_FAILURE;
     }
 
@@ -135,8 +121,8 @@ int CQueue_free(CQueue_t **queue) {
         return CQUEUE_NULL_QUEUE;
     }
 
-    if ((*queue)->list) {
-        CLinkedList_free(&(*queue)->list);
+    if ((*queue)->deque) {
+        CDeque_free(&(*queue)->deque);
     }
 
     free(*queue);
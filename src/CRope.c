@@ -0,0 +1,506 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CRope.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// \internal
+/// \brief Immutable, reference counted node of a rope. Leaves hold the
+/// characters; branches hold two non-empty subtrees.
+typedef struct _CRopeNode {
+    atomic_size_t refs;        ///< Number of ropes and branches sharing it.
+    size_t length;             ///< Number of characters in the subtree.
+    int height;                ///< Leaves have height 0.
+    struct _CRopeNode *left;   ///< Left subtree, NULL for leaves.
+    struct _CRopeNode *right;  ///< Right subtree, NULL for leaves.
+    char data[];               ///< Characters of a leaf.
+} Node;
+
+struct _CRope {
+    Node *root; ///< Root of the tree, NULL for an empty rope.
+};
+
+// Every internal function below consumes the references to the nodes passed
+// to it and returns a new reference, so that a failed allocation can release
+// everything it was handed and leave the caller's rope untouched.
+
+static Node *retain(Node *node) {
+    if (node != NULL)
+        atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+    return node;
+}
+
+static void release(Node *node) {
+    while (node != NULL &&
+           atomic_fetch_sub_explicit(&node->refs, 1, memory_order_acq_rel) ==
+               1) {
+        Node *right = node->right;
+        release(node->left);
+        free(node);
+        node = right;
+    }
+}
+
+static int height(const Node *node) { return node ? node->height : -1; }
+
+static Node *leaf(const char *ptr, size_t len) {
+    Node *node = malloc(sizeof(Node) + len);
+    if (node == NULL)
+        return NULL;
+    atomic_init(&node->refs, 1);
+    node->length = len;
+    node->height = 0;
+    node->left = node->right = NULL;
+    memcpy(node->data, ptr, len);
+    return node;
+}
+
+static Node *branch(Node *left, Node *right) {
+    if (left == NULL || right == NULL) {
+        release(left);
+        release(right);
+        return NULL;
+    }
+
+    Node *node = malloc(sizeof(Node));
+    if (node == NULL) {
+        release(left);
+        release(right);
+        return NULL;
+    }
+    atomic_init(&node->refs, 1);
+    node->length = left->length + right->length;
+    node->height =
+        1 + (left->height > right->height ? left->height : right->height);
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+/// \internal
+/// \brief Join two subtrees whose heights differ by at most two, rotating
+/// once or twice to restore the AVL balance.
+static Node *balance(Node *left, Node *right) {
+    if (left == NULL || right == NULL)
+        return branch(left, right);
+
+    if (height(right) > height(left) + 1) {
+        Node *rl = retain(right->left), *rr = retain(right->right);
+        release(right);
+        if (height(rl) > height(rr)) {
+            Node *rll = retain(rl->left), *rlr = retain(rl->right);
+            release(rl);
+            return branch(branch(left, rll), branch(rlr, rr));
+        }
+        return branch(branch(left, rl), rr);
+    }
+
+    if (height(left) > height(right) + 1) {
+        Node *ll = retain(left->left), *lr = retain(left->right);
+        release(left);
+        if (height(lr) > height(ll)) {
+            Node *lrl = retain(lr->left), *lrr = retain(lr->right);
+            release(lr);
+            return branch(branch(ll, lrl), branch(lrr, right));
+        }
+        return branch(ll, branch(lr, right));
+    }
+
+    return branch(left, right);
+}
+
+/// \internal
+/// \brief Concatenate two trees, descending the spine of the taller one.
+static Node *join(Node *left, Node *right) {
+    if (left == NULL)
+        return right;
+    if (right == NULL)
+        return left;
+
+    // Merge small neighbouring leaves instead of stacking them.
+    if (left->height == 0 && right->height == 0 &&
+        left->length + right->length <= CROPE_LEAF_SIZE) {
+        Node *node = malloc(sizeof(Node) + left->length + right->length);
+        if (node != NULL) {
+            atomic_init(&node->refs, 1);
+            node->length = left->length + right->length;
+            node->height = 0;
+            node->left = node->right = NULL;
+            memcpy(node->data, left->data, left->length);
+            memcpy(node->data + left->length, right->data, right->length);
+        }
+        release(left);
+        release(right);
+        return node;
+    }
+
+    if (left->height > right->height + 1) {
+        Node *ll = retain(left->left), *lr = retain(left->right);
+        release(left);
+        Node *joined = join(lr, right);
+        if (joined == NULL) {
+            release(ll);
+            return NULL;
+        }
+        return balance(ll, joined);
+    }
+
+    if (right->height > left->height + 1) {
+        Node *rl = retain(right->left), *rr = retain(right->right);
+        release(right);
+        Node *joined = join(left, rl);
+        if (joined == NULL) {
+            release(rr);
+            return NULL;
+        }
+        return balance(joined, rr);
+    }
+
+    return branch(left, right);
+}
+
+/// \internal
+/// \brief Split a tree into its first `index` characters and the rest.
+/// \return 0 on success, or -1 if an allocation failed, in which case both
+/// outputs are NULL.
+static int split(Node *node, size_t index, Node **left, Node **right) {
+    *left = *right = NULL;
+    if (node == NULL)
+        return 0;
+    if (index == 0) {
+        *right = node;
+        return 0;
+    }
+    if (index >= node->length) {
+        *left = node;
+        return 0;
+    }
+
+    if (node->height == 0) {
+        Node *head = leaf(node->data, index);
+        Node *tail = leaf(node->data + index, node->length - index);
+        release(node);
+        if (head == NULL || tail == NULL) {
+            release(head);
+            release(tail);
+            return -1;
+        }
+        *left = head;
+        *right = tail;
+        return 0;
+    }
+
+    Node *l = retain(node->left), *r = retain(node->right);
+    release(node);
+
+    if (index == l->length) {
+        *left = l;
+        *right = r;
+        return 0;
+    }
+
+    Node *a, *b;
+    if (index < l->length) {
+        if (split(l, index, &a, &b)) {
+            release(r);
+            return -1;
+        }
+        b = join(b, r);
+        if (b == NULL) {
+            release(a);
+            return -1;
+        }
+    } else {
+        if (split(r, index - l->length, &a, &b)) {
+            release(l);
+            return -1;
+        }
+        a = join(l, a);
+        if (a == NULL) {
+            release(b);
+            return -1;
+        }
+    }
+    *left = a;
+    *right = b;
+    return 0;
+}
+
+/// \internal
+/// \brief Build a perfectly balanced tree of full leaves over the characters.
+static Node *build(const char *ptr, size_t len) {
+    if (len == 0)
+        return NULL;
+    if (len <= CROPE_LEAF_SIZE)
+        return leaf(ptr, len);
+
+    size_t leaves = (len + CROPE_LEAF_SIZE - 1) / CROPE_LEAF_SIZE;
+    size_t mid = leaves / 2 * CROPE_LEAF_SIZE;
+    Node *left = build(ptr, mid);
+    if (left == NULL)
+        return NULL;
+    return branch(left, build(ptr + mid, len - mid));
+}
+
+static CResult_t *wrap(Node *root, const char *caller) {
+    CRope_t *rope = malloc(sizeof(CRope_t));
+    if (rope == NULL) {
+        release(root);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CRope.", caller,
+            CROPE_ALLOC_FAILURE));
+    }
+    rope->root = root;
+    return CResult_create(rope, NULL);
+}
+
+CResult_t *CRope_new() { return wrap(NULL, "CRope_new"); }
+
+CResult_t *CRope_from_view(CStringView_t view) {
+    Node *root = build(view.ptr, view.len);
+    if (root == NULL && view.len)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for the rope's characters.",
+            "CRope_from_view", CROPE_ALLOC_FAILURE));
+    return wrap(root, "CRope_from_view");
+}
+
+CResult_t *CRope_from_cstring(const CString_t *string) {
+    if (string == NULL)
+        return CResult_ecreate(CError_create("Recieved a null string.",
+                                             "CRope_from_cstring",
+                                             CROPE_NULL_ROPE));
+    return CRope_from_view(CString_view(string));
+}
+
+int CRope_init(CRope_t *rope) {
+    if (rope == NULL)
+        return CROPE_NULL_ROPE;
+    rope->root = NULL;
+    return CROPE_SUCCESS;
+}
+
+size_t CRope_length(const CRope_t *rope) {
+    if (rope == NULL || rope->root == NULL)
+        return 0;
+    return rope->root->length;
+}
+
+char CRope_at(const CRope_t *rope, size_t index) {
+    if (index >= CRope_length(rope))
+        return '\0';
+
+    const Node *node = rope->root;
+    while (node->height) {
+        if (index < node->left->length) {
+            node = node->left;
+        } else {
+            index -= node->left->length;
+            node = node->right;
+        }
+    }
+    return node->data[index];
+}
+
+int CRope_insert(CRope_t *rope, size_t index, CStringView_t view) {
+    if (rope == NULL)
+        return CROPE_NULL_ROPE;
+    if (index > CRope_length(rope))
+        return CROPE_INDEX_OUT_OF_BOUNDS;
+    if (view.len == 0)
+        return CROPE_SUCCESS;
+
+    Node *middle = build(view.ptr, view.len);
+    if (middle == NULL)
+        return CROPE_ALLOC_FAILURE;
+
+    Node *left, *right;
+    if (split(retain(rope->root), index, &left, &right)) {
+        release(middle);
+        return CROPE_ALLOC_FAILURE;
+    }
+
+    Node *head = join(left, middle);
+    if (head == NULL) {
+        release(right);
+        return CROPE_ALLOC_FAILURE;
+    }
+    Node *root = join(head, right);
+    if (root == NULL)
+        return CROPE_ALLOC_FAILURE;
+
+    release(rope->root);
+    rope->root = root;
+    return CROPE_SUCCESS;
+}
+
+int CRope_append(CRope_t *rope, CStringView_t view) {
+    return CRope_insert(rope, CRope_length(rope), view);
+}
+
+int CRope_prepend(CRope_t *rope, CStringView_t view) {
+    return CRope_insert(rope, 0, view);
+}
+
+int CRope_delete(CRope_t *rope, size_t start, size_t end) {
+    if (rope == NULL)
+        return CROPE_NULL_ROPE;
+    if (start > end || end > CRope_length(rope))
+        return CROPE_INDEX_OUT_OF_BOUNDS;
+    if (start == end)
+        return CROPE_SUCCESS;
+
+    Node *head, *rest, *middle, *tail;
+    if (split(retain(rope->root), end, &rest, &tail))
+        return CROPE_ALLOC_FAILURE;
+    if (split(rest, start, &head, &middle)) {
+        release(tail);
+        return CROPE_ALLOC_FAILURE;
+    }
+    release(middle);
+
+    Node *root = join(head, tail);
+    if (root == NULL && start + CRope_length(rope) - end)
+        return CROPE_ALLOC_FAILURE;
+
+    release(rope->root);
+    rope->root = root;
+    return CROPE_SUCCESS;
+}
+
+int CRope_concat(CRope_t *rope, const CRope_t *other) {
+    if (rope == NULL || other == NULL)
+        return CROPE_NULL_ROPE;
+    if (other->root == NULL)
+        return CROPE_SUCCESS;
+
+    Node *root = join(retain(rope->root), retain(other->root));
+    if (root == NULL)
+        return CROPE_ALLOC_FAILURE;
+
+    release(rope->root);
+    rope->root = root;
+    return CROPE_SUCCESS;
+}
+
+CResult_t *CRope_substring(const CRope_t *rope, size_t start, size_t end) {
+    if (rope == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null rope.", "CRope_substring", CROPE_NULL_ROPE));
+    if (start > end || end > CRope_length(rope))
+        return CResult_ecreate(
+            CError_create("Range lies outside of the rope.", "CRope_substring",
+                          CROPE_INDEX_OUT_OF_BOUNDS));
+
+    Node *head, *rest, *middle, *tail;
+    if (split(retain(rope->root), end, &rest, &tail))
+        goto failure;
+    release(tail);
+    if (split(rest, start, &head, &middle))
+        goto failure;
+    release(head);
+    return wrap(middle, "CRope_substring");
+
+failure:
+    return CResult_ecreate(
+        CError_create("Unable to allocate memory for the substring.",
+                      "CRope_substring", CROPE_ALLOC_FAILURE));
+}
+
+CResult_t *CRope_clone(const CRope_t *rope) {
+    if (rope == NULL)
+        return CResult_ecreate(CError_create("Recieved a null rope.",
+                                             "CRope_clone", CROPE_NULL_ROPE));
+    return wrap(retain(rope->root), "CRope_clone");
+}
+
+CResult_t *CRope_to_cstring(const CRope_t *rope) {
+    if (rope == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null rope.", "CRope_to_cstring", CROPE_NULL_ROPE));
+
+    CResult_t *res = CString_new();
+    if (CResult_is_error(res))
+        return res;
+    CString_t *string = CResult_get(res);
+
+    int code = CString_reserve(string, CRope_length(rope));
+    CRopeIter_t iter = CRope_iter(rope);
+    CStringView_t chunk;
+    while (!code && CRopeIter_next(&iter, &chunk))
+        code = CString_append_n(string, chunk.ptr, chunk.len);
+
+    if (code) {
+        CResult_free(&res);
+        CString_free(&string);
+        return CResult_ecreate(
+            CError_create("Unable to allocate memory for the string.",
+                          "CRope_to_cstring", CROPE_ALLOC_FAILURE));
+    }
+    return res;
+}
+
+CRopeIter_t CRope_iter(const CRope_t *rope) {
+    CRopeIter_t iter;
+    iter.depth = 0;
+    if (rope != NULL && rope->root != NULL)
+        iter.stack[iter.depth++] = rope->root;
+    return iter;
+}
+
+int CRopeIter_next(CRopeIter_t *iter, CStringView_t *chunk) {
+    if (iter == NULL || iter->depth == 0)
+        return 0;
+
+    // Descend to the leftmost leaf, leaving the right subtrees for later.
+    const Node *node = iter->stack[--iter->depth];
+    while (node->height) {
+        iter->stack[iter->depth++] = node->right;
+        node = node->left;
+    }
+
+    if (chunk != NULL)
+        *chunk = CStringView_from(node->data, node->length);
+    return 1;
+}
+
+int CRope_clear(CRope_t *rope) {
+    if (rope == NULL)
+        return CROPE_NULL_ROPE;
+    release(rope->root);
+    rope->root = NULL;
+    return CROPE_SUCCESS;
+}
+
+int CRope_free(CRope_t **rope) {
+    if (rope == NULL || *rope == NULL)
+        return CROPE_SUCCESS;
+    CRope_clear(*rope);
+    free(*rope);
+    *rope = NULL;
+    return CROPE_SUCCESS;
+}
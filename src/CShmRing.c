@@ -0,0 +1,434 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#define _GNU_SOURCE
+#include <cstd/CShmRing.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define MAGIC "CSTDRING"
+#define MIN_CAPACITY 4096
+#define SPINS 64
+
+/// \internal
+/// \brief Length marking the rest of the ring as unused, the next record
+/// being at the start.
+#define WRAP UINT32_MAX
+
+/// \internal
+/// \brief Shared header, placed at the start of the region.
+/// \details Each side writes one cache line only: its own position, and the
+/// futex word it signals the other side on. The flag of a side going to sleep
+/// lives next to the position it waits on, where the other side reads it
+/// after every update.
+typedef struct {
+    char magic[8];
+    uint64_t capacity;
+    _Alignas(64) uint64_t head;  ///< Read position, written by the consumer.
+    uint32_t head_signal;        ///< Bumped when the producer is woken.
+    uint32_t producer_sleeping;  ///< Set while the producer waits for room.
+    _Alignas(64) uint64_t tail;  ///< Write position, written by the producer.
+    uint32_t tail_signal;        ///< Bumped when the consumer is woken.
+    uint32_t consumer_sleeping;  ///< Set while the consumer waits for records.
+} Header;
+
+/// \internal
+/// \brief Record header, followed by the record and padded to 8 bytes.
+typedef struct {
+    uint32_t len;
+    uint32_t reserved;
+} Record;
+
+struct _CShmRing {
+    Header *header;
+    char *data;           ///< Records, right after the header.
+    uint64_t mask;        ///< Capacity minus one.
+    size_t size;          ///< Size of the mapping.
+    int fd;               ///< Descriptor of the region.
+    uint64_t head;        ///< Consumer side copy of the read position.
+    uint64_t tail;        ///< Producer side copy of the write position.
+    uint64_t seen_head;   ///< Read position last seen by the producer.
+    uint64_t seen_tail;   ///< Write position last seen by the consumer.
+    uint64_t reservation; ///< Position of the reserved record.
+    size_t reserved;      ///< Size of the reserved record.
+    int pending;          ///< Whether a record is reserved.
+};
+
+static uint64_t record_size(size_t len) {
+    return (sizeof(Record) + len + 7) & ~(uint64_t)7;
+}
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// \internal
+/// \brief Wait until `*position` differs from `seen`.
+/// \return Non-zero if it changed before `timeout_ns` elapsed.
+static int wait_change(const uint64_t *position, uint64_t seen,
+                       uint32_t *signal, uint32_t *sleeping,
+                       int64_t timeout_ns) {
+    if (timeout_ns == 0)
+        return 0;
+    // Spinning only helps when the other side runs on another CPU.
+    static long cpus;
+    if (cpus == 0)
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int spin = 0; cpus > 1 && spin < SPINS; spin++) {
+        if (__atomic_load_n(position, __ATOMIC_ACQUIRE) != seen)
+            return 1;
+        cpu_relax();
+    }
+
+    uint64_t deadline = timeout_ns > 0 ? now_ns() + (uint64_t)timeout_ns : 0;
+    for (;;) {
+        uint32_t value = __atomic_load_n(signal, __ATOMIC_ACQUIRE);
+        // Pairs with the fence in `wake`: either the other side sees the flag,
+        // or this side sees the new position.
+        __atomic_store_n(sleeping, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(position, __ATOMIC_SEQ_CST) != seen) {
+            __atomic_store_n(sleeping, 0, __ATOMIC_RELAXED);
+            return 1;
+        }
+        struct timespec ts, *wait = NULL;
+        if (deadline) {
+            uint64_t now = now_ns();
+            if (now >= deadline) {
+                __atomic_store_n(sleeping, 0, __ATOMIC_RELAXED);
+                return 0;
+            }
+            ts.tv_sec = (time_t)((deadline - now) / 1000000000u);
+            ts.tv_nsec = (long)((deadline - now) % 1000000000u);
+            wait = &ts;
+        }
+#ifdef __linux__
+        syscall(SYS_futex, signal, FUTEX_WAIT, value, wait, NULL, 0);
+#else
+        (void)value;
+        struct timespec nap = {0, 50000};
+        nanosleep(wait && wait->tv_sec == 0 && wait->tv_nsec < nap.tv_nsec
+                      ? wait
+                      : &nap,
+                  NULL);
+#endif
+    }
+}
+
+/// \internal
+/// \brief Wake the other side if it is asleep. Called right after publishing
+/// a new position.
+static void wake(uint32_t *signal, uint32_t *sleeping) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(sleeping, __ATOMIC_RELAXED)) {
+        __atomic_store_n(sleeping, 0, __ATOMIC_RELAXED);
+        __atomic_fetch_add(signal, 1, __ATOMIC_RELEASE);
+#ifdef __linux__
+        syscall(SYS_futex, signal, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+    }
+}
+
+/// \internal
+/// \brief Map a region and check that it holds a ring. Takes over `fd`.
+static CResult_t *map_ring(int fd, const char *fn) {
+    struct stat st;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return CResult_ecreate(CError_create("Unable to open the region.", fn,
+                                             CSHMRING_IO_FAILURE));
+    }
+    size_t size = (size_t)st.st_size;
+    Header *header = size >= sizeof(Header)
+                         ? mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, fd, 0)
+                         : NULL;
+    if (header == MAP_FAILED) {
+        close(fd);
+        return CResult_ecreate(CError_create("Unable to map the region.", fn,
+                                             CSHMRING_IO_FAILURE));
+    }
+    uint64_t capacity = header ? header->capacity : 0;
+    if (header == NULL || memcmp(header->magic, MAGIC, 8) ||
+        capacity < MIN_CAPACITY || (capacity & (capacity - 1)) ||
+        size - sizeof(Header) != capacity) {
+        if (header)
+            munmap(header, size);
+        close(fd);
+        return CResult_ecreate(CError_create("The region is not a ring.", fn,
+                                             CSHMRING_INVALID_RING));
+    }
+
+    CShmRing_t *ring = malloc(sizeof(CShmRing_t));
+    if (ring == NULL) {
+        munmap(header, size);
+        close(fd);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CShmRing.", fn,
+            CSHMRING_ALLOC_FAILURE));
+    }
+    ring->header = header;
+    ring->data = (char *)(header + 1);
+    ring->mask = capacity - 1;
+    ring->size = size;
+    ring->fd = fd;
+    ring->head = ring->seen_head = __atomic_load_n(&header->head,
+                                                   __ATOMIC_ACQUIRE);
+    ring->tail = ring->seen_tail = __atomic_load_n(&header->tail,
+                                                   __ATOMIC_ACQUIRE);
+    ring->reservation = 0;
+    ring->reserved = 0;
+    ring->pending = 0;
+    return CResult_create(ring, NULL);
+}
+
+CResult_t *CShmRing_new(const char *name, size_t capacity) {
+    size_t rounded = MIN_CAPACITY;
+    while (rounded < capacity && rounded <= SIZE_MAX / 4)
+        rounded *= 2;
+    if (rounded < capacity)
+        return CResult_ecreate(CError_create("The capacity is too large.",
+                                             "CShmRing_new",
+                                             CSHMRING_TOO_LARGE));
+
+    int fd;
+    if (name != NULL) {
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    } else {
+#ifdef MFD_CLOEXEC
+        fd = memfd_create("CShmRing", MFD_CLOEXEC);
+#else
+        // Without memfd, an unlinked POSIX region is just as anonymous.
+        char temp[64];
+        snprintf(temp, sizeof(temp), "/cstd-ring-%ld-%lu", (long)getpid(),
+                 (unsigned long)now_ns());
+        fd = shm_open(temp, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd >= 0)
+            shm_unlink(temp);
+#endif
+    }
+    if (fd < 0)
+        return CResult_ecreate(CError_create("Unable to create the region.",
+                                             "CShmRing_new",
+                                             CSHMRING_IO_FAILURE));
+
+    size_t size = sizeof(Header) + rounded;
+    Header *header = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) {
+        close(fd);
+        if (name != NULL)
+            shm_unlink(name);
+        return CResult_ecreate(CError_create("Unable to map the region.",
+                                             "CShmRing_new",
+                                             CSHMRING_IO_FAILURE));
+    }
+    // The region starts zeroed, so only the fields that identify it are set.
+    header->capacity = rounded;
+    memcpy(header->magic, MAGIC, sizeof(header->magic));
+    munmap(header, size);
+
+    CResult_t *res = map_ring(fd, "CShmRing_new");
+    if (CResult_is_error(res) && name != NULL)
+        shm_unlink(name);
+    return res;
+}
+
+CResult_t *CShmRing_open(const char *name) {
+    if (name == NULL)
+        return CResult_ecreate(CError_create(
+            "Recieved a null name.", "CShmRing_open", CSHMRING_NULL_RING));
+    int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+        return CResult_ecreate(CError_create("Unable to open the region.",
+                                             "CShmRing_open",
+                                             CSHMRING_IO_FAILURE));
+    return map_ring(fd, "CShmRing_open");
+}
+
+CResult_t *CShmRing_from_fd(int fd) {
+    int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (copy < 0)
+        return CResult_ecreate(CError_create("Unable to open the region.",
+                                             "CShmRing_from_fd",
+                                             CSHMRING_IO_FAILURE));
+    return map_ring(copy, "CShmRing_from_fd");
+}
+
+int CShmRing_fd(const CShmRing_t *ring) {
+    return ring ? ring->fd : -1;
+}
+
+size_t CShmRing_capacity(const CShmRing_t *ring) {
+    return ring ? (size_t)ring->mask + 1 : 0;
+}
+
+int CShmRing_reserve(CShmRing_t *ring, size_t size, void **data,
+                     int64_t timeout_ns) {
+    if (ring == NULL || data == NULL)
+        return CSHMRING_NULL_RING;
+    uint64_t capacity = ring->mask + 1;
+    // A record must fit even after skipping to the start of the ring.
+    if (size > capacity / 2 || record_size(size) > capacity / 2)
+        return CSHMRING_TOO_LARGE;
+
+    uint64_t need = record_size(size);
+    uint64_t index = ring->tail & ring->mask;
+    uint64_t skip = capacity - index < need ? capacity - index : 0;
+    while (ring->tail + skip + need - ring->seen_head > capacity) {
+        uint64_t head = __atomic_load_n(&ring->header->head, __ATOMIC_ACQUIRE);
+        if (head == ring->seen_head &&
+            !wait_change(&ring->header->head, head, &ring->header->head_signal,
+                         &ring->header->producer_sleeping, timeout_ns))
+            return CSHMRING_FULL;
+        ring->seen_head = __atomic_load_n(&ring->header->head,
+                                          __ATOMIC_ACQUIRE);
+    }
+
+    if (skip) {
+        // Published along with the record.
+        Record wrap = {WRAP, 0};
+        memcpy(ring->data + index, &wrap, sizeof(wrap));
+    }
+    ring->reservation = ring->tail + skip;
+    ring->reserved = size;
+    ring->pending = 1;
+    *data = ring->data + (ring->reservation & ring->mask) + sizeof(Record);
+    return CSHMRING_SUCCESS;
+}
+
+int CShmRing_commit(CShmRing_t *ring, size_t size) {
+    if (ring == NULL)
+        return CSHMRING_NULL_RING;
+    if (!ring->pending || size > ring->reserved)
+        return CSHMRING_EMPTY;
+
+    Record record = {(uint32_t)size, 0};
+    memcpy(ring->data + (ring->reservation & ring->mask), &record,
+           sizeof(record));
+    ring->tail = ring->reservation + record_size(size);
+    ring->pending = 0;
+    __atomic_store_n(&ring->header->tail, ring->tail, __ATOMIC_RELEASE);
+    wake(&ring->header->tail_signal, &ring->header->consumer_sleeping);
+    return CSHMRING_SUCCESS;
+}
+
+int CShmRing_push(CShmRing_t *ring, CStringView_t record,
+                  int64_t timeout_ns) {
+    void *data;
+    int code = CShmRing_reserve(ring, record.len, &data, timeout_ns);
+    if (code)
+        return code;
+    if (record.len)
+        memcpy(data, record.ptr, record.len);
+    return CShmRing_commit(ring, record.len);
+}
+
+int CShmRing_peek(CShmRing_t *ring, CStringView_t *record,
+                  int64_t timeout_ns) {
+    if (ring == NULL || record == NULL)
+        return CSHMRING_NULL_RING;
+    for (;;) {
+        if (ring->head == ring->seen_tail) {
+            ring->seen_tail =
+                __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+            if (ring->head == ring->seen_tail) {
+                if (!wait_change(&ring->header->tail, ring->head,
+                                 &ring->header->tail_signal,
+                                 &ring->header->consumer_sleeping,
+                                 timeout_ns))
+                    return CSHMRING_EMPTY;
+                ring->seen_tail =
+                    __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+            }
+        }
+
+        uint64_t index = ring->head & ring->mask;
+        Record header;
+        memcpy(&header, ring->data + index, sizeof(header));
+        if (header.len == WRAP) {
+            // The skipped bytes are handed back with the next release.
+            ring->head += ring->mask + 1 - index;
+            continue;
+        }
+        *record = CStringView_from(ring->data + index + sizeof(header),
+                                   header.len);
+        return CSHMRING_SUCCESS;
+    }
+}
+
+int CShmRing_release(CShmRing_t *ring) {
+    if (ring == NULL)
+        return CSHMRING_NULL_RING;
+    CStringView_t record;
+    int code = CShmRing_peek(ring, &record, 0);
+    if (code)
+        return code;
+    ring->head += record_size(record.len);
+    __atomic_store_n(&ring->header->head, ring->head, __ATOMIC_RELEASE);
+    wake(&ring->header->head_signal, &ring->header->producer_sleeping);
+    return CSHMRING_SUCCESS;
+}
+
+int CShmRing_free(CShmRing_t **ring) {
+    if (ring == NULL || *ring == NULL)
+        return CSHMRING_SUCCESS;
+    munmap((*ring)->header, (*ring)->size);
+    close((*ring)->fd);
+    free(*ring);
+    *ring = NULL;
+    return CSHMRING_SUCCESS;
+}
+
+int CShmRing_unlink(const char *name) {
+    if (name == NULL)
+        return CSHMRING_NULL_RING;
+    return shm_unlink(name) ? CSHMRING_IO_FAILURE : CSHMRING_SUCCESS;
+}
+
+#endif // POSIX
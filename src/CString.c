@@ -22,19 +22,157 @@
  * SOFTWARE.
  */
 
+
+#include "Pow10Table.h"
 #include <cstd/CString.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+static const char digit_pairs[201] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
 struct _CString {
-    CVector_t *characters;
+    char *data;      ///< Contiguous, null-terminated character buffer, shared
+                     ///< with clones until one of them is modified.
+    size_t length;   ///< Number of characters in the string.
+    size_t capacity; ///< Number of characters the buffer can hold, excluding
+                     ///< the null terminator.
 };
 
+/// \internal
+/// \brief Reference counted header placed in front of the characters.
+/// The hash is cached here rather than in the string, so that clones share
+/// it and hashing a string through a const pointer writes nothing but this
+/// atomic. Strings sharing a buffer always hold the same characters, and
+/// `reserve` resets the cache before they change.
+typedef struct {
+    atomic_size_t refs; ///< Number of strings sharing the characters.
+    atomic_size_t hash; ///< `CStringView_hash` of the characters, 0 until
+                        ///< computed.
+    char data[];        ///< The characters, as pointed to by `CString.data`.
+} Buffer;
+
+#define BUFFER_OF(ptr) ((Buffer *)((ptr) - offsetof(Buffer, data)))
+
+/// \internal
+/// \brief Drop a reference to the buffer holding `data`, freeing it when it
+/// was the last one.
+static void release(char *data) {
+    if (data == NULL)
+        return;
+    Buffer *buffer = BUFFER_OF(data);
+    if (atomic_fetch_sub_explicit(&buffer->refs, 1, memory_order_acq_rel) == 1)
+        free(buffer);
+}
+
+/// \internal
+/// \brief Whether the string is the only owner of its buffer, so that it may
+/// write to it.
+static int unique(const CString_t *string) {
+    return atomic_load_explicit(&BUFFER_OF(string->data)->refs,
+                                memory_order_acquire) == 1;
+}
+
+/// \internal
+/// \brief Give the string a buffer of exactly `capacity` characters that it
+/// owns alone, copying the characters out of a shared buffer.
+static int resize(CString_t *string, size_t capacity) {
+    if (string->data != NULL && !unique(string)) {
+        Buffer *buffer = malloc(sizeof(Buffer) + capacity + 1);
+        if (buffer == NULL)
+            return CSTRING_ALLOC_FAILURE;
+        atomic_init(&buffer->refs, 1);
+        atomic_init(&buffer->hash, 0);
+        memcpy(buffer->data, string->data, string->length + 1);
+        release(string->data);
+        string->data = buffer->data;
+        string->capacity = capacity;
+        return CSTRING_SUCCESS;
+    }
+
+    Buffer *old = string->data ? BUFFER_OF(string->data) : NULL;
+    Buffer *buffer = realloc(old, sizeof(Buffer) + capacity + 1);
+    if (buffer == NULL)
+        return CSTRING_ALLOC_FAILURE;
+    if (old == NULL) {
+        atomic_init(&buffer->refs, 1);
+        atomic_init(&buffer->hash, 0);
+        buffer->data[0] = '\0';
+    }
+
+    string->data = buffer->data;
+    string->capacity = capacity;
+    return CSTRING_SUCCESS;
+}
+
+/// \internal
+/// \brief Make sure the string owns a buffer that can hold at least `needed`
+/// characters. Every modification goes through here first.
+static int reserve(CString_t *string, size_t needed) {
+    int code = CSTRING_SUCCESS;
+    if (string->data != NULL && needed <= string->capacity) {
+        // Unsharing copies anyway, so keep the capacity as it is.
+        if (!unique(string))
+            code = resize(string, string->capacity);
+    } else {
+        size_t capacity = string->capacity * 2;
+        if (capacity < needed)
+            capacity = needed;
+        if (capacity < CSTRING_DEFAULT_ALLOC_SIZE)
+            capacity = CSTRING_DEFAULT_ALLOC_SIZE;
+        code = resize(string, capacity);
+    }
+    if (code == CSTRING_SUCCESS)
+        atomic_store_explicit(&BUFFER_OF(string->data)->hash, 0,
+                              memory_order_relaxed);
+    return code;
+}
+
+/// \internal
+/// \brief Append `len` characters from `str` to the end of the string.
+static int append_bytes(CString_t *string, const char *str, size_t len) {
+    if (len == 0)
+        return CSTRING_SUCCESS;
+
+    // The source may live inside our own buffer, which reserve can move.
+    int aliased = string->data != NULL && str >= string->data &&
+                  str < string->data + string->length;
+    size_t offset = aliased ? (size_t)(str - string->data) : 0;
+
+    int code = reserve(string, string->length + len);
+    if (code)
+        return code;
+    if (aliased)
+        str = string->data + offset;
+
+    memcpy(string->data + string->length, str, len);
+    string->length += len;
+    string->data[string->length] = '\0';
+    return CSTRING_SUCCESS;
+}
+
 CResult_t *CString_new() {
     CString_t *string = malloc(sizeof(CString_t));
+    if (string == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CString.", "CString_new",
+            CSTRING_ALLOC_FAILURE));
 
     int code = CString_init(string, CSTRING_DEFAULT_ALLOC_SIZE);
     if (code) {
+        free(string);
         return CResult_ecreate(CError_create(
             "Initialization of CString returned non-zero exit code.",
             "CString_new", code));
@@ -47,54 +185,35 @@ int CString_init(CString_t *string, size_t size) {
     if (string == NULL)
         return CSTRING_NULL_STRING;
 
-    CResult_t *res = CVector_new(size, NULL);
-    if (CResult_is_error(res)) {
-        CResult_free(&res);
-        string->characters = NULL;
-        return CSTRING_ALLOC_FAILURE;
-    }
-    string->characters = CResult_get(res);
-    CResult_free(&res);
-    return CSTRING_SUCCESS;
+    string->data = NULL;
+    string->length = 0;
+    string->capacity = 0;
+    return resize(string, size);
 }
 
 int CString_set(CString_t *string, char *str) {
     if (string == NULL || str == NULL)
         return CSTRING_NULL_STRING;
 
-    int code = CString_clear(string);
-    if (code != 0)
-        return code;
-
     size_t len = strlen(str);
-    code = CString_init(string, len);
+    int code = reserve(string, len);
     if (code)
         return code;
-    for (size_t i = 0; i < len; i++) {
-        code = CVector_add(string->characters, &str[i]);
-        if (code != CVECTOR_SUCCESS) {
-            return CSTRING_OP_FAILURE;
-        }
-    }
 
+    memmove(string->data, str, len);
+    string->length = len;
+    string->data[len] = '\0';
     return CSTRING_SUCCESS;
 }
 
 char CString_at(const CString_t *string, size_t index) {
-    if (string == NULL || string->characters == NULL)
+    if (string == NULL || string->data == NULL)
         return '\0';
 
-    if (index >= CVector_size(string->characters))
+    if (index >= string->length)
         return '\0';
 
-    CResult_t *res = CVector_get(string->characters, index);
-    if (CResult_is_error(res)) {
-        CResult_free(&res);
-        return '\0';
-    }
-    char c = (char)CResult_get(res);
-    CResult_free(&res);
-    return c;
+    return string->data[index];
 }
 
 int CString_free(CString_t **string) {
@@ -109,98 +228,414 @@ int CString_free(CString_t **string) {
 }
 
 size_t CString_length(const CString_t *string) {
-    return CVector_size(string->characters);
+    if (string == NULL)
+        return 0;
+    return string->length;
 }
 
 int CString_append_c(CString_t *string, const char *str) {
     if (string == NULL || str == NULL)
         return CSTRING_NULL_STRING;
 
-    size_t append_len = strlen(str);
-    size_t current_len = CVector_size(string->characters);
+    return append_bytes(string, str, strlen(str));
+}
 
-    if (CVector_reserve(string->characters, current_len + append_len) !=
-        CVECTOR_SUCCESS)
-        return CSTRING_ALLOC_FAILURE;
+int CString_append(CString_t *string, CString_t *str) {
+    if (string == NULL || str == NULL)
+        return CSTRING_NULL_STRING;
 
-    for (size_t i = 0; i < append_len; i++)
-        if (CVector_add(string->characters, (void *)(uintptr_t)(str[i])) !=
-            CVECTOR_SUCCESS)
-            return CSTRING_ALLOC_FAILURE;
+    return append_bytes(string, str->data, str->length);
+}
 
-    return CSTRING_SUCCESS;
+int CString_append_n(CString_t *string, const char *str, size_t len) {
+    if (string == NULL || (str == NULL && len))
+        return CSTRING_NULL_STRING;
+
+    return append_bytes(string, str, len);
 }
 
-int CString_append(CString_t *string, CString_t *str) {
-    if (string == NULL || str == NULL)
+int CString_vappendf(CString_t *string, const char *format, va_list args) {
+    if (string == NULL || format == NULL)
         return CSTRING_NULL_STRING;
 
-    size_t append_len = CVector_size(str->characters);
-    size_t current_len = CVector_size(string->characters);
+    int code = reserve(string, string->length);
+    if (code)
+        return code;
 
-    if (CVector_reserve(string->characters, current_len + append_len) !=
-        CVECTOR_SUCCESS)
-        return CSTRING_ALLOC_FAILURE;
+    va_list retry;
+    va_copy(retry, args);
+    size_t spare = string->capacity - string->length;
+    int written =
+        vsnprintf(string->data + string->length, spare + 1, format, args);
+    if (written < 0) {
+        va_end(retry);
+        string->data[string->length] = '\0';
+        return CSTRING_OP_FAILURE;
+    }
 
-    for (size_t i = 0; i < append_len; i++) {
-        CResult_t *res = CVector_get(str->characters, i);
-        if (CResult_is_error(res) ||
-            CVector_add(string->characters, CResult_get(res)) !=
-                CVECTOR_SUCCESS)
-            return CSTRING_ALLOC_FAILURE;
-        // don't delete data, just free the pointer to result.
-        CResult_free(&res);
+    if ((size_t)written > spare) {
+        code = reserve(string, string->length + (size_t)written);
+        if (code) {
+            va_end(retry);
+            string->data[string->length] = '\0';
+            return code;
+        }
+        vsnprintf(string->data + string->length, (size_t)written + 1, format,
+                  retry);
     }
+    va_end(retry);
+
+    string->length += (size_t)written;
     return CSTRING_SUCCESS;
 }
 
-void *clone_char(const void *data) {
-    char *ch = malloc(sizeof(char));
-    if (ch == NULL)
-        return NULL;
+int CString_appendf(CString_t *string, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int code = CString_vappendf(string, format, args);
+    va_end(args);
+    return code;
+}
 
-    if (data == NULL || (*(uint8_t *)data & ~0x7F) != 0) {
-        *ch = '\0';
-        return ch;
+int CString_reserve(CString_t *string, size_t capacity) {
+    if (string == NULL)
+        return CSTRING_NULL_STRING;
+    if (capacity <= string->capacity && string->data != NULL) {
+        if (unique(string))
+            return CSTRING_SUCCESS;
+        capacity = string->capacity;
     }
+    return resize(string, capacity);
+}
 
-    *ch = *(const uint8_t *)data;
-    return ch;
+static size_t count_digits(uint64_t value) {
+    size_t digits = 1;
+    for (;;) {
+        if (value < 10)
+            return digits;
+        if (value < 100)
+            return digits + 1;
+        if (value < 1000)
+            return digits + 2;
+        if (value < 10000)
+            return digits + 3;
+        value /= 10000;
+        digits += 4;
+    }
 }
 
-CResult_t *CString_clone(const CString_t *source) {
-    if (source == NULL)
-        return NULL;
+/// \internal
+/// \brief Write the decimal digits of `value` into the `digits` characters
+/// ending right before `end`, two at a time.
+static void write_digits(char *end, uint64_t value) {
+    while (value >= 100) {
+        const char *pair = &digit_pairs[(value % 100) * 2];
+        value /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (value >= 10) {
+        *--end = digit_pairs[value * 2 + 1];
+        *--end = digit_pairs[value * 2];
+    } else {
+        *--end = (char)('0' + value);
+    }
+}
 
-    CString_t *copy = malloc(sizeof(CString_t));
-    if (copy == NULL)
-        return NULL;
+static int append_number(CString_t *string, uint64_t value, int negative) {
+    size_t digits = count_digits(value);
+    size_t len = digits + (negative != 0);
+    int code = reserve(string, string->length + len);
+    if (code)
+        return code;
 
-    if (source->characters == NULL)
-        return CResult_create(copy, free);
+    char *out = string->data + string->length;
+    if (negative)
+        *out = '-';
+    write_digits(out + len, value);
+    string->length += len;
+    string->data[string->length] = '\0';
+    return CSTRING_SUCCESS;
+}
 
-    CResult_t *res = CVector_clone(source->characters, clone_char);
-    if (CResult_is_error(res))
-        return res;
-    copy->characters = CResult_get(res);
-    CResult_free(&res);
-    return CResult_create(copy, free);
+int CString_append_u64(CString_t *string, uint64_t value) {
+    if (string == NULL)
+        return CSTRING_NULL_STRING;
+    return append_number(string, value, 0);
 }
 
-int CString_clear(CString_t *string) {
+int CString_append_i64(CString_t *string, int64_t value) {
     if (string == NULL)
         return CSTRING_NULL_STRING;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    return append_number(string, magnitude, value < 0);
+}
+
+/// \internal
+/// \brief floor(q * log10(2)), for |q| below 2^12 or so.
+static int floor_log10_pow2(int q) {
+    return (int)((int64_t)q * 661971961083LL >> 41);
+}
 
-    if (string->characters != NULL) {
-        int code = CVector_clear(string->characters);
-        if (code != CVECTOR_SUCCESS)
-            return CSTRING_OP_FAILURE;
+/// \internal
+/// \brief floor(q * log10(2) + log10(3/4)), for |q| below 2^12 or so.
+static int floor_log10_three_quarters_pow2(int q) {
+    return (int)(((int64_t)q * 661971961083LL - 274743187321LL) >> 41);
+}
+
+/// \internal
+/// \brief floor(e * log2(10)), for |e| below 2^12 or so.
+static int floor_log2_pow10(int e) {
+    return (int)((int64_t)e * 913124641741LL >> 38);
+}
+
+static uint64_t multiply_high(uint64_t a, uint64_t b) {
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+}
+
+/// \internal
+/// \brief Round `g * cp / 2^127` to odd, `g` being the table entry `g1:g0`.
+static uint64_t round_to_odd(uint64_t g1, uint64_t g0, uint64_t cp) {
+    uint64_t x1 = multiply_high(g0, cp);
+    unsigned __int128 y = (unsigned __int128)g1 * cp;
+    uint64_t z = ((uint64_t)y >> 1) + x1;
+    uint64_t vbp = (uint64_t)(y >> 64) + (z >> 63);
+    return vbp | (((z & INT64_MAX) + INT64_MAX) >> 63);
+}
+
+/// \internal
+/// \brief Find the shortest decimal `digits * 10^exponent` that rounds to
+/// `c * 2^q`, the closest one if there are several.
+/// \details This is the Schubfach algorithm by Raffaello Giulietti: the
+/// bounds of the rounding interval are scaled by a power of ten from
+/// `pow10_table` with a single 128-bit multiplication each, and the
+/// shortest decimal is either one of the two multiples of ten around the
+/// scaled value, or one of the two integers around it.
+static uint64_t schubfach(int q, uint64_t c, int *exponent) {
+    uint64_t out = c & 1;
+    uint64_t cb = c << 2;
+    uint64_t cbr = cb + 2;
+    uint64_t cbl;
+    int k;
+    // The interval is asymmetric at powers of two, whose lower neighbour is
+    // twice as close.
+    if (c != (1ULL << 52) || q == -1074) {
+        cbl = cb - 2;
+        k = floor_log10_pow2(q);
+    } else {
+        cbl = cb - 1;
+        k = floor_log10_three_quarters_pow2(q);
+    }
+    int h = q + floor_log2_pow10(-k) + 2;
+    const uint64_t *g = pow10_table[k - POW10_K_MIN];
+
+    uint64_t vb = round_to_odd(g[0], g[1], cb << h);
+    uint64_t vbl = round_to_odd(g[0], g[1], cbl << h);
+    uint64_t vbr = round_to_odd(g[0], g[1], cbr << h);
+
+    uint64_t s = vb >> 2;
+    if (s >= 10) {
+        // Multiplying by ceil(2^64 / 10) divides by 10.
+        uint64_t sp10 = 10 * multiply_high(s, 1844674407370955168ULL);
+        uint64_t tp10 = sp10 + 10;
+        int upin = vbl + out <= sp10 << 2;
+        int wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin) {
+            *exponent = k;
+            return upin ? sp10 : tp10;
+        }
+    }
+
+    uint64_t t = s + 1;
+    int uin = vbl + out <= s << 2;
+    int win = (t << 2) + out <= vbr;
+    *exponent = k;
+    if (uin != win)
+        return uin ? s : t;
+    int64_t cmp = (int64_t)(vb - ((s + t) << 1));
+    return cmp < 0 || (cmp == 0 && (s & 1) == 0) ? s : t;
+}
+
+/// \internal
+/// \brief Find the shortest significant digits that parse back to `value`.
+/// \param value A positive, finite double.
+/// \param digits Receives the digits, without trailing zeros.
+/// \param exponent Receives the decimal exponent of the first digit.
+/// \return The number of digits.
+static size_t shortest_digits(double value, char *digits, int *exponent) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    int biased = (int)(bits >> 52) & 0x7ff;
+
+    uint64_t decimal;
+    int scale;
+    if (biased != 0)
+        decimal = schubfach(biased - 1075, fraction | (1ULL << 52), &scale);
+    else
+        decimal = schubfach(-1074, fraction, &scale);
+
+    while (decimal % 10 == 0) {
+        decimal /= 10;
+        scale++;
     }
+    size_t ndigits = count_digits(decimal);
+    write_digits(digits + ndigits, decimal);
+    *exponent = scale + (int)ndigits - 1;
+    return ndigits;
+}
 
-    if (string->characters) {
-        return CVector_free(&string->characters);
+int CString_append_double(CString_t *string, double value) {
+    if (string == NULL)
+        return CSTRING_NULL_STRING;
+
+    if (isnan(value))
+        return append_bytes(string, "nan", 3);
+    if (isinf(value))
+        return value < 0 ? append_bytes(string, "-inf", 4)
+                         : append_bytes(string, "inf", 3);
+
+    // Integral values below 2^53 are exact, so their digits are the shortest
+    // representation and need no floating-point formatting at all.
+    if (fabs(value) < 9007199254740992.0 && value == (double)(int64_t)value) {
+        if (value == 0 && signbit(value))
+            return append_bytes(string, "-0", 2);
+        return CString_append_i64(string, (int64_t)value);
     }
 
+    char digits[17];
+    int exponent;
+    size_t ndigits = shortest_digits(fabs(value), digits, &exponent);
+
+    char out[32];
+    size_t len = 0;
+    if (value < 0)
+        out[len++] = '-';
+    if (exponent >= 0 && exponent < 21) {
+        size_t whole = (size_t)exponent + 1;
+        for (size_t i = 0; i < whole; i++)
+            out[len++] = i < ndigits ? digits[i] : '0';
+        if (ndigits > whole) {
+            out[len++] = '.';
+            for (size_t i = whole; i < ndigits; i++)
+                out[len++] = digits[i];
+        }
+    } else if (exponent < 0 && exponent >= -6) {
+        out[len++] = '0';
+        out[len++] = '.';
+        for (int i = -1; i > exponent; i--)
+            out[len++] = '0';
+        for (size_t i = 0; i < ndigits; i++)
+            out[len++] = digits[i];
+    } else {
+        out[len++] = digits[0];
+        if (ndigits > 1) {
+            out[len++] = '.';
+            for (size_t i = 1; i < ndigits; i++)
+                out[len++] = digits[i];
+        }
+        out[len++] = 'e';
+        out[len++] = exponent < 0 ? '-' : '+';
+        unsigned magnitude = (unsigned)(exponent < 0 ? -exponent : exponent);
+        size_t width = count_digits(magnitude);
+        write_digits(out + len + width, magnitude);
+        len += width;
+    }
+    return append_bytes(string, out, len);
+}
+
+int CString_parse_i64(const CString_t *string, int64_t *value) {
+    if (string == NULL || value == NULL)
+        return CSTRING_NULL_STRING;
+    return CStringView_parse_i64(CString_view(string), value);
+}
+
+int CString_parse_double(const CString_t *string, double *value) {
+    if (string == NULL || value == NULL)
+        return CSTRING_NULL_STRING;
+    return CStringView_parse_double(CString_view(string), value);
+}
+
+int CString_validate_utf8(const CString_t *string) {
+    if (string == NULL)
+        return 0;
+    return CStringView_validate_utf8(CString_view(string));
+}
+
+size_t CString_utf8_length(const CString_t *string) {
+    return CStringView_utf8_length(CString_view(string));
+}
+
+/// \internal
+/// \brief Transcode into a null-terminated buffer of `unit` byte code units.
+/// Neither encoding needs more code units than the string has bytes.
+static CResult_t *transcode(const CString_t *string, size_t unit,
+                            size_t *length, const char *caller) {
+    if (string == NULL)
+        return CResult_ecreate(CError_create("Recieved a null string.",
+                                             caller, CSTRING_NULL_STRING));
+
+    void *out = malloc((string->length + 1) * unit);
+    if (out == NULL)
+        return CResult_ecreate(
+            CError_create("Unable to allocate memory for string.", caller,
+                          CSTRING_ALLOC_FAILURE));
+
+    size_t n = 0;
+    int status = unit == sizeof(uint16_t)
+                     ? CStringView_to_utf16(CString_view(string), out, &n)
+                     : CStringView_to_utf32(CString_view(string), out, &n);
+    if (status != CSTRINGVIEW_SUCCESS) {
+        free(out);
+        return CResult_ecreate(CError_create("String is not valid UTF-8.",
+                                             caller, CSTRING_INVALID_UTF8));
+    }
+
+    if (unit == sizeof(uint16_t))
+        ((uint16_t *)out)[n] = 0;
+    else
+        ((uint32_t *)out)[n] = 0;
+    if (length != NULL)
+        *length = n;
+    return CResult_create(out, free);
+}
+
+CResult_t *CString_to_utf16(const CString_t *string, size_t *length) {
+    return transcode(string, sizeof(uint16_t), length, "CString_to_utf16");
+}
+
+CResult_t *CString_to_utf32(const CString_t *string, size_t *length) {
+    return transcode(string, sizeof(uint32_t), length, "CString_to_utf32");
+}
+
+CResult_t *CString_clone(const CString_t *source) {
+    if (source == NULL)
+        return CResult_ecreate(CError_create("Recieved a null string.",
+                                             "CString_clone",
+                                             CSTRING_NULL_STRING));
+
+    CString_t *string = malloc(sizeof(CString_t));
+    if (string == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CString.", "CString_clone",
+            CSTRING_ALLOC_FAILURE));
+
+    // Share the characters; whichever string is modified first copies them.
+    *string = *source;
+    if (string->data != NULL)
+        atomic_fetch_add_explicit(&BUFFER_OF(string->data)->refs, 1,
+                                  memory_order_relaxed);
+    return CResult_create(string, NULL);
+}
+
+int CString_clear(CString_t *string) {
+    if (string == NULL)
+        return CSTRING_NULL_STRING;
+
+    release(string->data);
+    string->data = NULL;
+    string->length = 0;
+    string->capacity = 0;
     return CSTRING_SUCCESS;
 }
 
@@ -211,67 +646,60 @@ CResult_t *CString_c_str(CString_t *string) {
                           "C-style strings.",
                           "CString_c_str", CSTRING_NULL_STRING));
 
-    if (CVector_size(string->characters) <= 0 || string->characters == NULL) {
-        char *empty_str = malloc(1);
-        if (!empty_str) {
-            return CResult_ecreate(
-                CError_create("Memory allocation failed for empty string.",
-                              "CString_c_str", CSTRING_ALLOC_FAILURE));
-        }
-        empty_str[0] = '\0';
-        return CResult_create(empty_str, free);
-    }
-    char *str = malloc(sizeof(char) * (CVector_size(string->characters) + 1));
+    char *str = malloc(string->length + 1);
     if (str == NULL)
         return CResult_ecreate(
             CError_create("Unable to allocate memory for C string.",
                           "CString_c_str", CSTRING_ALLOC_FAILURE));
-    for (size_t i = 0; i < CVector_size(string->characters); i++) {
-        CResult_t *res = CVector_get(string->characters, i);
-        if (CResult_is_error(res)) {
-            free(str);
-            CResult_free(&res);
-            return CResult_ecreate(CError_create("Unable to get the character.",
-                                                 "CString_c_str",
-                                                 CSTRING_OP_FAILURE));
-        }
-        str[i] = (char)CResult_get(res);
-        CResult_free(&res);
-    }
-    str[CVector_size(string->characters)] = '\0'; // Null terminator
+
+    if (string->length)
+        memcpy(str, string->data, string->length);
+    str[string->length] = '\0'; // Null terminator
 
     return CResult_create((void *)str, free);
 }
 
+/// \internal
+/// \brief Get the cached hash of the string, or 0 if there is none.
+static size_t cached_hash(const CString_t *string) {
+    if (string->data == NULL)
+        return 0;
+    return atomic_load_explicit(&BUFFER_OF(string->data)->hash,
+                                memory_order_relaxed);
+}
+
+size_t CString_hash(const CString_t *string) {
+    if (string == NULL || string->data == NULL)
+        return CStringView_hash(CString_view(string));
+
+    // Threads hashing the same string at once store the same value, and a
+    // hash of 0 is simply never cached.
+    size_t hash = cached_hash(string);
+    if (hash == 0) {
+        hash = CStringView_hash(CString_view(string));
+        atomic_store_explicit(&BUFFER_OF(string->data)->hash, hash,
+                              memory_order_relaxed);
+    }
+    return hash;
+}
+
 int CString_equals(CString_t *str1, CString_t *str2) {
     if (str1 == str2)
         return 1;
     if (str1 == NULL || str2 == NULL)
         return 0;
-
-    if (CVector_size(str1->characters) != CVector_size(str2->characters))
+    if (str1->length != str2->length)
         return 0;
 
-    for (size_t i = 0; i < CVector_size(str1->characters); i++) {
-        CResult_t *res1 = CVector_get(str1->characters, i);
-        CResult_t *res2 = CVector_get(str2->characters, i);
-
-        char x, y;
-        if (CResult_is_error(res1))
-            return 0;
-        x = *(char *)CResult_get(res1);
-
-        if (CResult_is_error(res2))
-            return 0;
-        y = *(char *)CResult_get(res2);
-
-        if (x != y)
-            return 0;
-        CResult_free(&res1);
-        CResult_free(&res2);
-    }
-
-    return 1;
+    // Clones sharing a buffer are equal without looking at it, and differing
+    // cached hashes settle a mismatch just as cheaply.
+    if (str1->data == str2->data)
+        return 1;
+    size_t hash1 = cached_hash(str1);
+    size_t hash2 = cached_hash(str2);
+    if (hash1 != 0 && hash2 != 0 && hash1 != hash2)
+        return 0;
+    return CStringView_equals(CString_view(str1), CString_view(str2));
 }
 
 int64_t CString_compare(CString_t *str1, CString_t *str2) {
@@ -279,22 +707,20 @@ int64_t CString_compare(CString_t *str1, CString_t *str2) {
         return 0;
     if (str1 == NULL || str2 == NULL)
         return INT64_MIN;
+    return CStringView_compare(CString_view(str1), CString_view(str2));
+}
 
-    if (CString_length(str1) - CString_length(str2))
-        return CString_length(str1) - CString_length(str2);
-
-    for (size_t i = 0; i < CString_length(str1); i++) {
-        if (CString_at(str1, i) != CString_at(str2, i)) {
-            return CString_at(str1, i) - CString_at(str2, i);
-        }
-    }
+int CString_starts_with(const CString_t *string, CStringView_t prefix) {
+    return CStringView_starts_with(CString_view(string), prefix);
+}
 
-    return 0;
+int CString_ends_with(const CString_t *string, CStringView_t suffix) {
+    return CStringView_ends_with(CString_view(string), suffix);
 }
 
 CResult_t *CString_substring(const CString_t *string, size_t start,
                              size_t end) {
-    if (!string || !string->characters) {
+    if (!string || !string->data) {
         return CResult_ecreate(
             CError_create("Failed to add character to substring.",
                           "CString_substring", CSTRING_NULL_STRING));
@@ -308,51 +734,80 @@ CResult_t *CString_substring(const CString_t *string, size_t start,
                           "CString_substring", CSTRING_INDEX_OUT_OF_BOUNDS));
     }
 
-    size_t substring_length = end - start + 1;
-    CResult_t *res = CVector_new(substring_length, NULL);
-    if (CResult_is_error(res)) {
-        CResult_free(&res);
-        return CResult_ecreate(
-            CError_create("An error was encountered during creating a new "
-                          "vector for storing the substring.",
-                          "CString_substring", CSTRING_ALLOC_FAILURE));
-    }
-    CVector_t *substring_vector = CResult_get(res);
-    if (!substring_vector) {
-        return CResult_ecreate(
-            CError_create("Failed to allocate memory for substring vector.",
-                          "CString_substring", CSTRING_ALLOC_FAILURE));
-    }
+    return CString_from_view(CString_slice(string, start, end + 1));
+}
 
-    for (size_t i = start; i <= end; ++i) {
-        char ch = CString_at(string, i);
-        if (CVector_add(substring_vector, (void *)(uintptr_t)ch) !=
-            CVECTOR_SUCCESS) {
-            CVector_free(&substring_vector);
-            return CResult_ecreate(
-                CError_create("Failed to add character to substring.",
-                              "CString_substring", CSTRING_ALLOC_FAILURE));
-        }
-    }
+CStringView_t CString_view(const CString_t *string) {
+    if (string == NULL || string->data == NULL)
+        return CStringView_from(NULL, 0);
+    return CStringView_from(string->data, string->length);
+}
 
-    CString_t *substring = malloc(sizeof(CString_t));
-    if (!substring) {
-        CVector_free(&substring_vector);
-        return CResult_ecreate(
-            CError_create("Failed to allocate memory for substring.",
-                          "CString_substring", CSTRING_ALLOC_FAILURE));
-    }
+CStringView_t CString_slice(const CString_t *string, size_t start,
+                            size_t end) {
+    return CStringView_slice(CString_view(string), start, end);
+}
 
-    if (CString_init(substring, substring_length)) {
-        free(substring);
-        CVector_free(&substring_vector);
-        return CResult_ecreate(
-            CError_create("Failed to initialize substring's array.",
-                          "CString_substring", CSTRING_ALLOC_FAILURE));
+CResult_t *CString_from_view(CStringView_t view) {
+    CString_t *string = malloc(sizeof(CString_t));
+    if (string == NULL)
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for CString.", "CString_from_view",
+            CSTRING_ALLOC_FAILURE));
+
+    if (CString_init(string, view.len)) {
+        free(string);
+        return CResult_ecreate(CError_create(
+            "Unable to allocate memory for the string's characters.",
+            "CString_from_view", CSTRING_ALLOC_FAILURE));
     }
 
-    substring->characters = substring_vector;
-    return CResult_create(substring, free);
+    if (view.len)
+        memcpy(string->data, view.ptr, view.len);
+    string->length = view.len;
+    string->data[view.len] = '\0';
+    return CResult_create(string, NULL);
+}
+
+size_t CString_find(const CString_t *string, CStringView_t needle) {
+    if (string == NULL)
+        return CSTRINGVIEW_NOT_FOUND;
+    return CStringView_find(CString_view(string), needle);
+}
+
+size_t CString_rfind(const CString_t *string, CStringView_t needle) {
+    if (string == NULL)
+        return CSTRINGVIEW_NOT_FOUND;
+    return CStringView_rfind(CString_view(string), needle);
+}
+
+int CString_contains(const CString_t *string, CStringView_t needle) {
+    return CString_find(string, needle) != CSTRINGVIEW_NOT_FOUND;
+}
+
+size_t CString_find_char(const CString_t *string, char c) {
+    if (string == NULL)
+        return CSTRINGVIEW_NOT_FOUND;
+    return CStringView_find_char(CString_view(string), c);
+}
+
+size_t CString_find_any(const CString_t *string, CStringView_t set) {
+    if (string == NULL)
+        return CSTRINGVIEW_NOT_FOUND;
+    return CStringView_find_any(CString_view(string), set);
+}
+
+size_t CString_count(const CString_t *string, CStringView_t needle) {
+    return CStringView_count(CString_view(string), needle);
+}
+
+CStringSplit_t CString_split_iter(const CString_t *string,
+                                  CStringView_t delim) {
+    return CStringView_split_iter(CString_view(string), delim);
+}
+
+CStringSplit_t CString_lines_iter(const CString_t *string) {
+    return CStringView_lines_iter(CString_view(string));
 }
 
 #if __STDC_VERSION__ >= 201112L // C11 support
@@ -364,21 +819,10 @@ CResult_t *CString_c_wchar_t(CString_t *string) {
                                              CSTRING_NULL_STRING));
     }
 
-    size_t length = CString_length(string);
-    wchar_t *wide_str = (wchar_t *)malloc((length + 1) * sizeof(wchar_t));
-    if (!wide_str) {
-        return CResult_ecreate(
-            CError_create("Unable to allocate memory for string.",
-                          "CString_c_utf8_str", CSTRING_ALLOC_FAILURE));
-    }
-
-    for (size_t i = 0; i < length; ++i) {
-        wide_str[i] = (wchar_t)CString_at(string, i);
-    }
-
-    wide_str[length] = L'\0';
-
-    return CResult_create(wide_str, free);
+    _Static_assert(sizeof(wchar_t) == sizeof(uint16_t) ||
+                       sizeof(wchar_t) == sizeof(uint32_t),
+                   "wchar_t must be a UTF-16 or UTF-32 code unit");
+    return transcode(string, sizeof(wchar_t), NULL, "CString_c_wchar_t");
 }
 
-#endif // __STDC_VERSION__ >= 201112L
\ No newline at end of file
+#endif // __STDC_VERSION__ >= 201112L
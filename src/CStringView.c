@@ -0,0 +1,950 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CStringView.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Vector primitives used by the scanning routines. Every routine keeps a
+// scalar path for the bytes (or targets) the vector loop does not cover.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VEC_WIDTH 32
+typedef __m256i vec_t;
+static inline vec_t vec_splat(char c) { return _mm256_set1_epi8(c); }
+static inline vec_t vec_load(const char *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+static inline uint32_t vec_eq(vec_t a, vec_t b) {
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VEC_WIDTH 16
+typedef __m128i vec_t;
+static inline vec_t vec_splat(char c) { return _mm_set1_epi8(c); }
+static inline vec_t vec_load(const char *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+static inline uint32_t vec_eq(vec_t a, vec_t b) {
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+}
+#endif
+
+CStringView_t CStringView_from_c(const char *str) {
+    CStringView_t view = {str, str ? strlen(str) : 0};
+    return view;
+}
+
+CStringView_t CStringView_from(const char *ptr, size_t len) {
+    CStringView_t view = {ptr, ptr ? len : 0};
+    return view;
+}
+
+CStringView_t CStringView_slice(CStringView_t view, size_t start, size_t end) {
+    if (end > view.len)
+        end = view.len;
+    if (start > end)
+        start = end;
+
+    CStringView_t slice = {view.ptr ? view.ptr + start : NULL, end - start};
+    return slice;
+}
+
+int CStringView_equals(CStringView_t view1, CStringView_t view2) {
+    if (view1.len != view2.len)
+        return 0;
+    if (view1.ptr == view2.ptr || view1.len == 0)
+        return 1;
+    return memcmp(view1.ptr, view2.ptr, view1.len) == 0;
+}
+
+int CStringView_compare(CStringView_t view1, CStringView_t view2) {
+    size_t len = view1.len < view2.len ? view1.len : view2.len;
+    if (len && view1.ptr != view2.ptr) {
+        int order = memcmp(view1.ptr, view2.ptr, len);
+        if (order)
+            return (order > 0) - (order < 0);
+    }
+    return (view1.len > view2.len) - (view1.len < view2.len);
+}
+
+int CStringView_starts_with(CStringView_t view, CStringView_t prefix) {
+    if (prefix.len > view.len)
+        return 0;
+    return prefix.len == 0 || memcmp(view.ptr, prefix.ptr, prefix.len) == 0;
+}
+
+int CStringView_ends_with(CStringView_t view, CStringView_t suffix) {
+    if (suffix.len > view.len)
+        return 0;
+    return suffix.len == 0 ||
+           memcmp(view.ptr + view.len - suffix.len, suffix.ptr, suffix.len) ==
+               0;
+}
+
+size_t CStringView_common_prefix(CStringView_t view1, CStringView_t view2) {
+    size_t len = view1.len < view2.len ? view1.len : view2.len;
+    if (view1.ptr == view2.ptr)
+        return len;
+
+    size_t i = 0;
+#ifdef VEC_WIDTH
+    for (; i + VEC_WIDTH <= len; i += VEC_WIDTH) {
+        uint32_t mask =
+            vec_eq(vec_load(view1.ptr + i), vec_load(view2.ptr + i));
+        uint32_t differ = ~mask;
+#if VEC_WIDTH == 16
+        differ &= 0xFFFF;
+#endif
+        if (differ)
+            return i + (size_t)__builtin_ctz(differ);
+    }
+#endif
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t a, b;
+        memcpy(&a, view1.ptr + i, sizeof(a));
+        memcpy(&b, view2.ptr + i, sizeof(b));
+        if (a != b)
+            break;
+    }
+    while (i < len && view1.ptr[i] == view2.ptr[i])
+        i++;
+    return i;
+}
+
+static uint64_t fmix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+size_t CStringView_hash(CStringView_t view) {
+    const unsigned char *p = (const unsigned char *)view.ptr;
+    size_t len = view.len;
+    uint64_t hash =
+        0x9e3779b97f4a7c15ULL ^ ((uint64_t)len * 0x87c37b91114253d5ULL);
+
+    while (len >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        hash = (hash ^ word) * 0x4cf5ad432745937fULL;
+        hash ^= hash >> 31;
+        p += sizeof(word);
+        len -= sizeof(word);
+    }
+
+    if (len) {
+        uint64_t word = 0;
+        memcpy(&word, p, len);
+        hash = (hash ^ word) * 0x4cf5ad432745937fULL;
+        hash ^= hash >> 31;
+    }
+
+    return (size_t)fmix64(hash);
+}
+
+size_t CStringView_find_char(CStringView_t view, char c) {
+    const char *p = view.ptr;
+    size_t len = view.len;
+    size_t i = 0;
+
+#ifdef VEC_WIDTH
+    vec_t target = vec_splat(c);
+    for (; i + VEC_WIDTH <= len; i += VEC_WIDTH) {
+        uint32_t mask = vec_eq(vec_load(p + i), target);
+        if (mask)
+            return i + (size_t)__builtin_ctz(mask);
+    }
+#endif
+
+    if (i >= len)
+        return CSTRINGVIEW_NOT_FOUND;
+    const char *hit = memchr(p + i, c, len - i);
+    return hit ? (size_t)(hit - p) : CSTRINGVIEW_NOT_FOUND;
+}
+
+size_t CStringView_find(CStringView_t view, CStringView_t needle) {
+    const char *h = view.ptr;
+    const char *n = needle.ptr;
+    size_t len = view.len;
+    size_t nlen = needle.len;
+
+    if (nlen == 0)
+        return 0;
+    if (nlen > len)
+        return CSTRINGVIEW_NOT_FOUND;
+    if (nlen == 1)
+        return CStringView_find_char(view, n[0]);
+
+    size_t i = 0;
+    char first = n[0];
+    char last = n[nlen - 1];
+
+#ifdef VEC_WIDTH
+    // Only positions whose first and last bytes both match get a full
+    // comparison, which rejects almost every candidate in a single pass.
+    vec_t vfirst = vec_splat(first);
+    vec_t vlast = vec_splat(last);
+    for (; i + nlen - 1 + VEC_WIDTH <= len; i += VEC_WIDTH) {
+        uint32_t mask = vec_eq(vec_load(h + i), vfirst) &
+                        vec_eq(vec_load(h + i + nlen - 1), vlast);
+        while (mask) {
+            size_t pos = i + (size_t)__builtin_ctz(mask);
+            if (memcmp(h + pos + 1, n + 1, nlen - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i + nlen <= len; i++) {
+        if (h[i] == first && h[i + nlen - 1] == last &&
+            memcmp(h + i + 1, n + 1, nlen - 2) == 0)
+            return i;
+    }
+    return CSTRINGVIEW_NOT_FOUND;
+}
+
+size_t CStringView_rfind(CStringView_t view, CStringView_t needle) {
+    const char *h = view.ptr;
+    const char *n = needle.ptr;
+    size_t len = view.len;
+    size_t nlen = needle.len;
+
+    if (nlen > len)
+        return CSTRINGVIEW_NOT_FOUND;
+    if (nlen == 0)
+        return len;
+
+    // Candidate start positions are [0, end).
+    size_t end = len - nlen + 1;
+    char first = n[0];
+    char last = n[nlen - 1];
+    size_t body = nlen > 1 ? nlen - 2 : 0;
+
+#ifdef VEC_WIDTH
+    vec_t vfirst = vec_splat(first);
+    vec_t vlast = vec_splat(last);
+    while (end >= VEC_WIDTH) {
+        size_t base = end - VEC_WIDTH;
+        uint32_t mask = vec_eq(vec_load(h + base), vfirst) &
+                        vec_eq(vec_load(h + base + nlen - 1), vlast);
+        while (mask) {
+            int bit = 31 - __builtin_clz(mask);
+            size_t pos = base + (size_t)bit;
+            if (nlen < 2 || memcmp(h + pos + 1, n + 1, body) == 0)
+                return pos;
+            mask &= ~(1U << bit);
+        }
+        end = base;
+    }
+#endif
+
+    while (end > 0) {
+        size_t pos = --end;
+        if (h[pos] == first && h[pos + nlen - 1] == last &&
+            (nlen < 2 || memcmp(h + pos + 1, n + 1, body) == 0))
+            return pos;
+    }
+    return CSTRINGVIEW_NOT_FOUND;
+}
+
+int CStringView_contains(CStringView_t view, CStringView_t needle) {
+    return CStringView_find(view, needle) != CSTRINGVIEW_NOT_FOUND;
+}
+
+size_t CStringView_find_any(CStringView_t view, CStringView_t set) {
+    const unsigned char *p = (const unsigned char *)view.ptr;
+    size_t len = view.len;
+    size_t i = 0;
+
+    if (set.len == 0)
+        return CSTRINGVIEW_NOT_FOUND;
+    if (set.len == 1)
+        return CStringView_find_char(view, set.ptr[0]);
+
+#ifdef VEC_WIDTH
+    // Small sets, the common case for delimiters, are matched with one
+    // comparison per member. Larger sets use the lookup table below.
+    if (set.len <= 8) {
+        vec_t targets[8];
+        for (size_t k = 0; k < set.len; k++)
+            targets[k] = vec_splat(set.ptr[k]);
+        for (; i + VEC_WIDTH <= len; i += VEC_WIDTH) {
+            vec_t block = vec_load((const char *)p + i);
+            uint32_t mask = 0;
+            for (size_t k = 0; k < set.len; k++)
+                mask |= vec_eq(block, targets[k]);
+            if (mask)
+                return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+#endif
+
+    uint8_t table[256] = {0};
+    for (size_t k = 0; k < set.len; k++)
+        table[(unsigned char)set.ptr[k]] = 1;
+    for (; i < len; i++) {
+        if (table[p[i]])
+            return i;
+    }
+    return CSTRINGVIEW_NOT_FOUND;
+}
+
+size_t CStringView_count(CStringView_t view, CStringView_t needle) {
+    size_t count = 0;
+
+    if (needle.len == 0 || needle.len > view.len)
+        return 0;
+
+    if (needle.len == 1) {
+        const char *p = view.ptr;
+        char c = needle.ptr[0];
+        size_t i = 0;
+#ifdef VEC_WIDTH
+        vec_t target = vec_splat(c);
+        for (; i + VEC_WIDTH <= view.len; i += VEC_WIDTH) {
+            uint32_t mask = vec_eq(vec_load(p + i), target);
+            count += (size_t)__builtin_popcount(mask);
+        }
+#endif
+        for (; i < view.len; i++)
+            count += p[i] == c;
+        return count;
+    }
+
+    size_t pos;
+    while ((pos = CStringView_find(view, needle)) != CSTRINGVIEW_NOT_FOUND) {
+        count++;
+        view = CStringView_slice(view, pos + needle.len, view.len);
+    }
+    return count;
+}
+
+CStringSplit_t CStringView_split_iter(CStringView_t view, CStringView_t delim) {
+    CStringSplit_t iter = {view, delim, 0, 0};
+    return iter;
+}
+
+CStringSplit_t CStringView_lines_iter(CStringView_t view) {
+    CStringSplit_t iter = {view, CStringView_from("\n", 1), 1, 0};
+    return iter;
+}
+
+int CStringSplit_next(CStringSplit_t *iter, CStringView_t *token) {
+    if (iter == NULL || token == NULL || iter->done)
+        return 0;
+
+    CStringView_t rest = iter->rest;
+    if (iter->lines && rest.len == 0) {
+        iter->done = 1;
+        return 0;
+    }
+
+    size_t pos = iter->delim.len ? CStringView_find(rest, iter->delim)
+                                 : CSTRINGVIEW_NOT_FOUND;
+    if (pos == CSTRINGVIEW_NOT_FOUND) {
+        *token = rest;
+        iter->rest = CStringView_slice(rest, rest.len, rest.len);
+        iter->done = 1;
+    } else {
+        *token = CStringView_slice(rest, 0, pos);
+        iter->rest = CStringView_slice(rest, pos + iter->delim.len, rest.len);
+    }
+
+    if (iter->lines && token->len && token->ptr[token->len - 1] == '\r')
+        token->len--;
+    return 1;
+}
+
+CResult_t *CStringView_split_collect(CStringView_t view,
+                                     CStringView_t delim) {
+    CResult_t *res = CVector_new(16, free);
+    if (CResult_is_error(res))
+        return res;
+    CVector_t *tokens = CResult_get(res);
+
+    CStringSplit_t iter = CStringView_split_iter(view, delim);
+    CStringView_t token;
+    while (CStringSplit_next(&iter, &token)) {
+        CStringView_t *copy = malloc(sizeof(CStringView_t));
+        if (copy != NULL)
+            *copy = token;
+        if (copy == NULL || CVector_add(tokens, copy) != CVECTOR_SUCCESS) {
+            free(copy);
+            CVector_free(&tokens);
+            CResult_free(&res);
+            return CResult_ecreate(CError_create(
+                "Unable to allocate memory for the tokens.",
+                "CStringView_split_collect", CVECTOR_ALLOC_FAILURE));
+        }
+    }
+    return res;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SWAR_DIGITS
+/// \internal
+/// \brief Check if all 8 bytes of a little-endian word are ASCII digits.
+static inline int is_eight_digits(uint64_t word) {
+    return !(((word + 0x4646464646464646ULL) |
+              (word - 0x3030303030303030ULL)) &
+             0x8080808080808080ULL);
+}
+
+/// \internal
+/// \brief Convert 8 ASCII digits held in a little-endian word to their value
+/// using three multiplications instead of eight.
+static inline uint64_t parse_eight_digits(uint64_t word) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    word = (((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32;
+    return word;
+}
+#endif
+
+/// \internal
+/// \brief Accumulate up to `max` decimal digits starting at `*pos`.
+/// \return The number of digits consumed.
+static size_t parse_digits(CStringView_t view, size_t *pos, uint64_t *value,
+                           size_t max) {
+    const char *p = view.ptr;
+    size_t i = *pos;
+    size_t start = i;
+    uint64_t acc = *value;
+
+#ifdef SWAR_DIGITS
+    while (i + 8 <= view.len && i - start + 8 <= max) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        if (!is_eight_digits(word))
+            break;
+        acc = acc * 100000000ULL + parse_eight_digits(word);
+        i += 8;
+    }
+#endif
+    while (i < view.len && i - start < max && p[i] >= '0' && p[i] <= '9')
+        acc = acc * 10 + (uint64_t)(p[i++] - '0');
+
+    *pos = i;
+    *value = acc;
+    return i - start;
+}
+
+int CStringView_parse_i64(CStringView_t view, int64_t *value) {
+    if (value == NULL || view.len == 0)
+        return CSTRINGVIEW_INVALID_NUMBER;
+
+    size_t i = 0;
+    int negative = view.ptr[0] == '-';
+    if (negative || view.ptr[0] == '+')
+        i++;
+
+    size_t start = i;
+    while (i < view.len && view.ptr[i] == '0')
+        i++;
+
+    // 19 digits always fit in 64 unsigned bits.
+    uint64_t magnitude = 0;
+    parse_digits(view, &i, &magnitude, 19);
+    if (i == start)
+        return CSTRINGVIEW_INVALID_NUMBER;
+    if (i < view.len) {
+        if (view.ptr[i] >= '0' && view.ptr[i] <= '9')
+            return CSTRINGVIEW_OUT_OF_RANGE;
+        return CSTRINGVIEW_INVALID_NUMBER;
+    }
+
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    if (magnitude > limit)
+        return CSTRINGVIEW_OUT_OF_RANGE;
+
+    *value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return CSTRINGVIEW_SUCCESS;
+}
+
+static int parse_double_slow(CStringView_t view, double *value) {
+    char stack[64];
+    char *buffer = stack;
+    if (view.len >= sizeof(stack)) {
+        buffer = malloc(view.len + 1);
+        if (buffer == NULL)
+            return CSTRINGVIEW_INVALID_NUMBER;
+    }
+    memcpy(buffer, view.ptr, view.len);
+    buffer[view.len] = '\0';
+
+    char *end;
+    errno = 0;
+    double result = strtod(buffer, &end);
+    int code = CSTRINGVIEW_SUCCESS;
+    if (end != buffer + view.len)
+        code = CSTRINGVIEW_INVALID_NUMBER;
+    else if (errno == ERANGE && (result > 1 || result < -1))
+        code = CSTRINGVIEW_OUT_OF_RANGE;
+
+    if (buffer != stack)
+        free(buffer);
+    if (code == CSTRINGVIEW_SUCCESS)
+        *value = result;
+    return code;
+}
+
+int CStringView_parse_double(CStringView_t view, double *value) {
+    static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                    1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                    1e18, 1e19, 1e20, 1e21, 1e22};
+
+    if (value == NULL || view.len == 0)
+        return CSTRINGVIEW_INVALID_NUMBER;
+    // strtod would skip leading whitespace, which a view must not contain.
+    if (view.ptr[0] == ' ' || (view.ptr[0] >= '\t' && view.ptr[0] <= '\r'))
+        return CSTRINGVIEW_INVALID_NUMBER;
+
+    size_t i = 0;
+    int negative = view.ptr[0] == '-';
+    if (negative || view.ptr[0] == '+')
+        i++;
+
+    // Fast path: at most 19 significant digits and a small exponent can be
+    // converted exactly with a single multiplication or division.
+    uint64_t mantissa = 0;
+    size_t int_digits = parse_digits(view, &i, &mantissa, 19);
+    size_t frac_digits = 0;
+    if (i < view.len && view.ptr[i] == '.') {
+        i++;
+        frac_digits = parse_digits(view, &i, &mantissa, 19 - int_digits);
+    }
+    if (int_digits + frac_digits == 0)
+        return parse_double_slow(view, value);
+
+    int64_t exponent = -(int64_t)frac_digits;
+    if (i < view.len && (view.ptr[i] == 'e' || view.ptr[i] == 'E')) {
+        size_t j = i + 1;
+        int exp_negative = j < view.len && view.ptr[j] == '-';
+        if (j < view.len && (view.ptr[j] == '-' || view.ptr[j] == '+'))
+            j++;
+        uint64_t exp_value = 0;
+        if (parse_digits(view, &j, &exp_value, 4) == 0)
+            return CSTRINGVIEW_INVALID_NUMBER;
+        exponent += exp_negative ? -(int64_t)exp_value : (int64_t)exp_value;
+        i = j;
+    }
+
+    if (i != view.len || mantissa > (1ULL << 53) || exponent < -22 ||
+        exponent > 22)
+        return parse_double_slow(view, value);
+
+    double result = (double)mantissa;
+    if (exponent < 0)
+        result /= powers[-exponent];
+    else
+        result *= powers[exponent];
+    *value = negative ? -result : result;
+    return CSTRINGVIEW_SUCCESS;
+}
+
+// UTF-8 validation follows the lookup algorithm of Keiser and Lemire, which
+// classifies every byte pair with three table lookups and checks the
+// remaining length constraints with saturating subtractions.
+#if defined(__AVX2__)
+#define UTF8_WIDTH 32
+typedef __m256i utf8_vec_t;
+#define UTF8_TABLE(...)                                                        \
+    _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+static inline utf8_vec_t utf8_load(const unsigned char *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+static inline utf8_vec_t utf8_splat(unsigned char c) {
+    return _mm256_set1_epi8((char)c);
+}
+static inline utf8_vec_t utf8_or(utf8_vec_t a, utf8_vec_t b) {
+    return _mm256_or_si256(a, b);
+}
+static inline utf8_vec_t utf8_and(utf8_vec_t a, utf8_vec_t b) {
+    return _mm256_and_si256(a, b);
+}
+static inline utf8_vec_t utf8_xor(utf8_vec_t a, utf8_vec_t b) {
+    return _mm256_xor_si256(a, b);
+}
+static inline utf8_vec_t utf8_subs(utf8_vec_t a, utf8_vec_t b) {
+    return _mm256_subs_epu8(a, b);
+}
+static inline utf8_vec_t utf8_high_nibble(utf8_vec_t a) {
+    return _mm256_and_si256(_mm256_srli_epi16(a, 4), utf8_splat(0x0F));
+}
+static inline utf8_vec_t utf8_lookup(utf8_vec_t table, utf8_vec_t index) {
+    return _mm256_shuffle_epi8(table, index);
+}
+static inline utf8_vec_t utf8_zero(void) { return _mm256_setzero_si256(); }
+static inline int utf8_is_ascii(utf8_vec_t a) {
+    return _mm256_movemask_epi8(a) == 0;
+}
+static inline int utf8_nonzero(utf8_vec_t a) {
+    return !_mm256_testz_si256(a, a);
+}
+#define UTF8_PREV(input, prev, n)                                              \
+    _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21),    \
+                       16 - (n))
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define UTF8_WIDTH 16
+typedef __m128i utf8_vec_t;
+#define UTF8_TABLE(...) _mm_setr_epi8(__VA_ARGS__)
+static inline utf8_vec_t utf8_load(const unsigned char *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+static inline utf8_vec_t utf8_splat(unsigned char c) {
+    return _mm_set1_epi8((char)c);
+}
+static inline utf8_vec_t utf8_or(utf8_vec_t a, utf8_vec_t b) {
+    return _mm_or_si128(a, b);
+}
+static inline utf8_vec_t utf8_and(utf8_vec_t a, utf8_vec_t b) {
+    return _mm_and_si128(a, b);
+}
+static inline utf8_vec_t utf8_xor(utf8_vec_t a, utf8_vec_t b) {
+    return _mm_xor_si128(a, b);
+}
+static inline utf8_vec_t utf8_subs(utf8_vec_t a, utf8_vec_t b) {
+    return _mm_subs_epu8(a, b);
+}
+static inline utf8_vec_t utf8_high_nibble(utf8_vec_t a) {
+    return _mm_and_si128(_mm_srli_epi16(a, 4), utf8_splat(0x0F));
+}
+static inline utf8_vec_t utf8_lookup(utf8_vec_t table, utf8_vec_t index) {
+    return _mm_shuffle_epi8(table, index);
+}
+static inline utf8_vec_t utf8_zero(void) { return _mm_setzero_si128(); }
+static inline int utf8_is_ascii(utf8_vec_t a) {
+    return _mm_movemask_epi8(a) == 0;
+}
+static inline int utf8_nonzero(utf8_vec_t a) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128())) != 0xFFFF;
+}
+#define UTF8_PREV(input, prev, n) _mm_alignr_epi8(input, prev, 16 - (n))
+#endif
+
+#ifdef UTF8_WIDTH
+#define TOO_SHORT (1 << 0)
+#define TOO_LONG (1 << 1)
+#define OVERLONG_3 (1 << 2)
+#define TOO_LARGE (1 << 3)
+#define SURROGATE (1 << 4)
+#define OVERLONG_2 (1 << 5)
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4 (1 << 6)
+#define TWO_CONTS (1 << 7)
+#define CARRY (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+/// \internal
+/// \brief Flag invalid pairs of consecutive bytes.
+static inline utf8_vec_t utf8_special_cases(utf8_vec_t input,
+                                            utf8_vec_t prev1) {
+    const utf8_vec_t byte_1_high_table = UTF8_TABLE(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const utf8_vec_t byte_1_low_table = UTF8_TABLE(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2,
+        CARRY, CARRY, CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const utf8_vec_t byte_2_high_table = UTF8_TABLE(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+            OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+    utf8_vec_t byte_1_high =
+        utf8_lookup(byte_1_high_table, utf8_high_nibble(prev1));
+    utf8_vec_t byte_1_low =
+        utf8_lookup(byte_1_low_table, utf8_and(prev1, utf8_splat(0x0F)));
+    utf8_vec_t byte_2_high =
+        utf8_lookup(byte_2_high_table, utf8_high_nibble(input));
+    return utf8_and(utf8_and(byte_1_high, byte_1_low), byte_2_high);
+}
+
+/// \internal
+/// \brief Flag errors in the block `input`, whose preceding block is `prev`.
+static inline utf8_vec_t utf8_check_block(utf8_vec_t input, utf8_vec_t prev) {
+    utf8_vec_t prev1 = UTF8_PREV(input, prev, 1);
+    utf8_vec_t special = utf8_special_cases(input, prev1);
+
+    // The third and fourth bytes of a sequence must be continuations, which
+    // is exactly where the special cases flag two continuations in a row.
+    utf8_vec_t prev2 = UTF8_PREV(input, prev, 2);
+    utf8_vec_t prev3 = UTF8_PREV(input, prev, 3);
+    utf8_vec_t is_third = utf8_subs(prev2, utf8_splat(0xE0 - 0x80));
+    utf8_vec_t is_fourth = utf8_subs(prev3, utf8_splat(0xF0 - 0x80));
+    utf8_vec_t must_be_continuation =
+        utf8_and(utf8_or(is_third, is_fourth), utf8_splat(0x80));
+    return utf8_xor(must_be_continuation, special);
+}
+
+/// \internal
+/// \brief Flag a block whose last bytes start a sequence that continues past
+/// its end.
+static inline utf8_vec_t utf8_incomplete(utf8_vec_t input) {
+    unsigned char max[UTF8_WIDTH];
+    memset(max, 0xFF, sizeof(max));
+    max[UTF8_WIDTH - 3] = 0xF0 - 1;
+    max[UTF8_WIDTH - 2] = 0xE0 - 1;
+    max[UTF8_WIDTH - 1] = 0xC0 - 1;
+    return utf8_subs(input, utf8_load(max));
+}
+#endif
+
+/// \internal
+/// \brief Decode the sequence starting at `p[*i]` and advance `*i` past it.
+/// \return The code point, or `UINT32_MAX` if the sequence is invalid.
+static uint32_t utf8_decode(const unsigned char *p, size_t len, size_t *i) {
+    unsigned char c = p[*i];
+    size_t extra;
+    uint32_t cp;
+
+    if (c < 0x80) {
+        (*i)++;
+        return c;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        extra = 1;
+        cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        extra = 2;
+        cp = c & 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        extra = 3;
+        cp = c & 0x07;
+    } else {
+        return UINT32_MAX;
+    }
+
+    if (len - *i - 1 < extra)
+        return UINT32_MAX;
+    for (size_t k = 1; k <= extra; k++) {
+        unsigned char b = p[*i + k];
+        if ((b & 0xC0) != 0x80)
+            return UINT32_MAX;
+        cp = (cp << 6) | (b & 0x3F);
+    }
+
+    if ((extra == 2 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+        (extra == 3 && (cp < 0x10000 || cp > 0x10FFFF)))
+        return UINT32_MAX;
+
+    *i += extra + 1;
+    return cp;
+}
+
+#ifndef UTF8_WIDTH
+/// \internal
+/// \brief Length of the leading run of ASCII characters, checked a word at a
+/// time.
+static size_t ascii_prefix(const unsigned char *p, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        if (word & 0x8080808080808080ULL)
+            break;
+    }
+    while (i < len && p[i] < 0x80)
+        i++;
+    return i;
+}
+#endif
+
+int CStringView_validate_utf8(CStringView_t view) {
+    const unsigned char *p = (const unsigned char *)view.ptr;
+    size_t len = view.len;
+
+#ifdef UTF8_WIDTH
+    utf8_vec_t error = utf8_zero();
+    utf8_vec_t prev = utf8_zero();
+    utf8_vec_t prev_incomplete = utf8_zero();
+    size_t i = 0;
+
+    for (; i + UTF8_WIDTH <= len; i += UTF8_WIDTH) {
+        utf8_vec_t input = utf8_load(p + i);
+        if (utf8_is_ascii(input)) {
+            error = utf8_or(error, prev_incomplete);
+        } else {
+            error = utf8_or(error, utf8_check_block(input, prev));
+            prev_incomplete = utf8_incomplete(input);
+        }
+        prev = input;
+    }
+
+    // Pad the tail with zeros, which are ASCII and end any open sequence.
+    if (i < len) {
+        unsigned char tail[UTF8_WIDTH] = {0};
+        memcpy(tail, p + i, len - i);
+        utf8_vec_t input = utf8_load(tail);
+        error = utf8_or(error, utf8_check_block(input, prev));
+        prev_incomplete = utf8_zero();
+    }
+    error = utf8_or(error, prev_incomplete);
+    return !utf8_nonzero(error);
+#else
+    size_t i = 0;
+    while (i < len) {
+        i += ascii_prefix(p + i, len - i);
+        if (i < len && utf8_decode(p, len, &i) == UINT32_MAX)
+            return 0;
+    }
+    return 1;
+#endif
+}
+
+size_t CStringView_utf8_length(CStringView_t view) {
+    const char *p = view.ptr;
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef VEC_WIDTH
+    // Continuation bytes are 0x80 to 0xBF, that is below -64 when signed.
+    for (; i + VEC_WIDTH <= view.len; i += VEC_WIDTH) {
+        vec_t block = vec_load(p + i);
+#if VEC_WIDTH == 32
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(vec_splat(-64), block));
+#else
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(
+            _mm_cmpgt_epi8(vec_splat(-64), block));
+#endif
+        count += VEC_WIDTH - (size_t)__builtin_popcount(mask);
+    }
+#endif
+
+    for (; i < view.len; i++)
+        count += ((unsigned char)p[i] & 0xC0) != 0x80;
+    return count;
+}
+
+int CStringView_to_utf32(CStringView_t view, uint32_t *out, size_t *length) {
+    const unsigned char *p = (const unsigned char *)view.ptr;
+    size_t len = view.len;
+    size_t i = 0;
+    size_t n = 0;
+
+    if (out == NULL || length == NULL)
+        return CSTRINGVIEW_INVALID_UTF8;
+
+    while (i < len) {
+#ifdef VEC_WIDTH
+        // Widen blocks of ASCII directly, falling back to the decoder at the
+        // first block holding a multi-byte sequence.
+        for (; i + 16 <= len; i += 16, n += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(p + i));
+            if (_mm_movemask_epi8(bytes))
+                break;
+            __m128i zero = _mm_setzero_si128();
+            __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            __m128i *dst = (__m128i *)(out + n);
+            _mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+        if (i >= len)
+            break;
+#endif
+        if (p[i] < 0x80) {
+            out[n++] = p[i++];
+            continue;
+        }
+
+        uint32_t cp = utf8_decode(p, len, &i);
+        if (cp == UINT32_MAX)
+            return CSTRINGVIEW_INVALID_UTF8;
+        out[n++] = cp;
+    }
+
+    *length = n;
+    return CSTRINGVIEW_SUCCESS;
+}
+
+int CStringView_to_utf16(CStringView_t view, uint16_t *out, size_t *length) {
+    const unsigned char *p = (const unsigned char *)view.ptr;
+    size_t len = view.len;
+    size_t i = 0;
+    size_t n = 0;
+
+    if (out == NULL || length == NULL)
+        return CSTRINGVIEW_INVALID_UTF8;
+
+    while (i < len) {
+#ifdef VEC_WIDTH
+        for (; i + 16 <= len; i += 16, n += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(p + i));
+            if (_mm_movemask_epi8(bytes))
+                break;
+            __m128i zero = _mm_setzero_si128();
+            __m128i *dst = (__m128i *)(out + n);
+            _mm_storeu_si128(dst, _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(bytes, zero));
+        }
+        if (i >= len)
+            break;
+#endif
+        if (p[i] < 0x80) {
+            out[n++] = p[i++];
+            continue;
+        }
+
+        uint32_t cp = utf8_decode(p, len, &i);
+        if (cp == UINT32_MAX)
+            return CSTRINGVIEW_INVALID_UTF8;
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out[n++] = (uint16_t)(0xD800 | (cp >> 10));
+            out[n++] = (uint16_t)(0xDC00 | (cp & 0x3FF));
+        } else {
+            out[n++] = (uint16_t)cp;
+        }
+    }
+
+    *length = n;
+    return CSTRINGVIEW_SUCCESS;
+}
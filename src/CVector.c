@@ -22,18 +22,165 @@
  * SOFTWARE.
  */
 
+#define _GNU_SOURCE
+#include "Snapshot.h"
 #include <cstd/CVector.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAVE_MMAP
+#endif
+
+#define MAPPED_MAGIC "CSTDVMAP"
+
+/// \internal
+/// \brief Start of the region behind a mapped vector; the elements follow.
+typedef struct {
+    char magic[8];
+    uint64_t size; ///< Number of elements, as of the last sync.
+} MappedHeader;
+
 struct _CVector {
     void **data;        ///< Array to store data.
     size_t size;      ///< Number of elements in the vector.
     size_t capacity;  ///< Capacity of the vector.
     Destructor destroy; ///< Function pointer to the destructor for cleaning up
                         ///< individual elements.
+    void *mapping;       ///< Snapshot the vector was loaded from, if any.
+    size_t mapping_size; ///< Size of `mapping` in bytes.
+    MappedHeader *region; ///< Mapping holding `data`, for mapped vectors.
+    size_t region_size;   ///< Size of `region` in bytes.
+    int fd;               ///< File behind `region`, or -1.
 };
 
+#ifdef HAVE_MMAP
+
+static size_t page_round(size_t len) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (len + page - 1) / page * page;
+}
+
+/// \internal
+/// \brief Map or grow the region of a mapped vector to at least `len` bytes.
+/// \details Pages are only committed once they are written to, and growing
+/// never copies: `mremap` moves the page tables, and files are simply mapped
+/// again at their new length. The disk blocks of a file are allocated up
+/// front, so a full disk fails here instead of raising SIGBUS on a store.
+static int remap(CVector_t *vector, size_t len) {
+    len = page_round(len);
+    if (len <= vector->region_size)
+        return CVECTOR_SUCCESS;
+    if (vector->fd >= 0) {
+        if (ftruncate(vector->fd, (off_t)len))
+            return CVECTOR_IO_FAILURE;
+        int error = posix_fallocate(vector->fd, (off_t)vector->region_size,
+                                    (off_t)(len - vector->region_size));
+        if (error) {
+            errno = error;
+            return CVECTOR_IO_FAILURE;
+        }
+    }
+
+    void *region;
+    if (vector->region == NULL) {
+        region = vector->fd >= 0 ? mmap(NULL, len, PROT_READ | PROT_WRITE,
+                                        MAP_SHARED, vector->fd, 0)
+                                 : mmap(NULL, len, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    } else {
+#ifdef MREMAP_MAYMOVE
+        region = mremap(vector->region, vector->region_size, len,
+                        MREMAP_MAYMOVE);
+#else
+        if (vector->fd >= 0) {
+            region = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          vector->fd, 0);
+        } else {
+            region = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED)
+                memcpy(region, vector->region, vector->region_size);
+        }
+        if (region != MAP_FAILED)
+            munmap(vector->region, vector->region_size);
+#endif
+    }
+    if (region == MAP_FAILED)
+        return CVECTOR_ALLOC_FAILURE;
+
+    vector->region = region;
+    vector->region_size = len;
+    vector->data = (void **)(vector->region + 1);
+    vector->capacity = (len - sizeof(MappedHeader)) / sizeof(void *);
+    return CVECTOR_SUCCESS;
+}
+
+/// \internal
+/// \brief Release the region of a mapped vector, recording its size in the
+/// file first.
+static void unmap(CVector_t *vector) {
+    if (vector->region == NULL)
+        return;
+    vector->region->size = vector->size;
+    munmap(vector->region, vector->region_size);
+    if (vector->fd >= 0) {
+        // An emptied vector gives its disk space back.
+        if (vector->size == 0)
+            ftruncate(vector->fd, (off_t)page_round(sizeof(MappedHeader)));
+        close(vector->fd);
+    }
+    vector->region = NULL;
+    vector->region_size = 0;
+    vector->fd = -1;
+}
+
+#else
+
+static int remap(CVector_t *vector, size_t len) {
+    (void)vector;
+    (void)len;
+    return CVECTOR_ALLOC_FAILURE;
+}
+
+static void unmap(CVector_t *vector) { (void)vector; }
+
+#endif // HAVE_MMAP
+
+/// \internal
+/// \brief Whether `ptr` was allocated separately rather than taken from the
+/// snapshot the vector was loaded from.
+static int owned(const CVector_t *vector, const void *ptr) {
+    return !snapshot_contains(vector->mapping, vector->mapping_size, ptr);
+}
+
+/// \internal
+/// \brief Move the elements into an array of `capacity` slots. Arrays inside
+/// a snapshot cannot be reallocated and are copied out instead.
+static int grow(CVector_t *vector, size_t capacity) {
+    if (vector->region != NULL)
+        return remap(vector,
+                     sizeof(MappedHeader) + capacity * sizeof(void *));
+    void **data;
+    if (owned(vector, vector->data)) {
+        data = realloc(vector->data, capacity * sizeof(void *));
+    } else {
+        data = malloc(capacity * sizeof(void *));
+        if (data != NULL)
+            memcpy(data, vector->data, vector->size * sizeof(void *));
+    }
+    if (data == NULL)
+        return CVECTOR_ALLOC_FAILURE;
+    vector->data = data;
+    vector->capacity = capacity;
+    return CVECTOR_SUCCESS;
+}
+
 static int alloc(CVector_t *vector) {
     if (vector == NULL)
         return CVECTOR_NULL_VECTOR;
@@ -47,12 +194,11 @@ static int alloc(CVector_t *vector) {
     }
 
     if (vector->size == vector->capacity) {
-        size_t new_size = vector->capacity * CVECTOR_DEFAULT_GROWTH_RATE;
-        void **data = realloc(vector->data, new_size * sizeof(void *));
-        if (data == NULL)
+        size_t new_size = vector->capacity
+                              ? vector->capacity * CVECTOR_DEFAULT_GROWTH_RATE
+                              : 1;
+        if (grow(vector, new_size))
             return CVECTOR_ALLOC_FAILURE;
-        vector->data = data;
-        vector->capacity = new_size;
     }
 
     if (vector->size > vector->capacity) {
@@ -80,6 +226,11 @@ int CVector_init(CVector_t *vector, size_t reserve_capacity,
     vector->size = 0;
     vector->capacity = cap;
     vector->destroy = destroy;
+    vector->mapping = NULL;
+    vector->mapping_size = 0;
+    vector->region = NULL;
+    vector->region_size = 0;
+    vector->fd = -1;
 
     return CVECTOR_SUCCESS;
 }
@@ -244,14 +395,19 @@ int CVector_clear(CVector_t *vector) {
         return CVECTOR_NULL_VECTOR;
     if (vector->destroy != NULL) {
         for (size_t i = 0; i < vector->size; ++i) {
-            if (vector->data[i] != NULL) {
+            if (vector->data[i] != NULL && owned(vector, vector->data[i]))
                 vector->destroy(vector->data[i]);
-                vector->data[i] = NULL;
-            }
         }
     }
 
-    free(vector->data);
+    vector->size = 0;
+    if (vector->region != NULL)
+        unmap(vector);
+    else if (owned(vector, vector->data))
+        free(vector->data);
+    snapshot_unmap(vector->mapping, vector->mapping_size);
+    vector->mapping = NULL;
+    vector->mapping_size = 0;
     vector->data = NULL;
     vector->size = 0;
     vector->capacity = 0;
@@ -261,6 +417,13 @@ int CVector_clear(CVector_t *vector) {
 int CVector_free(CVector_t **vector) {
     if (vector == NULL || *vector == NULL)
         return CVECTOR_SUCCESS;
+    // File-backed elements outlive the vector.
+    if ((*vector)->fd >= 0) {
+        unmap(*vector);
+        free(*vector);
+        *vector = NULL;
+        return CVECTOR_SUCCESS;
+    }
     int code = CVector_clear(*vector);
     if (code)
         return code;
@@ -324,15 +487,7 @@ int CVector_reserve(CVector_t *vector, size_t new_capacity) {
         return CVECTOR_SUCCESS;
     }
 
-    void **new_data = realloc(vector->data, new_capacity * sizeof(void *));
-    if (new_data == NULL) {
-        return CVECTOR_ALLOC_FAILURE;
-    }
-
-    vector->data = new_data;
-    vector->capacity = new_capacity;
-
-    return CVECTOR_SUCCESS;
+    return grow(vector, new_capacity);
 }
 
 int CVector_set(CVector_t *vector, size_t index, void *new_element) {
@@ -345,7 +500,7 @@ int CVector_set(CVector_t *vector, size_t index, void *new_element) {
     }
 
     void *element = vector->data[index];
-    if (vector->destroy != NULL) {
+    if (vector->destroy != NULL && owned(vector, element)) {
         vector->destroy(element);
     }
 
@@ -353,3 +508,137 @@ int CVector_set(CVector_t *vector, size_t index, void *new_element) {
 
     return CVECTOR_SUCCESS;
 }
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+int CVector_save(const CVector_t *vector, const char *path,
+                 SerializeFn serialize) {
+    if (vector == NULL || vector->data == NULL || path == NULL)
+        return CVECTOR_NULL_VECTOR;
+    uint64_t meta[2] = {0, 0};
+    switch (snapshot_save(path, "CSTDVECT", vector->data, vector->size,
+                          &serialize, 1, meta)) {
+    case SNAPSHOT_SUCCESS:
+        return CVECTOR_SUCCESS;
+    case SNAPSHOT_ALLOC_FAILURE:
+        return CVECTOR_ALLOC_FAILURE;
+    case SNAPSHOT_INVALID:
+        return CVECTOR_NULL_VECTOR;
+    default:
+        return CVECTOR_IO_FAILURE;
+    }
+}
+
+CResult_t *CVector_load(const char *path, Destructor destroy) {
+    if (path == NULL)
+        return CResult_ecreate(CError_create("Recieved a null path.",
+                                             "CVector_load",
+                                             CVECTOR_NULL_VECTOR));
+    CVector_t *vector = malloc(sizeof(CVector_t));
+    if (vector == NULL)
+        return CResult_ecreate(
+            CError_create("Failed memory allocation for the vector.",
+                          "CVector_load", CVECTOR_ALLOC_FAILURE));
+
+    SnapshotTrailer trailer;
+    int code;
+    vector->mapping = snapshot_load(path, "CSTDVECT", 1, &trailer,
+                                    &vector->mapping_size, &code);
+    if (vector->mapping == NULL) {
+        free(vector);
+        if (code == SNAPSHOT_IO_FAILURE)
+            return CResult_ecreate(
+                CError_create("Unable to map the snapshot.", "CVector_load",
+                              CVECTOR_IO_FAILURE));
+        return CResult_ecreate(CError_create("The snapshot is malformed.",
+                                             "CVector_load",
+                                             CVECTOR_INVALID_SNAPSHOT));
+    }
+
+    vector->data = (void **)((char *)vector->mapping + trailer.table);
+    vector->size = trailer.slots;
+    vector->capacity = trailer.slots;
+    vector->destroy = destroy;
+    vector->region = NULL;
+    vector->region_size = 0;
+    vector->fd = -1;
+    return CResult_create(vector, NULL);
+}
+
+CResult_t *CVector_new_mapped(size_t reserve_capacity, Destructor destroy,
+                              const char *path) {
+    CVector_t *vector = malloc(sizeof(CVector_t));
+    if (vector == NULL)
+        return CResult_ecreate(
+            CError_create("Failed memory allocation for the vector.",
+                          "CVector_new_mapped", CVECTOR_ALLOC_FAILURE));
+    memset(vector, 0, sizeof(CVector_t));
+    vector->destroy = destroy;
+    vector->fd = -1;
+
+    size_t existing = 0;
+    if (path != NULL) {
+        struct stat st;
+        vector->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+        if (vector->fd < 0 || fstat(vector->fd, &st)) {
+            if (vector->fd >= 0)
+                close(vector->fd);
+            free(vector);
+            return CResult_ecreate(
+                CError_create("Unable to open the file.",
+                              "CVector_new_mapped", CVECTOR_IO_FAILURE));
+        }
+        existing = (size_t)st.st_size;
+    }
+
+    MappedHeader header;
+    if (existing &&
+        (pread(vector->fd, &header, sizeof(header), 0) != sizeof(header) ||
+         memcmp(header.magic, MAPPED_MAGIC, 8))) {
+        close(vector->fd);
+        free(vector);
+        return CResult_ecreate(
+            CError_create("The file does not hold a mapped vector.",
+                          "CVector_new_mapped", CVECTOR_INVALID_SNAPSHOT));
+    }
+    size_t len = sizeof(MappedHeader) + reserve_capacity * sizeof(void *);
+    int code = remap(vector, len > existing ? len : existing);
+    if (code) {
+        if (vector->fd >= 0)
+            close(vector->fd);
+        free(vector);
+        return CResult_ecreate(CError_create(
+            "Unable to map memory for the vector.", "CVector_new_mapped",
+            code));
+    }
+
+    if (existing == 0) {
+        memcpy(vector->region->magic, MAPPED_MAGIC, 8);
+        vector->region->size = 0;
+    } else if (vector->region->size > vector->capacity) {
+        munmap(vector->region, vector->region_size);
+        close(vector->fd);
+        free(vector);
+        return CResult_ecreate(
+            CError_create("The file does not hold a mapped vector.",
+                          "CVector_new_mapped", CVECTOR_INVALID_SNAPSHOT));
+    }
+    vector->size = vector->region->size;
+    return CResult_create(vector, NULL);
+}
+
+int CVector_sync(CVector_t *vector) {
+    if (vector == NULL)
+        return CVECTOR_NULL_VECTOR;
+    if (vector->region == NULL)
+        return CVECTOR_SUCCESS;
+    vector->region->size = vector->size;
+    if (vector->fd >= 0 &&
+        msync(vector->region, sizeof(MappedHeader) +
+                                  vector->size * sizeof(void *),
+              MS_SYNC))
+        return CVECTOR_IO_FAILURE;
+    return CVECTOR_SUCCESS;
+}
+
+#endif // POSIX
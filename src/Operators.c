@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include <cstd/CString.h>
 #include <cstd/Operators.h>
 
 #ifndef CSTD_NO_DEF_FN_IMPL
@@ -29,6 +30,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 int ccompare_pointer(const void *a, const void *b) { return (a > b) - (a < b); }
 
@@ -48,6 +50,30 @@ size_t chash_string(const void *key) {
     return hash;
 }
 
+size_t chash_cstring(const void *key) {
+    return CString_hash((const CString_t *)key);
+}
+
+int ccompare_cstring(const void *a, const void *b) {
+    const CString_t *str_a = (const CString_t *)a;
+    const CString_t *str_b = (const CString_t *)b;
+    size_t len_a = CString_length(str_a);
+    size_t len_b = CString_length(str_b);
+    if (len_a != len_b)
+        return (len_a > len_b) - (len_a < len_b);
+
+    // Both hashes are cached once the strings have been used as keys, which
+    // settles almost every mismatch without touching the characters.
+    size_t hash_a = CString_hash(str_a);
+    size_t hash_b = CString_hash(str_b);
+    if (hash_a != hash_b)
+        return (hash_a > hash_b) - (hash_a < hash_b);
+
+    if (len_a == 0)
+        return 0;
+    return memcmp(CString_view(str_a).ptr, CString_view(str_b).ptr, len_a);
+}
+
 size_t cdefault_hash(const void *key) {
     uintptr_t ptr = (uintptr_t)key;
     ptr ^= (ptr >> 33);
@@ -69,4 +95,17 @@ void *cclone_integer(const void *data) {
     return clone;
 }
 
+size_t cserialize_integer(const void *data, void *buffer, size_t size) {
+    if (size >= sizeof(int))
+        memcpy(buffer, data, sizeof(int));
+    return sizeof(int);
+}
+
+size_t cserialize_string(const void *data, void *buffer, size_t size) {
+    size_t len = strlen((const char *)data) + 1;
+    if (size >= len)
+        memcpy(buffer, data, len);
+    return len;
+}
+
 #endif
@@ -0,0 +1,217 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "Snapshot.h"
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+#include <cstd/CFileWriter.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BYTE_ORDER_MARK 0x01020304u
+#define TOMBSTONE UINTPTR_MAX
+
+int snapshot_save(const char *path, const char magic[8], void *const *slots,
+                  size_t count, const SerializeFn *serializers, size_t stride,
+                  const uint64_t meta[2]) {
+    for (size_t i = 0; i < stride; i++)
+        if (serializers[i] == NULL)
+            return SNAPSHOT_INVALID;
+
+    uintptr_t *table = malloc(count * sizeof(uintptr_t) + 1);
+    size_t scratch_size = 256;
+    char *scratch = malloc(scratch_size);
+    size_t len = strlen(path);
+    char *temp = malloc(len + 8);
+    if (table == NULL || scratch == NULL || temp == NULL) {
+        free(table);
+        free(scratch);
+        free(temp);
+        return SNAPSHOT_ALLOC_FAILURE;
+    }
+
+    // The snapshot is written next to `path` and renamed over it once
+    // complete. A container loaded from `path` may still read its elements
+    // from the old file, and a failed save must not destroy a good snapshot.
+    memcpy(temp, path, len);
+    memcpy(temp + len, ".XXXXXX", 8);
+    int fd = mkstemp(temp);
+    if (fd < 0) {
+        free(table);
+        free(scratch);
+        free(temp);
+        return SNAPSHOT_IO_FAILURE;
+    }
+    // mkstemp only grants access to the owner, as open would not.
+    fchmod(fd, 0644);
+    CResult_t *res = CFileWriter_from_fd(fd, 0);
+    if (CResult_is_error(res)) {
+        CResult_free(&res);
+        close(fd);
+        unlink(temp);
+        free(table);
+        free(scratch);
+        free(temp);
+        return SNAPSHOT_ALLOC_FAILURE;
+    }
+    CFileWriter_t *writer = CResult_get(res);
+    CResult_free(&res);
+
+    static const char padding[SNAPSHOT_ALIGNMENT];
+    int code = SNAPSHOT_SUCCESS;
+    uint64_t offset = 8;
+    CFileWriter_append(writer, magic, 8);
+    for (size_t i = 0; i < count && !code; i++) {
+        uintptr_t slot = (uintptr_t)slots[i];
+        if (slot == 0 || slot == TOMBSTONE) {
+            table[i] = slot;
+            continue;
+        }
+
+        SerializeFn serialize = serializers[i % stride];
+        size_t len = serialize(slots[i], scratch, scratch_size);
+        if (len > scratch_size) {
+            char *grown = realloc(scratch, len);
+            if (grown == NULL) {
+                code = SNAPSHOT_ALLOC_FAILURE;
+                break;
+            }
+            scratch = grown;
+            scratch_size = len;
+            len = serialize(slots[i], scratch, scratch_size);
+        }
+
+        size_t pad = -len & (SNAPSHOT_ALIGNMENT - 1);
+        table[i] = (uintptr_t)offset;
+        CFileWriter_append(writer, scratch, len);
+        CFileWriter_append(writer, padding, pad);
+        offset += len + pad;
+    }
+
+    SnapshotTrailer trailer = {SNAPSHOT_VERSION,
+                               BYTE_ORDER_MARK,
+                               sizeof(void *),
+                               offset,
+                               count,
+                               {meta[0], meta[1]},
+                               {0}};
+    memcpy(trailer.magic, magic, 8);
+    CFileWriter_append(writer, table, count * sizeof(uintptr_t));
+    CFileWriter_append(writer, &trailer, sizeof(trailer));
+    if ((CFileWriter_free(&writer) || fsync(fd)) && !code)
+        code = SNAPSHOT_IO_FAILURE;
+    if (close(fd) && !code)
+        code = SNAPSHOT_IO_FAILURE;
+    if (!code && rename(temp, path))
+        code = SNAPSHOT_IO_FAILURE;
+    if (code)
+        unlink(temp);
+    free(table);
+    free(scratch);
+    free(temp);
+    return code;
+}
+
+void *snapshot_load(const char *path, const char magic[8], size_t stride,
+                    SnapshotTrailer *trailer, size_t *size, int *code) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+        if (fd >= 0)
+            close(fd);
+        *code = SNAPSHOT_IO_FAILURE;
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    if (*size < 8 + sizeof(SnapshotTrailer)) {
+        close(fd);
+        *code = SNAPSHOT_INVALID;
+        return NULL;
+    }
+
+    // Private pages let the fixups below write to the table without touching
+    // the file; the elements stay shared with the page cache.
+    char *mapping =
+        mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        *code = SNAPSHOT_IO_FAILURE;
+        return NULL;
+    }
+
+    memcpy(trailer, mapping + *size - sizeof(SnapshotTrailer),
+           sizeof(SnapshotTrailer));
+    uint64_t table_end = *size - sizeof(SnapshotTrailer);
+    int valid = memcmp(mapping, magic, 8) == 0 &&
+                memcmp(trailer->magic, magic, 8) == 0 &&
+                trailer->version == SNAPSHOT_VERSION &&
+                trailer->byte_order == BYTE_ORDER_MARK &&
+                trailer->pointer_size == sizeof(void *) &&
+                trailer->table >= 8 && trailer->table <= table_end &&
+                trailer->table % SNAPSHOT_ALIGNMENT == 0 &&
+                trailer->slots == (table_end - trailer->table) /
+                                      sizeof(uintptr_t) &&
+                (table_end - trailer->table) % sizeof(uintptr_t) == 0 &&
+                trailer->slots % stride == 0;
+
+    uintptr_t *table = (uintptr_t *)(mapping + trailer->table);
+    for (uint64_t i = 0; valid && i < trailer->slots; i++) {
+        uintptr_t slot = table[i];
+        if (slot == 0 || slot == TOMBSTONE)
+            continue;
+        if (slot < 8 || slot > trailer->table)
+            valid = 0;
+        table[i] = (uintptr_t)(mapping + slot);
+    }
+
+    if (!valid) {
+        munmap(mapping, *size);
+        *code = SNAPSHOT_INVALID;
+        return NULL;
+    }
+    *code = SNAPSHOT_SUCCESS;
+    return mapping;
+}
+
+void snapshot_unmap(void *mapping, size_t size) {
+    if (mapping != NULL)
+        munmap(mapping, size);
+}
+
+#else
+
+// Snapshots cannot be loaded here, so there is never anything to unmap.
+void snapshot_unmap(void *mapping, size_t size) {
+    (void)mapping;
+    (void)size;
+}
+
+#endif // POSIX
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/// \file Snapshot.h
+/// \internal
+/// \brief Shared on-disk format behind the containers' `save` and `load`.
+///
+/// A snapshot stores a container's table of pointer slots together with the
+/// bytes of every element it points to:
+///
+///     magic | element bytes ... | slot table | SnapshotTrailer
+///
+/// Each element is padded to `SNAPSHOT_ALIGNMENT` bytes and each slot holds
+/// the file offset of its element, with `NULL` and the tombstone `(void *)-1`
+/// written as is. Loading maps the file privately and turns the offsets back
+/// into pointers in place, so the table keeps its layout and nothing is
+/// rehashed or copied.
+#ifndef CSTD_SNAPSHOT_H
+#define CSTD_SNAPSHOT_H
+
+#include <cstd/Operators.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SNAPSHOT_SUCCESS 0
+#define SNAPSHOT_ALLOC_FAILURE 1
+#define SNAPSHOT_IO_FAILURE 2
+#define SNAPSHOT_INVALID 3
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 8
+
+/// \brief Trailer at the end of every snapshot.
+typedef struct {
+    uint32_t version;      ///< `SNAPSHOT_VERSION`.
+    uint32_t byte_order;   ///< 0x01020304 in the writer's byte order.
+    uint64_t pointer_size; ///< `sizeof(void *)` of the writer.
+    uint64_t table;        ///< File offset of the slot table.
+    uint64_t slots;        ///< Number of slots in the table.
+    uint64_t meta[2];      ///< Container specific counters.
+    char magic[8];         ///< Container tag, also found at offset 0.
+} SnapshotTrailer;
+
+/// \brief Write `count` slots and the elements they point to into `path`.
+/// \details The file is written beside `path`, synced and renamed over it.
+/// \param serializers Serializer for each of the `stride` slots making up
+/// one table entry, slot `i` uses `serializers[i % stride]`.
+/// \return One of the `SNAPSHOT_*` codes.
+int snapshot_save(const char *path, const char magic[8], void *const *slots,
+                  size_t count, const SerializeFn *serializers, size_t stride,
+                  const uint64_t meta[2]);
+
+/// \brief Map a snapshot written by `snapshot_save` and restore its pointers.
+/// \param trailer Receives the trailer; the slot table starts at
+/// `mapping + trailer->table` and holds `trailer->slots` pointers.
+/// \param size Receives the size of the mapping.
+/// \param code Receives one of the `SNAPSHOT_*` codes.
+/// \return The mapping, or `NULL` on failure.
+void *snapshot_load(const char *path, const char magic[8], size_t stride,
+                    SnapshotTrailer *trailer, size_t *size, int *code);
+
+/// \brief Release a mapping returned by `snapshot_load`. `NULL` is ignored.
+void snapshot_unmap(void *mapping, size_t size);
+
+/// \brief Whether `ptr` lies in a mapping. Memory there must not be freed.
+static inline int snapshot_contains(const void *mapping, size_t size,
+                                    const void *ptr) {
+    return (const char *)ptr >= (const char *)mapping &&
+           (const char *)ptr < (const char *)mapping + size;
+}
+
+#endif // CSTD_SNAPSHOT_H
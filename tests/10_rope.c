@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CLog.h>
+#include <cstd/CRope.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX 20000
+#define MODEL_MAX (1 << 20)
+
+static char model[MODEL_MAX];
+static size_t model_len = 0;
+
+// Check the rope against the model through both the iterator and CRope_at.
+void check_rope(const CRope_t *rope) {
+    assert(CRope_length(rope) == model_len);
+    CRopeIter_t iter = CRope_iter(rope);
+    CStringView_t chunk;
+    size_t offset = 0;
+    while (CRopeIter_next(&iter, &chunk)) {
+        assert(chunk.len > 0 && chunk.len <= CROPE_LEAF_SIZE);
+        assert(memcmp(model + offset, chunk.ptr, chunk.len) == 0);
+        offset += chunk.len;
+    }
+    assert(offset == model_len);
+    for (int i = 0; i < 16 && model_len; i++) {
+        size_t index = (size_t)rand() % model_len;
+        assert(CRope_at(rope, index) == model[index]);
+    }
+}
+
+CRope_t *test_new() {
+    CLog(INFO, "test_new()");
+    CResult_t *res = CRope_new();
+    assert(!CResult_is_error(res));
+    CRope_t *rope = CResult_get(res);
+    CResult_free(&res);
+    assert(CRope_length(rope) == 0);
+    assert(CRope_at(rope, 0) == '\0');
+    CRopeIter_t iter = CRope_iter(rope);
+    assert(!CRopeIter_next(&iter, NULL));
+    return rope;
+}
+
+void test_edits(CRope_t *rope) {
+    CLog(INFO, "test_edits()");
+    char buffer[3000];
+    for (int i = 0; i < TEST_MAX; i++) {
+        if (rand() % 3 || model_len < 1000) {
+            size_t len = (size_t)rand() % (rand() % 16 ? 40 : 3000) + 1;
+            if (model_len + len > MODEL_MAX)
+                continue;
+            for (size_t k = 0; k < len; k++)
+                buffer[k] = (char)('a' + rand() % 26);
+            size_t at = (size_t)rand() % (model_len + 1);
+            assert(CRope_insert(rope, at, CStringView_from(buffer, len)) ==
+                   CROPE_SUCCESS);
+            memmove(model + at + len, model + at, model_len - at);
+            memcpy(model + at, buffer, len);
+            model_len += len;
+        } else {
+            size_t start = (size_t)rand() % (model_len + 1);
+            size_t end = start + (size_t)rand() % 200;
+            if (end > model_len)
+                end = model_len;
+            assert(CRope_delete(rope, start, end) == CROPE_SUCCESS);
+            memmove(model + start, model + end, model_len - end);
+            model_len -= end - start;
+        }
+        if (i % 1000 == 0)
+            check_rope(rope);
+    }
+    check_rope(rope);
+
+    assert(CRope_insert(rope, model_len + 1, CStringView_from_c("x")) ==
+           CROPE_INDEX_OUT_OF_BOUNDS);
+    assert(CRope_delete(rope, 2, 1) == CROPE_INDEX_OUT_OF_BOUNDS);
+    assert(CRope_delete(rope, 0, model_len + 1) == CROPE_INDEX_OUT_OF_BOUNDS);
+}
+
+void test_substring(CRope_t *rope) {
+    CLog(INFO, "test_substring()");
+    for (int i = 0; i < 100; i++) {
+        size_t start = (size_t)rand() % (model_len + 1);
+        size_t end = start + (size_t)rand() % 5000;
+        if (end > model_len)
+            end = model_len;
+        CResult_t *res = CRope_substring(rope, start, end);
+        assert(!CResult_is_error(res));
+        CRope_t *sub = CResult_get(res);
+        CResult_free(&res);
+
+        // Appending the substring to the rope shares its chunks.
+        if (model_len + end - start <= MODEL_MAX) {
+            assert(CRope_concat(rope, sub) == CROPE_SUCCESS);
+            memcpy(model + model_len, model + start, end - start);
+            model_len += end - start;
+        }
+        assert(CRope_length(sub) == end - start);
+        CRope_free(&sub);
+    }
+    check_rope(rope);
+
+    CResult_t *res = CRope_substring(rope, 0, model_len + 1);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+}
+
+void test_conversions(CRope_t *rope) {
+    CLog(INFO, "test_conversions()");
+    CResult_t *res = CRope_to_cstring(rope);
+    assert(!CResult_is_error(res));
+    CString_t *string = CResult_get(res);
+    CResult_free(&res);
+    assert(CStringView_equals(CString_view(string),
+                              CStringView_from(model, model_len)));
+
+    res = CRope_from_cstring(string);
+    assert(!CResult_is_error(res));
+    CRope_t *copy = CResult_get(res);
+    CResult_free(&res);
+    check_rope(copy);
+
+    // Edits to a clone leave the original alone.
+    res = CRope_clone(copy);
+    assert(!CResult_is_error(res));
+    CRope_t *clone = CResult_get(res);
+    CResult_free(&res);
+    assert(CRope_delete(clone, 0, CRope_length(clone) / 2) == CROPE_SUCCESS);
+    assert(CRope_prepend(clone, CStringView_from_c("<<")) == CROPE_SUCCESS);
+    assert(CRope_append(clone, CStringView_from_c(">>")) == CROPE_SUCCESS);
+    assert(CRope_at(clone, 0) == '<' &&
+           CRope_at(clone, CRope_length(clone) - 1) == '>');
+    check_rope(copy);
+
+    assert(CRope_concat(clone, clone) == CROPE_SUCCESS);
+    assert(CRope_clear(clone) == CROPE_SUCCESS);
+    assert(CRope_length(clone) == 0);
+
+    CRope_free(&clone);
+    CRope_free(&copy);
+    CString_free(&string);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    CRope_t *rope = test_new();
+    test_edits(rope);
+    test_substring(rope);
+    test_conversions(rope);
+    assert(CRope_free(&rope) == CROPE_SUCCESS);
+    assert(rope == NULL);
+    return 0;
+}
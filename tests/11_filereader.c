@@ -0,0 +1,199 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CFileReader.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_SIZE (3 << 20)
+
+static char *content;
+static size_t content_len;
+static char path[] = "/tmp/cstd_filereader_XXXXXX";
+
+// Lines of varying length, CRLF endings, a line longer than the read buffer,
+// record delimiters and no terminator at the very end.
+void make_file() {
+    CLog(INFO, "make_file()");
+    content = malloc(TEST_SIZE);
+    assert(content);
+    while (content_len < TEST_SIZE - 100) {
+        size_t len = (size_t)rand() % 120;
+        if (content_len == 1000)
+            len = CFILEREADER_BUFFER_SIZE + 12345;
+        if (content_len + len + 4 > TEST_SIZE - 100)
+            break;
+        for (size_t i = 0; i < len; i++)
+            content[content_len++] = (char)('a' + rand() % 26);
+        if (rand() % 5 == 0)
+            content[content_len++] = '|', content[content_len++] = '|';
+        if (rand() % 4 == 0)
+            content[content_len++] = '\r';
+        content[content_len++] = '\n';
+    }
+    memcpy(content + content_len, "last line", 9);
+    content_len += 9;
+
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    assert(write(fd, content, content_len) == (ssize_t)content_len);
+    close(fd);
+}
+
+void test_lines(int mode) {
+    CLog(INFO, "test_lines(%d)", mode);
+    CResult_t *res = CFileReader_open(path, mode);
+    assert(!CResult_is_error(res));
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+
+    CStringSplit_t expected = CStringView_lines_iter(
+        CStringView_from(content, content_len));
+    CStringView_t line, want;
+    size_t lines = 0;
+    while (CFileReader_next_line(reader, &line)) {
+        assert(CStringSplit_next(&expected, &want));
+        assert(CStringView_equals(line, want));
+        lines++;
+    }
+    assert(!CStringSplit_next(&expected, &want));
+    assert(CFileReader_error(reader) == CFILEREADER_SUCCESS);
+    assert(lines > 1000);
+    CFileReader_free(&reader);
+    assert(reader == NULL);
+}
+
+void test_records(int mode) {
+    CLog(INFO, "test_records(%d)", mode);
+    CResult_t *res = CFileReader_open(path, mode);
+    assert(!CResult_is_error(res));
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+
+    CStringView_t delim = CStringView_from_c("||\r\n");
+    CStringSplit_t expected =
+        CStringView_split_iter(CStringView_from(content, content_len), delim);
+    CStringView_t record, want;
+    while (CFileReader_next_record(reader, delim, &record)) {
+        assert(CStringSplit_next(&expected, &want));
+        assert(CStringView_equals(record, want));
+    }
+    assert(!CStringSplit_next(&expected, &want));
+
+    // Slurping after the end yields an empty string.
+    res = CFileReader_slurp(reader);
+    assert(!CResult_is_error(res));
+    CString_t *rest = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_length(rest) == 0);
+    CString_free(&rest);
+    CFileReader_free(&reader);
+}
+
+void test_slurp(int mode) {
+    CLog(INFO, "test_slurp(%d)", mode);
+    CResult_t *res = CFileReader_open(path, mode);
+    assert(!CResult_is_error(res));
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+
+    // Consume a line first; the rest of the file must follow it exactly.
+    CStringView_t line;
+    assert(CFileReader_next_line(reader, &line));
+    size_t offset = (size_t)(memchr(content, '\n', content_len) -
+                             (void *)content) + 1;
+    res = CFileReader_slurp(reader);
+    assert(!CResult_is_error(res));
+    CString_t *rest = CResult_get(res);
+    CResult_free(&res);
+    assert(CStringView_equals(
+        CString_view(rest),
+        CStringView_from(content + offset, content_len - offset)));
+    CString_free(&rest);
+    CFileReader_free(&reader);
+}
+
+void test_pipe() {
+    CLog(INFO, "test_pipe()");
+    int fds[2];
+    assert(pipe(fds) == 0);
+    const char *text = "first\nsecond\r\n\nfourth";
+    assert(write(fds[1], text, strlen(text)) == (ssize_t)strlen(text));
+    close(fds[1]);
+
+    CResult_t *res = CFileReader_from_fd(fds[0], CFILEREADER_MMAP);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+
+    res = CFileReader_from_fd(fds[0], CFILEREADER_AUTO);
+    assert(!CResult_is_error(res));
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+    const char *lines[] = {"first", "second", "", "fourth"};
+    CStringView_t line;
+    for (int i = 0; i < 4; i++) {
+        assert(CFileReader_next_line(reader, &line));
+        assert(CStringView_equals(line, CStringView_from_c(lines[i])));
+    }
+    assert(!CFileReader_next_line(reader, &line));
+    assert(CFileReader_error(reader) == CFILEREADER_SUCCESS);
+    CFileReader_free(&reader);
+
+    // The reader leaves descriptors it did not open alone.
+    assert(close(fds[0]) == 0);
+}
+
+void test_errors() {
+    CLog(INFO, "test_errors()");
+    CResult_t *res = CFileReader_open("/nonexistent/cstd/file", 0);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    assert(CFileReader_error(NULL) == CFILEREADER_NULL_READER);
+    assert(CFileReader_free(NULL) == CFILEREADER_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    make_file();
+    int modes[] = {CFILEREADER_AUTO, CFILEREADER_MMAP, CFILEREADER_READ};
+    for (int i = 0; i < 3; i++) {
+        test_lines(modes[i]);
+        test_records(modes[i]);
+        test_slurp(modes[i]);
+    }
+    test_pipe();
+    test_errors();
+    unlink(path);
+    free(content);
+    return 0;
+}
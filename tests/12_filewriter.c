@@ -0,0 +1,169 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstd/CFileReader.h>
+#include <cstd/CFileWriter.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_SIZE (16 << 20)
+
+static char *source;
+static char *expected;
+static size_t expected_len;
+static char path[] = "/tmp/cstd_filewriter_XXXXXX";
+
+// Compare the file on disk with what was written to it.
+void check_file() {
+    CResult_t *res = CFileReader_open(path, CFILEREADER_READ);
+    assert(!CResult_is_error(res));
+    CFileReader_t *reader = CResult_get(res);
+    CResult_free(&res);
+    res = CFileReader_slurp(reader);
+    assert(!CResult_is_error(res));
+    CString_t *contents = CResult_get(res);
+    CResult_free(&res);
+    assert(CStringView_equals(CString_view(contents),
+                              CStringView_from(expected, expected_len)));
+    CString_free(&contents);
+    CFileReader_free(&reader);
+}
+
+void test_writes(int flags) {
+    CLog(INFO, "test_writes(%d)", flags);
+    CResult_t *res = CFileWriter_open(path, flags);
+    if (CResult_is_error(res) && (flags & CFILEWRITER_DIRECT)) {
+        CLog(WARN, "Direct I/O is not supported here, skipping.");
+        CResult_free(&res);
+        return;
+    }
+    assert(!CResult_is_error(res));
+    CFileWriter_t *writer = CResult_get(res);
+    CResult_free(&res);
+
+    // Mix tiny appends, appends that straddle the buffer and payloads large
+    // enough to bypass it.
+    expected_len = 0;
+    while (expected_len < TEST_SIZE / 2) {
+        int kind = rand() % 100;
+        size_t len = kind < 90   ? (size_t)rand() % 100
+                     : kind < 98 ? (size_t)rand() % 100000
+                                 : CFILEWRITER_BUFFER_SIZE / 2 +
+                                       (size_t)rand() % CFILEWRITER_BUFFER_SIZE;
+        size_t from = (size_t)rand() % (TEST_SIZE - len);
+        assert(CFileWriter_append(writer, source + from, len) ==
+               CFILEWRITER_SUCCESS);
+        memcpy(expected + expected_len, source + from, len);
+        expected_len += len;
+        if (rand() % 500 == 0)
+            assert(CFileWriter_flush(writer) == CFILEWRITER_SUCCESS);
+    }
+    assert(CFileWriter_sync(writer) == CFILEWRITER_SUCCESS);
+    assert(CFileWriter_free(&writer) == CFILEWRITER_SUCCESS);
+    assert(writer == NULL);
+    check_file();
+}
+
+void test_append() {
+    CLog(INFO, "test_append()");
+    CResult_t *res = CFileWriter_open(path, CFILEWRITER_APPEND);
+    assert(!CResult_is_error(res));
+    CFileWriter_t *writer = CResult_get(res);
+    CResult_free(&res);
+
+    res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *line = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_set(line, "appended line\n") == CSTRING_SUCCESS);
+    assert(CFileWriter_append_cstring(writer, line) == CFILEWRITER_SUCCESS);
+    assert(CFileWriter_append_view(writer, CStringView_from_c("end")) ==
+           CFILEWRITER_SUCCESS);
+    assert(CFileWriter_free(&writer) == CFILEWRITER_SUCCESS);
+
+    memcpy(expected + expected_len, "appended line\nend", 17);
+    expected_len += 17;
+    check_file();
+    CString_free(&line);
+
+    res = CFileWriter_open(path, CFILEWRITER_APPEND | CFILEWRITER_DIRECT);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+}
+
+void test_pipe() {
+    CLog(INFO, "test_pipe()");
+    int fds[2];
+    assert(pipe(fds) == 0);
+    CResult_t *res = CFileWriter_from_fd(fds[1], 0);
+    assert(!CResult_is_error(res));
+    CFileWriter_t *writer = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < 100; i++)
+        assert(CFileWriter_append(writer, "x", 1) == CFILEWRITER_SUCCESS);
+    assert(CFileWriter_flush(writer) == CFILEWRITER_SUCCESS);
+
+    char buffer[128];
+    assert(read(fds[0], buffer, sizeof(buffer)) == 100);
+    assert(CFileWriter_free(&writer) == CFILEWRITER_SUCCESS);
+
+    // The writer leaves descriptors it did not open alone.
+    assert(close(fds[1]) == 0);
+    close(fds[0]);
+
+    assert(CFileWriter_append(NULL, "x", 1) == CFILEWRITER_NULL_WRITER);
+    assert(CFileWriter_error(NULL) == CFILEWRITER_NULL_WRITER);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    source = malloc(TEST_SIZE);
+    expected = malloc(TEST_SIZE * 2);
+    assert(source && expected);
+    for (size_t i = 0; i < TEST_SIZE; i++)
+        source[i] = (char)rand();
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    test_writes(0);
+    test_writes(CFILEWRITER_SYNC_FLUSH);
+    test_writes(CFILEWRITER_DIRECT | CFILEWRITER_SYNC_CLOSE);
+    test_append();
+    test_pipe();
+
+    unlink(path);
+    free(expected);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,282 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CAsyncIO.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_SIZE (4 << 20)
+#define BLOCK 4096
+#define DEPTH 16
+
+static char *source;
+static char path[] = "/tmp/cstd_asyncio_XXXXXX";
+static int fd;
+
+typedef struct {
+    CAsyncIO_t *io;
+    char *buffer;
+    uint64_t offset;
+    size_t len;
+    int64_t result;
+    int done;
+    int requeue; // Read the next block from the callback this many times.
+} Read;
+
+static void on_read(void *user_data, int64_t result) {
+    Read *read = user_data;
+    read->result = result;
+    read->done++;
+    assert(result == (int64_t)read->len);
+    assert(memcmp(read->buffer, source + read->offset, read->len) == 0);
+    if (read->requeue) {
+        read->requeue--;
+        read->offset = (read->offset + read->len) % (TEST_SIZE - read->len);
+        assert(CAsyncIO_read(read->io, fd, read->buffer, read->len,
+                             read->offset, on_read,
+                             read) == CASYNCIO_SUCCESS);
+    }
+}
+
+static void on_write(void *user_data, int64_t result) {
+    *(int64_t *)user_data = result;
+}
+
+CAsyncIO_t *create(int backend) {
+    CResult_t *res = CAsyncIO_new(DEPTH, backend);
+    if (CResult_is_error(res) && backend == CASYNCIO_URING) {
+        CLog(WARN, "io_uring is not available here, skipping.");
+        CResult_free(&res);
+        return NULL;
+    }
+    assert(!CResult_is_error(res));
+    CAsyncIO_t *io = CResult_get(res);
+    CResult_free(&res);
+    assert(backend == CASYNCIO_AUTO || CAsyncIO_backend(io) == backend);
+    return io;
+}
+
+void test_reads(int backend) {
+    CLog(INFO, "test_reads(%d)", backend);
+    CAsyncIO_t *io = create(backend);
+    if (io == NULL)
+        return;
+
+    Read reads[DEPTH];
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            reads[i] = (Read){io, malloc(BLOCK), 0, 0, 0, 0, 0};
+            reads[i].len = 1 + (size_t)rand() % BLOCK;
+            reads[i].offset = (uint64_t)rand() % (TEST_SIZE - BLOCK);
+            assert(CAsyncIO_read(io, fd, reads[i].buffer, reads[i].len,
+                                 reads[i].offset, on_read,
+                                 &reads[i]) == CASYNCIO_SUCCESS);
+        }
+        assert(CAsyncIO_read(io, fd, NULL, 1, 0, on_read, NULL) ==
+               CASYNCIO_QUEUE_FULL);
+        assert(CAsyncIO_pending(io) == DEPTH);
+        assert(CAsyncIO_submit(io) == CASYNCIO_SUCCESS);
+
+        size_t completed = 0;
+        while (completed < DEPTH)
+            completed += CAsyncIO_poll(io, 1);
+        assert(completed == DEPTH);
+        assert(CAsyncIO_pending(io) == 0);
+        for (int i = 0; i < DEPTH; i++) {
+            assert(reads[i].done == 1);
+            free(reads[i].buffer);
+        }
+    }
+
+    // Callbacks may queue follow-up requests; they go out on the next poll.
+    reads[0] = (Read){io, malloc(BLOCK), 0, BLOCK, 0, 0, 100};
+    assert(CAsyncIO_read(io, fd, reads[0].buffer, BLOCK, 0, on_read,
+                         &reads[0]) == CASYNCIO_SUCCESS);
+    while (CAsyncIO_pending(io))
+        CAsyncIO_poll(io, 1);
+    assert(reads[0].done == 101);
+    free(reads[0].buffer);
+
+    // Reads past the end of the file come back short.
+    char tail[BLOCK];
+    void *user_data = NULL;
+    int64_t result = 0;
+    assert(CAsyncIO_read(io, fd, tail, BLOCK, TEST_SIZE - 10, NULL, tail) ==
+           CASYNCIO_SUCCESS);
+    assert(CAsyncIO_poll(io, 1) == 1);
+    assert(CAsyncIO_next_completion(io, &user_data, &result) ==
+           CASYNCIO_SUCCESS);
+    assert(user_data == tail && result == 10);
+    assert(memcmp(tail, source + TEST_SIZE - 10, 10) == 0);
+
+    assert(CAsyncIO_free(&io) == CASYNCIO_SUCCESS);
+    assert(io == NULL);
+}
+
+void test_completions(int backend) {
+    CLog(INFO, "test_completions(%d)", backend);
+    CAsyncIO_t *io = create(backend);
+    if (io == NULL)
+        return;
+
+    // Requests without a callback leave their completions in a queue.
+    Read reads[DEPTH];
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            reads[i] = (Read){io, malloc(BLOCK), 0, 0, 0, 0, 0};
+            reads[i].len = 1 + (size_t)rand() % BLOCK;
+            reads[i].offset = (uint64_t)rand() % (TEST_SIZE - BLOCK);
+            assert(CAsyncIO_read(io, fd, reads[i].buffer, reads[i].len,
+                                 reads[i].offset, NULL,
+                                 &reads[i]) == CASYNCIO_SUCCESS);
+        }
+        assert(CAsyncIO_next_completion(io, NULL, NULL) ==
+               CASYNCIO_NO_COMPLETION);
+
+        size_t completed = 0;
+        while (completed < DEPTH)
+            completed += CAsyncIO_poll(io, DEPTH - completed);
+        assert(CAsyncIO_pending(io) == 0);
+        // Untaken completions still hold their slots.
+        assert(CAsyncIO_read(io, fd, NULL, 1, 0, NULL, NULL) ==
+               CASYNCIO_QUEUE_FULL);
+
+        void *user_data;
+        int64_t result;
+        for (int i = 0; i < DEPTH; i++) {
+            assert(CAsyncIO_next_completion(io, &user_data, &result) ==
+                   CASYNCIO_SUCCESS);
+            Read *read = user_data;
+            assert(result == (int64_t)read->len);
+            assert(memcmp(read->buffer, source + read->offset, read->len) ==
+                   0);
+            read->done++;
+        }
+        assert(CAsyncIO_next_completion(io, &user_data, &result) ==
+               CASYNCIO_NO_COMPLETION);
+        for (int i = 0; i < DEPTH; i++) {
+            assert(reads[i].done == 1);
+            free(reads[i].buffer);
+        }
+    }
+
+    // Untaken completions are discarded by free.
+    char scratch[BLOCK];
+    assert(CAsyncIO_read(io, fd, scratch, BLOCK, 0, NULL, NULL) ==
+           CASYNCIO_SUCCESS);
+    assert(CAsyncIO_poll(io, 1) == 1);
+    assert(CAsyncIO_free(&io) == CASYNCIO_SUCCESS);
+}
+
+void test_writes(int backend) {
+    CLog(INFO, "test_writes(%d)", backend);
+    CAsyncIO_t *io = create(backend);
+    if (io == NULL)
+        return;
+
+    char scratch[] = "/tmp/cstd_asyncio_XXXXXX";
+    int out = mkstemp(scratch);
+    assert(out >= 0);
+    int64_t results[DEPTH];
+    for (size_t offset = 0; offset < TEST_SIZE; offset += DEPTH * BLOCK) {
+        for (int i = 0; i < DEPTH; i++)
+            assert(CAsyncIO_write(io, out, source + offset + i * BLOCK, BLOCK,
+                                  offset + i * BLOCK, on_write,
+                                  &results[i]) == CASYNCIO_SUCCESS);
+        assert(CAsyncIO_poll(io, DEPTH) == DEPTH);
+        for (int i = 0; i < DEPTH; i++)
+            assert(results[i] == BLOCK);
+    }
+
+    // Leave a request in flight for free to wait on.
+    assert(CAsyncIO_write(io, out, "end", 3, TEST_SIZE, NULL, NULL) ==
+           CASYNCIO_SUCCESS);
+    assert(CAsyncIO_free(&io) == CASYNCIO_SUCCESS);
+
+    char *contents = malloc(TEST_SIZE + 3);
+    assert(pread(out, contents, TEST_SIZE + 3, 0) == TEST_SIZE + 3);
+    assert(memcmp(contents, source, TEST_SIZE) == 0);
+    assert(memcmp(contents + TEST_SIZE, "end", 3) == 0);
+    free(contents);
+
+    // Failures are reported through the callback as negated errno values.
+    io = create(backend);
+    int64_t result = 0;
+    assert(CAsyncIO_read(io, -1, scratch, 1, 0, on_write, &result) ==
+           CASYNCIO_SUCCESS);
+    assert(CAsyncIO_poll(io, 1) == 1);
+    assert(result < 0);
+    assert(CAsyncIO_free(&io) == CASYNCIO_SUCCESS);
+
+    close(out);
+    unlink(scratch);
+}
+
+void test_null() {
+    CLog(INFO, "test_null()");
+    assert(CAsyncIO_read(NULL, 0, NULL, 0, 0, NULL, NULL) ==
+           CASYNCIO_NULL_ENGINE);
+    assert(CAsyncIO_submit(NULL) == CASYNCIO_NULL_ENGINE);
+    assert(CAsyncIO_next_completion(NULL, NULL, NULL) ==
+           CASYNCIO_NULL_ENGINE);
+    assert(CAsyncIO_backend(NULL) == CASYNCIO_NULL_ENGINE);
+    assert(CAsyncIO_poll(NULL, 1) == 0);
+    assert(CAsyncIO_pending(NULL) == 0);
+    assert(CAsyncIO_free(NULL) == CASYNCIO_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    source = malloc(TEST_SIZE);
+    assert(source);
+    for (size_t i = 0; i < TEST_SIZE; i++)
+        source[i] = (char)rand();
+    fd = mkstemp(path);
+    assert(fd >= 0);
+    assert(write(fd, source, TEST_SIZE) == TEST_SIZE);
+
+    test_reads(CASYNCIO_URING);
+    test_reads(CASYNCIO_THREADS);
+    test_reads(CASYNCIO_AUTO);
+    test_completions(CASYNCIO_URING);
+    test_completions(CASYNCIO_THREADS);
+    test_writes(CASYNCIO_URING);
+    test_writes(CASYNCIO_THREADS);
+    test_null();
+
+    close(fd);
+    unlink(path);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CConstMap.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_MAX 100000
+
+static char path[] = "/tmp/cstd_constmap_XXXXXX";
+
+static CStringView_t key_of(int i, char *buffer) {
+    int len = snprintf(buffer, 32, "10.%d.%d.%d", i >> 16, (i >> 8) & 255,
+                       i & 255);
+    return CStringView_from(buffer, (size_t)len);
+}
+
+void test_build() {
+    CLog(INFO, "test_build()");
+    CResult_t *res = CConstMapBuilder_new(path);
+    assert(!CResult_is_error(res));
+    CConstMapBuilder_t *builder = CResult_get(res);
+    CResult_free(&res);
+
+    char key[32], value[32];
+    for (int i = 0; i < TEST_MAX; i++) {
+        int len = snprintf(value, sizeof(value), "country-%d", i % 250);
+        assert(CConstMapBuilder_add(builder, key_of(i, key),
+                                    CStringView_from(value, (size_t)len)) ==
+               CCONSTMAP_SUCCESS);
+    }
+    // Duplicates resolve to the first value, and empty keys and values are
+    // fine.
+    assert(CConstMapBuilder_add(builder, key_of(7, key),
+                                CStringView_from_c("shadowed")) ==
+           CCONSTMAP_SUCCESS);
+    assert(CConstMapBuilder_add(builder, CStringView_from_c(""),
+                                CStringView_from_c("")) == CCONSTMAP_SUCCESS);
+    assert(CConstMapBuilder_finish(&builder) == CCONSTMAP_SUCCESS);
+    assert(builder == NULL);
+}
+
+void test_lookup() {
+    CLog(INFO, "test_lookup()");
+    CResult_t *res = CConstMap_open(path);
+    assert(!CResult_is_error(res));
+    CConstMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    assert(CConstMap_size(map) == TEST_MAX + 2);
+
+    char key[32], expected[32];
+    CStringView_t value;
+    for (int i = 0; i < TEST_MAX; i++) {
+        int len = snprintf(expected, sizeof(expected), "country-%d", i % 250);
+        assert(CConstMap_get(map, key_of(i, key), &value) ==
+               CCONSTMAP_SUCCESS);
+        assert(CStringView_equals(value,
+                                  CStringView_from(expected, (size_t)len)));
+    }
+    for (int i = TEST_MAX; i < TEST_MAX * 2; i++)
+        assert(CConstMap_get(map, key_of(i, key), NULL) ==
+               CCONSTMAP_NOT_FOUND);
+    assert(CConstMap_get(map, CStringView_from_c(""), &value) ==
+           CCONSTMAP_SUCCESS);
+    assert(value.len == 0);
+
+    // Worker processes look up keys in the same pages.
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        int found = CConstMap_get(map, key_of(12345, key), &value);
+        _exit(found == CCONSTMAP_SUCCESS &&
+                      CStringView_equals(value,
+                                         CStringView_from_c("country-95"))
+                  ? 0
+                  : 1);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    assert(CConstMap_free(&map) == CCONSTMAP_SUCCESS);
+    assert(map == NULL);
+}
+
+void test_failures() {
+    CLog(INFO, "test_failures()");
+    // An abandoned builder leaves the existing map alone.
+    CResult_t *res = CConstMapBuilder_new(path);
+    assert(!CResult_is_error(res));
+    CConstMapBuilder_t *builder = CResult_get(res);
+    CResult_free(&res);
+    assert(CConstMapBuilder_add(builder, CStringView_from_c("a"),
+                                CStringView_from_c("b")) ==
+           CCONSTMAP_SUCCESS);
+    assert(CConstMapBuilder_free(&builder) == CCONSTMAP_SUCCESS);
+    res = CConstMap_open(path);
+    assert(!CResult_is_error(res));
+    CConstMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    assert(CConstMap_size(map) == TEST_MAX + 2);
+    CConstMap_free(&map);
+
+    assert(truncate(path, 4096) == 0);
+    res = CConstMap_open(path);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CCONSTMAP_INVALID_FILE);
+    CResult_free(&res);
+    unlink(path);
+    res = CConstMap_open(path);
+    assert(CError_get_code(CResult_eget(res)) == CCONSTMAP_IO_FAILURE);
+    CResult_free(&res);
+
+    res = CConstMapBuilder_new("/nonexistent/dir/map");
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    assert(CConstMap_get(NULL, CStringView_from_c("a"), NULL) ==
+           CCONSTMAP_NULL_MAP);
+    assert(CConstMap_size(NULL) == 0);
+    assert(CConstMapBuilder_add(NULL, CStringView_from_c("a"),
+                                CStringView_from_c("b")) ==
+           CCONSTMAP_NULL_MAP);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    test_build();
+    test_lookup();
+    test_failures();
+    return 0;
+}
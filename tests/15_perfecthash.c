@@ -0,0 +1,184 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CLog.h>
+#include <cstd/CPerfectHash.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX 200000
+
+static size_t string_hash(const void *key) {
+    size_t hash = 5381;
+    for (const char *c = key; *c; c++)
+        hash = hash * 33 + (unsigned char)*c;
+    return hash;
+}
+
+static CVector_t *make_keys(size_t count) {
+    CResult_t *res = CVector_new(count ? count : 1, free);
+    assert(!CResult_is_error(res));
+    CVector_t *keys = CResult_get(res);
+    CResult_free(&res);
+    for (size_t i = 0; i < count; i++) {
+        char *key = malloc(32);
+        snprintf(key, 32, "/route/%zu/%zx", i, i * 2654435761u);
+        assert(CVector_add(keys, key) == CVECTOR_SUCCESS);
+    }
+    return keys;
+}
+
+// Every key of the set must get its own index.
+static void check_bijection(const CPerfectHash_t *ph, CVector_t *keys) {
+    size_t n = CVector_size(keys);
+    assert(CPerfectHash_size(ph) == n);
+    unsigned char *seen = calloc(n + 1, 1);
+    for (size_t i = 0; i < n; i++) {
+        size_t index = CPerfectHash_index(ph, CVector_fget(keys, i));
+        assert(index < n);
+        assert(!seen[index]);
+        seen[index] = 1;
+    }
+    free(seen);
+}
+
+void test_build() {
+    CLog(INFO, "test_build()");
+    for (size_t n = 0; n < 300; n++) {
+        CVector_t *keys = make_keys(n);
+        CResult_t *res = CPerfectHash_build(keys, string_hash);
+        assert(!CResult_is_error(res));
+        CPerfectHash_t *ph = CResult_get(res);
+        CResult_free(&res);
+        check_bijection(ph, keys);
+        CPerfectHash_free(&ph);
+        CVector_free(&keys);
+    }
+
+    CVector_t *keys = make_keys(TEST_MAX);
+    CResult_t *res = CPerfectHash_build(keys, string_hash);
+    assert(!CResult_is_error(res));
+    CPerfectHash_t *ph = CResult_get(res);
+    CResult_free(&res);
+    check_bijection(ph, keys);
+
+    // Keys outside the set still land in range.
+    char other[32];
+    for (int i = 0; i < 10000; i++) {
+        snprintf(other, sizeof(other), "/missing/%d", i);
+        assert(CPerfectHash_index(ph, other) < TEST_MAX);
+    }
+
+    size_t size = CPerfectHash_serialize(ph, NULL, 0);
+    CLog(INFO, "%.2f bits per key", size * 8.0 / TEST_MAX);
+    assert(size < TEST_MAX);
+    char *buffer = malloc(size);
+    assert(CPerfectHash_serialize(ph, buffer, size) == size);
+    res = CPerfectHash_deserialize(buffer, size, string_hash);
+    assert(!CResult_is_error(res));
+    CPerfectHash_t *copy = CResult_get(res);
+    CResult_free(&res);
+    for (size_t i = 0; i < TEST_MAX; i++) {
+        void *key = CVector_fget(keys, i);
+        assert(CPerfectHash_index(ph, key) == CPerfectHash_index(copy, key));
+    }
+
+    // Damaged buffers are rejected.
+    res = CPerfectHash_deserialize(buffer, size - 1, string_hash);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    buffer[0] = 'X';
+    res = CPerfectHash_deserialize(buffer, size, string_hash);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CPERFECTHASH_INVALID_FORMAT);
+    CResult_free(&res);
+
+    free(buffer);
+    CPerfectHash_free(&copy);
+    CPerfectHash_free(&ph);
+    assert(ph == NULL);
+    CVector_free(&keys);
+}
+
+static const char *colors[] = {"red",    "green", "blue",   "cyan",
+                               "yellow", "black", "white", "magenta"};
+
+void test_lookup_table() {
+    CLog(INFO, "test_lookup_table()");
+    CResult_t *res = CVector_new(8, NULL);
+    CVector_t *keys = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < 8; i++)
+        CVector_add(keys, (void *)colors[i]);
+    res = CPerfectHash_build(keys, string_hash);
+    assert(!CResult_is_error(res));
+    CPerfectHash_t *ph = CResult_get(res);
+    CResult_free(&res);
+
+    // A string-to-enum table: one slot per key and a single comparison.
+    const char *names[8];
+    int values[8];
+    for (int i = 0; i < 8; i++) {
+        size_t index = CPerfectHash_index(ph, colors[i]);
+        names[index] = colors[i];
+        values[index] = i;
+    }
+    for (int i = 0; i < 8; i++) {
+        size_t index = CPerfectHash_index(ph, colors[i]);
+        assert(strcmp(names[index], colors[i]) == 0 && values[index] == i);
+    }
+    size_t index = CPerfectHash_index(ph, "purple");
+    assert(strcmp(names[index], "purple") != 0);
+
+    // The same key twice cannot be told apart.
+    CVector_add(keys, (void *)"blue");
+    res = CPerfectHash_build(keys, string_hash);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CPERFECTHASH_DUPLICATE_KEYS);
+    CResult_free(&res);
+
+    res = CPerfectHash_build(NULL, string_hash);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    assert(CPerfectHash_index(NULL, "red") == 0);
+    assert(CPerfectHash_free(NULL) == CPERFECTHASH_SUCCESS);
+
+    CPerfectHash_free(&ph);
+    CVector_free(&keys);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    test_build();
+    test_lookup_table();
+    return 0;
+}
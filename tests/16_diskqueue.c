@@ -0,0 +1,262 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CDiskQueue.h>
+#include <cstd/CLog.h>
+#include <cstd/CString.h>
+
+#include <assert.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_MAX 1000
+#define SEGMENT_SIZE 4096
+
+static char dir[] = "/tmp/cstd_diskqueue_XXXXXX";
+
+static CStringView_t record_of(int i, char *buffer) {
+    int len = snprintf(buffer, 32, "record-%d", i);
+    return CStringView_from(buffer, (size_t)len);
+}
+
+/// Count the files in the directory whose name ends with `suffix`.
+static int count_files(const char *suffix) {
+    DIR *d = opendir(dir);
+    assert(d != NULL);
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        size_t len = strlen(entry->d_name), n = strlen(suffix);
+        count += len >= n && strcmp(entry->d_name + len - n, suffix) == 0;
+    }
+    closedir(d);
+    return count;
+}
+
+/// Remove every file in the directory, leaving an empty queue behind.
+static void clear_dir() {
+    DIR *d = opendir(dir);
+    assert(d != NULL);
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL)
+        if (entry->d_name[0] != '.')
+            unlinkat(dirfd(d), entry->d_name, 0);
+    closedir(d);
+}
+
+void test_push_pop() {
+    CLog(INFO, "test_push_pop()");
+    CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 16);
+    assert(!CResult_is_error(res));
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+    assert(CDiskQueue_size(queue) == 0);
+
+    char buffer[32];
+    for (int i = 0; i < TEST_MAX; i++)
+        assert(CDiskQueue_push(queue, record_of(i, buffer)) ==
+               CDISKQUEUE_SUCCESS);
+    assert(CDiskQueue_size(queue) == TEST_MAX);
+    // Records spill over many segments.
+    assert(count_files(".seg") > 4);
+
+    CStringView_t record;
+    for (int i = 0; i < TEST_MAX / 2; i += 2) {
+        res = CDiskQueue_pop(queue);
+        assert(!CResult_is_error(res));
+        CString_t *string = CResult_get(res);
+        CResult_free(&res);
+        assert(CStringView_equals(CString_view(string),
+                                  record_of(i, buffer)));
+        CString_free(&string);
+        assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+        assert(CStringView_equals(record, record_of(i + 1, buffer)));
+    }
+    assert(CDiskQueue_size(queue) == TEST_MAX / 2);
+    assert(CDiskQueue_free(&queue) == CDISKQUEUE_SUCCESS);
+    assert(queue == NULL);
+}
+
+void test_restart() {
+    CLog(INFO, "test_restart()");
+    char buffer[32];
+    // A consumer that dies before syncing gets its records again.
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+        assert(!CResult_is_error(res));
+        CDiskQueue_t *queue = CResult_get(res);
+        CResult_free(&res);
+        for (int i = TEST_MAX; i < TEST_MAX + 10; i++)
+            CDiskQueue_push(queue, record_of(i, buffer));
+        CDiskQueue_sync(queue);
+        for (int i = 0; i < 100; i++)
+            CDiskQueue_pop(queue);
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(!CResult_is_error(res));
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+    assert(CDiskQueue_size(queue) == TEST_MAX / 2 + 10);
+    CStringView_t record;
+    for (int i = TEST_MAX / 2; i < TEST_MAX + 10; i++) {
+        assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+        assert(CStringView_equals(record, record_of(i, buffer)));
+    }
+    assert(CDiskQueue_size(queue) == 0);
+    assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_EMPTY);
+
+    // Consumed segments are recycled once the checkpoint has moved past them,
+    // leaving the one being consumed and the one being appended to.
+    assert(CDiskQueue_sync(queue) == CDISKQUEUE_SUCCESS);
+    assert(count_files(".seg") <= 2);
+    assert(count_files("spare") == 1);
+    assert(CDiskQueue_free(&queue) == CDISKQUEUE_SUCCESS);
+
+    res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(!CResult_is_error(res));
+    queue = CResult_get(res);
+    CResult_free(&res);
+    assert(CDiskQueue_size(queue) == 0);
+    CDiskQueue_free(&queue);
+}
+
+void test_torn_write() {
+    CLog(INFO, "test_torn_write()");
+    clear_dir();
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+        assert(!CResult_is_error(res));
+        CDiskQueue_t *queue = CResult_get(res);
+        CResult_free(&res);
+        CDiskQueue_push(queue, CStringView_from_c("a"));
+        CDiskQueue_push(queue, CStringView_from_c("b"));
+        CDiskQueue_push(queue, CStringView_from_c("c"));
+        CDiskQueue_push(queue, CStringView_from_c("d"));
+        _exit(CDiskQueue_sync(queue));
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // Damage "c", the third 24 byte record of the first segment; "d" is
+    // still intact behind it.
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%016x.seg", dir, 1);
+    int fd = open(path, O_WRONLY);
+    assert(fd >= 0);
+    assert(pwrite(fd, "x", 1, 2 * 24 + 16) == 1);
+    close(fd);
+
+    CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(!CResult_is_error(res));
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+    assert(CDiskQueue_size(queue) == 2);
+    CStringView_t record;
+    assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("a")));
+    assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("b")));
+    // New records never bring "d" back.
+    assert(CDiskQueue_push(queue, CStringView_from_c("e")) ==
+           CDISKQUEUE_SUCCESS);
+    CDiskQueue_free(&queue);
+
+    res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(!CResult_is_error(res));
+    queue = CResult_get(res);
+    CResult_free(&res);
+    assert(CDiskQueue_size(queue) == 1);
+    assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("e")));
+    CDiskQueue_free(&queue);
+}
+
+void test_failures() {
+    CLog(INFO, "test_failures()");
+    CResult_t *res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(!CResult_is_error(res));
+    CDiskQueue_t *queue = CResult_get(res);
+    CResult_free(&res);
+    char big[SEGMENT_SIZE];
+    memset(big, 'x', sizeof(big));
+    assert(CDiskQueue_push(queue, CStringView_from(big, sizeof(big))) ==
+           CDISKQUEUE_TOO_LARGE);
+    assert(CDiskQueue_push(queue, CStringView_from(big, SEGMENT_SIZE - 16)) ==
+           CDISKQUEUE_SUCCESS);
+    CStringView_t record;
+    assert(CDiskQueue_pop_view(queue, &record) == CDISKQUEUE_SUCCESS);
+    assert(record.len == SEGMENT_SIZE - 16);
+
+    // Only one queue may use a directory.
+    res = CDiskQueue_new(dir, SEGMENT_SIZE, 0);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CDISKQUEUE_IO_FAILURE);
+    CResult_free(&res);
+    CDiskQueue_free(&queue);
+
+    res = CDiskQueue_new("/nonexistent/dir/queue", 0, 0);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    res = CDiskQueue_pop(NULL);
+    assert(CError_get_code(CResult_eget(res)) == CDISKQUEUE_NULL_QUEUE);
+    CResult_free(&res);
+    assert(CDiskQueue_push(NULL, CStringView_from_c("a")) ==
+           CDISKQUEUE_NULL_QUEUE);
+    assert(CDiskQueue_sync(NULL) == CDISKQUEUE_NULL_QUEUE);
+    assert(CDiskQueue_size(NULL) == 0);
+    assert(CDiskQueue_free(NULL) == CDISKQUEUE_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+    assert(mkdtemp(dir) != NULL);
+
+    test_push_pop();
+    test_restart();
+    test_torn_write();
+    test_failures();
+
+    clear_dir();
+    rmdir(dir);
+    return 0;
+}
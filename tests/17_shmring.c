@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CLog.h>
+#include <cstd/CShmRing.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_MAX 100000
+
+/// Fill `buffer` with a record of `i` whose size varies with `i`.
+static CStringView_t record_of(int i, char *buffer) {
+    size_t len = (size_t)(i * 37) % 300;
+    for (size_t j = 0; j < len; j++)
+        buffer[j] = (char)(i + j);
+    return CStringView_from(buffer, len);
+}
+
+void test_single() {
+    CLog(INFO, "test_single()");
+    CResult_t *res = CShmRing_new(NULL, 1000);
+    assert(!CResult_is_error(res));
+    CShmRing_t *ring = CResult_get(res);
+    CResult_free(&res);
+    assert(CShmRing_capacity(ring) == 4096);
+
+    CStringView_t record;
+    assert(CShmRing_peek(ring, &record, 0) == CSHMRING_EMPTY);
+    assert(CShmRing_release(ring) == CSHMRING_EMPTY);
+
+    // Records of every size wrap around the ring many times.
+    char buffer[300];
+    int pushed = 0, popped = 0;
+    while (popped < TEST_MAX) {
+        while (pushed < TEST_MAX &&
+               CShmRing_push(ring, record_of(pushed, buffer), 0) ==
+                   CSHMRING_SUCCESS)
+            pushed++;
+        assert(CShmRing_peek(ring, &record, 0) == CSHMRING_SUCCESS);
+        assert(CStringView_equals(record, record_of(popped, buffer)));
+        assert(CShmRing_release(ring) == CSHMRING_SUCCESS);
+        popped++;
+    }
+    assert(CShmRing_peek(ring, &record, 0) == CSHMRING_EMPTY);
+
+    // Records are written in place and may end up shorter than reserved.
+    void *data;
+    assert(CShmRing_reserve(ring, 100, &data, 0) == CSHMRING_SUCCESS);
+    assert(((uintptr_t)data & 7) == 0);
+    memcpy(data, "hello", 5);
+    assert(CShmRing_commit(ring, 101) == CSHMRING_EMPTY);
+    assert(CShmRing_commit(ring, 5) == CSHMRING_SUCCESS);
+    assert(CShmRing_commit(ring, 5) == CSHMRING_EMPTY);
+    assert(CShmRing_peek(ring, &record, 0) == CSHMRING_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("hello")));
+    assert(CShmRing_release(ring) == CSHMRING_SUCCESS);
+
+    assert(CShmRing_reserve(ring, 4096, &data, 0) == CSHMRING_TOO_LARGE);
+    while (CShmRing_reserve(ring, 1000, &data, 0) == CSHMRING_SUCCESS)
+        CShmRing_commit(ring, 1000);
+    assert(CShmRing_reserve(ring, 1000, &data, 1000000) == CSHMRING_FULL);
+    CShmRing_free(&ring);
+    assert(ring == NULL);
+}
+
+void test_processes() {
+    CLog(INFO, "test_processes()");
+    // A small ring keeps both sides waiting on each other.
+    CResult_t *res = CShmRing_new(NULL, 4096);
+    assert(!CResult_is_error(res));
+    CShmRing_t *ring = CResult_get(res);
+    CResult_free(&res);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        char buffer[300];
+        CStringView_t record;
+        for (int i = 0; i < TEST_MAX; i++) {
+            if (CShmRing_peek(ring, &record, CSHMRING_FOREVER) ||
+                !CStringView_equals(record, record_of(i, buffer)))
+                _exit(1);
+            CShmRing_release(ring);
+        }
+        _exit(0);
+    }
+
+    char buffer[300];
+    for (int i = 0; i < TEST_MAX; i++)
+        assert(CShmRing_push(ring, record_of(i, buffer), CSHMRING_FOREVER) ==
+               CSHMRING_SUCCESS);
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CShmRing_free(&ring);
+}
+
+void test_open() {
+    CLog(INFO, "test_open()");
+    char name[64];
+    snprintf(name, sizeof(name), "/cstd_test_ring_%d", (int)getpid());
+    CResult_t *res = CShmRing_new(name, 8192);
+    assert(!CResult_is_error(res));
+    CShmRing_t *producer = CResult_get(res);
+    CResult_free(&res);
+
+    res = CShmRing_open(name);
+    assert(!CResult_is_error(res));
+    CShmRing_t *consumer = CResult_get(res);
+    CResult_free(&res);
+    assert(CShmRing_capacity(consumer) == 8192);
+    assert(CShmRing_push(producer, CStringView_from_c("named"), 0) ==
+           CSHMRING_SUCCESS);
+
+    // Handles share the positions; peeking consumes nothing.
+    res = CShmRing_from_fd(CShmRing_fd(producer));
+    assert(!CResult_is_error(res));
+    CShmRing_t *other = CResult_get(res);
+    CResult_free(&res);
+    CStringView_t record;
+    assert(CShmRing_peek(other, &record, 0) == CSHMRING_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("named")));
+    CShmRing_free(&other);
+
+    assert(CShmRing_peek(consumer, &record, 0) == CSHMRING_SUCCESS);
+    assert(CStringView_equals(record, CStringView_from_c("named")));
+    CShmRing_free(&consumer);
+    CShmRing_free(&producer);
+
+    assert(CShmRing_unlink(name) == CSHMRING_SUCCESS);
+    res = CShmRing_open(name);
+    assert(CError_get_code(CResult_eget(res)) == CSHMRING_IO_FAILURE);
+    CResult_free(&res);
+
+    // Regions that are not rings are refused.
+    res = CShmRing_from_fd(STDIN_FILENO);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    assert(CShmRing_push(NULL, CStringView_from_c("a"), 0) ==
+           CSHMRING_NULL_RING);
+    assert(CShmRing_peek(NULL, &record, 0) == CSHMRING_NULL_RING);
+    assert(CShmRing_fd(NULL) == -1);
+    assert(CShmRing_free(NULL) == CSHMRING_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+
+    test_single();
+    test_processes();
+    test_open();
+    return 0;
+}
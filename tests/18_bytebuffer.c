@@ -0,0 +1,217 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CByteBuffer.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_MAX 10000
+
+void test_fixed() {
+    CLog(INFO, "test_fixed()");
+    CResult_t *res = CByteBuffer_new(0);
+    assert(!CResult_is_error(res));
+    CByteBuffer_t *buffer = CResult_get(res);
+    CResult_free(&res);
+    assert(CByteBuffer_put_u8(buffer, 0xab) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u16le(buffer, 0x0102) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u16be(buffer, 0x0102) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u32le(buffer, 0x01020304) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u32be(buffer, 0x01020304) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u64le(buffer, 0x0102030405060708) ==
+           CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_u64be(buffer, 0x0102030405060708) ==
+           CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_readable(buffer) == 1 + 2 * (2 + 4 + 8));
+
+    // The bytes are laid out in the requested order on any machine.
+    static const unsigned char expected[] = {
+        0xab, 2, 1, 1, 2, 4, 3, 2, 1, 1, 2, 3, 4,
+        8,    7, 6, 5, 4, 3, 2, 1, 1, 2, 3, 4, 5, 6, 7, 8};
+    CStringView_t view = CByteBuffer_view(buffer);
+    assert(view.len == sizeof(expected));
+    assert(memcmp(view.ptr, expected, sizeof(expected)) == 0);
+
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+    assert(CByteBuffer_get_u8(buffer, &u8) == CBYTEBUFFER_SUCCESS);
+    assert(u8 == 0xab);
+    assert(CByteBuffer_get_u16le(buffer, &u16) == CBYTEBUFFER_SUCCESS);
+    assert(u16 == 0x0102);
+    assert(CByteBuffer_get_u16be(buffer, &u16) == CBYTEBUFFER_SUCCESS);
+    assert(u16 == 0x0102);
+    assert(CByteBuffer_get_u32le(buffer, &u32) == CBYTEBUFFER_SUCCESS);
+    assert(u32 == 0x01020304);
+    assert(CByteBuffer_get_u32be(buffer, &u32) == CBYTEBUFFER_SUCCESS);
+    assert(u32 == 0x01020304);
+    assert(CByteBuffer_get_u64le(buffer, &u64) == CBYTEBUFFER_SUCCESS);
+    assert(u64 == 0x0102030405060708);
+    // A short read leaves the cursor alone.
+    CByteBuffer_skip(buffer, 1);
+    assert(CByteBuffer_get_u64be(buffer, &u64) == CBYTEBUFFER_UNDERFLOW);
+    assert(CByteBuffer_readable(buffer) == 7);
+    assert(CByteBuffer_get_u8(buffer, &u8) == CBYTEBUFFER_SUCCESS);
+    assert(u8 == 2);
+    CByteBuffer_free(&buffer);
+    assert(buffer == NULL);
+}
+
+void test_varint() {
+    CLog(INFO, "test_varint()");
+    CResult_t *res = CByteBuffer_new(16);
+    assert(!CResult_is_error(res));
+    CByteBuffer_t *buffer = CResult_get(res);
+    CResult_free(&res);
+    static const uint64_t values[] = {0,          1,          127,
+                                      128,        300,        16383,
+                                      16384,      UINT32_MAX, INT64_MAX,
+                                      UINT64_MAX};
+    static const size_t sizes[] = {1, 1, 1, 2, 2, 2, 3, 5, 9, 10};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        size_t before = CByteBuffer_readable(buffer);
+        assert(CByteBuffer_put_varint(buffer, values[i]) ==
+               CBYTEBUFFER_SUCCESS);
+        assert(CByteBuffer_readable(buffer) - before == sizes[i]);
+    }
+    // 300 is the classic example.
+    CStringView_t slice;
+    assert(CByteBuffer_slice(buffer, 5, 7, &slice) == CBYTEBUFFER_SUCCESS);
+    assert(memcmp(slice.ptr, "\xac\x02", 2) == 0);
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint64_t value;
+        assert(CByteBuffer_get_varint(buffer, &value) == CBYTEBUFFER_SUCCESS);
+        assert(value == values[i]);
+    }
+
+    for (int64_t i = -TEST_MAX; i <= TEST_MAX; i++)
+        assert(CByteBuffer_put_svarint(buffer, i * 997) ==
+               CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_svarint(buffer, INT64_MIN) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put_svarint(buffer, -1) == CBYTEBUFFER_SUCCESS);
+    for (int64_t i = -TEST_MAX; i <= TEST_MAX; i++) {
+        int64_t value;
+        assert(CByteBuffer_get_svarint(buffer, &value) ==
+               CBYTEBUFFER_SUCCESS);
+        assert(value == i * 997);
+    }
+    int64_t value;
+    assert(CByteBuffer_get_svarint(buffer, &value) == CBYTEBUFFER_SUCCESS);
+    assert(value == INT64_MIN);
+    // Small negative numbers stay small.
+    assert(CByteBuffer_readable(buffer) == 1);
+    assert(CByteBuffer_get_svarint(buffer, &value) == CBYTEBUFFER_SUCCESS);
+    assert(value == -1);
+
+    // Cut short, then completed.
+    uint64_t u64;
+    assert(CByteBuffer_put(buffer, "\xff\xff", 2) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) == CBYTEBUFFER_UNDERFLOW);
+    assert(CByteBuffer_put_u8(buffer, 0x03) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) == CBYTEBUFFER_SUCCESS);
+    assert(u64 == 0xffff);
+    // Eleven bytes, or a tenth byte past 64 bits.
+    assert(CByteBuffer_put(buffer, "\xff\xff\xff\xff\xff\xff\xff\xff\xff\x02",
+                           10) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) ==
+           CBYTEBUFFER_INVALID_VARINT);
+    // Padded forms of a shorter encoding are refused too.
+    assert(CByteBuffer_clear(buffer) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put(buffer, "\x80\x00", 2) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) ==
+           CBYTEBUFFER_INVALID_VARINT);
+    assert(CByteBuffer_clear(buffer) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put(buffer, "\x81\x80\x00", 3) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) ==
+           CBYTEBUFFER_INVALID_VARINT);
+    assert(CByteBuffer_clear(buffer) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_put(buffer, "\x00", 1) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_get_varint(buffer, &u64) == CBYTEBUFFER_SUCCESS);
+    assert(u64 == 0);
+    CByteBuffer_free(&buffer);
+}
+
+void test_cursors() {
+    CLog(INFO, "test_cursors()");
+    CResult_t *res = CByteBuffer_new(64);
+    assert(!CResult_is_error(res));
+    CByteBuffer_t *buffer = CResult_get(res);
+    CResult_free(&res);
+    assert(CByteBuffer_writable(buffer) == 64);
+    // Reading straight into the room, as from a socket.
+    memcpy(CByteBuffer_write_ptr(buffer), "frame-one|frame-two|", 20);
+    assert(CByteBuffer_commit(buffer, 20) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_commit(buffer, 45) == CBYTEBUFFER_OUT_OF_RANGE);
+
+    CStringView_t frame;
+    assert(CByteBuffer_get_view(buffer, 10, &frame) == CBYTEBUFFER_SUCCESS);
+    assert(CStringView_equals(frame, CStringView_from_c("frame-one|")));
+    assert(CByteBuffer_slice(buffer, 6, 9, &frame) == CBYTEBUFFER_SUCCESS);
+    assert(CStringView_equals(frame, CStringView_from_c("two")));
+    assert(CByteBuffer_slice(buffer, 6, 11, &frame) ==
+           CBYTEBUFFER_OUT_OF_RANGE);
+
+    assert(CByteBuffer_compact(buffer) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_writable(buffer) == 54);
+    assert(CStringView_equals(CByteBuffer_view(buffer),
+                              CStringView_from_c("frame-two|")));
+
+    // Once half the buffer is consumed, reserving slides instead of growing.
+    char block[40] = {0};
+    assert(CByteBuffer_put(buffer, block, sizeof(block)) ==
+           CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_skip(buffer, 45) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_reserve(buffer, 40) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_readable(buffer) + CByteBuffer_writable(buffer) == 64);
+    assert(CByteBuffer_reserve(buffer, 100) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_writable(buffer) >= 100);
+    assert(CByteBuffer_readable(buffer) == 5);
+
+    assert(CByteBuffer_clear(buffer) == CBYTEBUFFER_SUCCESS);
+    assert(CByteBuffer_readable(buffer) == 0);
+    assert(CByteBuffer_skip(buffer, 1) == CBYTEBUFFER_UNDERFLOW);
+    CByteBuffer_free(&buffer);
+
+    assert(CByteBuffer_put_u8(NULL, 1) == CBYTEBUFFER_NULL_BUFFER);
+    assert(CByteBuffer_get_varint(NULL, NULL) == CBYTEBUFFER_NULL_BUFFER);
+    assert(CByteBuffer_readable(NULL) == 0);
+    assert(CByteBuffer_free(NULL) == CBYTEBUFFER_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+
+    test_fixed();
+    test_varint();
+    test_cursors();
+    return 0;
+}
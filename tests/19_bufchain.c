@@ -0,0 +1,223 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#include <cstd/CBufChain.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int released;
+
+static void count_release(void *owner) {
+    assert(strcmp(owner, "body") == 0);
+    released++;
+}
+
+void test_compose() {
+    CLog(INFO, "test_compose()");
+    static char body[] = "<html>cached</html>";
+    CResult_t *res = CBufSegment_wrap(CStringView_from_c(body),
+                                      count_release, "body");
+    assert(!CResult_is_error(res));
+    CBufSegment_t *cached = CResult_get(res);
+    CResult_free(&res);
+
+    res = CString_new();
+    CString_t *trailer = CResult_get(res);
+    CResult_free(&res);
+    CString_append_c(trailer, "\r\n0\r\n");
+
+    // Two responses share the cached body.
+    res = CBufChain_new();
+    assert(!CResult_is_error(res));
+    CBufChain_t *first = CResult_get(res);
+    CResult_free(&res);
+    res = CBufChain_new();
+    assert(!CResult_is_error(res));
+    CBufChain_t *second = CResult_get(res);
+    CResult_free(&res);
+    assert(CBufChain_append(first, cached, 0, sizeof(body) - 1) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_append_string(first, trailer) == CBUFCHAIN_SUCCESS);
+    assert(CBufChain_prepend(first, cached, 0, 0) == CBUFCHAIN_SUCCESS);
+    assert(CBufChain_append(second, cached, 6, 12) == CBUFCHAIN_SUCCESS);
+    assert(CBufChain_append(second, cached, 6, 100) ==
+           CBUFCHAIN_OUT_OF_RANGE);
+    CBufSegment_free(&cached);
+    assert(cached == NULL);
+
+    res = CBufSegment_new(CStringView_from_c("HTTP/1.1 200 OK\r\n\r\n"));
+    CBufSegment_t *header = CResult_get(res);
+    CResult_free(&res);
+    assert(CBufChain_prepend(first, header, 0, 17) == CBUFCHAIN_SUCCESS);
+    CBufSegment_free(&header);
+    // The string may change; the chain keeps what it was given.
+    CString_append_c(trailer, "changed");
+    CString_free(&trailer);
+
+    // Copying out reads the bytes without consuming them.
+    assert(CBufChain_count(first) == 3);
+    char buffer[256];
+    size_t len = CBufChain_copy_out(first, buffer, sizeof(buffer));
+    assert(len == CBufChain_size(first));
+    assert(CStringView_equals(
+        CStringView_from(buffer, len),
+        CStringView_from_c(
+            "HTTP/1.1 200 OK\r\n<html>cached</html>\r\n0\r\n")));
+    len = CBufChain_copy_out(second, buffer, sizeof(buffer));
+    assert(CStringView_equals(CStringView_from(buffer, len),
+                              CStringView_from_c("cached")));
+
+    struct iovec iov[8];
+    assert(CBufChain_to_iovec(first, iov, 8) == 3);
+    assert(iov[1].iov_base == body);
+    assert(CBufChain_to_iovec(first, iov, 2) == 2);
+
+    CBufChain_free(&first);
+    assert(released == 0);
+    CBufChain_free(&second);
+    assert(released == 1);
+}
+
+void test_copies() {
+    CLog(INFO, "test_copies()");
+    CResult_t *res = CBufChain_new();
+    assert(!CResult_is_error(res));
+    CBufChain_t *chain = CResult_get(res);
+    CResult_free(&res);
+    // Small copies share one range.
+    assert(CBufChain_append_copy(chain, CStringView_from_c("Content-")) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_append_copy(chain, CStringView_from_c("Length: 5")) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_count(chain) == 1);
+    char buffer[32];
+    size_t len = CBufChain_copy_out(chain, buffer, sizeof(buffer));
+    assert(CStringView_equals(CStringView_from(buffer, len),
+                              CStringView_from_c("Content-Length: 5")));
+
+    char big[10000];
+    memset(big, 'b', sizeof(big));
+    assert(CBufChain_append_copy(chain, CStringView_from(big, sizeof(big))) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_append_copy(chain, CStringView_from_c("!")) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_count(chain) == 3);
+    assert(CBufChain_size(chain) == 17 + sizeof(big) + 1);
+
+    // Moving ranges between chains leaves the source empty.
+    res = CBufChain_new();
+    assert(!CResult_is_error(res));
+    CBufChain_t *other = CResult_get(res);
+    CResult_free(&res);
+    assert(CBufChain_append_copy(other, CStringView_from_c("tail")) ==
+           CBUFCHAIN_SUCCESS);
+    assert(CBufChain_consume(chain, 17 + sizeof(big)) == CBUFCHAIN_SUCCESS);
+    assert(CBufChain_concat(chain, other) == CBUFCHAIN_SUCCESS);
+    assert(CBufChain_size(other) == 0);
+    assert(CBufChain_append_copy(other, CStringView_from_c("new")) ==
+           CBUFCHAIN_SUCCESS);
+    len = CBufChain_copy_out(other, buffer, sizeof(buffer));
+    assert(CStringView_equals(CStringView_from(buffer, len),
+                              CStringView_from_c("new")));
+    len = CBufChain_copy_out(chain, buffer, sizeof(buffer));
+    assert(CStringView_equals(CStringView_from(buffer, len),
+                              CStringView_from_c("!tail")));
+    assert(CBufChain_consume(chain, 6) == CBUFCHAIN_OUT_OF_RANGE);
+    assert(CBufChain_size(chain) == 0);
+    CBufChain_free(&other);
+    CBufChain_free(&chain);
+}
+
+void test_writev() {
+    CLog(INFO, "test_writev()");
+    int fds[2];
+    assert(pipe(fds) == 0);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+    // More bytes and ranges than the pipe and one `writev` take.
+    CResult_t *res = CBufChain_new();
+    assert(!CResult_is_error(res));
+    CBufChain_t *chain = CResult_get(res);
+    CResult_free(&res);
+    char block[1000];
+    size_t total = 0;
+    for (int i = 0; i < 200; i++) {
+        memset(block, 'a' + i % 26, sizeof(block));
+        res = CBufSegment_new(CStringView_from(block, 1000));
+        CBufSegment_t *segment = CResult_get(res);
+        CResult_free(&res);
+        CBufChain_append(chain, segment, 0, 1000);
+        CBufChain_append_copy(chain, CStringView_from_c("|"));
+        CBufSegment_free(&segment);
+        total += 1001;
+    }
+
+    size_t received = 0;
+    char byte, previous = 0;
+    while (CBufChain_size(chain)) {
+        ssize_t written = CBufChain_writev(chain, fds[1]);
+        assert(written > 0);
+        assert(CBufChain_size(chain) == total - received - (size_t)written);
+        // Drain the pipe, checking the stream is in order.
+        for (ssize_t i = 0; i < written; i++) {
+            assert(read(fds[0], &byte, 1) == 1);
+            if (byte != '|') {
+                assert(previous == '|' || previous == 0 || byte == previous);
+                previous = byte;
+            } else {
+                previous = '|';
+            }
+        }
+        received += (size_t)written;
+    }
+    assert(received == total);
+    assert(CBufChain_writev(chain, fds[1]) == 0);
+    CBufChain_free(&chain);
+    close(fds[0]);
+    close(fds[1]);
+
+    assert(CBufChain_append_copy(NULL, CStringView_from_c("a")) ==
+           CBUFCHAIN_NULL_CHAIN);
+    assert(CBufChain_size(NULL) == 0);
+    assert(CBufChain_free(NULL) == CBUFCHAIN_SUCCESS);
+    assert(CBufSegment_free(NULL) == CBUFCHAIN_SUCCESS);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+
+    test_compose();
+    test_copies();
+    test_writev();
+    return 0;
+}
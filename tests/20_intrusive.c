@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+#include <cstd/CIntrusiveList.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <string.h>
+
+typedef struct {
+    int id;
+    CListLink_t all;
+    CListLink_t idle;
+} Connection;
+
+/// Check the ids of the objects on the `all` list, front to back and back to
+/// front.
+static void expect(const CIntrusiveList_t *list, const int *ids, size_t n) {
+    assert(CIntrusiveList_size(list) == n);
+    size_t i = 0;
+    CINTRUSIVELIST_FOREACH(list, link) {
+        assert(i < n);
+        assert(CLISTLINK_ENTRY(link, Connection, all)->id == ids[i++]);
+    }
+    assert(i == n);
+    for (CListLink_t *link = CIntrusiveList_back(list); link != NULL;
+         link = CIntrusiveList_prev(list, link))
+        assert(CLISTLINK_ENTRY(link, Connection, all)->id == ids[--i]);
+    assert(i == 0);
+}
+
+void test_links() {
+    CLog(INFO, "test_links()");
+    Connection pool[5];
+    memset(pool, 0, sizeof(pool));
+    for (int i = 0; i < 5; i++)
+        pool[i].id = i;
+
+    CIntrusiveList_t all;
+    assert(CIntrusiveList_init(&all) == CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_front(&all) == NULL);
+    assert(CIntrusiveList_pop_back(&all) == NULL);
+    expect(&all, NULL, 0);
+
+    assert(!CListLink_is_linked(&pool[0].all));
+    assert(CIntrusiveList_push_back(&all, &pool[1].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_push_back(&all, &pool[3].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_push_front(&all, &pool[0].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_insert_before(&all, &pool[3].all, &pool[2].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_insert_after(&all, &pool[3].all, &pool[4].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    expect(&all, (int[]){0, 1, 2, 3, 4}, 5);
+    assert(CListLink_is_linked(&pool[0].all));
+
+    // A link is on one list at most.
+    assert(CIntrusiveList_push_back(&all, &pool[2].all) ==
+           CINTRUSIVELIST_ALREADY_LINKED);
+    assert(CIntrusiveList_insert_after(&all, &pool[0].idle, &pool[1].idle) ==
+           CINTRUSIVELIST_NOT_LINKED);
+
+    assert(CIntrusiveList_remove(&all, &pool[2].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(!CListLink_is_linked(&pool[2].all));
+    assert(CIntrusiveList_remove(&all, &pool[2].all) ==
+           CINTRUSIVELIST_NOT_LINKED);
+    expect(&all, (int[]){0, 1, 3, 4}, 4);
+
+    assert(CIntrusiveList_pop_front(&all) == &pool[0].all);
+    assert(CIntrusiveList_pop_back(&all) == &pool[4].all);
+    assert(!CListLink_is_linked(&pool[4].all));
+    expect(&all, (int[]){1, 3}, 2);
+
+    // A removed link can be added again, to any list.
+    assert(CIntrusiveList_push_front(&all, &pool[4].all) ==
+           CINTRUSIVELIST_SUCCESS);
+    expect(&all, (int[]){4, 1, 3}, 3);
+
+    assert(CIntrusiveList_clear(&all) == CINTRUSIVELIST_SUCCESS);
+    expect(&all, NULL, 0);
+    for (int i = 0; i < 5; i++)
+        assert(!CListLink_is_linked(&pool[i].all));
+
+    assert(CIntrusiveList_init(NULL) == CINTRUSIVELIST_NULL);
+    assert(CIntrusiveList_push_back(NULL, &pool[0].all) ==
+           CINTRUSIVELIST_NULL);
+    assert(CIntrusiveList_push_back(&all, NULL) == CINTRUSIVELIST_NULL);
+    assert(CIntrusiveList_remove(&all, NULL) == CINTRUSIVELIST_NULL);
+    assert(CIntrusiveList_size(NULL) == 0);
+}
+
+void test_several_lists() {
+    CLog(INFO, "test_several_lists()");
+    Connection pool[6];
+    memset(pool, 0, sizeof(pool));
+    CIntrusiveList_t all, idle, busy;
+    CIntrusiveList_init(&all);
+    CIntrusiveList_init(&idle);
+    CIntrusiveList_init(&busy);
+    for (int i = 0; i < 6; i++) {
+        pool[i].id = i;
+        CListLink_init(&pool[i].idle);
+        CIntrusiveList_push_back(&all, &pool[i].all);
+        CIntrusiveList_push_back(i % 2 ? &busy : &idle, &pool[i].idle);
+    }
+
+    // Removing while iterating.
+    CINTRUSIVELIST_FOREACH_SAFE(&idle, link, tmp) {
+        Connection *c = CLISTLINK_ENTRY(link, Connection, idle);
+        if (c->id != 2) {
+            CIntrusiveList_remove(&idle, link);
+            CIntrusiveList_push_front(&busy, link);
+        }
+    }
+    assert(CIntrusiveList_size(&idle) == 1);
+    assert(CIntrusiveList_size(&busy) == 5);
+    assert(CIntrusiveList_front(&busy) == &pool[4].idle);
+    expect(&all, (int[]){0, 1, 2, 3, 4, 5}, 6);
+
+    // Splicing moves the links without touching them.
+    assert(CIntrusiveList_splice(&idle, &busy) == CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_size(&busy) == 0);
+    assert(CIntrusiveList_front(&busy) == NULL);
+    assert(CIntrusiveList_size(&idle) == 6);
+    int order[] = {2, 4, 0, 1, 3, 5};
+    size_t i = 0;
+    CINTRUSIVELIST_FOREACH(&idle, link)
+        assert(CLISTLINK_ENTRY(link, Connection, idle)->id == order[i++]);
+    assert(CIntrusiveList_next(&idle, &pool[5].idle) == NULL);
+    assert(CIntrusiveList_prev(&idle, &pool[2].idle) == NULL);
+    assert(CIntrusiveList_splice(&idle, &busy) == CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_splice(&idle, &idle) == CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_size(&idle) == 6);
+
+    // The lists still work after splicing.
+    assert(CIntrusiveList_pop_back(&idle) == &pool[5].idle);
+    assert(CIntrusiveList_push_back(&busy, &pool[5].idle) ==
+           CINTRUSIVELIST_SUCCESS);
+    assert(CIntrusiveList_back(&busy) == &pool[5].idle);
+    assert(CIntrusiveList_back(&idle) == &pool[3].idle);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+
+    test_links();
+    test_several_lists();
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Subhadip Roy Chowdhury
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+#include <cstd/CDeque.h>
+#include <cstd/CLog.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_ends() {
+    CLog(INFO, "test_ends()");
+    CResult_t *res = CDeque_new(NULL);
+    assert(!CResult_is_error(res));
+    CDeque_t *deque = CResult_get(res);
+    CResult_free(&res);
+    assert(CDeque_size(deque) == 0);
+    assert(CDeque_fpop_front(deque) == NULL);
+    assert(CDeque_fpop_back(deque) == NULL);
+
+    res = CDeque_pop_front(deque);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CDEQUE_EMPTY);
+    CResult_free(&res);
+
+    // Pushing at the front wraps around the block map.
+    for (intptr_t i = 0; i < 10; i++)
+        assert(CDeque_push_back(deque, (void *)(i + 10)) == CDEQUE_SUCCESS);
+    for (intptr_t i = 9; i >= 0; i--)
+        assert(CDeque_push_front(deque, (void *)i) == CDEQUE_SUCCESS);
+    assert(CDeque_size(deque) == 20);
+    for (size_t i = 0; i < 20; i++)
+        assert((intptr_t)CDeque_fget(deque, i) == (intptr_t)i);
+    assert(CDeque_fget(deque, 20) == NULL);
+
+    res = CDeque_pop_front(deque);
+    assert(!CResult_is_error(res));
+    assert((intptr_t)CResult_get(res) == 0);
+    CResult_free(&res);
+    res = CDeque_pop_back(deque);
+    assert((intptr_t)CResult_get(res) == 19);
+    CResult_free(&res);
+    assert((intptr_t)CDeque_fpop_back(deque) == 18);
+    assert((intptr_t)CDeque_fpop_front(deque) == 1);
+    assert(CDeque_size(deque) == 16);
+    for (size_t i = 0; i < 16; i++)
+        assert((intptr_t)CDeque_fget(deque, i) == 2 + (intptr_t)i);
+
+    res = CDeque_get(deque, 3);
+    assert((intptr_t)CResult_get(res) == 5);
+    CResult_free(&res);
+    res = CDeque_get(deque, 16);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CDEQUE_INDEX_OUT_OF_BOUNDS);
+    CResult_free(&res);
+
+    assert(CDeque_set(deque, 0, (void *)100) == CDEQUE_SUCCESS);
+    assert((intptr_t)CDeque_fget(deque, 0) == 100);
+    assert(CDeque_set(deque, 16, NULL) == CDEQUE_INDEX_OUT_OF_BOUNDS);
+
+    while (CDeque_size(deque) > 0)
+        CDeque_fpop_front(deque);
+    assert(CDeque_fpop_front(deque) == NULL);
+    CDeque_free(&deque);
+    assert(deque == NULL);
+}
+
+void test_growth() {
+    CLog(INFO, "test_growth()");
+    CResult_t *res = CDeque_new(NULL);
+    assert(!CResult_is_error(res));
+    CDeque_t *deque = CResult_get(res);
+    CResult_free(&res);
+
+    // Both ends grow past several map doublings, from a start in the middle
+    // of a block.
+    for (intptr_t i = 0; i < 30; i++)
+        CDeque_push_back(deque, (void *)i);
+    for (intptr_t i = 0; i < 25; i++)
+        assert((intptr_t)CDeque_fpop_front(deque) == i);
+    for (intptr_t i = 30; i < 5000; i++)
+        assert(CDeque_push_back(deque, (void *)i) == CDEQUE_SUCCESS);
+    for (intptr_t i = 24; i >= -5000; i--)
+        assert(CDeque_push_front(deque, (void *)i) == CDEQUE_SUCCESS);
+    assert(CDeque_size(deque) == 10000);
+    for (size_t i = 0; i < 10000; i++)
+        assert((intptr_t)CDeque_fget(deque, i) == -5000 + (intptr_t)i);
+
+    // Popping from the back and pushing at the front moves the deque round
+    // the map without growing it.
+    for (intptr_t i = -5001; i > -20000; i--) {
+        CDeque_fpop_back(deque);
+        CDeque_push_front(deque, (void *)i);
+    }
+    assert(CDeque_size(deque) == 10000);
+    for (size_t i = 0; i < 10000; i++)
+        assert((intptr_t)CDeque_fget(deque, i) == -19999 + (intptr_t)i);
+    assert(CDeque_fget(deque, 10000) == NULL);
+
+    // Draining frees the emptied blocks; refilling takes spares first.
+    for (intptr_t i = -19999; i < -10009; i++)
+        assert((intptr_t)CDeque_fpop_front(deque) == i);
+    assert(CDeque_size(deque) == 10);
+    for (intptr_t i = -10010; i >= -15000; i--)
+        assert(CDeque_push_front(deque, (void *)i) == CDEQUE_SUCCESS);
+    while (CDeque_size(deque) > 1)
+        CDeque_fpop_back(deque);
+    assert((intptr_t)CDeque_fpop_back(deque) == -15000);
+    assert(CDeque_fpop_back(deque) == NULL);
+    for (intptr_t i = 0; i < 200; i++)
+        assert(CDeque_push_back(deque, (void *)i) == CDEQUE_SUCCESS);
+    assert(CDeque_size(deque) == 200);
+    assert((intptr_t)CDeque_fget(deque, 199) == 199);
+
+    assert(CDeque_clear(deque) == CDEQUE_SUCCESS);
+    assert(CDeque_size(deque) == 0);
+    assert(CDeque_fget(deque, 0) == NULL);
+    CDeque_push_front(deque, (void *)7);
+    assert(CDeque_size(deque) == 1);
+    assert((intptr_t)CDeque_fget(deque, 0) == 7);
+    CDeque_free(&deque);
+}
+
+void test_window() {
+    CLog(INFO, "test_window()");
+    CResult_t *res = CDeque_new(free);
+    assert(!CResult_is_error(res));
+    CDeque_t *deque = CResult_get(res);
+    CResult_free(&res);
+
+    // A sliding window keeps the last 100 values.
+    for (int i = 0; i < 1000; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        CDeque_push_back(deque, value);
+        if (CDeque_size(deque) > 100)
+            free(CDeque_fpop_front(deque));
+    }
+    assert(CDeque_size(deque) == 100);
+    assert(*(int *)CDeque_fget(deque, 0) == 900);
+    assert(*(int *)CDeque_fget(deque, 99) == 999);
+
+    // The destructor frees what is left.
+    CDeque_free(&deque);
+
+    assert(CDeque_push_back(NULL, NULL) == CDEQUE_NULL_DEQUE);
+    assert(CDeque_push_front(NULL, NULL) == CDEQUE_NULL_DEQUE);
+    assert(CDeque_fpop_front(NULL) == NULL);
+    assert(CDeque_size(NULL) == 0);
+    assert(CDeque_clear(NULL) == CDEQUE_NULL_DEQUE);
+    assert(CDeque_free(NULL) == CDEQUE_SUCCESS);
+    res = CDeque_pop_back(NULL);
+    assert(CError_get_code(CResult_eget(res)) == CDEQUE_NULL_DEQUE);
+    CResult_free(&res);
+}
+
+int main() {
+    // enable_debugging();
+    enable_location();
+    shortened_location();
+
+    test_ends();
+    test_growth();
+    test_window();
+    return 0;
+}
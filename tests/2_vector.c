@@ -25,8 +25,11 @@
 #include <assert.h>
 #include <cstd/CLog.h>
 #include <cstd/CVector.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 int test_strings() {
     CLog(INFO, "test_strings()");
@@ -310,6 +313,169 @@ int test_reserve() {
     return 0;
 }
 
+typedef struct {
+    double x, y;
+} Point;
+
+size_t serialize_point(const void *data, void *buffer, size_t size) {
+    if (size >= sizeof(Point))
+        memcpy(buffer, data, sizeof(Point));
+    return sizeof(Point);
+}
+
+int test_snapshot() {
+    CLog(INFO, "test_snapshot()");
+    CResult_t *res = CVector_new(4, free);
+    assert(!CResult_is_error(res));
+    CVector_t *vec = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < 10000; i++) {
+        Point *point = NULL;
+        if (i % 100) {
+            point = malloc(sizeof(Point));
+            *point = (Point){i, -i};
+        }
+        assert(CVector_add(vec, point) == CVECTOR_SUCCESS);
+    }
+
+    char path[] = "/tmp/cstd_vector_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(CVector_save(vec, path, serialize_point) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    res = CVector_load(path, free);
+    assert(!CResult_is_error(res));
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 10000);
+    for (int i = 0; i < 10000; i++) {
+        Point *point = CVector_fget(vec, i);
+        assert((point == NULL) == (i % 100 == 0));
+        assert(point == NULL || (point->x == i && point->y == -i));
+    }
+
+    // Growing moves the table out of the snapshot; replacing an element from
+    // the snapshot must not free it.
+    Point *point = malloc(sizeof(Point));
+    *point = (Point){-1, -1};
+    assert(CVector_set(vec, 1, point) == CVECTOR_SUCCESS);
+    for (int i = 0; i < 100; i++) {
+        point = malloc(sizeof(Point));
+        *point = (Point){i, i};
+        assert(CVector_add(vec, point) == CVECTOR_SUCCESS);
+    }
+    assert(((Point *)CVector_fget(vec, 2))->x == 2);
+    assert(((Point *)CVector_fget(vec, 1))->x == -1);
+    assert(CVector_size(vec) == 10100);
+
+    // A loaded vector can be saved over the file it still reads from.
+    assert(CVector_save(vec, path, serialize_point) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+    res = CVector_load(path, free);
+    assert(!CResult_is_error(res));
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 10100);
+    assert(((Point *)CVector_fget(vec, 1))->x == -1);
+    assert(((Point *)CVector_fget(vec, 9999))->y == -9999);
+    assert(((Point *)CVector_fget(vec, 10099))->x == 99);
+    assert(CVector_save(vec, path, serialize_point) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    // Empty vectors round trip too.
+    res = CVector_new(4, NULL);
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_save(vec, path, serialize_point) == CVECTOR_SUCCESS);
+    CVector_free(&vec);
+    res = CVector_load(path, NULL);
+    assert(!CResult_is_error(res));
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 0);
+    assert(CVector_add(vec, path) == CVECTOR_SUCCESS);
+    assert(CVector_fget(vec, 0) == path);
+    CVector_free(&vec);
+
+    res = CVector_load("/nonexistent/cstd_vector", NULL);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    unlink(path);
+    return 0;
+}
+
+int test_mapped() {
+    CLog(INFO, "test_mapped()");
+    // Anonymous storage grows in place of realloc.
+    CResult_t *res = CVector_new_mapped(16, free, NULL);
+    assert(!CResult_is_error(res));
+    CVector_t *vec = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < 100000; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        assert(CVector_add(vec, value) == CVECTOR_SUCCESS);
+    }
+    for (int i = 0; i < 100000; i += 997)
+        assert(*(int *)CVector_fget(vec, i) == i);
+    assert(CVector_sync(vec) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    // File-backed storage survives being freed and reopened.
+    char path[] = "/tmp/cstd_mapped_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    res = CVector_new_mapped(0, NULL, path);
+    assert(!CResult_is_error(res));
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 0);
+    for (uintptr_t i = 0; i < 1000000; i++)
+        assert(CVector_add(vec, (void *)(i * 3)) == CVECTOR_SUCCESS);
+    assert(CVector_sync(vec) == CVECTOR_SUCCESS);
+    // The file is allocated as it grows, not left sparse.
+    struct stat st;
+    assert(stat(path, &st) == 0);
+    assert((off_t)st.st_blocks * 512 >= st.st_size);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    res = CVector_new_mapped(0, NULL, path);
+    assert(!CResult_is_error(res));
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 1000000);
+    for (uintptr_t i = 0; i < 1000000; i++)
+        assert(CVector_fget(vec, i) == (void *)(i * 3));
+    assert(CVector_del(vec, 0) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    res = CVector_new_mapped(0, NULL, path);
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 999999);
+    assert(CVector_fget(vec, 0) == (void *)3);
+    assert(CVector_clear(vec) == CVECTOR_SUCCESS);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+    res = CVector_new_mapped(0, NULL, path);
+    vec = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(vec) == 0);
+    assert(CVector_free(&vec) == CVECTOR_SUCCESS);
+
+    // Other files are left alone.
+    FILE *file = fopen(path, "w");
+    fputs("not a vector, but long enough to have a header", file);
+    fclose(file);
+    res = CVector_new_mapped(0, NULL, path);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    unlink(path);
+    return 0;
+}
+
 int main() {
     // enable_debugging();
     enable_location();
@@ -324,6 +490,8 @@ int main() {
     assert(!test_free());
     assert(!test_copy());
     assert(!test_reserve());
+    assert(!test_snapshot());
+    assert(!test_mapped());
 
     return 0;
 }
\ No newline at end of file
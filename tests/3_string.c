@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <cstd/CLog.h>
 #include <cstd/CString.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -71,11 +72,558 @@ int test_at() {
     return 0;
 }
 
+int test_view() {
+    CLog(INFO, "test_view()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_append_c(str, TEST_STRING) == CSTRING_SUCCESS);
+
+    CStringView_t view = CString_view(str);
+    assert(view.len == strlen(TEST_STRING));
+    assert(CStringView_equals(view, CStringView_from_c(TEST_STRING)));
+    assert(CStringView_hash(view) ==
+           CStringView_hash(CStringView_from_c(TEST_STRING)));
+
+    CStringView_t word = CString_slice(str, 5, 7);
+    assert(CStringView_equals(word, CStringView_from_c("IS")));
+    assert(!CStringView_equals(word, CStringView_from_c("IT")));
+    assert(CStringView_slice(word, 1, 100).len == 1);
+    assert(CStringView_slice(view, 10, 5).len == 0);
+
+    res = CString_from_view(CStringView_slice(view, 10, 21));
+    assert(!CResult_is_error(res));
+    CString_t *owned = CResult_get(res);
+    CResult_free(&res);
+    assert(CStringView_equals(CString_view(owned),
+                              CStringView_from_c("TEST STRING")));
+
+    res = CString_substring(str, 10, 13);
+    assert(!CResult_is_error(res));
+    CString_t *sub = CResult_get(res);
+    CResult_free(&res);
+    assert(CStringView_equals(CString_view(sub), CStringView_from_c("TEST")));
+
+    res = CString_clone(str);
+    assert(!CResult_is_error(res));
+    CString_t *copy = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_equals(copy, str));
+    assert(CString_append(copy, copy) == CSTRING_SUCCESS);
+    assert(CString_length(copy) == 2 * CString_length(str));
+
+    CString_free(&copy);
+    CString_free(&sub);
+    CString_free(&owned);
+    CString_free(&str);
+    return 0;
+}
+
+static size_t naive_find(const char *h, size_t len, const char *n,
+                         size_t nlen, int last) {
+    size_t found = CSTRINGVIEW_NOT_FOUND;
+    for (size_t i = 0; i + nlen <= len; i++) {
+        if (memcmp(h + i, n, nlen) == 0) {
+            found = i;
+            if (!last)
+                break;
+        }
+    }
+    return found;
+}
+
+int test_search() {
+    CLog(INFO, "test_search()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_append_c(str, "key=value; path=/a/b/c; key=other") ==
+           CSTRING_SUCCESS);
+
+    assert(CString_find(str, CStringView_from_c("key")) == 0);
+    assert(CString_rfind(str, CStringView_from_c("key")) == 24);
+    assert(CString_find(str, CStringView_from_c("path")) == 11);
+    assert(CString_find(str, CStringView_from_c("nope")) ==
+           CSTRINGVIEW_NOT_FOUND);
+    assert(CString_contains(str, CStringView_from_c("/a/b")));
+    assert(CString_find_char(str, ';') == 9);
+    assert(CString_find_any(str, CStringView_from_c("/;")) == 9);
+    assert(CString_count(str, CStringView_from_c("key")) == 2);
+    assert(CString_count(str, CStringView_from_c("/")) == 3);
+
+    // Cross-check the vectorized paths against a naive search.
+    char hay[300];
+    char needle[8];
+    for (int round = 0; round < 2000; round++) {
+        size_t len = (size_t)(rand() % 300);
+        size_t nlen = 1 + (size_t)(rand() % 7);
+        for (size_t i = 0; i < len; i++)
+            hay[i] = "abc"[rand() % 3];
+        for (size_t i = 0; i < nlen; i++)
+            needle[i] = "abc"[rand() % 3];
+        CStringView_t h = CStringView_from(hay, len);
+        CStringView_t n = CStringView_from(needle, nlen);
+        assert(CStringView_find(h, n) == naive_find(hay, len, needle, nlen, 0));
+        assert(CStringView_rfind(h, n) ==
+               naive_find(hay, len, needle, nlen, 1));
+        assert(CStringView_find_char(h, 'c') ==
+               naive_find(hay, len, "c", 1, 0));
+
+        size_t count = 0;
+        for (size_t i = 0; i < len; i++)
+            count += hay[i] == 'b';
+        assert(CStringView_count(h, CStringView_from_c("b")) == count);
+    }
+
+    CString_free(&str);
+    return 0;
+}
+
+int test_split() {
+    CLog(INFO, "test_split()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_append_c(str, "id,,name,age") == CSTRING_SUCCESS);
+
+    const char *fields[] = {"id", "", "name", "age"};
+    CStringSplit_t iter = CString_split_iter(str, CStringView_from_c(","));
+    CStringView_t token;
+    size_t n = 0;
+    while (CStringSplit_next(&iter, &token)) {
+        assert(n < 4);
+        assert(CStringView_equals(token, CStringView_from_c(fields[n])));
+        n++;
+    }
+    assert(n == 4);
+    assert(!CStringSplit_next(&iter, &token));
+
+    const char *lines[] = {"first", "", "third"};
+    iter = CStringView_lines_iter(CStringView_from_c("first\r\n\nthird\n"));
+    n = 0;
+    while (CStringSplit_next(&iter, &token)) {
+        assert(n < 3);
+        assert(CStringView_equals(token, CStringView_from_c(lines[n])));
+        n++;
+    }
+    assert(n == 3);
+    iter = CStringView_lines_iter(CStringView_from_c(""));
+    assert(!CStringSplit_next(&iter, &token));
+
+    res = CStringView_split_collect(CString_view(str), CStringView_from_c(","));
+    assert(!CResult_is_error(res));
+    CVector_t *tokens = CResult_get(res);
+    CResult_free(&res);
+    assert(CVector_size(tokens) == 4);
+    for (size_t i = 0; i < 4; i++) {
+        CStringView_t *view = CVector_fget(tokens, i);
+        assert(CStringView_equals(*view, CStringView_from_c(fields[i])));
+    }
+    CVector_free(&tokens);
+
+    CString_free(&str);
+    return 0;
+}
+
+int test_appendf() {
+    CLog(INFO, "test_appendf()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+
+    assert(CString_reserve(str, 4) == CSTRING_SUCCESS);
+    assert(CString_appendf(str, "%s=%d", "id", 42) == CSTRING_SUCCESS);
+    assert(CString_append_n(str, "; tail", 1) == CSTRING_SUCCESS);
+    assert(CStringView_equals(CString_view(str), CStringView_from_c("id=42;")));
+
+    // Force the retry path with output well past the current capacity.
+    char expected[512] = "id=42;";
+    for (int i = 0; i < 40; i++) {
+        assert(CString_appendf(str, "[%08d]", i) == CSTRING_SUCCESS);
+        sprintf(expected + strlen(expected), "[%08d]", i);
+    }
+    assert(CStringView_equals(CString_view(str), CStringView_from_c(expected)));
+
+    res = CString_c_str(str);
+    assert(!CResult_is_error(res));
+    assert(strcmp(CResult_get(res), expected) == 0);
+    CResult_free(&res);
+
+    assert(CString_clear(str) == CSTRING_SUCCESS);
+    assert(CString_appendf(str, "%s", "after clear") == CSTRING_SUCCESS);
+    assert(CString_length(str) == strlen("after clear"));
+
+    CString_free(&str);
+    return 0;
+}
+
+int test_numbers() {
+    CLog(INFO, "test_numbers()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+
+    assert(CString_append_u64(str, UINT64_MAX) == CSTRING_SUCCESS);
+    assert(CString_append_c(str, " ") == CSTRING_SUCCESS);
+    assert(CString_append_i64(str, INT64_MIN) == CSTRING_SUCCESS);
+    assert(CString_append_c(str, " ") == CSTRING_SUCCESS);
+    assert(CString_append_i64(str, 0) == CSTRING_SUCCESS);
+    assert(CStringView_equals(
+        CString_view(str),
+        CStringView_from_c("18446744073709551615 -9223372036854775808 0")));
+
+    // Powers of two have a closer neighbour below than above, and the
+    // smallest subnormals have a single significant digit.
+    const double doubles[] = {
+        0.1,    -2.5,   100,     1e21,   1.5e-7, 123456.789, 5e-324,
+        1.7976931348623157e308,  0.3,    1e23,   7e-323,
+        2.2250738585072014e-308, 0x1p1023,       0x1p-1000};
+    const char *expected[] = {
+        "0.1",    "-2.5",   "100",   "1e+21",  "1.5e-7", "123456.789",
+        "5e-324", "1.7976931348623157e+308",   "0.3",    "1e+23",
+        "7e-323", "2.2250738585072014e-308",   "8.98846567431158e+307",
+        "9.332636185032189e-302"};
+    for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+        assert(CString_set(str, "") == CSTRING_SUCCESS);
+        assert(CString_append_double(str, doubles[i]) == CSTRING_SUCCESS);
+        assert(CStringView_equals(CString_view(str),
+                                  CStringView_from_c(expected[i])));
+        double parsed;
+        assert(CString_parse_double(str, &parsed) == CSTRINGVIEW_SUCCESS);
+        assert(parsed == doubles[i]);
+    }
+
+    // Random doubles must round-trip through their shortest form.
+    for (int i = 0; i < 10000; i++) {
+        uint64_t bits = ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^
+                        (uint64_t)rand();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (value != value)
+            continue;
+        assert(CString_set(str, "") == CSTRING_SUCCESS);
+        assert(CString_append_double(str, value) == CSTRING_SUCCESS);
+        double parsed;
+        assert(CString_parse_double(str, &parsed) == CSTRINGVIEW_SUCCESS);
+        assert(parsed == value);
+    }
+
+    int64_t n;
+    assert(CStringView_parse_i64(CStringView_from_c("-1234567890123"), &n) ==
+           CSTRINGVIEW_SUCCESS);
+    assert(n == -1234567890123LL);
+    assert(CStringView_parse_i64(CStringView_from_c("9223372036854775807"),
+                                 &n) == CSTRINGVIEW_SUCCESS);
+    assert(n == INT64_MAX);
+    assert(CStringView_parse_i64(CStringView_from_c("-9223372036854775808"),
+                                 &n) == CSTRINGVIEW_SUCCESS);
+    assert(n == INT64_MIN);
+    assert(CStringView_parse_i64(CStringView_from_c("9223372036854775808"),
+                                 &n) == CSTRINGVIEW_OUT_OF_RANGE);
+    assert(CStringView_parse_i64(CStringView_from_c("123456789012345678901"),
+                                 &n) == CSTRINGVIEW_OUT_OF_RANGE);
+    assert(CStringView_parse_i64(CStringView_from_c("00000000000000000000042"),
+                                 &n) == CSTRINGVIEW_SUCCESS);
+    assert(n == 42);
+    assert(CStringView_parse_i64(CStringView_from_c("12a"), &n) ==
+           CSTRINGVIEW_INVALID_NUMBER);
+    assert(CStringView_parse_i64(CStringView_from_c("-"), &n) ==
+           CSTRINGVIEW_INVALID_NUMBER);
+
+    double d;
+    assert(CStringView_parse_double(CStringView_from_c("-12.5e3"), &d) ==
+           CSTRINGVIEW_SUCCESS);
+    assert(d == -12500.0);
+    assert(CStringView_parse_double(CStringView_from_c("1e400"), &d) ==
+           CSTRINGVIEW_OUT_OF_RANGE);
+    assert(CStringView_parse_double(CStringView_from_c(" 1"), &d) ==
+           CSTRINGVIEW_INVALID_NUMBER);
+    assert(CStringView_parse_double(CStringView_from_c("1.5x"), &d) ==
+           CSTRINGVIEW_INVALID_NUMBER);
+
+    CString_free(&str);
+    return 0;
+}
+
+int test_clone() {
+    CLog(INFO, "test_clone()");
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_set(str, TEST_STRING) == CSTRING_SUCCESS);
+
+    // Clones share the characters until one of them is modified.
+    CString_t *clones[4];
+    for (int i = 0; i < 4; i++) {
+        res = CString_clone(str);
+        assert(!CResult_is_error(res));
+        clones[i] = CResult_get(res);
+        CResult_free(&res);
+        assert(CString_view(clones[i]).ptr == CString_view(str).ptr);
+    }
+
+    assert(CString_append_c(clones[0], "!") == CSTRING_SUCCESS);
+    assert(CString_view(clones[0]).ptr != CString_view(str).ptr);
+    assert(CStringView_equals(CString_view(clones[0]),
+                              CStringView_from_c(TEST_STRING "!")));
+    assert(CStringView_equals(CString_view(str),
+                              CStringView_from_c(TEST_STRING)));
+
+    // Modifying through the original leaves the clones untouched.
+    assert(CString_set(str, "changed") == CSTRING_SUCCESS);
+    assert(CStringView_equals(CString_view(clones[1]),
+                              CStringView_from_c(TEST_STRING)));
+
+    // The last two clones still share, and outlive the original.
+    CString_free(&str);
+    assert(CString_view(clones[2]).ptr == CString_view(clones[3]).ptr);
+    assert(CString_reserve(clones[2], 4) == CSTRING_SUCCESS);
+    assert(CString_view(clones[2]).ptr != CString_view(clones[3]).ptr);
+    assert(CString_appendf(clones[3], "%d", 42) == CSTRING_SUCCESS);
+    assert(CStringView_equals(CString_view(clones[2]),
+                              CStringView_from_c(TEST_STRING)));
+    assert(CStringView_equals(CString_view(clones[3]),
+                              CStringView_from_c(TEST_STRING "42")));
+
+    // Cached hashes follow the characters through clones and modifications.
+    size_t hash = CString_hash(clones[2]);
+    assert(hash == CStringView_hash(CStringView_from_c(TEST_STRING)));
+    assert(CString_hash(clones[2]) == hash);
+    assert(CString_hash(clones[3]) != hash);
+    assert(CString_set(clones[3], TEST_STRING) == CSTRING_SUCCESS);
+    assert(CString_hash(clones[3]) == hash);
+
+    // A clone shares the cache, and modifying it leaves the original's alone.
+    CString_free(&clones[0]);
+    res = CString_clone(clones[2]);
+    assert(!CResult_is_error(res));
+    clones[0] = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_hash(clones[0]) == hash);
+    assert(CString_append_c(clones[0], "?") == CSTRING_SUCCESS);
+    assert(CString_hash(clones[0]) != hash);
+    assert(CString_hash(clones[2]) == hash);
+
+    for (int i = 0; i < 4; i++)
+        CString_free(&clones[i]);
+    return 0;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    int64_t order =
+        CString_compare(*(CString_t *const *)a, *(CString_t *const *)b);
+    return (order > 0) - (order < 0);
+}
+
+int test_compare() {
+    CLog(INFO, "test_compare()");
+    // Short strings over a small alphabet give plenty of prefixes and ties,
+    // and the high byte checks that characters compare as unsigned.
+    const char alphabet[] = {'a', 'b', (char)0xE9};
+    CString_t *strings[500];
+    for (int i = 0; i < 500; i++) {
+        CResult_t *res = CString_new();
+        assert(!CResult_is_error(res));
+        strings[i] = CResult_get(res);
+        CResult_free(&res);
+        int len = rand() % 6;
+        for (int k = 0; k < len; k++)
+            assert(CString_append_n(strings[i], &alphabet[rand() % 3], 1) ==
+                   CSTRING_SUCCESS);
+    }
+
+    qsort(strings, 500, sizeof(CString_t *), compare_entries);
+    for (int i = 1; i < 500; i++) {
+        CStringView_t prev = CString_view(strings[i - 1]);
+        CStringView_t cur = CString_view(strings[i]);
+        size_t common = CStringView_common_prefix(prev, cur);
+        // Sorted neighbours differ first at a larger byte, or are prefixes.
+        assert(common == prev.len ||
+               (common < cur.len && (unsigned char)prev.ptr[common] <
+                                        (unsigned char)cur.ptr[common]));
+        assert(CString_starts_with(strings[i], CStringView_slice(prev, 0,
+                                                                 common)));
+        assert(CString_equals(strings[i - 1], strings[i]) ==
+               (CStringView_compare(prev, cur) == 0));
+    }
+    for (int i = 0; i < 500; i++)
+        CString_free(&strings[i]);
+
+    // Long common prefixes exercise the vector loop of the mismatch search.
+    char a[300], b[300];
+    for (size_t i = 0; i < sizeof(a); i++)
+        a[i] = b[i] = (char)('a' + i % 26);
+    for (size_t at = 0; at < sizeof(a); at++) {
+        b[at] = '#';
+        CStringView_t va = CStringView_from(a, sizeof(a));
+        CStringView_t vb = CStringView_from(b, sizeof(b));
+        assert(CStringView_common_prefix(va, vb) == at);
+        assert(CStringView_compare(va, vb) == 1);
+        assert(CStringView_compare(vb, va) == -1);
+        b[at] = a[at];
+    }
+
+    CStringView_t path = CStringView_from_c("/api/v1/users");
+    assert(CStringView_starts_with(path, CStringView_from_c("/api/")));
+    assert(!CStringView_starts_with(path, CStringView_from_c("/apix")));
+    assert(CStringView_ends_with(path, CStringView_from_c("users")));
+    assert(CStringView_ends_with(path, CStringView_from_c("")));
+    assert(!CStringView_ends_with(CStringView_from_c("rs"), path));
+    assert(CStringView_compare(CStringView_from_c("ab"),
+                               CStringView_from_c("abc")) == -1);
+    assert(CStringView_compare(CStringView_from_c("b"),
+                               CStringView_from_c("abc")) == 1);
+    return 0;
+}
+
+// Reference decoder used to cross-check the vectorized routines.
+static int naive_utf8(const unsigned char *p, size_t len, uint32_t *out,
+                      size_t *count) {
+    size_t n = 0;
+    for (size_t i = 0; i < len;) {
+        uint32_t cp;
+        size_t extra;
+        if (p[i] < 0x80) {
+            cp = p[i], extra = 0;
+        } else if ((p[i] & 0xE0) == 0xC0) {
+            cp = p[i] & 0x1F, extra = 1;
+        } else if ((p[i] & 0xF0) == 0xE0) {
+            cp = p[i] & 0x0F, extra = 2;
+        } else if ((p[i] & 0xF8) == 0xF0) {
+            cp = p[i] & 0x07, extra = 3;
+        } else {
+            return 0;
+        }
+        if (i + extra >= len)
+            return 0;
+        for (size_t k = 1; k <= extra; k++) {
+            if ((p[i + k] & 0xC0) != 0x80)
+                return 0;
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        const uint32_t min[] = {0, 0x80, 0x800, 0x10000};
+        if (cp < min[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return 0;
+        out[n++] = cp;
+        i += extra + 1;
+    }
+    *count = n;
+    return 1;
+}
+
+int test_utf8() {
+    CLog(INFO, "test_utf8()");
+    const char *valid[] = {"", "plain ascii", "caf\xC3\xA9",
+                           "\xE2\x82\xAC 100", "\xF0\x9F\x98\x80",
+                           "\xF4\x8F\xBF\xBF", "\xED\x9F\xBF"};
+    const char *invalid[] = {"\x80",         "\xC3",         "\xC0\xAF",
+                             "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+                             "\xF8\x88\x80\x80\x80", "abc\xE2\x82"};
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++)
+        assert(CStringView_validate_utf8(CStringView_from_c(valid[i])));
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+        assert(!CStringView_validate_utf8(CStringView_from_c(invalid[i])));
+
+    // Mix valid sequences with stray bytes across vector block boundaries.
+    const char *pieces[] = {"a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80",
+                            "0123456789abcdef"};
+    unsigned char buffer[300];
+    uint32_t expected[300], decoded[300];
+    uint16_t units[300];
+    for (int round = 0; round < 20000; round++) {
+        size_t len = 0;
+        size_t target = (size_t)rand() % 200;
+        while (len < target) {
+            const char *piece = pieces[rand() % 5];
+            memcpy(buffer + len, piece, strlen(piece));
+            len += strlen(piece);
+        }
+        if (rand() % 2)
+            buffer[rand() % (len + 1)] = (unsigned char)rand();
+
+        CStringView_t view = CStringView_from((const char *)buffer, len);
+        size_t count = 0, n = 0;
+        int ok = naive_utf8(buffer, len, expected, &count);
+        assert(CStringView_validate_utf8(view) == ok);
+        assert((CStringView_to_utf32(view, decoded, &n) ==
+                CSTRINGVIEW_SUCCESS) == ok);
+        if (!ok)
+            continue;
+        assert(n == count);
+        assert(memcmp(decoded, expected, n * sizeof(uint32_t)) == 0);
+        assert(CStringView_utf8_length(view) == count);
+        assert(CStringView_to_utf16(view, units, &n) == CSTRINGVIEW_SUCCESS);
+        for (size_t i = 0, j = 0; i < count; i++) {
+            if (expected[i] >= 0x10000) {
+                assert(units[j++] == 0xD800 + ((expected[i] - 0x10000) >> 10));
+                assert(units[j++] == 0xDC00 + (expected[i] & 0x3FF));
+            } else {
+                assert(units[j++] == expected[i]);
+            }
+            assert(i + 1 < count || j == n);
+        }
+    }
+
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_set(str, "\xE2\x82\xAC\xF0\x9F\x98\x80!") ==
+           CSTRING_SUCCESS);
+    assert(CString_validate_utf8(str));
+    assert(CString_utf8_length(str) == 3);
+
+    size_t n;
+    res = CString_to_utf16(str, &n);
+    assert(!CResult_is_error(res));
+    uint16_t *utf16 = CResult_get(res);
+    assert(n == 4 && utf16[0] == 0x20AC && utf16[1] == 0xD83D &&
+           utf16[2] == 0xDE00 && utf16[3] == '!' && utf16[4] == 0);
+    CResult_free(&res);
+
+    res = CString_to_utf32(str, &n);
+    assert(!CResult_is_error(res));
+    uint32_t *utf32 = CResult_get(res);
+    assert(n == 3 && utf32[0] == 0x20AC && utf32[1] == 0x1F600 &&
+           utf32[2] == '!' && utf32[3] == 0);
+    CResult_free(&res);
+
+    res = CString_c_wchar_t(str);
+    assert(!CResult_is_error(res));
+    wchar_t *wide = CResult_get(res);
+    assert(wide[0] == 0x20AC && wide[wcslen(wide) - 1] == L'!');
+    CResult_free(&res);
+
+    assert(CString_append_c(str, "\xFF") == CSTRING_SUCCESS);
+    assert(!CString_validate_utf8(str));
+    res = CString_to_utf32(str, NULL);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CSTRING_INVALID_UTF8);
+    CResult_free(&res);
+
+    CString_free(&str);
+    return 0;
+}
+
 int main() {
     // enable_debugging();
     enable_location();
     shortened_location();
     assert(!test_empty());
     assert(!test_at());
+    assert(!test_view());
+    assert(!test_search());
+    assert(!test_split());
+    assert(!test_appendf());
+    assert(!test_numbers());
+    assert(!test_utf8());
+    assert(!test_clone());
+    assert(!test_compare());
     return 0;
 }
\ No newline at end of file
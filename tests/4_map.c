@@ -24,11 +24,14 @@
 
 #include <cstd/CHashMap.h>
 #include <cstd/CLog.h>
+#include <cstd/CString.h>
 
 #include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #define TEST_MAX 1000
 
@@ -38,9 +41,15 @@ int int_compare(const void *a, const void *b) {
 
 uint64_t int_hash(const void *key) { return (*(int *)key) % 4096 + 127; }
 
+int integer_compare(const void *a, const void *b) {
+    const int *int_a = (const int *)a;
+    const int *int_b = (const int *)b;
+    return (*int_a > *int_b) - (*int_a < *int_b);
+}
+
 int create_hash_map(CHashMap_t **map) {
     CLog(INFO, "create_hash_map()");
-    CResult_t *res = CHashMap_new(20, ccompare_integer, int_hash, free, free);
+    CResult_t *res = CHashMap_new(20, integer_compare, int_hash, free, free);
     assert(!CResult_is_error(res));
     assert(map);
     *map = CResult_get(res);
@@ -124,10 +133,164 @@ void test_free(CHashMap_t **map) {
     assert(result == CHASHMAP_SUCCESS);
 }
 
-int ccompare_integer(const void *a, const void *b) {
-    const int *int_a = (const int *)a;
-    const int *int_b = (const int *)b;
-    return (*int_a > *int_b) - (*int_a < *int_b);
+// The CString key operators come with the library's default functions.
+#ifndef CSTD_NO_DEF_FN_IMPL
+void cstring_destroy(void *string) {
+    CString_t *str = string;
+    CString_free(&str);
+}
+
+CString_t *make_path(int i) {
+    CResult_t *res = CString_new();
+    assert(!CResult_is_error(res));
+    CString_t *str = CResult_get(res);
+    CResult_free(&res);
+    assert(CString_appendf(str, "/api/v1/routes/service/%d/handler", i) ==
+           CSTRING_SUCCESS);
+    return str;
+}
+
+void test_cstring_keys() {
+    CLog(INFO, "test_cstring_keys()");
+    CResult_t *res = CHashMap_new(20, ccompare_cstring, chash_cstring,
+                                  cstring_destroy, free);
+    assert(!CResult_is_error(res));
+    CHashMap_t *map = CResult_get(res);
+    CResult_free(&res);
+
+    for (int i = 0; i < TEST_MAX; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        assert(CHashMap_insert(map, make_path(i), value) == CHASHMAP_SUCCESS);
+    }
+
+    // Lookups with fresh keys hash them once, then compare via the cache.
+    for (int i = 0; i < TEST_MAX; i++) {
+        CString_t *key = make_path(i);
+        for (int repeat = 0; repeat < 3; repeat++) {
+            res = CHashMap_get(map, key);
+            assert(!CResult_is_error(res));
+            assert(*(int *)CResult_get(res) == i);
+            CResult_free(&res);
+        }
+
+        // Modifying the key must invalidate its cached hash.
+        assert(CString_append_c(key, "/missing") == CSTRING_SUCCESS);
+        res = CHashMap_get(map, key);
+        assert(CResult_is_error(res));
+        CResult_free(&res);
+        CString_free(&key);
+    }
+
+    assert(CHashMap_free(&map) == CHASHMAP_SUCCESS);
+}
+#endif // CSTD_NO_DEF_FN_IMPL
+
+int string_compare(const void *a, const void *b) { return strcmp(a, b); }
+
+size_t string_hash(const void *key) {
+    size_t hash = 5381;
+    for (const char *c = key; *c; c++)
+        hash = hash * 33 + (unsigned char)*c;
+    return hash;
+}
+
+size_t serialize_string(const void *data, void *buffer, size_t size) {
+    size_t len = strlen(data) + 1;
+    if (size >= len)
+        memcpy(buffer, data, len);
+    return len;
+}
+
+size_t serialize_int(const void *data, void *buffer, size_t size) {
+    if (size >= sizeof(int))
+        memcpy(buffer, data, sizeof(int));
+    return sizeof(int);
+}
+
+char *make_key(int i) {
+    char *key = malloc(32);
+    assert(key);
+    snprintf(key, 32, "key-%d", i);
+    return key;
+}
+
+void test_snapshot() {
+    CLog(INFO, "test_snapshot()");
+    CResult_t *res = CHashMap_new(20, string_compare, string_hash, free, free);
+    assert(!CResult_is_error(res));
+    CHashMap_t *map = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < TEST_MAX; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i * 7;
+        assert(CHashMap_insert(map, make_key(i), value) == CHASHMAP_SUCCESS);
+    }
+    // Leave tombstones behind for the snapshot to keep.
+    for (int i = 0; i < TEST_MAX; i += 10) {
+        char *key = make_key(i);
+        assert(CHashMap_remove(map, key) == CHASHMAP_SUCCESS);
+        free(key);
+    }
+
+    char path[] = "/tmp/cstd_map_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(CHashMap_save(map, path, serialize_string, serialize_int) ==
+           CHASHMAP_SUCCESS);
+    assert(CHashMap_save(map, path, NULL, serialize_int) ==
+           CHASHMAP_NULL_VAL);
+    assert(CHashMap_save(map, path, serialize_string, serialize_int) ==
+           CHASHMAP_SUCCESS);
+    size_t size = CHashMap_size(map);
+    assert(CHashMap_free(&map) == CHASHMAP_SUCCESS);
+
+    res = CHashMap_load(path, string_compare, string_hash, free, free);
+    assert(!CResult_is_error(res));
+    map = CResult_get(res);
+    CResult_free(&res);
+    assert(CHashMap_size(map) == size);
+    for (int i = 0; i < TEST_MAX; i++) {
+        char *key = make_key(i);
+        res = CHashMap_get(map, key);
+        assert(CResult_is_error(res) == (i % 10 == 0));
+        if (i % 10)
+            assert(*(int *)CResult_get(res) == i * 7);
+        CResult_free(&res);
+        free(key);
+    }
+
+    // Loaded maps stay mutable; entries from the snapshot are not freed.
+    int *value = malloc(sizeof(int));
+    *value = -1;
+    assert(CHashMap_update(map, "key-1", value) == CHASHMAP_SUCCESS);
+    assert(CHashMap_remove(map, "key-2") == CHASHMAP_SUCCESS);
+    for (int i = 0; i < TEST_MAX * 2; i++) {
+        value = malloc(sizeof(int));
+        *value = i;
+        assert(CHashMap_insert(map, make_key(TEST_MAX + i), value) ==
+               CHASHMAP_SUCCESS);
+    }
+    res = CHashMap_get(map, "key-1");
+    assert(*(int *)CResult_get(res) == -1);
+    CResult_free(&res);
+    res = CHashMap_get(map, "key-3");
+    assert(*(int *)CResult_get(res) == 21);
+    CResult_free(&res);
+    assert(CHashMap_free(&map) == CHASHMAP_SUCCESS);
+
+    // Truncated and missing files are rejected.
+    assert(truncate(path, 100) == 0);
+    res = CHashMap_load(path, string_compare, string_hash, free, free);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CHASHMAP_INVALID_SNAPSHOT);
+    CResult_free(&res);
+    unlink(path);
+    res = CHashMap_load(path, string_compare, string_hash, free, free);
+    assert(CResult_is_error(res));
+    assert(CError_get_code(CResult_eget(res)) == CHASHMAP_IO_FAILURE);
+    CResult_free(&res);
 }
 
 int main() {
@@ -143,5 +306,9 @@ int main() {
     test_remove(map);
     test_clear(map);
     test_free(&map);
+#ifndef CSTD_NO_DEF_FN_IMPL
+    test_cstring_keys();
+#endif
+    test_snapshot();
     return 0;
 }
@@ -29,6 +29,8 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 int int_compare(const void *a, const void *b) {
     return (*(int *)a - *(int *)b);
@@ -36,6 +38,12 @@ int int_compare(const void *a, const void *b) {
 
 uint64_t int_hash(const void *key) { return (*(int *)key) + 1; }
 
+size_t serialize_int(const void *data, void *buffer, size_t size) {
+    if (size >= sizeof(int))
+        memcpy(buffer, data, sizeof(int));
+    return sizeof(int);
+}
+
 void test_insert(CHashSet_t *set) {
     CLog(INFO, "test_insert()");
     for (int i = 0; i < 1000; i++) {
@@ -76,6 +84,52 @@ void test_free(CHashSet_t **set) {
     assert(result == CHASHSET_SUCCESS);
 }
 
+void test_snapshot() {
+    CLog(INFO, "test_snapshot()");
+    CResult_t *res = CHashSet_new(20, int_compare, int_hash, free);
+    assert(!CResult_is_error(res));
+    CHashSet_t *set = CResult_get(res);
+    CResult_free(&res);
+    test_insert(set);
+    for (int i = 0; i < 1000; i += 3)
+        assert(CHashSet_remove(set, &i) == CHASHSET_SUCCESS);
+
+    char path[] = "/tmp/cstd_set_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(CHashSet_save(set, path, serialize_int) == CHASHSET_SUCCESS);
+    assert(CHashSet_free(&set) == CHASHSET_SUCCESS);
+
+    res = CHashSet_load(path, int_compare, int_hash, free);
+    assert(!CResult_is_error(res));
+    set = CResult_get(res);
+    CResult_free(&res);
+    for (int i = 0; i < 1000; i++) {
+        int found = CHashSet_contains(set, &i) == CHASHSET_SUCCESS;
+        assert(found == (i % 3 != 0));
+    }
+    for (int i = 1000; i < 3000; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        assert(CHashSet_add(set, value) == CHASHSET_SUCCESS);
+    }
+    for (int i = 1; i < 3000; i += 3)
+        assert(CHashSet_remove(set, &i) == CHASHSET_SUCCESS);
+    for (int i = 0; i < 3000; i++) {
+        int found = CHashSet_contains(set, &i) == CHASHSET_SUCCESS;
+        assert(found == (i % 3 == 2 || (i >= 1000 && i % 3 == 0)));
+    }
+    assert(CHashSet_free(&set) == CHASHSET_SUCCESS);
+
+    // Empty files are rejected.
+    assert(truncate(path, 0) == 0);
+    res = CHashSet_load(path, int_compare, int_hash, free);
+    assert(CResult_is_error(res));
+    CResult_free(&res);
+    unlink(path);
+}
+
 int main() {
     enable_debugging();
     enable_location();
@@ -91,5 +145,6 @@ int main() {
     test_clear(set);
     test_free(&set);
     CResult_free(&res);
+    test_snapshot();
     return 0;
 }
@@ -195,6 +195,218 @@ int test_clone() {
     return 0;
 }
 
+/// Check the list holds `expected`, walking it forwards then backwards.
+static void expect_list(CLinkedList_t *list, const int *expected, size_t n) {
+    assert(CLinkedList_size(list) == n);
+    CListCursor_t it = CLinkedList_cursor(list);
+    for (size_t i = 0; i < n; i++) {
+        assert(CListCursor_next(&it));
+        assert(*(int *)CListCursor_value(&it) == expected[i]);
+    }
+    assert(!CListCursor_next(&it));
+    assert(CListCursor_value(&it) == NULL);
+    for (size_t i = n; i-- > 0;) {
+        assert(CListCursor_prev(&it));
+        assert(*(int *)CListCursor_value(&it) == expected[i]);
+    }
+    assert(!CListCursor_prev(&it));
+}
+
+int test_cursor() {
+    CLog(INFO, "test_cursor()");
+    static int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    for (int type = CLINKEDLIST_TYPE_SINGLE; type <= CLINKEDLIST_TYPE_DOUBLE;
+         type++) {
+        CResult_t *res = CLinkedList_new(type, NULL);
+        assert(!CResult_is_error(res));
+        CLinkedList_t *list = CResult_get(res);
+        CResult_free(&res);
+
+        CListNode_t *nodes[10];
+        for (int i = 0; i < 10; i++)
+            assert(CLinkedList_add_node(list, &values[i], &nodes[i]) ==
+                   CLINKEDLIST_SUCCESS);
+        assert(CListNode_value(nodes[7]) == &values[7]);
+
+        // Drop the even numbers in one pass.
+        CListCursor_t it = CLinkedList_cursor(list);
+        assert(CListCursor_remove_here(&it) ==
+               CLINKEDLIST_INDEX_OUT_OF_BOUNDS);
+        while (CListCursor_next(&it))
+            if (*(int *)CListCursor_value(&it) % 2 == 0)
+                assert(CListCursor_remove_here(&it) == CLINKEDLIST_SUCCESS);
+        expect_list(list, (int[]){1, 3, 5, 7, 9}, 5);
+
+        // Inserting around the cursor, on an element and in a gap.
+        it = CLinkedList_cursor_at(list, nodes[5]);
+        assert(CListCursor_node(&it) == nodes[5]);
+        assert(CListCursor_insert_before(&it, &values[4]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CListCursor_insert_after(&it, &values[6]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CListCursor_remove_here(&it) == CLINKEDLIST_SUCCESS);
+        assert(CListCursor_insert_after(&it, &values[10]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CListCursor_insert_before(&it, &values[11]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CListCursor_next(&it));
+        assert(CListCursor_value(&it) == &values[10]);
+        expect_list(list, (int[]){1, 3, 4, 11, 10, 6, 7, 9}, 8);
+
+        // Moving an element to the back by its handle, as an LRU would.
+        assert(CLinkedList_remove_node(list, nodes[1]) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_add_node(list, &values[1], &nodes[1]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_remove_node(list, nodes[9]) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_add(list, &values[0]) == CLINKEDLIST_SUCCESS);
+        expect_list(list, (int[]){3, 4, 11, 10, 6, 7, 1, 0}, 8);
+
+        // Adding at the end after removing the last element by index.
+        assert(CLinkedList_remove(list, 7) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_add(list, &values[2]) == CLINKEDLIST_SUCCESS);
+        expect_list(list, (int[]){3, 4, 11, 10, 6, 7, 1, 2}, 8);
+
+        // Emptying the list through a cursor, then filling it again.
+        it = CLinkedList_cursor(list);
+        while (CListCursor_next(&it))
+            CListCursor_remove_here(&it);
+        assert(CLinkedList_size(list) == 0);
+        assert(CListCursor_insert_before(&it, &values[8]) ==
+               CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_add(list, &values[9]) == CLINKEDLIST_SUCCESS);
+        expect_list(list, (int[]){8, 9}, 2);
+        CLinkedList_free(&list);
+    }
+
+    assert(CLinkedList_add_node(NULL, NULL, NULL) == CLINKEDLIST_NULL_LIST);
+    assert(CLinkedList_remove_node(NULL, NULL) == CLINKEDLIST_NULL_LIST);
+    assert(CListNode_value(NULL) == NULL);
+    return 0;
+}
+
+/// Order pairs {key, tag} by key alone, to check that sorting is stable.
+static int32_t compare_key(const void *a, const void *b) {
+    return ((const int *)a)[0] - ((const int *)b)[0];
+}
+
+int test_sort_splice() {
+    CLog(INFO, "test_sort_splice()");
+    static int pairs[][2] = {{5, 0}, {3, 1}, {9, 2}, {3, 3}, {1, 4},
+                             {5, 5}, {7, 6}, {3, 7}, {0, 8}, {9, 9}};
+    static int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    for (int type = CLINKEDLIST_TYPE_SINGLE; type <= CLINKEDLIST_TYPE_DOUBLE;
+         type++) {
+        CResult_t *res = CLinkedList_new(type, NULL);
+        assert(!CResult_is_error(res));
+        CLinkedList_t *list = CResult_get(res);
+        CResult_free(&res);
+        res = CLinkedList_new(type, NULL);
+        CLinkedList_t *other = CResult_get(res);
+        CResult_free(&res);
+
+        assert(CLinkedList_sort(list, compare_key) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_reverse(list) == CLINKEDLIST_SUCCESS);
+        CListNode_t *nodes[10];
+        for (int i = 0; i < 10; i++)
+            CLinkedList_add_node(list, pairs[i], &nodes[i]);
+        assert(CLinkedList_sort(list, NULL) == CLINKEDLIST_INVALID_OPERATION);
+        assert(CLinkedList_sort(list, compare_key) == CLINKEDLIST_SUCCESS);
+        int tags[] = {8, 4, 1, 3, 7, 0, 5, 6, 2, 9};
+        CListCursor_t it = CLinkedList_cursor(list);
+        for (int i = 0; i < 10; i++) {
+            assert(CListCursor_next(&it));
+            assert(((int *)CListCursor_value(&it))[1] == tags[i]);
+        }
+        assert(!CListCursor_next(&it));
+        // Handles survive the sort, and so does the last node.
+        it = CLinkedList_cursor_at(list, nodes[2]);
+        assert(CListCursor_next(&it));
+        assert(CListCursor_value(&it) == pairs[9]);
+        assert(!CListCursor_next(&it));
+        assert(CListCursor_prev(&it));
+        assert(CListCursor_value(&it) == pairs[9]);
+        CLinkedList_clear(list);
+
+        // Splicing at the front, in the middle and at the back.
+        for (int i = 3; i < 5; i++)
+            CLinkedList_add_node(list, &values[i], &nodes[i]);
+        CLinkedList_add(other, &values[0]);
+        CLinkedList_add(other, &values[1]);
+        assert(CLinkedList_splice(list, NULL, other) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_size(other) == 0);
+        CLinkedList_add(other, &values[7]);
+        assert(CLinkedList_splice(list, nodes[4], other) ==
+               CLINKEDLIST_SUCCESS);
+        CLinkedList_add(other, &values[2]);
+        assert(CLinkedList_splice(list, nodes[3], other) ==
+               CLINKEDLIST_SUCCESS);
+        CLinkedList_add(other, &values[8]);
+        CLinkedList_add(other, &values[9]);
+        assert(CLinkedList_concat(list, other) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_concat(list, other) == CLINKEDLIST_SUCCESS);
+        expect_list(list, (int[]){0, 1, 3, 2, 4, 7, 8, 9}, 8);
+
+        // Both lists stay usable at their ends.
+        CLinkedList_add(list, &values[5]);
+        CLinkedList_add(other, &values[6]);
+        expect_list(other, (int[]){6}, 1);
+        assert(CLinkedList_concat(other, list) == CLINKEDLIST_SUCCESS);
+        expect_list(other, (int[]){6, 0, 1, 3, 2, 4, 7, 8, 9, 5}, 10);
+        expect_list(list, NULL, 0);
+
+        assert(CLinkedList_reverse(other) == CLINKEDLIST_SUCCESS);
+        expect_list(other, (int[]){5, 9, 8, 7, 4, 2, 3, 1, 0, 6}, 10);
+        CLinkedList_add(other, &values[4]);
+        expect_list(other, (int[]){5, 9, 8, 7, 4, 2, 3, 1, 0, 6, 4}, 11);
+
+        assert(CLinkedList_splice(other, NULL, other) ==
+               CLINKEDLIST_INVALID_OPERATION);
+        res = CLinkedList_new(!type, NULL);
+        CLinkedList_t *mismatch = CResult_get(res);
+        CResult_free(&res);
+        assert(CLinkedList_concat(other, mismatch) ==
+               CLINKEDLIST_INVALID_OPERATION);
+        CLinkedList_free(&mismatch);
+        CLinkedList_free(&list);
+        CLinkedList_free(&other);
+    }
+
+    // Larger lists, sorted then reversed.
+    for (int type = CLINKEDLIST_TYPE_SINGLE; type <= CLINKEDLIST_TYPE_DOUBLE;
+         type++) {
+        CResult_t *res = CLinkedList_new(type, free);
+        CLinkedList_t *list = CResult_get(res);
+        CResult_free(&res);
+        for (int i = 0; i < 1000; i++) {
+            int *pair = malloc(2 * sizeof(int));
+            pair[0] = rand() % 100;
+            pair[1] = i;
+            CLinkedList_add(list, pair);
+        }
+        assert(CLinkedList_sort(list, compare_key) == CLINKEDLIST_SUCCESS);
+        assert(CLinkedList_reverse(list) == CLINKEDLIST_SUCCESS);
+        int *last = NULL;
+        size_t count = 0;
+        CListCursor_t it = CLinkedList_cursor(list);
+        while (CListCursor_next(&it)) {
+            int *pair = CListCursor_value(&it);
+            if (last) {
+                assert(pair[0] <= last[0]);
+                assert(pair[0] < last[0] || pair[1] < last[1]);
+            }
+            last = pair;
+            count++;
+        }
+        assert(count == 1000);
+        CLinkedList_free(&list);
+    }
+
+    assert(CLinkedList_sort(NULL, compare_key) == CLINKEDLIST_NULL_LIST);
+    assert(CLinkedList_splice(NULL, NULL, NULL) == CLINKEDLIST_NULL_LIST);
+    assert(CLinkedList_reverse(NULL) == CLINKEDLIST_NULL_LIST);
+    return 0;
+}
+
 int main() {
     enable_location();
     shortened_location();
@@ -203,5 +415,7 @@ int main() {
     assert(!test_custom_structs());
     assert(!test_clear());
     assert(!test_clone());
+    assert(!test_cursor());
+    assert(!test_sort_splice());
     return 0;
 }